@@ -0,0 +1,27 @@
+<?php
+header("Content-Type: text/javascript; charset=utf-8");
+header("Cache-Control: max-age=3600");
+
+$mode = $_GET["mode"];
+
+function sendChunk($chunk)
+{
+    echo $chunk;
+    flush();
+    usleep(100000);
+}
+
+// "split" is not ASCII from the first byte, the other modes start out ASCII and switch mid-load.
+if ($mode != "split")
+    sendChunk("// " . str_repeat("ascii padding ", 100) . "\n");
+
+sendChunk("scriptLoaded(\"" . $mode . "\", \"" . ($mode == "split" ? "" : "ascii "));
+
+// U+00E9, U+D55C and U+1F600 with their bytes spread over several chunks.
+sendChunk("\xC3");
+sendChunk("\xA9\xED");
+sendChunk("\x95");
+sendChunk("\x9C\xF0\x9F");
+sendChunk("\x98");
+echo "\x80" . ($mode == "split" ? "" : " tail") . "\");\n";
+?>
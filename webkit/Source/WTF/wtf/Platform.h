@@ -343,6 +343,11 @@
 
 #endif /* ARM */
 
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+/* SSE2 is part of the x86-64 baseline; wider instruction sets have to be checked at runtime. */
+#define HAVE_X86_SSE2_INTRINSICS 1
+#endif
+
 #if CPU(ARM) || CPU(MIPS) || CPU(SH4)
 #define WTF_CPU_NEEDS_ALIGNED_ACCESS 1
 #endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the box blur passes behind feGaussianBlur and CSS blur(), and the erode/dilate passes of
+// feMorphology, with the scalar loops of FEGaussianBlur and FEMorphology and with the SIMD kernels this
+// CPU gets, over layer-sized buffers. Every SIMD result is checked against the scalar one.
+//
+// On Linux, you can build this against a WebKit build tree like so:
+// clang++ -o FilterBenchmark Source/WebCore/benchmarks/FilterBenchmark.cpp -O3 -std=c++14 -fvisibility=hidden
+//     -ISource/WTF -ISource/JavaScriptCore -ISource/WebCore -ISource/WebCore/platform -ISource/WebCore/platform/graphics
+//     -ISource/WebCore/platform/graphics/cpu/arm/filters -ISource/WebCore/platform/graphics/cpu/x86
+//     -ISource/WebCore/platform/graphics/cpu/x86/filters -ISource/WebCore/platform/graphics/filters
+//     -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/WebCore -LWebKitBuild/Release/lib
+//     -lWebCore -lJavaScriptCore -lWTF -licuuc
+
+#include "config.h"
+
+#include "CPUFeaturesX86.h"
+#include "FEGaussianBlur.h"
+#include "FEGaussianBlurAVX2.h"
+#include "FEGaussianBlurNEON.h"
+#include "FEGaussianBlurSSE2.h"
+#include "FEMorphology.h"
+#include "FEMorphologyNEON.h"
+#include "FEMorphologySSE2.h"
+#include <runtime/Uint8ClampedArray.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/RandomNumber.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+using namespace WebCore;
+
+namespace {
+
+void scalarBoxBlur(Uint8ClampedArray* source, Uint8ClampedArray* destination, unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+    FEGaussianBlur::scalarBoxBlur(source, destination, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight, false, EDGEMODE_NONE);
+}
+
+void simdBoxBlur(Uint8ClampedArray* sourceArray, Uint8ClampedArray* destinationArray, unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+#if HAVE(ARM_NEON_INTRINSICS) || HAVE(X86_SSE2_INTRINSICS)
+    const uint8_t* source = sourceArray->data();
+    uint8_t* destination = destinationArray->data();
+#endif
+#if HAVE(ARM_NEON_INTRINSICS)
+    boxBlurNEON(source, destination, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+#elif HAVE(X86_SSE2_INTRINSICS)
+#if COMPILER(GCC_OR_CLANG)
+    if (cpuSupportsAVX2()) {
+        boxBlurAVX2(source, destination, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+        return;
+    }
+#endif
+    boxBlurSSE2(source, destination, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+#else
+    scalarBoxBlur(sourceArray, destinationArray, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+#endif
+}
+
+typedef void (*BoxBlurFunction)(Uint8ClampedArray*, Uint8ClampedArray*, unsigned, int, int, int, int, int, int);
+
+// Three horizontal and vertical passes, as standardBoxBlur() does. The result ends up in pixels.
+void gaussianBlur(BoxBlurFunction boxBlur, Uint8ClampedArray* pixels, Uint8ClampedArray* scratch, int width, int height, unsigned kernelSize)
+{
+    int dxLeft = kernelSize / 2;
+    int dxRight = kernelSize - dxLeft;
+    for (int i = 0; i < 3; ++i) {
+        boxBlur(pixels, scratch, kernelSize, dxLeft, dxRight, 4, width * 4, width, height);
+        boxBlur(scratch, pixels, kernelSize, dxLeft, dxRight, width * 4, 4, height, width);
+    }
+}
+
+MorphologyOperatorType morphologyOperator(bool dilate)
+{
+    return dilate ? FEMORPHOLOGY_OPERATOR_DILATE : FEMORPHOLOGY_OPERATOR_ERODE;
+}
+
+void scalarMorphology(Uint8ClampedArray* source, Uint8ClampedArray* destination, int width, int height, int radiusX, int radiusY, bool dilate)
+{
+    FEMorphology::scalarMorphology(morphologyOperator(dilate), source, destination, width, height, radiusX, radiusY, 0, height);
+}
+
+// The same separable passes as platformApplySeparable() in FEMorphology.cpp.
+void simdMorphology(Uint8ClampedArray* sourceArray, Uint8ClampedArray* destinationArray, int width, int height, int radiusX, int radiusY, bool dilate)
+{
+#if HAVE(ARM_NEON_INTRINSICS)
+    typedef MorphologyOperationsNEON Operations;
+#elif HAVE(X86_SSE2_INTRINSICS)
+    typedef MorphologyOperationsSSE2 Operations;
+#endif
+#if HAVE(X86_SSE2_INTRINSICS) || HAVE(ARM_NEON_INTRINSICS)
+    const uint8_t* source = sourceArray->data();
+    uint8_t* destination = destinationArray->data();
+    Vector<uint8_t> extrema(width * 4);
+    for (int y = 0; y < height; ++y) {
+        int yStart = std::max(0, y - radiusY);
+        int yEnd = std::min(height - 1, y + radiusY);
+        morphologyColumnExtrema<Operations>(source + yStart * width * 4, width * 4, yEnd - yStart + 1, extrema.data(), dilate);
+        morphologyRowExtrema<Operations>(extrema.data(), width, radiusX, destination + y * width * 4, dilate);
+    }
+#else
+    scalarMorphology(sourceArray, destinationArray, width, height, radiusX, radiusY, dilate);
+#endif
+}
+
+bool equalPixels(const Uint8ClampedArray& a, const Uint8ClampedArray& b)
+{
+    return a.length() == b.length() && !memcmp(a.data(), b.data(), a.length());
+}
+
+// Mostly opaque content with some translucent and transparent runs, premultiplied.
+RefPtr<Uint8ClampedArray> makeLayerPixels(int width, int height)
+{
+    RefPtr<Uint8ClampedArray> pixels = Uint8ClampedArray::createUninitialized(width * height * 4);
+    uint8_t* data = pixels->data();
+    for (int i = 0; i < width * height; ++i) {
+        double random = randomNumber();
+        uint8_t alpha = random < 0.7 ? 255 : random < 0.9 ? static_cast<uint8_t>(randomNumber() * 255) : 0;
+        for (int channel = 0; channel < 3; ++channel)
+            data[i * 4 + channel] = static_cast<uint8_t>(randomNumber() * alpha);
+        data[i * 4 + 3] = alpha;
+    }
+    return pixels;
+}
+
+struct LayerSize {
+    int width;
+    int height;
+};
+
+} // anonymous namespace
+
+int main(int, char**)
+{
+    WTF::initializeThreading();
+
+#if HAVE(ARM_NEON_INTRINSICS)
+    const char* simdName = "NEON";
+#elif HAVE(X86_SSE2_INTRINSICS)
+    const char* simdName = cpuSupportsAVX2() ? "AVX2" : "SSE2";
+#else
+    const char* simdName = "none";
+#endif
+
+    const LayerSize sizes[] = { { 256, 256 }, { 1024, 768 }, { 2048, 1536 } };
+    const unsigned kernelSizes[] = { 3, 15, 63 };
+    const int radii[] = { 1, 4, 16 };
+
+    for (const auto& size : sizes) {
+        RefPtr<Uint8ClampedArray> layer = makeLayerPixels(size.width, size.height);
+        unsigned length = layer->length();
+        RefPtr<Uint8ClampedArray> scratch = Uint8ClampedArray::createUninitialized(length);
+        RefPtr<Uint8ClampedArray> scalarPixels = Uint8ClampedArray::createUninitialized(length);
+        RefPtr<Uint8ClampedArray> simdPixels = Uint8ClampedArray::createUninitialized(length);
+        unsigned iterations = std::max(2, (1024 * 1024) / (size.width * size.height) * 4);
+
+        for (unsigned kernelSize : kernelSizes) {
+            double start = monotonicallyIncreasingTimeMS();
+            for (unsigned i = 0; i < iterations; ++i) {
+                memcpy(scalarPixels->data(), layer->data(), length);
+                gaussianBlur(scalarBoxBlur, scalarPixels.get(), scratch.get(), size.width, size.height, kernelSize);
+            }
+            double scalarTime = (monotonicallyIncreasingTimeMS() - start) / iterations;
+
+            start = monotonicallyIncreasingTimeMS();
+            for (unsigned i = 0; i < iterations; ++i) {
+                memcpy(simdPixels->data(), layer->data(), length);
+                gaussianBlur(simdBoxBlur, simdPixels.get(), scratch.get(), size.width, size.height, kernelSize);
+            }
+            double simdTime = (monotonicallyIncreasingTimeMS() - start) / iterations;
+            RELEASE_ASSERT(equalPixels(*scalarPixels, *simdPixels));
+
+            dataLogF("%4dx%-4d blur   kernel %2u: scalar %8.3f ms, %s %8.3f ms (%.2fx)\n", size.width, size.height, kernelSize,
+                scalarTime, simdName, simdTime, scalarTime / simdTime);
+        }
+
+        for (int radius : radii) {
+            unsigned morphologyIterations = std::max(1u, iterations / radius);
+            double start = monotonicallyIncreasingTimeMS();
+            for (unsigned i = 0; i < morphologyIterations; ++i)
+                scalarMorphology(layer.get(), scalarPixels.get(), size.width, size.height, radius, radius, i % 2);
+            double scalarTime = (monotonicallyIncreasingTimeMS() - start) / morphologyIterations;
+
+            start = monotonicallyIncreasingTimeMS();
+            for (unsigned i = 0; i < morphologyIterations; ++i)
+                simdMorphology(layer.get(), simdPixels.get(), size.width, size.height, radius, radius, i % 2);
+            double simdTime = (monotonicallyIncreasingTimeMS() - start) / morphologyIterations;
+            RELEASE_ASSERT(equalPixels(*scalarPixels, *simdPixels));
+
+            dataLogF("%4dx%-4d morph  radius %2d: scalar %8.3f ms, %s %8.3f ms (%.2fx)\n", size.width, size.height, radius,
+                scalarTime, simdName, simdTime, scalarTime / simdTime);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures how RenderLayer::hitTestList() picks the layers it hit tests, for stacking contexts with 100 to 50,000
+// child layers: the back to front walk over every layer, and the walk over the candidates LayerHitTestIndex
+// returns. Both have to agree on the frontmost layer under every point. Building the index is timed separately,
+// since it happens again after each layout.
+//
+// On Linux, you can build this against a WebKit build tree like so:
+// clang++ -o HitTestBenchmark Source/WebCore/benchmarks/HitTestBenchmark.cpp -O3 -std=c++14 -fvisibility=hidden
+//     -ISource/WTF -ISource/WebCore -ISource/WebCore/platform -ISource/WebCore/platform/graphics -ISource/WebCore/rendering
+//     -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/WebCore -LWebKitBuild/Release/lib -lWebCore -lWTF -licuuc
+
+#include "config.h"
+
+#include "LayerHitTestIndex.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/RandomNumber.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+using namespace WebCore;
+
+namespace {
+
+// A long feed of positioned cards with a few positioned children each, a fixed header, and a
+// transformed carousel every fifty cards, which the index always has to test.
+struct TestLayer {
+    LayoutRect bounds;
+    bool alwaysTested;
+};
+
+Vector<TestLayer> makeFeedLayers(unsigned layerCount)
+{
+    Vector<TestLayer> layers;
+    for (unsigned i = 0; layers.size() < layerCount; ++i) {
+        int top = 80 + i * 320;
+        layers.append({ LayoutRect(40, top, 920, 300), !(i % 50) });
+        for (unsigned child = 0; child < 3 && layers.size() < layerCount; ++child)
+            layers.append({ LayoutRect(60 + child * 300, top + 20 + static_cast<int>(randomNumber() * 20), 280, 200), false });
+    }
+    layers.last() = { LayoutRect(0, 0, 1280, 64), false };
+    return layers;
+}
+
+// The layers that are always tested can't be ruled out by their bounds, so like hitTestLayer() on a
+// transformed layer, they are hit when the point is in their bounds and cost a full test either way.
+int hitTestLinear(const Vector<TestLayer>& layers, const LayoutPoint& point, unsigned& testedLayers)
+{
+    for (size_t i = layers.size(); i > 0; --i) {
+        ++testedLayers;
+        if (layers[i - 1].bounds.contains(point))
+            return i - 1;
+    }
+    return -1;
+}
+
+int hitTestIndexed(const Vector<TestLayer>& layers, const LayerHitTestIndex& index, const LayoutPoint& point, Vector<unsigned>& candidates, unsigned& testedLayers)
+{
+    if (!index.collectCandidates(LayoutRect(point, LayoutSize(1, 1)), candidates))
+        return hitTestLinear(layers, point, testedLayers);
+
+    for (size_t i = candidates.size(); i > 0; --i) {
+        ++testedLayers;
+        if (layers[candidates[i - 1]].bounds.contains(point))
+            return candidates[i - 1];
+    }
+    return -1;
+}
+
+std::unique_ptr<LayerHitTestIndex> buildIndex(const Vector<TestLayer>& layers)
+{
+    auto index = std::make_unique<LayerHitTestIndex>();
+    for (const auto& layer : layers) {
+        if (layer.alwaysTested)
+            index->appendAlwaysTested();
+        else
+            index->append(layer.bounds);
+    }
+    return index;
+}
+
+} // anonymous namespace
+
+int main(int, char**)
+{
+    WTF::initializeThreading();
+
+    const unsigned layerCounts[] = { 100, 1000, 5000, 10000, 50000 };
+    const unsigned pointCount = 2000;
+    for (unsigned layerCount : layerCounts) {
+        auto layers = makeFeedLayers(layerCount);
+        LayoutRect documentRect;
+        for (const auto& layer : layers)
+            documentRect.unite(layer.bounds);
+
+        // Points all over the document, like mousemove events while the page scrolls.
+        Vector<LayoutPoint> points;
+        for (unsigned i = 0; i < pointCount; ++i)
+            points.append(LayoutPoint(randomNumber() * documentRect.width().toFloat(), randomNumber() * documentRect.height().toFloat()));
+
+        double start = monotonicallyIncreasingTimeMS();
+        auto index = buildIndex(layers);
+        double buildTime = monotonicallyIncreasingTimeMS() - start;
+
+        Vector<int> linearHits;
+        unsigned linearTested = 0;
+        start = monotonicallyIncreasingTimeMS();
+        for (const auto& point : points)
+            linearHits.append(hitTestLinear(layers, point, linearTested));
+        double linearTime = (monotonicallyIncreasingTimeMS() - start) / pointCount;
+
+        Vector<int> indexedHits;
+        Vector<unsigned> candidates;
+        unsigned indexedTested = 0;
+        start = monotonicallyIncreasingTimeMS();
+        for (const auto& point : points)
+            indexedHits.append(hitTestIndexed(layers, *index, point, candidates, indexedTested));
+        double indexedTime = (monotonicallyIncreasingTimeMS() - start) / pointCount;
+        RELEASE_ASSERT(linearHits == indexedHits);
+
+        dataLogF("%5u layers: linear %8.4f ms/hit (%6u layers tested), indexed %8.4f ms/hit (%4u layers tested), build %8.3f ms\n",
+            layerCount, linearTime, linearTested / pointCount, indexedTime, indexedTested / pointCount, buildTime);
+    }
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the overlap testing RenderLayerCompositor::computeCompositingRequirements() does, for layer
+// trees of 100 to 5,000 composited layers, with OverlapMapContainer and with a plain list of rects.
+//
+// On Linux, you can build this against a WebKit build tree like so:
+// clang++ -o OverlapMapBenchmark Source/WebCore/benchmarks/OverlapMapBenchmark.cpp -O3 -std=c++14 -fvisibility=hidden
+//     -ISource/WTF -ISource/WebCore -ISource/WebCore/platform -ISource/WebCore/platform/graphics -ISource/WebCore/rendering
+//     -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/WebCore -LWebKitBuild/Release/lib -lWebCore -lWTF -licuuc
+
+#include "config.h"
+
+#include "OverlapMapContainer.h"
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/RandomNumber.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+using namespace WebCore;
+
+namespace {
+
+struct LinearOverlapMapContainer {
+    void add(const LayoutRect& bounds) { m_layerRects.append(bounds); }
+
+    bool overlapsLayers(const LayoutRect& bounds) const
+    {
+        for (const auto& layerRect : m_layerRects) {
+            if (layerRect.intersects(bounds))
+                return true;
+        }
+        return false;
+    }
+
+    void unite(const LinearOverlapMapContainer& other) { m_layerRects.appendVector(other.m_layerRects); }
+
+    Vector<LayoutRect> m_layerRects;
+};
+
+// A long feed: rows of cards that each contain a few composited children, with a fixed header
+// and a sidebar overlapping the top of the page.
+Vector<LayoutRect> makeFeedLayers(unsigned layerCount)
+{
+    Vector<LayoutRect> layers;
+    layers.append(LayoutRect(0, 0, 1280, 64));
+    layers.append(LayoutRect(1000, 64, 280, 900));
+    for (unsigned i = 0; layers.size() < layerCount; ++i) {
+        int top = 80 + i * 320;
+        layers.append(LayoutRect(40, top, 920, 300));
+        for (unsigned child = 0; child < 3 && layers.size() < layerCount; ++child)
+            layers.append(LayoutRect(60 + child * 300, top + 20 + static_cast<int>(randomNumber() * 20), 280, 200));
+    }
+    return layers;
+}
+
+// Mirrors OverlapMap: a layer tests against the stack top, and only contributes to overlap once its
+// compositing container has been popped.
+template<typename Container>
+unsigned runCompositingPass(const Vector<LayoutRect>& layers, unsigned childrenPerContainer)
+{
+    Vector<Container> stack;
+    stack.append(Container());
+    stack.append(Container());
+
+    unsigned overlapCount = 0;
+    for (unsigned i = 0; i < layers.size(); ++i) {
+        if (stack.last().overlapsLayers(layers[i]))
+            ++overlapCount;
+        stack[stack.size() - 2].add(layers[i]);
+
+        if (!((i + 1) % childrenPerContainer)) {
+            stack[stack.size() - 2].unite(stack.last());
+            stack.removeLast();
+            stack.append(Container());
+        }
+    }
+    return overlapCount;
+}
+
+template<typename Container>
+double measure(const Vector<LayoutRect>& layers, unsigned iterations, unsigned& overlapCount)
+{
+    double start = monotonicallyIncreasingTimeMS();
+    for (unsigned i = 0; i < iterations; ++i)
+        overlapCount = runCompositingPass<Container>(layers, 10);
+    return (monotonicallyIncreasingTimeMS() - start) / iterations;
+}
+
+} // anonymous namespace
+
+int main(int, char**)
+{
+    WTF::initializeThreading();
+
+    const unsigned layerCounts[] = { 100, 250, 500, 1000, 2500, 5000 };
+    for (unsigned layerCount : layerCounts) {
+        auto layers = makeFeedLayers(layerCount);
+        unsigned iterations = std::max(5u, 20000 / layerCount);
+
+        unsigned linearOverlaps = 0;
+        unsigned gridOverlaps = 0;
+        double linearTime = measure<LinearOverlapMapContainer>(layers, iterations, linearOverlaps);
+        double gridTime = measure<OverlapMapContainer>(layers, iterations, gridOverlaps);
+        RELEASE_ASSERT(linearOverlaps == gridOverlaps);
+
+        dataLogF("%5u layers: linear %8.3f ms, grid %8.3f ms (%u overlapping)\n", layerCount, linearTime, gridTime, gridOverlaps);
+    }
+    return 0;
+}
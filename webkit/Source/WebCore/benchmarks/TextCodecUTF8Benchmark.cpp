@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures UTF-8 decoding by TextCodecUTF8, which uses the vector decoders this CPU gets, against the scalar
+// loop they replace. The built-in corpora are pages made of the first article of the Universal Declaration of
+// Human Rights in several scripts, wrapped in the kind of markup news and portal sites have. Pass file names to
+// decode other corpora, such as saved pages. Every corpus is decoded in one go and in network-sized chunks, and
+// both results are checked against the scalar one, as are copies of the corpus with random bytes corrupted.
+//
+// On Linux, you can build this against a WebKit build tree like so:
+// clang++ -o TextCodecUTF8Benchmark Source/WebCore/benchmarks/TextCodecUTF8Benchmark.cpp
+//     Source/WebCore/platform/text/TextCodec.cpp Source/WebCore/platform/text/TextCodecUTF8.cpp -O3 -std=c++14
+//     -fvisibility=hidden -ISource/WTF -ISource/WebCore -ISource/WebCore/platform -ISource/WebCore/platform/graphics/cpu/x86
+//     -ISource/WebCore/platform/text -ISource/WebCore/platform/text/cpu/arm -ISource/WebCore/platform/text/cpu/x86
+//     -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/WebCore -LWebKitBuild/Release/lib -lWTF -licuuc
+
+#include "config.h"
+
+#include "CPUFeaturesX86.h"
+#include "TextCodecUTF8.h"
+#include <stdio.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/RandomNumber.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/WTFString.h>
+#include <wtf/unicode/CharacterNames.h>
+
+using namespace WebCore;
+
+namespace {
+
+struct Corpus {
+    const char* name;
+    const char* text;
+};
+
+const Corpus builtInCorpora[] = {
+    { "English", "All human beings are born free and equal in dignity and rights. They are endowed with reason and conscience and should act towards one another in a spirit of brotherhood." },
+    { "Korean", "모든 인간은 태어날 때부터 자유로우며 그 존엄과 권리에 있어 동등하다. 인간은 천부적으로 이성과 양심을 부여받았으며 서로 형제애의 정신으로 행동하여야 한다." },
+    { "Japanese", "すべての人間は、生まれながらにして自由であり、かつ、尊厳と権利とについて平等である。人間は、理性と良心とを授けられており、互いに同胞の精神をもって行動しなければならない。" },
+    { "Chinese", "人人生而自由，在尊严和权利上一律平等。他们赋有理性和良心，并应以兄弟关系的精神相对待。" },
+    { "Russian", "Все люди рождаются свободными и равными в своем достоинстве и правах. Они наделены разумом и совестью и должны поступать в отношении друг друга в духе братства." },
+    { "Greek", "Όλοι οι άνθρωποι γεννιούνται ελεύθεροι και ίσοι στην αξιοπρέπεια και τα δικαιώματα. Είναι προικισμένοι με λογική και συνείδηση, και οφείλουν να συμπεριφέρονται μεταξύ τους με πνεύμα αδελφοσύνης." },
+    { "Arabic", "يولد جميع الناس أحرارًا متساوين في الكرامة والحقوق. وقد وهبوا عقلاً وضميرًا وعليهم أن يعامل بعضهم بعضًا بروح الإخاء." },
+    { "Hindi", "सभी मनुष्यों को गौरव और अधिकारों के मामले में जन्मजात स्वतन्त्रता और समानता प्राप्त है। उन्हें बुद्धि और अन्तरात्मा की देन प्राप्त है और परस्पर उन्हें भाईचारे के भाव से बर्ताव करना चाहिए।" },
+    { "Emoji", "모든 인간은 태어날 때부터 자유로우며 😀 all human beings are born free 🎉 人人生而自由 👍🏽 Все люди рождаются свободными ❤️" },
+};
+
+// Wraps a text in markup until the page is about a megabyte, which is more than most pages, but keeps timer noise down.
+Vector<uint8_t> makePage(const char* text)
+{
+    StringBuilder page;
+    page.appendLiteral("<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>");
+    page.append(String::fromUTF8(text).left(20));
+    page.appendLiteral("</title><link rel=\"stylesheet\" href=\"/static/css/main.css\"></head><body>\n");
+    for (unsigned i = 0; page.length() < 1024 * 1024; ++i) {
+        page.appendLiteral("<div class=\"article-item\" data-id=\"");
+        page.appendNumber(i);
+        page.appendLiteral("\"><a href=\"/news/article?id=");
+        page.appendNumber(i);
+        page.appendLiteral("\" class=\"title\">");
+        page.append(String::fromUTF8(text).left(12 + i % 9));
+        page.appendLiteral("</a>\n<p class=\"summary\">");
+        page.append(String::fromUTF8(text));
+        page.appendLiteral("</p></div>\n");
+    }
+    page.appendLiteral("</body></html>\n");
+
+    CString utf8 = page.toString().utf8();
+    Vector<uint8_t> bytes;
+    bytes.append(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+    return bytes;
+}
+
+bool readFile(const char* path, Vector<uint8_t>& bytes)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    uint8_t buffer[64 * 1024];
+    while (size_t length = fread(buffer, 1, sizeof(buffer), file))
+        bytes.append(buffer, length);
+    fclose(file);
+    return true;
+}
+
+// The per-character loop of TextCodecUTF8::decode(), without the vector decoders or the 8-bit path.
+int sequenceLength(uint8_t firstByte)
+{
+    if (firstByte < 0x80)
+        return 1;
+    if (firstByte < 0xC2)
+        return 0;
+    if (firstByte < 0xE0)
+        return 2;
+    if (firstByte < 0xF0)
+        return 3;
+    if (firstByte < 0xF5)
+        return 4;
+    return 0;
+}
+
+UChar32 decodeSequence(const uint8_t* sequence, int length)
+{
+    uint8_t secondByteMinimum = 0x80;
+    uint8_t secondByteMaximum = 0xBF;
+    if (sequence[0] == 0xE0)
+        secondByteMinimum = 0xA0;
+    else if (sequence[0] == 0xED)
+        secondByteMaximum = 0x9F;
+    else if (sequence[0] == 0xF0)
+        secondByteMinimum = 0x90;
+    else if (sequence[0] == 0xF4)
+        secondByteMaximum = 0x8F;
+    if (sequence[1] < secondByteMinimum || sequence[1] > secondByteMaximum)
+        return -1;
+
+    UChar32 character = sequence[0] & (0xFF >> (length + 1));
+    for (int i = 1; i < length; ++i) {
+        if (i > 1 && (sequence[i] & 0xC0) != 0x80)
+            return -1;
+        character = (character << 6) | (sequence[i] & 0x3F);
+    }
+    return character;
+}
+
+String scalarDecode(const Vector<uint8_t>& bytes)
+{
+    Vector<UChar> characters;
+    characters.reserveInitialCapacity(bytes.size());
+    const uint8_t* source = bytes.data();
+    const uint8_t* end = source + bytes.size();
+    while (source < end) {
+        int length = sequenceLength(*source);
+        UChar32 character = length && length <= end - source ? (length == 1 ? *source : decodeSequence(source, length)) : -1;
+        if (character < 0) {
+            characters.uncheckedAppend(replacementCharacter);
+            ++source;
+            continue;
+        }
+        source += length;
+        if (U_IS_BMP(character))
+            characters.uncheckedAppend(character);
+        else {
+            characters.uncheckedAppend(U16_LEAD(character));
+            characters.uncheckedAppend(U16_TRAIL(character));
+        }
+    }
+    return String::adopt(characters);
+}
+
+String codecDecode(const Vector<uint8_t>& bytes, size_t chunkSize)
+{
+    TextCodecUTF8 codec;
+    TextCodec& textCodec = codec;
+    bool sawError = false;
+    if (chunkSize >= bytes.size())
+        return textCodec.decode(reinterpret_cast<const char*>(bytes.data()), bytes.size(), true, false, sawError);
+
+    StringBuilder builder;
+    for (size_t offset = 0; offset < bytes.size(); offset += chunkSize) {
+        size_t length = std::min(chunkSize, bytes.size() - offset);
+        builder.append(textCodec.decode(reinterpret_cast<const char*>(bytes.data() + offset), length, offset + length == bytes.size(), false, sawError));
+    }
+    return builder.toString();
+}
+
+void checkCorpus(const Vector<uint8_t>& bytes)
+{
+    const size_t chunkSizes[] = { 1, 7, 4096, bytes.size() };
+    String expected = scalarDecode(bytes);
+    for (size_t chunkSize : chunkSizes)
+        RELEASE_ASSERT(codecDecode(bytes, chunkSize) == expected);
+
+    // Errors in the middle of blocks, at their edges, and in sequences split between chunks.
+    for (unsigned i = 0; i < 20 && !bytes.isEmpty(); ++i) {
+        Vector<uint8_t> corrupted = bytes;
+        for (unsigned j = 0; j < 10; ++j)
+            corrupted[randomNumber() * corrupted.size()] = randomNumber() * 256;
+        expected = scalarDecode(corrupted);
+        RELEASE_ASSERT(codecDecode(corrupted, corrupted.size()) == expected);
+        RELEASE_ASSERT(codecDecode(corrupted, 4096) == expected);
+    }
+}
+
+void benchmarkCorpus(const char* name, const Vector<uint8_t>& bytes, const char* simdName)
+{
+    checkCorpus(bytes);
+
+    const unsigned iterations = std::max<size_t>(5, (64 * 1024 * 1024) / std::max<size_t>(bytes.size(), 1));
+    double start = monotonicallyIncreasingTimeMS();
+    for (unsigned i = 0; i < iterations; ++i)
+        scalarDecode(bytes);
+    double scalarTime = (monotonicallyIncreasingTimeMS() - start) / iterations;
+
+    start = monotonicallyIncreasingTimeMS();
+    for (unsigned i = 0; i < iterations; ++i)
+        codecDecode(bytes, bytes.size());
+    double codecTime = (monotonicallyIncreasingTimeMS() - start) / iterations;
+
+    start = monotonicallyIncreasingTimeMS();
+    for (unsigned i = 0; i < iterations; ++i)
+        codecDecode(bytes, 4096);
+    double chunkedTime = (monotonicallyIncreasingTimeMS() - start) / iterations;
+
+    double megabytes = bytes.size() / (1024.0 * 1024.0);
+    dataLogF("%-24s %8zu bytes: scalar %7.1f MB/s, %s %7.1f MB/s (%.2fx), 4 KB chunks %7.1f MB/s\n", name, bytes.size(),
+        megabytes / scalarTime * 1000, simdName, megabytes / codecTime * 1000, scalarTime / codecTime, megabytes / chunkedTime * 1000);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    WTF::initializeThreading();
+
+#if HAVE(ARM_NEON_INTRINSICS)
+    const char* simdName = "NEON";
+#elif HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+    const char* simdName = cpuSupportsAVX2() ? "AVX2" : cpuSupportsSSE41() ? "SSE4.1" : "none";
+#else
+    const char* simdName = "none";
+#endif
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            Vector<uint8_t> bytes;
+            if (!readFile(argv[i], bytes)) {
+                dataLogF("Could not read %s\n", argv[i]);
+                return 1;
+            }
+            benchmarkCorpus(argv[i], bytes, simdName);
+        }
+        return 0;
+    }
+
+    for (const auto& corpus : builtInCorpora)
+        benchmarkCorpus(corpus.name, makePage(corpus.text), simdName);
+    return 0;
+}
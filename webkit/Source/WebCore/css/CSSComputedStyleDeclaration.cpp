@@ -145,6 +145,7 @@ static const CSSPropertyID computedProperties[] = {
     CSSPropertyClear,
     CSSPropertyClip,
     CSSPropertyColor,
+    CSSPropertyContain,
     CSSPropertyContent,
     CSSPropertyCursor,
     CSSPropertyDirection,
@@ -1711,6 +1712,29 @@ static Ref<CSSValue> renderTextDecorationFlagsToCSSValue(int textDecoration)
     return list.releaseNonNull();
 }
 
+static Ref<CSSValue> containmentToCSSValue(Containment containment)
+{
+    auto& cssValuePool = CSSValuePool::singleton();
+    if (containment == ContainmentStrict)
+        return cssValuePool.createIdentifierValue(CSSValueStrict);
+    if (containment == ContainmentContent)
+        return cssValuePool.createIdentifierValue(CSSValueContent);
+
+    auto list = CSSValueList::createSpaceSeparated();
+    if (containment & ContainmentSize)
+        list->append(cssValuePool.createIdentifierValue(CSSValueSize));
+    if (containment & ContainmentLayout)
+        list->append(cssValuePool.createIdentifierValue(CSSValueLayout));
+    if (containment & ContainmentStyle)
+        list->append(cssValuePool.createIdentifierValue(CSSValueStyle));
+    if (containment & ContainmentPaint)
+        list->append(cssValuePool.createIdentifierValue(CSSValuePaint));
+
+    if (!list->length())
+        return cssValuePool.createIdentifierValue(CSSValueNone);
+    return WTFMove(list);
+}
+
 static Ref<CSSValue> renderTextDecorationStyleFlagsToCSSValue(TextDecorationStyle textDecorationStyle)
 {
     switch (textDecorationStyle) {
@@ -3277,6 +3301,8 @@ RefPtr<CSSValue> ComputedStyleExtractor::propertyValue(CSSPropertyID propertyID,
             return cssValuePool.createValue(style->nbspMode());
         case CSSPropertyResize:
             return cssValuePool.createValue(style->resize());
+        case CSSPropertyContain:
+            return containmentToCSSValue(style->contain());
         case CSSPropertyWebkitFontKerning:
             return cssValuePool.createValue(style->fontDescription().kerning());
         case CSSPropertyWebkitFontSmoothing:
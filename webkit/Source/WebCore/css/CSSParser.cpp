@@ -2879,6 +2879,13 @@ bool CSSParser::parseValue(CSSPropertyID propId, bool important)
             return parseWillChange(important);
         break;
 
+    case CSSPropertyContain: // none | strict | content | [ size || layout || style || paint ]
+        if (id == CSSValueNone || id == CSSValueStrict || id == CSSValueContent)
+            validPrimitive = true;
+        else
+            return parseContain(important);
+        break;
+
     // Apple specific properties.  These will never be standardized and are purely to
     // support custom WebKit-based Apple applications.
     case CSSPropertyWebkitLineClamp:
@@ -11285,6 +11292,41 @@ bool CSSParser::parseWillChange(bool important)
     return true;
 }
 
+bool CSSParser::parseContain(bool important)
+{
+    auto list = CSSValueList::createSpaceSeparated();
+    Containment seen = ContainmentNone;
+    for (CSSParserValue* value = m_valueList->current(); value; value = m_valueList->next()) {
+        Containment containment;
+        switch (value->id) {
+        case CSSValueSize:
+            containment = ContainmentSize;
+            break;
+        case CSSValueLayout:
+            containment = ContainmentLayout;
+            break;
+        case CSSValueStyle:
+            containment = ContainmentStyle;
+            break;
+        case CSSValuePaint:
+            containment = ContainmentPaint;
+            break;
+        default:
+            return false;
+        }
+        if (seen & containment)
+            return false;
+        seen |= containment;
+        list->append(CSSValuePool::singleton().createIdentifierValue(value->id));
+    }
+
+    if (!list->length())
+        return false;
+
+    addProperty(CSSPropertyContain, WTFMove(list), important);
+    return true;
+}
+
 RefPtr<CSSCalcValue> CSSParser::parseCalculation(CSSParserValue& value, CalculationPermittedValueRange range)
 {
     ASSERT(isCalculation(value));
@@ -381,6 +381,7 @@ public:
     bool parseFontVariant(bool important);
 
     bool parseWillChange(bool important);
+    bool parseContain(bool important);
 
     // Faster than doing a new/delete each time since it keeps one vector.
     std::unique_ptr<Vector<std::unique_ptr<CSSParserSelector>>> createSelectorVector();
@@ -32,11 +32,63 @@
 #include "CSSStyleSheet.h"
 #include "ExtensionStyleSheets.h"
 #include "MediaQueryEvaluator.h"
+#include "SecurityOrigin.h"
 #include "StyleResolver.h"
 #include "StyleSheetContents.h"
+#include <wtf/Hasher.h>
+#include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 
+static HashMap<unsigned, Vector<SharedAuthorRuleSet*>>& sharedAuthorRuleSets()
+{
+    static NeverDestroyed<HashMap<unsigned, Vector<SharedAuthorRuleSet*>>> ruleSets;
+    return ruleSets;
+}
+
+Ref<SharedAuthorRuleSet> SharedAuthorRuleSet::create(SheetList&& sheets, std::unique_ptr<RuleSet> ruleSet)
+{
+    return adoptRef(*new SharedAuthorRuleSet(WTFMove(sheets), WTFMove(ruleSet)));
+}
+
+SharedAuthorRuleSet::SharedAuthorRuleSet(SheetList&& sheets, std::unique_ptr<RuleSet> ruleSet)
+    : m_sheets(WTFMove(sheets))
+    , m_ruleSet(WTFMove(ruleSet))
+{
+    sharedAuthorRuleSets().add(hash(m_sheets), Vector<SharedAuthorRuleSet*>()).iterator->value.append(this);
+}
+
+SharedAuthorRuleSet::~SharedAuthorRuleSet()
+{
+    auto it = sharedAuthorRuleSets().find(hash(m_sheets));
+    ASSERT(it != sharedAuthorRuleSets().end());
+    it->value.removeFirst(this);
+    if (it->value.isEmpty())
+        sharedAuthorRuleSets().remove(it);
+}
+
+unsigned SharedAuthorRuleSet::hash(const SheetList& sheets)
+{
+    IntegerHasher hasher;
+    for (auto& sheet : sheets) {
+        hasher.add(PtrHash<StyleSheetContents*>::hash(sheet.first.get()));
+        hasher.add(sheet.second);
+    }
+    return hasher.hash();
+}
+
+SharedAuthorRuleSet* SharedAuthorRuleSet::find(const SheetList& sheets)
+{
+    auto it = sharedAuthorRuleSets().find(hash(sheets));
+    if (it == sharedAuthorRuleSets().end())
+        return nullptr;
+    for (auto* ruleSet : it->value) {
+        if (ruleSet->sheets() == sheets)
+            return ruleSet;
+    }
+    return nullptr;
+}
+
 DocumentRuleSets::DocumentRuleSets()
 {
 }
@@ -80,23 +132,91 @@ void DocumentRuleSets::resetAuthorStyle()
 {
     m_authorStyle = std::make_unique<RuleSet>();
     m_authorStyle->disableAutoShrinkToFit();
+    m_sharedAuthorStyle = nullptr;
+    m_hasAuthorStyleSheets = false;
 }
 
 void DocumentRuleSets::appendAuthorStyleSheets(const Vector<RefPtr<CSSStyleSheet>>& styleSheets, MediaQueryEvaluator* medium, InspectorCSSOMWrappers& inspectorCSSOMWrappers, StyleResolver* resolver)
 {
     // This handles sheets added to the end of the stylesheet list only. In other cases the style resolver
     // needs to be reconstructed. To handle insertions too the rule order numbers would need to be updated.
+    Vector<CSSStyleSheet*> matchingSheets;
     for (auto& cssSheet : styleSheets) {
         ASSERT(!cssSheet->disabled());
         if (cssSheet->mediaQueries() && !medium->evaluate(*cssSheet->mediaQueries(), resolver))
             continue;
-        m_authorStyle->addRulesFromSheet(cssSheet->contents(), *medium, resolver);
+        matchingSheets.append(cssSheet.get());
         inspectorCSSOMWrappers.collectFromStyleSheetIfNeeded(cssSheet.get());
     }
-    m_authorStyle->shrinkToFit();
+
+    if (m_sharedAuthorStyle && !matchingSheets.isEmpty())
+        unshareAuthorStyle(*medium, *resolver);
+
+    // Only a complete set of sheets can be shared, later additions go to a RuleSet of our own.
+    if (m_hasAuthorStyleSheets || !resolver || !appendSharedAuthorStyleSheets(matchingSheets, *medium, *resolver)) {
+        for (auto* cssSheet : matchingSheets)
+            m_authorStyle->addRulesFromSheet(cssSheet->contents(), *medium, resolver);
+        m_authorStyle->shrinkToFit();
+    }
+    if (!matchingSheets.isEmpty())
+        m_hasAuthorStyleSheets = true;
+
     collectFeatures();
 }
 
+bool DocumentRuleSets::appendSharedAuthorStyleSheets(const Vector<CSSStyleSheet*>& styleSheets, const MediaQueryEvaluator& medium, StyleResolver& resolver)
+{
+    if (styleSheets.isEmpty())
+        return false;
+
+    SharedAuthorRuleSet::SheetList sheets;
+    sheets.reserveInitialCapacity(styleSheets.size());
+    for (auto* cssSheet : styleSheets) {
+        auto& contents = cssSheet->contents();
+        // Cacheable contents are copied before they are mutated, so the rules indexed from them stay valid.
+        if (!contents.isCacheable())
+            return false;
+        // The key records the origin of the top-level sheets only, imported sheets may have a different one.
+        if (!contents.importRules().isEmpty())
+            return false;
+        bool hasDocumentSecurityOrigin = resolver.document().securityOrigin()->canRequest(contents.baseURL());
+        sheets.uncheckedAppend(std::make_pair(&contents, hasDocumentSecurityOrigin));
+    }
+
+    if (auto* sharedAuthorStyle = SharedAuthorRuleSet::find(sheets)) {
+        // The resolver still needs the fonts, keyframes and media query dependencies of the sheets.
+        RuleSet resolverState;
+        for (auto& sheet : sheets)
+            resolverState.addRulesFromSheet(*sheet.first, medium, &resolver, RuleSet::AddRulesMode::ResolverStateOnly);
+        if (resolverState.mediaQueryResults() == sharedAuthorStyle->ruleSet().mediaQueryResults()) {
+            m_sharedAuthorStyle = sharedAuthorStyle;
+            return true;
+        }
+        // Some @media rule evaluates differently in this document, index the rules ourselves.
+        for (auto& sheet : sheets)
+            m_authorStyle->addRulesFromSheet(*sheet.first, medium, &resolver, RuleSet::AddRulesMode::RulesOnly);
+        m_authorStyle->shrinkToFit();
+        return true;
+    }
+
+    auto ruleSet = std::make_unique<RuleSet>();
+    for (auto& sheet : sheets)
+        ruleSet->addRulesFromSheet(*sheet.first, medium, &resolver);
+    ruleSet->shrinkToFit();
+    m_sharedAuthorStyle = SharedAuthorRuleSet::create(WTFMove(sheets), WTFMove(ruleSet));
+    return true;
+}
+
+void DocumentRuleSets::unshareAuthorStyle(const MediaQueryEvaluator& medium, StyleResolver& resolver)
+{
+    ASSERT(m_sharedAuthorStyle);
+    ASSERT(!m_authorStyle->ruleCount());
+
+    for (auto& sheet : m_sharedAuthorStyle->sheets())
+        m_authorStyle->addRulesFromSheet(*sheet.first, medium, &resolver, RuleSet::AddRulesMode::RulesOnly);
+    m_sharedAuthorStyle = nullptr;
+}
+
 void DocumentRuleSets::collectFeatures() const
 {
     m_features.clear();
@@ -107,8 +227,8 @@ void DocumentRuleSets::collectFeatures() const
         m_features.add(CSSDefaultStyleSheets::defaultStyle->features());
     m_defaultStyleVersionOnFeatureCollection = CSSDefaultStyleSheets::defaultStyleVersion;
 
-    if (m_authorStyle)
-        m_features.add(m_authorStyle->features());
+    if (auto* authorStyle = this->authorStyle())
+        m_features.add(authorStyle->features());
     if (m_userStyle)
         m_features.add(m_userStyle->features());
 
@@ -28,6 +28,7 @@
 #include "RuleSet.h"
 #include <memory>
 #include <wtf/HashMap.h>
+#include <wtf/RefCounted.h>
 #include <wtf/RefPtr.h>
 #include <wtf/Vector.h>
 
@@ -39,12 +40,37 @@ class ExtensionStyleSheets;
 class InspectorCSSOMWrappers;
 class MediaQueryEvaluator;
 class RuleSet;
+class StyleSheetContents;
+
+// An author RuleSet built only from sheets that can be shared through the memory cache. Documents and shadow trees
+// with the same active sheets use the same instance instead of each indexing their own copy. It is never mutated.
+class SharedAuthorRuleSet : public RefCounted<SharedAuthorRuleSet> {
+public:
+    // The contents of each sheet and whether it has the document security origin.
+    typedef Vector<std::pair<RefPtr<StyleSheetContents>, bool>> SheetList;
+
+    static Ref<SharedAuthorRuleSet> create(SheetList&&, std::unique_ptr<RuleSet>);
+    static SharedAuthorRuleSet* find(const SheetList&);
+    ~SharedAuthorRuleSet();
+
+    const SheetList& sheets() const { return m_sheets; }
+    RuleSet& ruleSet() const { return *m_ruleSet; }
+
+private:
+    SharedAuthorRuleSet(SheetList&&, std::unique_ptr<RuleSet>);
+
+    static unsigned hash(const SheetList&);
+
+    SheetList m_sheets;
+    std::unique_ptr<RuleSet> m_ruleSet;
+};
 
 class DocumentRuleSets {
 public:
     DocumentRuleSets();
     ~DocumentRuleSets();
-    RuleSet* authorStyle() const { return m_authorStyle.get(); }
+    RuleSet* authorStyle() const { return m_sharedAuthorStyle ? &m_sharedAuthorStyle->ruleSet() : m_authorStyle.get(); }
+    bool hasSharedAuthorStyle() const { return m_sharedAuthorStyle; }
     RuleSet* userStyle() const { return m_userStyle.get(); }
     const RuleFeatureSet& features() const;
     RuleSet* sibling() const { return m_siblingRuleSet.get(); }
@@ -59,6 +85,13 @@ public:
     };
     const AttributeRules* ancestorAttributeRulesForHTML(AtomicStringImpl*) const;
 
+    struct StyleSharingStatistics {
+        unsigned documentCacheHits { 0 };
+        unsigned documentCacheMisses { 0 };
+    };
+    const StyleSharingStatistics& styleSharingStatistics() const { return m_styleSharingStatistics; }
+    StyleSharingStatistics& styleSharingStatistics() { return m_styleSharingStatistics; }
+
     void initUserStyle(ExtensionStyleSheets&, const MediaQueryEvaluator&, StyleResolver&);
     void resetAuthorStyle();
     void appendAuthorStyleSheets(const Vector<RefPtr<CSSStyleSheet>>&, MediaQueryEvaluator*, InspectorCSSOMWrappers&, StyleResolver*);
@@ -68,8 +101,12 @@ public:
 private:
     void collectFeatures() const;
     void collectRulesFromUserStyleSheets(const Vector<RefPtr<CSSStyleSheet>>&, RuleSet& userStyle, const MediaQueryEvaluator&, StyleResolver&);
+    bool appendSharedAuthorStyleSheets(const Vector<CSSStyleSheet*>&, const MediaQueryEvaluator&, StyleResolver&);
+    void unshareAuthorStyle(const MediaQueryEvaluator&, StyleResolver&);
 
     std::unique_ptr<RuleSet> m_authorStyle;
+    RefPtr<SharedAuthorRuleSet> m_sharedAuthorStyle;
+    bool m_hasAuthorStyleSheets { false };
     std::unique_ptr<RuleSet> m_userStyle;
 
     mutable RuleFeatureSet m_features;
@@ -78,6 +115,7 @@ private:
     mutable std::unique_ptr<RuleSet> m_uncommonAttributeRuleSet;
     mutable HashMap<AtomicStringImpl*, std::unique_ptr<RuleSet>> m_ancestorClassRuleSets;
     mutable HashMap<AtomicStringImpl*, std::unique_ptr<AttributeRules>> m_ancestorAttributeRuleSetsForHTML;
+    StyleSharingStatistics m_styleSharingStatistics;
 };
 
 inline const RuleFeatureSet& DocumentRuleSets::features() const
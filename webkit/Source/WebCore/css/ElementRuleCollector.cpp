@@ -459,14 +459,9 @@ inline bool ElementRuleCollector::ruleMatches(const RuleData& ruleData, unsigned
     return selectorMatches;
 }
 
-void ElementRuleCollector::collectMatchingRulesForList(const RuleSet::RuleDataVector* rules, const MatchRequest& matchRequest, StyleResolver::RuleRange& ruleRange)
+void ElementRuleCollector::collectMatchingRulesForList(RuleSet::RuleDataList rules, const MatchRequest& matchRequest, StyleResolver::RuleRange& ruleRange)
 {
-    if (!rules)
-        return;
-
-    for (unsigned i = 0, size = rules->size(); i < size; ++i) {
-        const RuleData& ruleData = rules->data()[i];
-
+    for (auto& ruleData : rules) {
         if (!ruleData.canMatchPseudoElement() && m_pseudoStyleRequest.pseudoId != NOPSEUDO)
             continue;
 
@@ -177,21 +177,84 @@ RuleSet::~RuleSet()
 {
 }
 
-void RuleSet::addToRuleSet(AtomicStringImpl* key, AtomRuleMap& map, const RuleData& ruleData)
+void RuleSet::AtomRuleMap::add(AtomicStringImpl* key, const RuleData& ruleData)
 {
-    if (!key)
-        return;
-    auto& rules = map.add(key, nullptr).iterator->value;
+    auto& rules = m_growingRules.add(key, nullptr).iterator->value;
     if (!rules)
         rules = std::make_unique<RuleDataVector>();
     rules->append(ruleData);
 }
 
+unsigned RuleSet::AtomRuleMap::count(AtomicStringImpl* key) const
+{
+    unsigned count = 0;
+    auto range = m_ranges.find(key);
+    if (range != m_ranges.end())
+        count += range->value.size;
+    if (auto* rules = m_growingRules.get(key))
+        count += rules->size();
+    return count;
+}
+
+RuleSet::RuleDataList RuleSet::AtomRuleMap::get(AtomicStringImpl* key) const
+{
+    compactIfNeeded();
+
+    auto it = m_ranges.find(key);
+    if (it == m_ranges.end())
+        return { };
+    return { m_rules.data() + it->value.start, it->value.size };
+}
+
+void RuleSet::AtomRuleMap::compact() const
+{
+    ASSERT(!m_growingRules.isEmpty());
+
+    unsigned ruleCount = m_rules.size();
+    for (auto& rules : m_growingRules.values())
+        ruleCount += rules->size();
+
+    // Keys are laid out in table order. Each lookup reads one range and then a run of adjacent RuleData.
+    // Rules added since the last compaction go after the compacted ones for the same key, which keeps
+    // every range in source order.
+    Vector<RuleData> compactedRules;
+    HashMap<AtomicStringImpl*, Range> compactedRanges;
+    compactedRules.reserveInitialCapacity(ruleCount);
+    compactedRanges.reserveInitialCapacity(m_ranges.size() + m_growingRules.size());
+    auto appendRules = [&] (AtomicStringImpl* key, const Range* range, RuleDataVector* growingRules) {
+        unsigned start = compactedRules.size();
+        if (range) {
+            for (unsigned i = 0; i < range->size; ++i)
+                compactedRules.uncheckedAppend(WTFMove(m_rules[range->start + i]));
+        }
+        if (growingRules) {
+            for (auto& ruleData : *growingRules)
+                compactedRules.uncheckedAppend(WTFMove(ruleData));
+        }
+        compactedRanges.add(key, Range { start, static_cast<unsigned>(compactedRules.size()) - start });
+    };
+    for (auto& keyValuePair : m_ranges) {
+        auto growingRules = m_growingRules.take(keyValuePair.key);
+        appendRules(keyValuePair.key, &keyValuePair.value, growingRules.get());
+    }
+    for (auto& keyValuePair : m_growingRules)
+        appendRules(keyValuePair.key, nullptr, keyValuePair.value.get());
+
+    m_rules = WTFMove(compactedRules);
+    m_ranges = WTFMove(compactedRanges);
+    m_growingRules.clear();
+}
+
+void RuleSet::addToRuleSet(AtomicStringImpl* key, AtomRuleMap& map, const RuleData& ruleData)
+{
+    if (!key)
+        return;
+    map.add(key, ruleData);
+}
+
 static unsigned rulesCountForName(const RuleSet::AtomRuleMap& map, AtomicStringImpl* name)
 {
-    if (const auto* rules = map.get(name))
-        return rules->size();
-    return 0;
+    return map.count(name);
 }
 
 void RuleSet::addRule(StyleRule* rule, unsigned selectorIndex, AddRuleFlags addRuleFlags)
@@ -326,43 +389,57 @@ void RuleSet::addRegionRule(StyleRuleRegion* regionRule, bool hasDocumentSecurit
     m_regionSelectorsAndRuleSets.append(RuleSetSelectorPair(regionRule->selectorList().first(), WTFMove(regionRuleSet)));
 }
 
-void RuleSet::addChildRules(const Vector<RefPtr<StyleRuleBase>>& rules, const MediaQueryEvaluator& medium, StyleResolver* resolver, bool hasDocumentSecurityOrigin, bool isInitiatingElementInUserAgentShadowTree, AddRuleFlags addRuleFlags)
+bool RuleSet::evaluateMediaQueries(const MediaQuerySet& mediaQueries, const MediaQueryEvaluator& medium, StyleResolver* resolver, AddRulesMode mode)
 {
+    // In RulesOnly mode the resolver has already recorded its viewport and accessibility dependent results.
+    bool result = medium.evaluate(mediaQueries, mode == AddRulesMode::RulesOnly ? nullptr : resolver);
+    m_mediaQueryResults.append(result);
+    return result;
+}
+
+void RuleSet::addChildRules(const Vector<RefPtr<StyleRuleBase>>& rules, const MediaQueryEvaluator& medium, StyleResolver* resolver, bool hasDocumentSecurityOrigin, bool isInitiatingElementInUserAgentShadowTree, AddRuleFlags addRuleFlags, AddRulesMode mode)
+{
+    bool addsRules = mode != AddRulesMode::ResolverStateOnly;
+    bool updatesResolver = resolver && mode != AddRulesMode::RulesOnly;
+
     for (auto& rule : rules) {
-        if (is<StyleRule>(*rule))
-            addStyleRule(downcast<StyleRule>(rule.get()), addRuleFlags);
-        else if (is<StyleRulePage>(*rule))
-            addPageRule(downcast<StyleRulePage>(rule.get()));
-        else if (is<StyleRuleMedia>(*rule)) {
+        if (is<StyleRule>(*rule)) {
+            if (addsRules)
+                addStyleRule(downcast<StyleRule>(rule.get()), addRuleFlags);
+        } else if (is<StyleRulePage>(*rule)) {
+            if (addsRules)
+                addPageRule(downcast<StyleRulePage>(rule.get()));
+        } else if (is<StyleRuleMedia>(*rule)) {
             auto& mediaRule = downcast<StyleRuleMedia>(*rule);
-            if ((!mediaRule.mediaQueries() || medium.evaluate(*mediaRule.mediaQueries(), resolver)))
-                addChildRules(mediaRule.childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags);
-        } else if (is<StyleRuleFontFace>(*rule) && resolver) {
+            if ((!mediaRule.mediaQueries() || evaluateMediaQueries(*mediaRule.mediaQueries(), medium, resolver, mode)))
+                addChildRules(mediaRule.childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags, mode);
+        } else if (is<StyleRuleFontFace>(*rule) && updatesResolver) {
             // Add this font face to our set.
             resolver->document().fontSelector().addFontFaceRule(downcast<StyleRuleFontFace>(*rule.get()), isInitiatingElementInUserAgentShadowTree);
             resolver->invalidateMatchedPropertiesCache();
-        } else if (is<StyleRuleKeyframes>(*rule) && resolver)
+        } else if (is<StyleRuleKeyframes>(*rule) && updatesResolver)
             resolver->addKeyframeStyle(downcast<StyleRuleKeyframes>(*rule));
         else if (is<StyleRuleSupports>(*rule) && downcast<StyleRuleSupports>(*rule).conditionIsSupported())
-            addChildRules(downcast<StyleRuleSupports>(*rule).childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags);
+            addChildRules(downcast<StyleRuleSupports>(*rule).childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags, mode);
 #if ENABLE(CSS_REGIONS)
         else if (is<StyleRuleRegion>(*rule) && resolver) {
-            addRegionRule(downcast<StyleRuleRegion>(rule.get()), hasDocumentSecurityOrigin);
+            if (addsRules)
+                addRegionRule(downcast<StyleRuleRegion>(rule.get()), hasDocumentSecurityOrigin);
         }
 #endif
 #if ENABLE(CSS_DEVICE_ADAPTATION)
-        else if (is<StyleRuleViewport>(*rule) && resolver) {
+        else if (is<StyleRuleViewport>(*rule) && updatesResolver) {
             resolver->viewportStyleResolver()->addViewportRule(downcast<StyleRuleViewport>(rule.get()));
         }
 #endif
     }
 }
 
-void RuleSet::addRulesFromSheet(StyleSheetContents& sheet, const MediaQueryEvaluator& medium, StyleResolver* resolver)
+void RuleSet::addRulesFromSheet(StyleSheetContents& sheet, const MediaQueryEvaluator& medium, StyleResolver* resolver, AddRulesMode mode)
 {
     for (auto& rule : sheet.importRules()) {
-        if (rule->styleSheet() && (!rule->mediaQueries() || medium.evaluate(*rule->mediaQueries(), resolver)))
-            addRulesFromSheet(*rule->styleSheet(), medium, resolver);
+        if (rule->styleSheet() && (!rule->mediaQueries() || evaluateMediaQueries(*rule->mediaQueries(), medium, resolver, mode)))
+            addRulesFromSheet(*rule->styleSheet(), medium, resolver, mode);
     }
 
     bool hasDocumentSecurityOrigin = resolver && resolver->document().securityOrigin()->canRequest(sheet.baseURL());
@@ -371,7 +448,7 @@ void RuleSet::addRulesFromSheet(StyleSheetContents& sheet, const MediaQueryEvalu
     // FIXME: Skip Content Security Policy check when stylesheet is in a user agent shadow tree.
     // See <https://bugs.webkit.org/show_bug.cgi?id=146663>.
     bool isInitiatingElementInUserAgentShadowTree = false;
-    addChildRules(sheet.childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags);
+    addChildRules(sheet.childRules(), medium, resolver, hasDocumentSecurityOrigin, isInitiatingElementInUserAgentShadowTree, addRuleFlags, mode);
 
     if (m_autoShrinkToFitEnabled)
         shrinkToFit();
@@ -396,8 +473,10 @@ bool RuleSet::hasShadowPseudoElementRules() const
 
 void RuleSet::copyShadowPseudoElementRulesFrom(const RuleSet& other)
 {
-    for (auto& keyValuePair : other.m_shadowPseudoElementRules)
-        m_shadowPseudoElementRules.add(keyValuePair.key, std::make_unique<RuleDataVector>(*keyValuePair.value));
+    other.m_shadowPseudoElementRules.forEach([this] (AtomicStringImpl* key, RuleDataList rules) {
+        for (auto& ruleData : rules)
+            m_shadowPseudoElementRules.add(key, ruleData);
+    });
 
 #if ENABLE(VIDEO_TRACK)
     // FIXME: We probably shouldn't treat WebVTT as author stylable user agent shadow tree.
@@ -406,19 +485,10 @@ void RuleSet::copyShadowPseudoElementRulesFrom(const RuleSet& other)
 #endif
 }
 
-static inline void shrinkMapVectorsToFit(RuleSet::AtomRuleMap& map)
-{
-    for (auto& vector : map.values())
-        vector->shrinkToFit();
-}
-
 void RuleSet::shrinkToFit()
 {
-    shrinkMapVectorsToFit(m_idRules);
-    shrinkMapVectorsToFit(m_classRules);
-    shrinkMapVectorsToFit(m_tagLocalNameRules);
-    shrinkMapVectorsToFit(m_tagLowercaseLocalNameRules);
-    shrinkMapVectorsToFit(m_shadowPseudoElementRules);
+    // The AtomRuleMaps compact themselves on the first lookup after a batch of additions, so appending
+    // sheet after sheet does not rebuild them each time.
     m_linkPseudoClassRules.shrinkToFit();
 #if ENABLE(VIDEO_TRACK)
     m_cuePseudoRules.shrinkToFit();
@@ -430,6 +500,7 @@ void RuleSet::shrinkToFit()
     m_pageRules.shrinkToFit();
     m_features.shrinkToFit();
     m_regionSelectorsAndRuleSets.shrinkToFit();
+    m_mediaQueryResults.shrinkToFit();
 }
 
 } // namespace WebCore
@@ -50,6 +50,7 @@ enum PropertyWhitelistType {
 class CSSSelector;
 class ContainerNode;
 class MediaQueryEvaluator;
+class MediaQuerySet;
 class Node;
 class StyleResolver;
 class StyleRuleRegion;
@@ -160,9 +161,71 @@ public:
     ~RuleSet();
 
     typedef Vector<RuleData, 1> RuleDataVector;
-    typedef HashMap<AtomicStringImpl*, std::unique_ptr<RuleDataVector>> AtomRuleMap;
 
-    void addRulesFromSheet(StyleSheetContents&, const MediaQueryEvaluator&, StyleResolver* = 0);
+    // A view on rules that are stored contiguously, either in a RuleDataVector or in a compacted AtomRuleMap.
+    class RuleDataList {
+    public:
+        RuleDataList() { }
+        RuleDataList(const RuleDataVector* rules)
+            : m_data(rules ? rules->data() : nullptr)
+            , m_size(rules ? rules->size() : 0)
+        {
+        }
+        RuleDataList(const RuleData* data, unsigned size)
+            : m_data(data)
+            , m_size(size)
+        {
+        }
+
+        const RuleData* begin() const { return m_data; }
+        const RuleData* end() const { return m_data + m_size; }
+        unsigned size() const { return m_size; }
+        bool isEmpty() const { return !m_size; }
+
+    private:
+        const RuleData* m_data { nullptr };
+        unsigned m_size { 0 };
+    };
+
+    // Rules being added go into a vector per key. The first lookup after a batch of additions merges them
+    // into a single array with a per key range, which is the layout style resolution sees.
+    class AtomRuleMap {
+    public:
+        void add(AtomicStringImpl* key, const RuleData&);
+        unsigned count(AtomicStringImpl* key) const;
+        RuleDataList get(AtomicStringImpl* key) const;
+        bool isEmpty() const { return m_growingRules.isEmpty() && m_ranges.isEmpty(); }
+
+        template<typename Functor> void forEach(const Functor&) const;
+
+    private:
+        void compactIfNeeded() const
+        {
+            if (!m_growingRules.isEmpty())
+                compact();
+        }
+        void compact() const;
+
+        struct Range {
+            unsigned start;
+            unsigned size;
+        };
+
+        mutable HashMap<AtomicStringImpl*, std::unique_ptr<RuleDataVector>> m_growingRules;
+        mutable HashMap<AtomicStringImpl*, Range> m_ranges;
+        mutable Vector<RuleData> m_rules;
+    };
+
+    enum class AddRulesMode {
+        // Index the rules and let the resolver know about fonts, keyframes and the media queries it depends on.
+        RulesAndResolverState,
+        // Index the rules only, the resolver already knows about this sheet.
+        RulesOnly,
+        // Only update the resolver, for a sheet whose rules are in a shared RuleSet.
+        ResolverStateOnly
+    };
+
+    void addRulesFromSheet(StyleSheetContents&, const MediaQueryEvaluator&, StyleResolver* = 0, AddRulesMode = AddRulesMode::RulesAndResolverState);
 
     void addStyleRule(StyleRule*, AddRuleFlags);
     void addRule(StyleRule*, unsigned selectorIndex, AddRuleFlags);
@@ -174,10 +237,13 @@ public:
 
     const RuleFeatureSet& features() const { return m_features; }
 
-    const RuleDataVector* idRules(AtomicStringImpl& key) const { return m_idRules.get(&key); }
-    const RuleDataVector* classRules(AtomicStringImpl* key) const { return m_classRules.get(key); }
-    const RuleDataVector* tagRules(AtomicStringImpl* key, bool isHTMLName) const;
-    const RuleDataVector* shadowPseudoElementRules(AtomicStringImpl* key) const { return m_shadowPseudoElementRules.get(key); }
+    // Results of the @media and @import media queries evaluated while adding sheets, in document order.
+    const Vector<bool>& mediaQueryResults() const { return m_mediaQueryResults; }
+
+    RuleDataList idRules(AtomicStringImpl& key) const { return m_idRules.get(&key); }
+    RuleDataList classRules(AtomicStringImpl* key) const { return m_classRules.get(key); }
+    RuleDataList tagRules(AtomicStringImpl* key, bool isHTMLName) const;
+    RuleDataList shadowPseudoElementRules(AtomicStringImpl* key) const { return m_shadowPseudoElementRules.get(key); }
     const RuleDataVector* linkPseudoClassRules() const { return &m_linkPseudoClassRules; }
 #if ENABLE(VIDEO_TRACK)
     const RuleDataVector* cuePseudoRules() const { return &m_cuePseudoRules; }
@@ -196,7 +262,8 @@ public:
     void copyShadowPseudoElementRulesFrom(const RuleSet&);
 
 private:
-    void addChildRules(const Vector<RefPtr<StyleRuleBase>>&, const MediaQueryEvaluator& medium, StyleResolver*, bool hasDocumentSecurityOrigin, bool isInitiatingElementInUserAgentShadowTree, AddRuleFlags);
+    void addChildRules(const Vector<RefPtr<StyleRuleBase>>&, const MediaQueryEvaluator& medium, StyleResolver*, bool hasDocumentSecurityOrigin, bool isInitiatingElementInUserAgentShadowTree, AddRuleFlags, AddRulesMode);
+    bool evaluateMediaQueries(const MediaQuerySet&, const MediaQueryEvaluator&, StyleResolver*, AddRulesMode);
 
     AtomRuleMap m_idRules;
     AtomRuleMap m_classRules;
@@ -216,9 +283,18 @@ private:
     bool m_autoShrinkToFitEnabled { false };
     RuleFeatureSet m_features;
     Vector<RuleSetSelectorPair> m_regionSelectorsAndRuleSets;
+    Vector<bool> m_mediaQueryResults;
 };
 
-inline const RuleSet::RuleDataVector* RuleSet::tagRules(AtomicStringImpl* key, bool isHTMLName) const
+template<typename Functor>
+inline void RuleSet::AtomRuleMap::forEach(const Functor& functor) const
+{
+    compactIfNeeded();
+    for (auto& keyValuePair : m_ranges)
+        functor(keyValuePair.key, RuleDataList(m_rules.data() + keyValuePair.value.start, keyValuePair.value.size));
+}
+
+inline RuleSet::RuleDataList RuleSet::tagRules(AtomicStringImpl* key, bool isHTMLName) const
 {
     const AtomRuleMap* tagRules;
     if (isHTMLName)
@@ -82,6 +82,7 @@ public:
     static ETextAlign convertTextAlign(StyleResolver&, CSSValue&);
     static RefPtr<ClipPathOperation> convertClipPath(StyleResolver&, CSSValue&);
     static EResize convertResize(StyleResolver&, CSSValue&);
+    static Containment convertContain(StyleResolver&, CSSValue&);
     static int convertMarqueeRepetition(StyleResolver&, CSSValue&);
     static int convertMarqueeSpeed(StyleResolver&, CSSValue&);
     static PassRefPtr<QuotesData> convertQuotes(StyleResolver&, CSSValue&);
@@ -542,6 +543,42 @@ inline EResize StyleBuilderConverter::convertResize(StyleResolver& styleResolver
     return resize;
 }
 
+inline Containment StyleBuilderConverter::convertContain(StyleResolver&, CSSValue& value)
+{
+    if (is<CSSPrimitiveValue>(value)) {
+        switch (downcast<CSSPrimitiveValue>(value).getValueID()) {
+        case CSSValueStrict:
+            return ContainmentStrict;
+        case CSSValueContent:
+            return ContainmentContent;
+        default:
+            return ContainmentNone;
+        }
+    }
+
+    Containment containment = ContainmentNone;
+    for (auto& currentValue : downcast<CSSValueList>(value)) {
+        switch (downcast<CSSPrimitiveValue>(currentValue.get()).getValueID()) {
+        case CSSValueSize:
+            containment |= ContainmentSize;
+            break;
+        case CSSValueLayout:
+            containment |= ContainmentLayout;
+            break;
+        case CSSValueStyle:
+            containment |= ContainmentStyle;
+            break;
+        case CSSValuePaint:
+            containment |= ContainmentPaint;
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+            break;
+        }
+    }
+    return containment;
+}
+
 inline int StyleBuilderConverter::convertMarqueeRepetition(StyleResolver&, CSSValue& value)
 {
     auto& primitiveValue = downcast<CSSPrimitiveValue>(value);
@@ -939,6 +939,8 @@ void StyleResolver::adjustRenderStyle(RenderStyle& style, const RenderStyle& par
 #endif
             || style.hasBlendMode()
             || style.hasIsolation()
+            || style.containsLayout()
+            || style.containsPaint()
             || style.position() == StickyPosition
             || (style.position() == FixedPosition && documentSettings() && documentSettings()->fixedPositionCreatesStackingContext())
             || style.hasFlowFrom()
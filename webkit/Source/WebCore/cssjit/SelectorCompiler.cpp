@@ -34,6 +34,7 @@
 #include "Element.h"
 #include "ElementData.h"
 #include "ElementRareData.h"
+#include "ElementTraversal.h"
 #include "FunctionCall.h"
 #include "HTMLDocument.h"
 #include "HTMLNames.h"
@@ -206,6 +207,7 @@ struct SelectorFragment {
     Vector<NthChildOfSelectorInfo> nthChildOfFilters;
     Vector<std::pair<int, int>, 2> nthLastChildFilters;
     Vector<NthChildOfSelectorInfo> nthLastChildOfFilters;
+    Vector<const CSSSelector*, 2> ofTypeFilters;
     SelectorList notFilters;
     Vector<SelectorList> matchesFilters;
     Vector<Vector<SelectorFragment>> anyFilters;
@@ -294,7 +296,10 @@ private:
     void generateContextFunctionCallTest(Assembler::JumpList& failureCases, JSC::FunctionPtr);
     void generateElementIsActive(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementIsEmpty(Assembler::JumpList& failureCases);
+    void generateElementIsDragged(Assembler::JumpList& failureCases);
     void generateElementIsFirstChild(Assembler::JumpList& failureCases);
+    void generateElementIsOfType(Assembler::JumpList& failureCases, const SelectorFragment&);
+    void generateElementIsOfType(Assembler::JumpList& failureCases, const SelectorFragment&, const CSSSelector&);
     void generateElementIsHovered(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementIsInLanguage(Assembler::JumpList& failureCases, const SelectorFragment&);
     void generateElementIsInLanguage(Assembler::JumpList& failureCases, const Vector<AtomicString>*);
@@ -623,17 +628,11 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
         return FunctionType::CannotMatchAnything;
 
     // FIXME: Compile these pseudoclasses, too!
-    case CSSSelector::PseudoClassFirstOfType:
-    case CSSSelector::PseudoClassLastOfType:
-    case CSSSelector::PseudoClassOnlyOfType:
-    case CSSSelector::PseudoClassNthOfType:
-    case CSSSelector::PseudoClassNthLastOfType:
-    case CSSSelector::PseudoClassDrag:
 #if ENABLE(CSS_SELECTORS_LEVEL4)
     case CSSSelector::PseudoClassDir:
     case CSSSelector::PseudoClassRole:
-#endif
         return FunctionType::CannotCompile;
+#endif
 
     // Optimized pseudo selectors.
     case CSSSelector::PseudoClassAnyLink:
@@ -669,6 +668,7 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
         return FunctionType::SelectorCheckerWithCheckingContext;
 
     case CSSSelector::PseudoClassActive:
+    case CSSSelector::PseudoClassDrag:
     case CSSSelector::PseudoClassEmpty:
     case CSSSelector::PseudoClassFirstChild:
     case CSSSelector::PseudoClassHover:
@@ -687,6 +687,22 @@ static inline FunctionType addPseudoClassType(const CSSSelector& selector, Selec
     case CSSSelector::PseudoClassNthLastChild:
         return addNthChildType(selector, selectorContext, positionInRootFragments, CSSSelector::PseudoClassLastChild, visitedMatchEnabled, fragment.nthLastChildFilters, fragment.nthLastChildOfFilters, fragment.pseudoClasses, internalSpecificity);
 
+    case CSSSelector::PseudoClassNthOfType:
+    case CSSSelector::PseudoClassNthLastOfType:
+        if (!selector.parseNth())
+            return FunctionType::CannotMatchAnything;
+        // The element count is always positive.
+        if (selector.nthA() <= 0 && selector.nthB() < 1)
+            return FunctionType::CannotMatchAnything;
+        FALLTHROUGH;
+    case CSSSelector::PseudoClassFirstOfType:
+    case CSSSelector::PseudoClassLastOfType:
+    case CSSSelector::PseudoClassOnlyOfType:
+        fragment.ofTypeFilters.append(&selector);
+        if (selectorContext == SelectorContext::QuerySelector)
+            return FunctionType::SimpleSelectorChecker;
+        return FunctionType::SelectorCheckerWithCheckingContext;
+
     case CSSSelector::PseudoClassNot:
         {
             const CSSSelectorList* selectorList = selector.selectorList();
@@ -1093,7 +1109,7 @@ static unsigned minimumRegisterRequirements(const SelectorFragment& selectorFrag
         minimum = std::max(minimum, attributeMinimum);
     }
 
-    if (!selectorFragment.nthChildFilters.isEmpty() || !selectorFragment.nthChildOfFilters.isEmpty() || !selectorFragment.nthLastChildFilters.isEmpty() || !selectorFragment.nthLastChildOfFilters.isEmpty())
+    if (!selectorFragment.nthChildFilters.isEmpty() || !selectorFragment.nthChildOfFilters.isEmpty() || !selectorFragment.nthLastChildFilters.isEmpty() || !selectorFragment.nthLastChildOfFilters.isEmpty() || !selectorFragment.ofTypeFilters.isEmpty())
         minimum = std::max(minimum, minimumRequiredRegisterCountForNthChildFilter);
 
     // :any pseudo class filters cause some register pressure.
@@ -2595,6 +2611,8 @@ void SelectorCodeGenerator::generateElementMatching(Assembler::JumpList& matchin
         generateElementIsEmpty(matchingPostTagNameFailureCases);
     if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassHover))
         generateElementIsHovered(matchingPostTagNameFailureCases, fragment);
+    if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassDrag))
+        generateElementIsDragged(matchingPostTagNameFailureCases);
     if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassOnlyChild))
         generateElementIsOnlyChild(matchingPostTagNameFailureCases);
     if (fragment.pseudoClasses.contains(CSSSelector::PseudoClassPlaceholderShown))
@@ -2607,6 +2625,8 @@ void SelectorCodeGenerator::generateElementMatching(Assembler::JumpList& matchin
         generateElementIsNthChild(matchingPostTagNameFailureCases, fragment);
     if (!fragment.nthLastChildFilters.isEmpty())
         generateElementIsNthLastChild(matchingPostTagNameFailureCases, fragment);
+    if (!fragment.ofTypeFilters.isEmpty())
+        generateElementIsOfType(matchingPostTagNameFailureCases, fragment);
     if (!fragment.notFilters.isEmpty())
         generateElementMatchesNotPseudoClass(matchingPostTagNameFailureCases, fragment);
     if (!fragment.anyFilters.isEmpty())
@@ -3220,6 +3240,21 @@ void SelectorCodeGenerator::generateElementIsHovered(Assembler::JumpList& failur
     failureCases.append(functionCall.callAndBranchOnBooleanReturnValue(Assembler::Zero));
 }
 
+static bool elementIsDragged(const Element* element)
+{
+    return element->renderer() && element->renderer()->isDragging();
+}
+
+void SelectorCodeGenerator::generateElementIsDragged(Assembler::JumpList& failureCases)
+{
+    generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::AffectedByDrag);
+
+    FunctionCall functionCall(m_assembler, m_registerAllocator, m_stackAllocator, m_functionCalls);
+    functionCall.setFunctionAddress(elementIsDragged);
+    functionCall.setOneArgument(elementAddressRegister);
+    failureCases.append(functionCall.callAndBranchOnBooleanReturnValue(Assembler::Zero));
+}
+
 void SelectorCodeGenerator::generateElementIsInLanguage(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
 {
     for (const Vector<AtomicString>* languageArguments : fragment.languageArgumentsList)
@@ -3649,6 +3684,109 @@ void SelectorCodeGenerator::generateElementIsNthLastChild(Assembler::JumpList& f
         generateNthFilterTest(failureCases, elementCounter, slot.first, slot.second);
 }
 
+static bool ofTypePseudoClassIsBackward(const CSSSelector& selector)
+{
+    return selector.pseudoClassType() == CSSSelector::PseudoClassLastOfType || selector.pseudoClassType() == CSSSelector::PseudoClassNthLastOfType;
+}
+
+static bool ofTypePseudoClassIsForward(const CSSSelector& selector)
+{
+    return !ofTypePseudoClassIsBackward(selector);
+}
+
+static bool elementMatchesOfTypePseudoClass(const Element* element, const CSSSelector* selector)
+{
+    const QualifiedName& type = element->tagQName();
+    unsigned elementsOfTypeBefore = 0;
+    unsigned elementsOfTypeAfter = 0;
+
+    switch (selector->pseudoClassType()) {
+    case CSSSelector::PseudoClassFirstOfType:
+    case CSSSelector::PseudoClassNthOfType:
+    case CSSSelector::PseudoClassOnlyOfType:
+        for (const Element* sibling = ElementTraversal::previousSibling(*element); sibling; sibling = ElementTraversal::previousSibling(*sibling)) {
+            if (sibling->hasTagName(type))
+                ++elementsOfTypeBefore;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (selector->pseudoClassType()) {
+    case CSSSelector::PseudoClassLastOfType:
+    case CSSSelector::PseudoClassNthLastOfType:
+    case CSSSelector::PseudoClassOnlyOfType:
+        for (const Element* sibling = ElementTraversal::nextSibling(*element); sibling; sibling = ElementTraversal::nextSibling(*sibling)) {
+            if (sibling->hasTagName(type))
+                ++elementsOfTypeAfter;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (selector->pseudoClassType()) {
+    case CSSSelector::PseudoClassFirstOfType:
+        return !elementsOfTypeBefore;
+    case CSSSelector::PseudoClassLastOfType:
+        return !elementsOfTypeAfter;
+    case CSSSelector::PseudoClassOnlyOfType:
+        return !elementsOfTypeBefore && !elementsOfTypeAfter;
+    case CSSSelector::PseudoClassNthOfType:
+        return selector->matchNth(1 + elementsOfTypeBefore);
+    case CSSSelector::PseudoClassNthLastOfType:
+        return selector->matchNth(1 + elementsOfTypeAfter);
+    default:
+        ASSERT_NOT_REACHED();
+        return false;
+    }
+}
+
+void SelectorCodeGenerator::generateElementIsOfType(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
+{
+    for (const CSSSelector* selector : fragment.ofTypeFilters)
+        generateElementIsOfType(failureCases, fragment, *selector);
+}
+
+void SelectorCodeGenerator::generateElementIsOfType(Assembler::JumpList& failureCases, const SelectorFragment& fragment, const CSSSelector& selector)
+{
+    { // The *-of-type pseudo classes require a parent to match. If there is a parent, do the invalidation marking.
+        LocalRegister parentElement(m_registerAllocator);
+        generateWalkToParentElement(failureCases, parentElement);
+
+        if (ofTypePseudoClassIsBackward(selector) || selector.pseudoClassType() == CSSSelector::PseudoClassOnlyOfType) {
+            generateAddStyleRelationIfResolvingStyle(parentElement, Style::Relation::ChildrenAffectedByBackwardPositionalRules);
+            failureCases.append(m_assembler.branchTest32(Assembler::Zero, Assembler::Address(parentElement, Node::nodeFlagsMemoryOffset()), Assembler::TrustedImm32(Node::flagIsParsingChildrenFinished())));
+        }
+    }
+
+    if (ofTypePseudoClassIsForward(selector) && m_selectorContext != SelectorContext::QuerySelector) {
+        if (!isAdjacentRelation(fragment.relationToRightFragment))
+            generateAddStyleRelationIfResolvingStyle(elementAddressRegister, Style::Relation::AffectedByPreviousSibling);
+
+        // Any previous sibling can change the count. This marks more siblings than SelectorChecker, which stops
+        // at the first element of the same type, but the extra invalidation is harmless.
+        LocalRegister previousSibling(m_registerAllocator);
+        m_assembler.move(elementAddressRegister, previousSibling);
+
+        Assembler::JumpList noMoreSiblingsCases;
+        Assembler::Label loopStart = m_assembler.label();
+        generateWalkToPreviousAdjacentElement(noMoreSiblingsCases, previousSibling);
+        generateAddStyleRelationIfResolvingStyle(previousSibling, Style::Relation::AffectsNextSibling);
+        m_assembler.jump().linkTo(loopStart, &m_assembler);
+        noMoreSiblingsCases.link(&m_assembler);
+    }
+
+    LocalRegisterWithPreference selectorRegister(m_registerAllocator, JSC::GPRInfo::argumentGPR1);
+    m_assembler.move(Assembler::TrustedImmPtr(&selector), selectorRegister);
+
+    FunctionCall functionCall(m_assembler, m_registerAllocator, m_stackAllocator, m_functionCalls);
+    functionCall.setFunctionAddress(elementMatchesOfTypePseudoClass);
+    functionCall.setTwoArguments(elementAddressRegister, selectorRegister);
+    failureCases.append(functionCall.callAndBranchOnBooleanReturnValue(Assembler::Zero));
+}
+
 void SelectorCodeGenerator::generateElementIsNthLastChildOf(Assembler::JumpList& failureCases, const SelectorFragment& fragment)
 {
     Vector<const NthChildOfSelectorInfo*> validSubsetFilters;
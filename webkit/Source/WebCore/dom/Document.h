@@ -1203,6 +1203,10 @@ public:
     WEBCORE_EXPORT void startTrackingStyleRecalcs();
     WEBCORE_EXPORT unsigned styleRecalcCount() const;
 
+    // Used for testing.
+    void didReceivePreconnectHint() { ++m_preconnectHintCount; }
+    unsigned preconnectHintCount() const { return m_preconnectHintCount; }
+
     void didAddTouchEventHandler(Node&);
     void didRemoveTouchEventHandler(Node&, EventHandlerRemoval = EventHandlerRemoval::One);
 
@@ -1534,6 +1538,7 @@ private:
     unsigned m_ignoreOpensDuringUnloadCount { 0 };
 
     unsigned m_styleRecalcCount { 0 };
+    unsigned m_preconnectHintCount { 0 };
 
     StringWithDirection m_title;
     StringWithDirection m_rawTitle;
@@ -277,6 +277,10 @@ bool ScriptElement::requestScript(const String& sourceUrl)
         request.setCharset(scriptCharset());
         request.setInitiator(&element());
 
+        // The parser waits for scripts without async or defer, which holds back rendering of the rest of the page.
+        if (m_parserInserted && !asyncAttributeValue() && !deferAttributeValue())
+            request.setPriority(ResourceLoadPriority::High);
+
         m_cachedScript = m_element.document().cachedResourceLoader().requestScript(request);
         m_isExternalScript = true;
     }
@@ -108,8 +108,16 @@ SelectorDataList::SelectorDataList(const CSSSelectorList& selectorList)
                 break;
             }
         }
-    } else
+    } else {
         m_matchType = CompilableMultipleSelectorMatch;
+        m_multipleSelectorsHaveRootFilter = true;
+        for (auto& selectorData : m_selectors) {
+            if (findIdMatchingType(*selectorData.selector) != IdMatchingType::Filter) {
+                m_multipleSelectorsHaveRootFilter = false;
+                break;
+            }
+        }
+    }
 }
 
 inline bool SelectorDataList::selectorMatches(const SelectorData& selectorData, Element& element, const ContainerNode& rootNode) const
@@ -276,6 +284,29 @@ static ContainerNode& filterRootById(ContainerNode& rootNode, const CSSSelector&
     return rootNode;
 }
 
+ContainerNode& SelectorDataList::filterRootForMultipleSelectors(ContainerNode& rootNode) const
+{
+    if (!m_multipleSelectorsHaveRootFilter)
+        return rootNode;
+
+    // Every selector is anchored on an Id, the elements can only match inside the closest subtree containing all the anchors.
+    ContainerNode* commonRoot = nullptr;
+    for (auto& selectorData : m_selectors) {
+        ContainerNode* selectorRoot = &filterRootById(rootNode, *selectorData.selector);
+        if (selectorRoot == &rootNode)
+            return rootNode;
+        if (!commonRoot) {
+            commonRoot = selectorRoot;
+            continue;
+        }
+        while (commonRoot != &rootNode && commonRoot != selectorRoot && !selectorRoot->isDescendantOf(commonRoot))
+            commonRoot = commonRoot->parentNode();
+        if (commonRoot == &rootNode)
+            return rootNode;
+    }
+    return *commonRoot;
+}
+
 static ALWAYS_INLINE bool localNameMatches(const Element& element, const AtomicString& localName, const AtomicString& lowercaseLocalName)
 {
     if (element.isHTMLElement() && element.document().isHTMLDocument())
@@ -379,9 +410,9 @@ ALWAYS_INLINE void SelectorDataList::executeSingleSelectorData(const ContainerNo
 }
 
 template <typename SelectorQueryTrait>
-ALWAYS_INLINE void SelectorDataList::executeSingleMultiSelectorData(const ContainerNode& rootNode, typename SelectorQueryTrait::OutputType& output) const
+ALWAYS_INLINE void SelectorDataList::executeSingleMultiSelectorData(const ContainerNode& rootNode, const ContainerNode& searchRootNode, typename SelectorQueryTrait::OutputType& output) const
 {
-    for (auto& element : elementDescendants(const_cast<ContainerNode&>(rootNode))) {
+    for (auto& element : elementDescendants(const_cast<ContainerNode&>(searchRootNode))) {
         for (auto& selector : m_selectors) {
             if (selectorMatches(selector, element, rootNode)) {
                 SelectorQueryTrait::appendOutputForElement(output, &element);
@@ -394,6 +425,11 @@ ALWAYS_INLINE void SelectorDataList::executeSingleMultiSelectorData(const Contai
 }
 
 #if ENABLE(CSS_SELECTOR_JIT)
+static bool isCompiledSelector(SelectorCompilationStatus compilationStatus)
+{
+    return compilationStatus == SelectorCompilationStatus::SimpleSelectorChecker || compilationStatus == SelectorCompilationStatus::SelectorCheckerWithCheckingContext;
+}
+
 template <typename SelectorQueryTrait>
 ALWAYS_INLINE void SelectorDataList::executeCompiledSimpleSelectorChecker(const ContainerNode& searchRootNode, SelectorCompiler::QuerySelectorSimpleSelectorChecker selectorChecker, typename SelectorQueryTrait::OutputType& output, const SelectorData& selectorData) const
 {
@@ -432,22 +468,29 @@ ALWAYS_INLINE void SelectorDataList::executeCompiledSelectorCheckerWithCheckingC
 }
 
 template <typename SelectorQueryTrait>
-ALWAYS_INLINE void SelectorDataList::executeCompiledSingleMultiSelectorData(const ContainerNode& rootNode, typename SelectorQueryTrait::OutputType& output) const
+ALWAYS_INLINE void SelectorDataList::executeCompiledSingleMultiSelectorData(const ContainerNode& rootNode, const ContainerNode& searchRootNode, typename SelectorQueryTrait::OutputType& output) const
 {
     SelectorChecker::CheckingContext checkingContext(SelectorChecker::Mode::QueryingRules);
     checkingContext.scope = rootNode.isDocumentNode() ? nullptr : &rootNode;
-    for (auto& element : elementDescendants(const_cast<ContainerNode&>(rootNode))) {
+    for (auto& element : elementDescendants(const_cast<ContainerNode&>(searchRootNode))) {
         for (auto& selector : m_selectors) {
+            bool matched = false;
+            // A single selector the compiler cannot handle should not push the whole list back to the interpreter.
+            if (!isCompiledSelector(selector.compilationStatus))
+                matched = selectorMatches(selector, element, rootNode);
+            else if (selector.compilationStatus == SelectorCompilationStatus::SimpleSelectorChecker) {
 #if CSS_SELECTOR_JIT_PROFILING
-            selector.compiledSelectorUsed();
+                selector.compiledSelectorUsed();
 #endif
-            bool matched = false;
-            void* compiledSelectorChecker = selector.compiledSelectorCodeRef.code().executableAddress();
-            if (selector.compilationStatus == SelectorCompilationStatus::SimpleSelectorChecker) {
+                void* compiledSelectorChecker = selector.compiledSelectorCodeRef.code().executableAddress();
                 auto selectorChecker = SelectorCompiler::querySelectorSimpleSelectorCheckerFunction(compiledSelectorChecker, selector.compilationStatus);
                 matched = selectorChecker(&element);
             } else {
                 ASSERT(selector.compilationStatus == SelectorCompilationStatus::SelectorCheckerWithCheckingContext);
+#if CSS_SELECTOR_JIT_PROFILING
+                selector.compiledSelectorUsed();
+#endif
+                void* compiledSelectorChecker = selector.compiledSelectorCodeRef.code().executableAddress();
                 auto selectorChecker = SelectorCompiler::querySelectorSelectorCheckerFunctionWithCheckingContext(compiledSelectorChecker, selector.compilationStatus);
                 matched = selectorChecker(&element, &checkingContext);
             }
@@ -461,11 +504,6 @@ ALWAYS_INLINE void SelectorDataList::executeCompiledSingleMultiSelectorData(cons
     }
 }
 
-static bool isCompiledSelector(SelectorCompilationStatus compilationStatus)
-{
-    return compilationStatus == SelectorCompilationStatus::SimpleSelectorChecker || compilationStatus == SelectorCompilationStatus::SelectorCheckerWithCheckingContext;
-}
-
 bool SelectorDataList::compileSelector(const SelectorData& selectorData, const ContainerNode& rootNode)
 {
     if (selectorData.compilationStatus != SelectorCompilationStatus::NotCompiled)
@@ -573,11 +611,14 @@ ALWAYS_INLINE void SelectorDataList::execute(ContainerNode& rootNode, typename S
     case CompilableMultipleSelectorMatch:
 #if ENABLE(CSS_SELECTOR_JIT)
         {
+        bool hasCompiledSelector = false;
         for (auto& selector : m_selectors) {
-            if (!compileSelector(selector, *searchRootNode)) {
-                m_matchType = MultipleSelectorMatch;
-                goto MultipleSelectorMatch;
-            }
+            if (compileSelector(selector, *searchRootNode))
+                hasCompiledSelector = true;
+        }
+        if (!hasCompiledSelector) {
+            m_matchType = MultipleSelectorMatch;
+            goto MultipleSelectorMatch;
         }
         m_matchType = CompiledMultipleSelectorMatch;
         goto CompiledMultipleSelectorMatch;
@@ -588,7 +629,7 @@ ALWAYS_INLINE void SelectorDataList::execute(ContainerNode& rootNode, typename S
     case CompiledMultipleSelectorMatch:
 #if ENABLE(CSS_SELECTOR_JIT)
         CompiledMultipleSelectorMatch:
-        executeCompiledSingleMultiSelectorData<SelectorQueryTrait>(*searchRootNode, output);
+        executeCompiledSingleMultiSelectorData<SelectorQueryTrait>(rootNode, filterRootForMultipleSelectors(rootNode), output);
         break;
 #else
         FALLTHROUGH;
@@ -597,7 +638,7 @@ ALWAYS_INLINE void SelectorDataList::execute(ContainerNode& rootNode, typename S
 #if ENABLE(CSS_SELECTOR_JIT)
         MultipleSelectorMatch:
 #endif
-        executeSingleMultiSelectorData<SelectorQueryTrait>(*searchRootNode, output);
+        executeSingleMultiSelectorData<SelectorQueryTrait>(rootNode, filterRootForMultipleSelectors(rootNode), output);
         break;
     }
 }
@@ -54,6 +54,8 @@ LinkRelAttribute::LinkRelAttribute(const String& rel)
         iconType = LinkIconType::TouchPrecomposedIcon;
     else if (equalLettersIgnoringASCIICase(rel, "dns-prefetch"))
         isDNSPrefetch = true;
+    else if (equalLettersIgnoringASCIICase(rel, "preconnect"))
+        isPreconnect = true;
     else if (RuntimeEnabledFeatures::sharedFeatures().linkPreloadEnabled() && equalLettersIgnoringASCIICase(rel, "preload"))
         isLinkPreload = true;
     else if (equalLettersIgnoringASCIICase(rel, "alternate stylesheet") || equalLettersIgnoringASCIICase(rel, "stylesheet alternate")) {
@@ -76,6 +78,8 @@ LinkRelAttribute::LinkRelAttribute(const String& rel)
                 iconType = LinkIconType::TouchIcon;
             else if (equalLettersIgnoringASCIICase(word, "apple-touch-icon-precomposed"))
                 iconType = LinkIconType::TouchPrecomposedIcon;
+            else if (equalLettersIgnoringASCIICase(word, "preconnect"))
+                isPreconnect = true;
 #if ENABLE(LINK_PREFETCH)
             else if (equalLettersIgnoringASCIICase(word, "prefetch"))
                 isLinkPrefetch = true;
@@ -44,6 +44,7 @@ struct LinkRelAttribute {
     Optional<LinkIconType> iconType;
     bool isAlternate { false };
     bool isDNSPrefetch { false };
+    bool isPreconnect { false };
     bool isLinkPreload { false };
 #if ENABLE(LINK_PREFETCH)
     bool isLinkPrefetch { false };
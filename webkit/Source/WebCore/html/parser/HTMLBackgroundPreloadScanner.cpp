@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HTMLBackgroundPreloadScanner.h"
+
+#include "Document.h"
+#include "HTMLResourcePreloader.h"
+#include "SegmentedString.h"
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/WorkQueue.h>
+
+namespace WebCore {
+
+static WorkQueue& scanQueue()
+{
+    static NeverDestroyed<Ref<WorkQueue>> queue(WorkQueue::create("org.webkit.HTMLBackgroundPreloadScanner", WorkQueue::Type::Serial, WorkQueue::QOS::UserInitiated));
+    return queue.get();
+}
+
+template<size_t length>
+static bool tagNameIs(const HTMLToken::DataVector& name, const char (&expected)[length])
+{
+    if (name.size() != length - 1)
+        return false;
+    for (size_t i = 0; i < length - 1; ++i) {
+        if (name[i] != static_cast<LChar>(expected[i]))
+            return false;
+    }
+    return true;
+}
+
+// The queue owns everything it touches: the tokenizer and its input. HTMLNames and
+// AtomicStrings belong to the main thread, so tag names are compared against literals here.
+class HTMLBackgroundPreloadScanner::Tokenizer : public ThreadSafeRefCounted<Tokenizer> {
+public:
+    static Ref<Tokenizer> create(const HTMLParserOptions& options)
+    {
+        return adoptRef(*new Tokenizer(options));
+    }
+
+    void stop() { m_stopped = true; }
+    bool stopped() const { return m_stopped; }
+
+    Vector<HTMLToken> tokenize(const String& text)
+    {
+        ASSERT(!isMainThread());
+
+        Vector<HTMLToken> tokens;
+        if (m_stopped)
+            return tokens;
+
+        m_input.append(SegmentedString(text));
+        while (auto token = m_tokenizer.nextToken(m_input)) {
+            if (m_stopped)
+                break;
+            if (!shouldForward(*token))
+                continue;
+            tokens.append(WTFMove(*token));
+        }
+        return tokens;
+    }
+
+private:
+    explicit Tokenizer(const HTMLParserOptions& options)
+        : m_options(options)
+        , m_tokenizer(options)
+    {
+    }
+
+    bool shouldForward(const HTMLToken& token)
+    {
+        switch (token.type()) {
+        case HTMLToken::Character:
+            return m_inStyle;
+        case HTMLToken::StartTag:
+            updateTokenizerState(token.name());
+            if (tagNameIs(token.name(), "style"))
+                m_inStyle = true;
+            return isScannedTag(token.name());
+        case HTMLToken::EndTag:
+            if (tagNameIs(token.name(), "style"))
+                m_inStyle = false;
+            return isScannedTag(token.name());
+        default:
+            return false;
+        }
+    }
+
+    // These are the tags TokenPreloadScanner::tagIdFor() knows about.
+    static bool isScannedTag(const HTMLToken::DataVector& name)
+    {
+        return tagNameIs(name, "img")
+            || tagNameIs(name, "input")
+            || tagNameIs(name, "link")
+            || tagNameIs(name, "script")
+            || tagNameIs(name, "meta")
+            || tagNameIs(name, "source")
+            || tagNameIs(name, "style")
+            || tagNameIs(name, "base")
+            || tagNameIs(name, "template")
+            || tagNameIs(name, "picture");
+    }
+
+    // Same approximation as HTMLTokenizer::updateStateFor(), without AtomicStrings.
+    void updateTokenizerState(const HTMLToken::DataVector& name)
+    {
+        if (tagNameIs(name, "textarea") || tagNameIs(name, "title"))
+            m_tokenizer.setRCDATAState();
+        else if (tagNameIs(name, "plaintext"))
+            m_tokenizer.setPLAINTEXTState();
+        else if (tagNameIs(name, "script"))
+            m_tokenizer.setScriptDataState();
+        else if (tagNameIs(name, "style")
+            || tagNameIs(name, "iframe")
+            || tagNameIs(name, "xmp")
+            || (tagNameIs(name, "noembed") && m_options.pluginsEnabled)
+            || tagNameIs(name, "noframes")
+            || (tagNameIs(name, "noscript") && m_options.scriptEnabled))
+            m_tokenizer.setRAWTEXTState();
+    }
+
+    const HTMLParserOptions m_options;
+    HTMLTokenizer m_tokenizer;
+    SegmentedString m_input;
+    bool m_inStyle { false };
+    std::atomic<bool> m_stopped { false };
+};
+
+HTMLBackgroundPreloadScanner::HTMLBackgroundPreloadScanner(const HTMLParserOptions& options, Document& document, HTMLResourcePreloader& preloader)
+    : m_document(document)
+    , m_preloader(preloader)
+    , m_scanner(document.url(), document.deviceScaleFactor())
+    , m_tokenizer(Tokenizer::create(options))
+    , m_weakFactory(this)
+{
+}
+
+HTMLBackgroundPreloadScanner::~HTMLBackgroundPreloadScanner()
+{
+    m_tokenizer->stop();
+}
+
+void HTMLBackgroundPreloadScanner::appendText(const String& text, const TextEncoding& encoding)
+{
+    ASSERT(isMainThread());
+    if (m_stopped || text.isEmpty())
+        return;
+
+    if (!m_encoding.isValid())
+        m_encoding = encoding;
+    else if (m_encoding != encoding) {
+        // The decoder switched encodings mid-stream. What was tokenized so far is garbage, and the parser
+        // has to catch up anyway, so stop speculating.
+        m_stopped = true;
+        m_tokenizer->stop();
+        return;
+    }
+
+    auto weakThis = m_weakFactory.createWeakPtr();
+    scanQueue().dispatch([tokenizer = m_tokenizer.copyRef(), text = text.isolatedCopy(), weakThis] {
+        auto tokens = tokenizer->tokenize(text);
+        if (tokens.isEmpty())
+            return;
+        callOnMainThread([tokens = WTFMove(tokens), weakThis]() mutable {
+            if (weakThis)
+                weakThis->scanTokens(WTFMove(tokens));
+        });
+    });
+}
+
+void HTMLBackgroundPreloadScanner::scanTokens(Vector<HTMLToken>&& tokens)
+{
+    ASSERT(isMainThread());
+
+    // Like HTMLPreloadScanner, start from the real base URL when there is one.
+    const URL& startingBaseElementURL = m_document.baseElementURL();
+    if (!startingBaseElementURL.isEmpty())
+        m_scanner.setPredictedBaseElementURL(startingBaseElementURL);
+
+    PreloadRequestStream requests;
+    for (auto& token : tokens)
+        m_scanner.scan(token, requests, m_document);
+
+    m_preloader.preload(WTFMove(requests));
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HTMLBackgroundPreloadScanner_h
+#define HTMLBackgroundPreloadScanner_h
+
+#include "HTMLPreloadScanner.h"
+#include "TextEncoding.h"
+#include <wtf/WeakPtr.h>
+
+namespace WebCore {
+
+class Document;
+class HTMLResourcePreloader;
+
+// Tokenizes the text of a document on a background queue as it is decoded from the network, so that
+// resources are discovered even while the parser is blocked on a script. Only the tokens the
+// TokenPreloadScanner cares about are sent back to the main thread, where the preloads are issued.
+class HTMLBackgroundPreloadScanner {
+    WTF_MAKE_NONCOPYABLE(HTMLBackgroundPreloadScanner); WTF_MAKE_FAST_ALLOCATED;
+public:
+    HTMLBackgroundPreloadScanner(const HTMLParserOptions&, Document&, HTMLResourcePreloader&);
+    ~HTMLBackgroundPreloadScanner();
+
+    // Takes the same decoder output the parser gets. Scanning stops if the decoder changes encodings.
+    void appendText(const String&, const TextEncoding&);
+
+    bool isActive() const { return !m_stopped; }
+
+private:
+    class Tokenizer;
+
+    void scanTokens(Vector<HTMLToken>&&);
+
+    Document& m_document;
+    HTMLResourcePreloader& m_preloader;
+    TokenPreloadScanner m_scanner;
+    Ref<Tokenizer> m_tokenizer;
+    TextEncoding m_encoding;
+    bool m_stopped { false };
+    WeakPtrFactory<HTMLBackgroundPreloadScanner> m_weakFactory;
+};
+
+}
+
+#endif
@@ -28,7 +28,9 @@
 #include "HTMLDocumentParser.h"
 
 #include "DocumentFragment.h"
+#include "DocumentWriter.h"
 #include "Frame.h"
+#include "HTMLBackgroundPreloadScanner.h"
 #include "HTMLDocument.h"
 #include "HTMLParserScheduler.h"
 #include "HTMLPreloadScanner.h"
@@ -36,6 +38,8 @@
 #include "HTMLTreeBuilder.h"
 #include "HTMLUnknownElement.h"
 #include "JSCustomElementInterface.h"
+#include "Settings.h"
+#include "TextResourceDecoder.h"
 
 namespace WebCore {
 
@@ -51,6 +55,8 @@ HTMLDocumentParser::HTMLDocumentParser(HTMLDocument& document)
     , m_xssAuditorDelegate(document)
     , m_preloader(std::make_unique<HTMLResourcePreloader>(document))
 {
+    if (document.settings() && document.settings()->backgroundPreloadScanningEnabled())
+        m_backgroundPreloadScanner = std::make_unique<HTMLBackgroundPreloadScanner>(m_options, document, *m_preloader);
 }
 
 Ref<HTMLDocumentParser> HTMLDocumentParser::create(HTMLDocument& document)
@@ -94,6 +100,7 @@ void HTMLDocumentParser::detach()
     // Yet during fast/dom/HTMLScriptElement/script-load-events.html we do.
     m_preloadScanner = nullptr;
     m_insertionPreloadScanner = nullptr;
+    m_backgroundPreloadScanner = nullptr;
     m_parserScheduler = nullptr; // Deleting the scheduler will clear any timers.
 }
 
@@ -291,7 +298,8 @@ void HTMLDocumentParser::pumpTokenizer(SynchronousMode mode)
     if (shouldResume)
         m_parserScheduler->scheduleForResume();
 
-    if (isWaitingForScripts()) {
+    // An active background scanner has already seen everything that came from the network.
+    if (isWaitingForScripts() && !(m_backgroundPreloadScanner && m_backgroundPreloadScanner->isActive())) {
         ASSERT(m_tokenizer.isInDataState());
         if (!m_preloadScanner) {
             m_preloadScanner = std::make_unique<HTMLPreloadScanner>(m_options, document()->url(), document()->deviceScaleFactor());
@@ -359,6 +367,34 @@ void HTMLDocumentParser::insert(const SegmentedString& source)
     endIfDelayed();
 }
 
+void HTMLDocumentParser::appendBytes(DocumentWriter& writer, const char* data, size_t length)
+{
+    if (!length)
+        return;
+
+    TextResourceDecoder& decoder = *writer.createDecoderIfNeeded();
+    appendDecodedData(writer, decoder.decode(data, length), decoder.encoding());
+}
+
+void HTMLDocumentParser::flush(DocumentWriter& writer)
+{
+    TextResourceDecoder& decoder = *writer.createDecoderIfNeeded();
+    appendDecodedData(writer, decoder.flush(), decoder.encoding());
+}
+
+void HTMLDocumentParser::appendDecodedData(DocumentWriter& writer, String&& decoded, const TextEncoding& encoding)
+{
+    if (decoded.isEmpty())
+        return;
+
+    // Hand the text over before parsing it, the parser may block on a script.
+    if (m_backgroundPreloadScanner)
+        m_backgroundPreloadScanner->appendText(decoded, encoding);
+
+    writer.reportDataReceived();
+    append(decoded.releaseImpl());
+}
+
 void HTMLDocumentParser::append(RefPtr<StringImpl>&& inputSource)
 {
     if (isStopped())
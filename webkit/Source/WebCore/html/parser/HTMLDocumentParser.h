@@ -39,6 +39,7 @@
 namespace WebCore {
 
 class DocumentFragment;
+class HTMLBackgroundPreloadScanner;
 class HTMLDocument;
 class HTMLParserScheduler;
 class HTMLPreloadScanner;
@@ -46,6 +47,7 @@ class HTMLScriptRunner;
 class HTMLTreeBuilder;
 class HTMLResourcePreloader;
 class PumpSession;
+class TextEncoding;
 
 class HTMLDocumentParser : public ScriptableDocumentParser, private HTMLScriptRunnerHost, private CachedResourceClient {
     WTF_MAKE_FAST_ALLOCATED;
@@ -67,6 +69,8 @@ protected:
 
     void insert(const SegmentedString&) final;
     void append(RefPtr<StringImpl>&&) override;
+    void appendBytes(DocumentWriter&, const char* bytes, size_t length) override;
+    void flush(DocumentWriter&) override;
     void finish() override;
 
     HTMLTreeBuilder& treeBuilder();
@@ -75,6 +79,8 @@ private:
     HTMLDocumentParser(DocumentFragment&, Element& contextElement, ParserContentPolicy);
     static Ref<HTMLDocumentParser> create(DocumentFragment&, Element& contextElement, ParserContentPolicy);
 
+    void appendDecodedData(DocumentWriter&, String&& decoded, const TextEncoding&);
+
     // DocumentParser
     void detach() final;
     bool hasInsertionPoint() final;
@@ -135,6 +141,7 @@ private:
     XSSAuditorDelegate m_xssAuditorDelegate;
 
     std::unique_ptr<HTMLResourcePreloader> m_preloader;
+    std::unique_ptr<HTMLBackgroundPreloadScanner> m_backgroundPreloadScanner;
 
     bool m_endWasDelayed { false };
     unsigned m_pumpSessionNestingLevel { 0 };
@@ -99,6 +99,7 @@ public:
     explicit StartTagScanner(TagId tagId, float deviceScaleFactor = 1.0)
         : m_tagId(tagId)
         , m_linkIsStyleSheet(false)
+        , m_linkIsPreconnect(false)
         , m_metaIsViewport(false)
         , m_inputIsImage(false)
         , m_deviceScaleFactor(deviceScaleFactor)
@@ -145,6 +146,7 @@ public:
         auto request = std::make_unique<PreloadRequest>(initiatorFor(m_tagId), m_urlToLoad, predictedBaseURL, resourceType(), m_mediaAttribute);
         request->setCrossOriginMode(m_crossOriginMode);
         request->setCharset(charset());
+        request->setIsPreconnect(m_tagId == TagId::Link && m_linkIsPreconnect && !m_linkIsStyleSheet);
         return request;
     }
 
@@ -208,8 +210,11 @@ private:
         case TagId::Link:
             if (match(attributeName, hrefAttr))
                 setUrlToLoad(attributeValue);
-            else if (match(attributeName, relAttr))
-                m_linkIsStyleSheet = relAttributeIsStyleSheet(attributeValue);
+            else if (match(attributeName, relAttr)) {
+                LinkRelAttribute parsedAttribute { attributeValue };
+                m_linkIsStyleSheet = relAttributeIsStyleSheet(parsedAttribute);
+                m_linkIsPreconnect = parsedAttribute.isPreconnect;
+            }
             else if (match(attributeName, mediaAttr))
                 m_mediaAttribute = attributeValue;
             else if (match(attributeName, charsetAttr))
@@ -238,9 +243,8 @@ private:
         }
     }
 
-    static bool relAttributeIsStyleSheet(const String& attributeValue)
+    static bool relAttributeIsStyleSheet(const LinkRelAttribute& parsedAttribute)
     {
-        LinkRelAttribute parsedAttribute { attributeValue };
         return parsedAttribute.isStyleSheet && !parsedAttribute.isAlternate && !parsedAttribute.iconType && !parsedAttribute.isDNSPrefetch;
     }
 
@@ -272,7 +276,11 @@ private:
             ASSERT(m_tagId != TagId::Input || m_inputIsImage);
             return CachedResource::ImageResource;
         case TagId::Link:
-            ASSERT(m_linkIsStyleSheet);
+            if (!m_linkIsStyleSheet) {
+                // A preconnect, which loads nothing.
+                ASSERT(m_linkIsPreconnect);
+                return CachedResource::RawResource;
+            }
             return CachedResource::CSSStyleSheet;
         case TagId::Meta:
         case TagId::Unknown:
@@ -294,7 +302,7 @@ private:
         if (protocolIs(m_urlToLoad, "data") || protocolIs(m_urlToLoad, "about"))
             return false;
 
-        if (m_tagId == TagId::Link && !m_linkIsStyleSheet)
+        if (m_tagId == TagId::Link && !m_linkIsStyleSheet && !m_linkIsPreconnect)
             return false;
 
         if (m_tagId == TagId::Input && !m_inputIsImage)
@@ -311,6 +319,7 @@ private:
     String m_charset;
     String m_crossOriginMode;
     bool m_linkIsStyleSheet;
+    bool m_linkIsPreconnect;
     String m_mediaAttribute;
     String m_metaContent;
     bool m_metaIsViewport;
@@ -28,6 +28,11 @@
 
 #include "CachedResourceLoader.h"
 #include "Document.h"
+#include "Frame.h"
+#include "FrameLoader.h"
+#include "FrameLoaderClient.h"
+#include "LinkLoader.h"
+#include "Settings.h"
 
 #include "MediaList.h"
 #include "MediaQueryEvaluator.h"
@@ -69,8 +74,43 @@ void HTMLResourcePreloader::preload(std::unique_ptr<PreloadRequest> preload)
         return;
 
     CachedResourceRequest request = preload->resourceRequest(m_document);
+    if (preload->isPreconnect()) {
+        LinkLoader::preconnectTo(request.resourceRequest().url(), m_document);
+        return;
+    }
+
+    prefetchDNSIfNeeded(request.resourceRequest().url(), preload->resourceType());
     m_document.cachedResourceLoader().preload(preload->resourceType(), request, preload->charset());
 }
 
+// Only the first few cross-origin servers get a speculative lookup. They are usually the CDNs that serve
+// most of the page, and guessing further down the page is more likely to be wasted.
+static const unsigned maxAutomaticDNSPrefetches = 4;
+
+// Resources found before the body are the ones named in the first bytes of the document. The scripts and
+// stylesheets among them are fetched right away, which resolves their hosts anyway, but everything else
+// waits in CachedResourceLoader::preload() until the body has a renderer. Resolve their hosts in the meantime.
+void HTMLResourcePreloader::prefetchDNSIfNeeded(const URL& url, CachedResource::Type type)
+{
+#if PLATFORM(IOS)
+    // Nothing is held back on iOS.
+    UNUSED_PARAM(url);
+    UNUSED_PARAM(type);
+#else
+    if (type == CachedResource::Script || type == CachedResource::CSSStyleSheet)
+        return;
+    if (m_document.bodyOrFrameset() || m_prefetchedHosts.size() >= maxAutomaticDNSPrefetches)
+        return;
+    auto* settings = m_document.settings();
+    if (!settings || !settings->preloadDNSPrefetchingEnabled() || !settings->dnsPrefetchingEnabled())
+        return;
+    if (!url.isValid() || !url.protocolIsInHTTPFamily() || url.host() == m_document.url().host())
+        return;
+
+    if (m_prefetchedHosts.add(url.host()).isNewEntry)
+        m_document.frame()->loader().client().prefetchDNS(url.host());
+#endif
+}
+
 
 }
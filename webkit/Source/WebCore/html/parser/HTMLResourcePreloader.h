@@ -28,6 +28,8 @@
 
 #include "CachedResource.h"
 #include "CachedResourceRequest.h"
+#include <wtf/HashSet.h>
+#include <wtf/text/StringHash.h>
 
 namespace WebCore {
 
@@ -50,6 +52,8 @@ public:
     void setCharset(const String& charset) { m_charset = charset.isolatedCopy(); }
     void setCrossOriginMode(const String& mode) { m_crossOriginMode = mode; }
     CachedResource::Type resourceType() const { return m_resourceType; }
+    bool isPreconnect() const { return m_isPreconnect; }
+    void setIsPreconnect(bool isPreconnect) { m_isPreconnect = isPreconnect; }
 
 private:
     URL completeURL(Document&);
@@ -61,6 +65,7 @@ private:
     CachedResource::Type m_resourceType;
     String m_mediaAttribute;
     String m_crossOriginMode;
+    bool m_isPreconnect { false };
 };
 
 typedef Vector<std::unique_ptr<PreloadRequest>> PreloadRequestStream;
@@ -80,7 +85,10 @@ public:
     WeakPtr<HTMLResourcePreloader> createWeakPtr() { return m_weakFactory.createWeakPtr(); }
 
 private:
+    void prefetchDNSIfNeeded(const URL&, CachedResource::Type);
+
     Document& m_document;
+    HashSet<String> m_prefetchedHosts;
     WeakPtrFactory<HTMLResourcePreloader> m_weakFactory;
 };
 
@@ -136,6 +136,18 @@ static void preloadIfNeeded(const LinkRelAttribute& relAttribute, const URL& hre
     document.cachedResourceLoader().preload(type.value(), linkRequest, emptyString());
 }
 
+void LinkLoader::preconnectTo(const URL& url, Document& document)
+{
+    if (!url.isValid() || !url.protocolIsInHTTPFamily())
+        return;
+    document.didReceivePreconnectHint();
+
+    // None of the network backends can open a connection ahead of a request, so only the DNS lookup is saved.
+    Settings* settings = document.settings();
+    if (settings && settings->dnsPrefetchingEnabled() && document.frame())
+        document.frame()->loader().client().prefetchDNS(url.host());
+}
+
 bool LinkLoader::loadLink(const LinkRelAttribute& relAttribute, const URL& href, const String& as, const String& crossOrigin, Document& document)
 {
     if (relAttribute.isDNSPrefetch) {
@@ -146,6 +158,9 @@ bool LinkLoader::loadLink(const LinkRelAttribute& relAttribute, const URL& href,
             document.frame()->loader().client().prefetchDNS(href.host());
     }
 
+    if (relAttribute.isPreconnect)
+        preconnectTo(href, document);
+
     if (m_client.shouldLoadLink())
         preloadIfNeeded(relAttribute, href, document, as, crossOrigin);
 
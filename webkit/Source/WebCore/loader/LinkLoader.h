@@ -52,6 +52,7 @@ public:
 
     bool loadLink(const LinkRelAttribute&, const URL&, const String& as, const String& crossOrigin, Document&);
     static Optional<CachedResource::Type> resourceTypeFromAsAttribute(const String& as);
+    static void preconnectTo(const URL&, Document&);
 
 private:
     void notifyFinished(CachedResource*) override;
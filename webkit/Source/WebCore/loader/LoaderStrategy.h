@@ -27,6 +27,7 @@
 #define LoaderStrategy_h
 
 #include "ResourceHandleTypes.h"
+#include "ResourceLoadPhaseTimes.h"
 #include "ResourceLoadPriority.h"
 #include "ResourceLoaderOptions.h"
 #include <wtf/Vector.h>
@@ -53,6 +54,8 @@ public:
 
     virtual void remove(ResourceLoader*) = 0;
     virtual void setDefersLoading(ResourceLoader*, bool) = 0;
+    // Called after the priority of the request of the loader changed, whether it started loading or not.
+    virtual void setResourceLoadPriority(ResourceLoader*, ResourceLoadPriority) = 0;
     virtual void crossOriginRedirectReceived(ResourceLoader*, const URL& redirectURL) = 0;
 
     virtual void servePendingRequests(ResourceLoadPriority minimumPriority = ResourceLoadPriority::VeryLow) = 0;
@@ -61,6 +64,10 @@ public:
 
     virtual void createPingHandle(NetworkingContext*, ResourceRequest&, bool shouldUseCredentialStorage) = 0;
 
+    // Totals for the loads that finished since the last reset, by the priority they had when they finished.
+    virtual ResourceLoadPhaseTimes loadPhaseTimes(ResourceLoadPriority) = 0;
+    virtual void resetLoadPhaseTimes() = 0;
+
 protected:
     virtual ~LoaderStrategy();
 };
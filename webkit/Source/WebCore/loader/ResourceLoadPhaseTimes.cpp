@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ResourceLoadPhaseTimes.h"
+
+#include "ResourceResponse.h"
+
+namespace WebCore {
+
+void ResourceLoadPhaseTimes::addLoad(double loadQueuedTime, double loadNetworkTime, const ResourceResponse& response)
+{
+    // The network layer reports its own timings in milliseconds from a common origin, or -1 when it does not know.
+    auto& resourceLoadTiming = response.resourceLoadTiming();
+    double loadConnectingTime = 0;
+    int connectionStart = resourceLoadTiming.domainLookupStart >= 0 ? resourceLoadTiming.domainLookupStart : resourceLoadTiming.connectStart;
+    if (connectionStart >= 0 && resourceLoadTiming.connectEnd >= connectionStart)
+        loadConnectingTime = (resourceLoadTiming.connectEnd - connectionStart) / 1000.0;
+    double loadWaitingTime = 0;
+    if (resourceLoadTiming.requestStart >= 0 && resourceLoadTiming.responseStart > resourceLoadTiming.requestStart)
+        loadWaitingTime = (resourceLoadTiming.responseStart - resourceLoadTiming.requestStart) / 1000.0;
+
+    // Our own clock is the one that counts, the reported phases only split it.
+    loadNetworkTime = std::max(loadNetworkTime, 0.0);
+    loadConnectingTime = std::min(loadConnectingTime, loadNetworkTime);
+    loadWaitingTime = std::min(loadWaitingTime, loadNetworkTime - loadConnectingTime);
+
+    ++loadCount;
+    queuedTime += std::max(loadQueuedTime, 0.0);
+    connectingTime += loadConnectingTime;
+    waitingTime += loadWaitingTime;
+    receivingTime += loadNetworkTime - loadConnectingTime - loadWaitingTime;
+}
+
+} // namespace WebCore
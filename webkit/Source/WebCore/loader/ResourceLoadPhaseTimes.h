@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ResourceLoadPhaseTimes_h
+#define ResourceLoadPhaseTimes_h
+
+namespace WebCore {
+
+class ResourceResponse;
+
+// Time spent by finished loads in each phase, in seconds.
+struct ResourceLoadPhaseTimes {
+    unsigned loadCount { 0 };
+    double queuedTime { 0 }; // Waiting for the loader to start the load.
+    double connectingTime { 0 }; // Looking up the host and connecting, when the network layer reports it.
+    double waitingTime { 0 }; // From sending the request to the first byte of the response.
+    double receivingTime { 0 }; // The rest of the time on the network.
+
+    // Adds a load that was queued for queuedTime and then spent networkTime on the network.
+    // The ResourceLoadTiming of the response splits the network time into phases.
+    WEBCORE_EXPORT void addLoad(double queuedTime, double networkTime, const ResourceResponse&);
+
+    template<class Encoder> void encode(Encoder&) const;
+    template<class Decoder> static bool decode(Decoder&, ResourceLoadPhaseTimes&);
+};
+
+template<class Encoder>
+void ResourceLoadPhaseTimes::encode(Encoder& encoder) const
+{
+    encoder << loadCount;
+    encoder << queuedTime;
+    encoder << connectingTime;
+    encoder << waitingTime;
+    encoder << receivingTime;
+}
+
+template<class Decoder>
+bool ResourceLoadPhaseTimes::decode(Decoder& decoder, ResourceLoadPhaseTimes& times)
+{
+    return decoder.decode(times.loadCount)
+        && decoder.decode(times.queuedTime)
+        && decoder.decode(times.connectingTime)
+        && decoder.decode(times.waitingTime)
+        && decoder.decode(times.receivingTime);
+}
+
+} // namespace WebCore
+
+#endif // ResourceLoadPhaseTimes_h
@@ -226,6 +226,18 @@ void ResourceLoader::setDefersLoading(bool defers)
     platformStrategies()->loaderStrategy()->setDefersLoading(this, defers);
 }
 
+void ResourceLoader::setPriority(ResourceLoadPriority priority)
+{
+    if (m_reachedTerminalState || m_request.priority() == priority)
+        return;
+
+    m_request.setPriority(priority);
+    if (m_handle)
+        m_handle->setPriority(priority);
+
+    platformStrategies()->loaderStrategy()->setResourceLoadPriority(this, priority);
+}
+
 FrameLoader* ResourceLoader::frameLoader() const
 {
     if (!m_frame)
@@ -494,7 +506,7 @@ void ResourceLoader::didReceiveDataOrBuffer(const char* data, unsigned length, R
     // However, with today's computers and networking speeds, this won't happen in practice.
     // Could be an issue with a giant local file.
     if (m_options.sendLoadCallbacks() == SendCallbacks && m_frame)
-        frameLoader()->notifier().didReceiveData(this, buffer ? buffer->data() : data, buffer ? buffer->size() : length, static_cast<int>(encodedDataLength));
+        frameLoader()->notifier().didReceiveData(this, buffer ? buffer->flattenedData() : data, buffer ? buffer->size() : length, static_cast<int>(encodedDataLength));
 }
 
 void ResourceLoader::didFinishLoading(double finishTime)
@@ -90,6 +90,8 @@ public:
     virtual void setDefersLoading(bool);
     bool defersLoading() const { return m_defersLoading; }
 
+    WEBCORE_EXPORT void setPriority(ResourceLoadPriority);
+
     unsigned long identifier() const { return m_identifier; }
 
     virtual void releaseResources();
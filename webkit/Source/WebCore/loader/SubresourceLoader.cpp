@@ -326,13 +326,13 @@ void SubresourceLoader::didReceiveDataOrBuffer(const char* data, int length, Ref
     Ref<SubresourceLoader> protectedThis(*this);
     RefPtr<SharedBuffer> buffer = prpBuffer;
     
-    ResourceLoader::didReceiveDataOrBuffer(data, length, WTFMove(buffer), encodedDataLength, dataPayloadType);
+    ResourceLoader::didReceiveDataOrBuffer(data, length, buffer.copyRef(), encodedDataLength, dataPayloadType);
 
     if (!m_loadingMultipartContent) {
         if (auto* resourceData = this->resourceData())
             m_resource->addDataBuffer(*resourceData);
         else
-            m_resource->addData(buffer ? buffer->data() : data, buffer ? buffer->size() : length);
+            m_resource->addData(buffer ? buffer->flattenedData() : data, buffer ? buffer->size() : length);
     }
 }
 
@@ -26,12 +26,14 @@
 #include "DOMImplementation.h"
 #include "HTMLMetaCharsetParser.h"
 #include "HTMLNames.h"
+#include "SharedBuffer.h"
 #include "TextCodec.h"
 #include "TextEncoding.h"
 #include "TextEncodingDetector.h"
 #include "TextEncodingRegistry.h"
 #include <wtf/ASCIICType.h>
 #include <wtf/StringExtras.h>
+#include <wtf/text/StringBuilder.h>
 
 using namespace WTF;
 
@@ -676,4 +678,15 @@ String TextResourceDecoder::decodeAndFlush(const char* data, size_t length)
     return decoded + flush();
 }
 
+String TextResourceDecoder::decodeAndFlush(const SharedBuffer& buffer)
+{
+    StringBuilder result;
+    buffer.forEachSegment([this, &result](const char* segment, unsigned length) {
+        result.append(decode(segment, length));
+        return true;
+    });
+    result.append(flush());
+    return result.toString();
+}
+
 }
@@ -29,6 +29,7 @@
 namespace WebCore {
 
 class HTMLMetaCharsetParser;
+class SharedBuffer;
 
 class TextResourceDecoder : public RefCounted<TextResourceDecoder> {
 public:
@@ -58,6 +59,8 @@ public:
     WEBCORE_EXPORT String flush();
 
     WEBCORE_EXPORT String decodeAndFlush(const char* data, size_t length);
+    // Decodes segment by segment so the buffer doesn't need to be flattened first.
+    String decodeAndFlush(const SharedBuffer&);
 
     void setHintEncoding(const TextResourceDecoder* hintDecoder)
     {
@@ -87,7 +87,7 @@ const String CachedCSSStyleSheet::sheetText(MIMETypeCheck mimeTypeCheck, bool* h
         return m_decodedSheetText;
     
     // Don't cache the decoded text, regenerating is cheap and it can use quite a bit of memory
-    return m_decoder->decodeAndFlush(m_data->data(), m_data->size());
+    return m_decoder->decodeAndFlush(*m_data);
 }
 
 void CachedCSSStyleSheet::finishLoading(SharedBuffer* data)
@@ -96,7 +96,7 @@ void CachedCSSStyleSheet::finishLoading(SharedBuffer* data)
     setEncodedSize(data ? data->size() : 0);
     // Decode the data to find out the encoding and keep the sheet text around during checkNotify()
     if (data)
-        m_decodedSheetText = m_decoder->decodeAndFlush(data->data(), data->size());
+        m_decodedSheetText = m_decoder->decodeAndFlush(*data);
     setLoading(false);
     checkNotify();
     // Clear the decoded text as it is unlikely to be needed immediately again and is cheap to regenerate.
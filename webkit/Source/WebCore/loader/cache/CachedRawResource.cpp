@@ -45,28 +45,15 @@ CachedRawResource::CachedRawResource(ResourceRequest& resourceRequest, Type type
     ASSERT(isMainOrMediaOrRawResource());
 }
 
-const char* CachedRawResource::calculateIncrementalDataChunk(SharedBuffer* data, unsigned& incrementalDataLength)
-{
-    incrementalDataLength = 0;
-    if (!data)
-        return nullptr;
-
-    unsigned previousDataLength = encodedSize();
-    ASSERT(data->size() >= previousDataLength);
-    incrementalDataLength = data->size() - previousDataLength;
-    return data->data() + previousDataLength;
-}
-
 void CachedRawResource::addDataBuffer(SharedBuffer& data)
 {
     CachedResourceHandle<CachedRawResource> protectedThis(this);
     ASSERT(dataBufferingPolicy() == BufferData);
     m_data = &data;
 
-    unsigned incrementalDataLength;
-    const char* incrementalData = calculateIncrementalDataChunk(&data, incrementalDataLength);
+    unsigned previousDataLength = encodedSize();
     setEncodedSize(data.size());
-    notifyClientsDataWasReceived(incrementalData, incrementalDataLength);
+    notifyClientsDataWasReceived(data, previousDataLength);
     if (dataBufferingPolicy() == DoNotBufferData) {
         if (m_loader)
             m_loader->setDataBufferingPolicy(DoNotBufferData);
@@ -91,11 +78,11 @@ void CachedRawResource::finishLoading(SharedBuffer* data)
     if (dataBufferingPolicy == BufferData) {
         m_data = data;
 
-        unsigned incrementalDataLength;
-        const char* incrementalData = calculateIncrementalDataChunk(data, incrementalDataLength);
-        if (data)
+        if (data) {
+            unsigned previousDataLength = encodedSize();
             setEncodedSize(data->size());
-        notifyClientsDataWasReceived(incrementalData, incrementalDataLength);
+            notifyClientsDataWasReceived(*data, previousDataLength);
+        }
     }
 
     m_allowEncodedDataReplacement = !m_loader->isQuickLookResource();
@@ -108,6 +95,18 @@ void CachedRawResource::finishLoading(SharedBuffer* data)
     }
 }
 
+void CachedRawResource::notifyClientsDataWasReceived(SharedBuffer& data, unsigned position)
+{
+    ASSERT(data.size() >= position);
+
+    // Hand out the new bytes segment by segment instead of flattening the whole buffer on every chunk.
+    Ref<SharedBuffer> protectedData(data);
+    data.forEachSegment([this](const char* segment, unsigned length) {
+        notifyClientsDataWasReceived(segment, length);
+        return true;
+    }, position);
+}
+
 void CachedRawResource::notifyClientsDataWasReceived(const char* data, unsigned length)
 {
     if (!length)
@@ -150,8 +149,12 @@ void CachedRawResource::didAddClient(CachedResourceClient* c)
     }
     if (!hasClient(c))
         return;
-    if (m_data)
-        client->dataReceived(this, m_data->data(), m_data->size());
+    if (RefPtr<SharedBuffer> data = m_data) {
+        data->forEachSegment([this, c, client](const char* segment, unsigned length) {
+            client->dataReceived(this, segment, length);
+            return hasClient(c);
+        });
+    }
     if (!hasClient(c))
        return;
     CachedResource::didAddClient(client);
@@ -67,7 +67,7 @@ private:
     void switchClientsToRevalidatedResource() override;
     bool mayTryReplaceEncodedData() const override { return m_allowEncodedDataReplacement; }
 
-    const char* calculateIncrementalDataChunk(SharedBuffer*, unsigned& incrementalDataLength);
+    void notifyClientsDataWasReceived(SharedBuffer&, unsigned position);
     void notifyClientsDataWasReceived(const char* data, unsigned length);
 
 #if USE(SOUP)
@@ -136,7 +136,6 @@ CachedResource::CachedResource(const ResourceRequest& request, Type type, Sessio
     , m_status(Pending)
 #ifndef NDEBUG
     , m_deleted(false)
-    , m_lruIndex(0)
 #endif
     , m_owningCachedResourceLoader(nullptr)
     , m_resourceToRevalidate(nullptr)
@@ -571,18 +570,11 @@ void CachedResource::setDecodedSize(unsigned size)
         return;
 
     int delta = size - m_decodedSize;
-
-    // The object must be moved to a different queue, since its size has been changed.
-    // Remove before updating m_decodedSize, so we find the resource in the correct LRU list.
-    if (allowsCaching() && inCache())
-        MemoryCache::singleton().removeFromLRUList(*this);
-    
     m_decodedSize = size;
    
     if (allowsCaching() && inCache()) {
         auto& memoryCache = MemoryCache::singleton();
-        // Now insert into the new LRU list.
-        memoryCache.insertInLRUList(*this);
+        memoryCache.adjustLRUListSize(*this, delta);
         
         // Insert into or remove from the live decoded list if necessary.
         // When inserting into the LiveDecodedResourcesList it is possible
@@ -608,17 +600,11 @@ void CachedResource::setEncodedSize(unsigned size)
         return;
 
     int delta = size - m_encodedSize;
-
-    // The object must be moved to a different queue, since its size has been changed.
-    // Remove before updating m_encodedSize, so we find the resource in the correct LRU list.
-    if (allowsCaching() && inCache())
-        MemoryCache::singleton().removeFromLRUList(*this);
-
     m_encodedSize = size;
 
     if (allowsCaching() && inCache()) {
         auto& memoryCache = MemoryCache::singleton();
-        memoryCache.insertInLRUList(*this);
+        memoryCache.adjustLRUListSize(*this, delta);
         memoryCache.adjustSize(hasClients(), delta);
     }
 }
@@ -810,10 +796,20 @@ bool CachedResource::areAllClientsXMLHttpRequests() const
 
 void CachedResource::setLoadPriority(const Optional<ResourceLoadPriority>& loadPriority)
 {
-    if (loadPriority)
-        m_loadPriority = loadPriority.value();
-    else
-        m_loadPriority = defaultPriorityForResourceType(type());
+    ResourceLoadPriority priority = loadPriority ? loadPriority.value() : defaultPriorityForResourceType(type());
+
+    // While loading, the priority only goes up. A later, less urgent request for the same resource would
+    // otherwise delay whoever asked first, e.g. the parser waiting for a script that was also preloaded.
+    if (isLoading()) {
+        if (priority <= m_loadPriority)
+            return;
+        m_loadPriority = priority;
+        if (m_loader)
+            m_loader->setPriority(priority);
+        return;
+    }
+
+    m_loadPriority = priority;
 }
 
 inline CachedResource::Callback::Callback(CachedResource& resource, CachedResourceClient& client)
@@ -848,7 +844,18 @@ void CachedResource::tryReplaceEncodedData(SharedBuffer& newBuffer)
     // We have to do the memcmp because we can't tell if the replacement file backed data is for the
     // same resource or if we made a second request with the same URL which gave us a different
     // resource. We have seen this happen for cached POST resources.
-    if (m_data->size() != newBuffer.size() || memcmp(m_data->data(), newBuffer.data(), m_data->size()))
+    if (m_data->size() != newBuffer.size())
+        return;
+
+    // The replacement is platform data and flat already, compare our segments against it without flattening them.
+    const char* newData = newBuffer.flattenedData();
+    bool isEqual = true;
+    m_data->forEachSegment([&newData, &isEqual](const char* segment, unsigned segmentLength) {
+        isEqual = !memcmp(segment, newData, segmentLength);
+        newData += segmentLength;
+        return isEqual;
+    });
+    if (!isEqual)
         return;
 
     if (m_data->tryReplaceContentsWithPlatformBuffer(newBuffer))
@@ -337,7 +337,6 @@ private:
 
 #ifndef NDEBUG
     bool m_deleted;
-    unsigned m_lruIndex;
 #endif
 
     CachedResourceLoader* m_owningCachedResourceLoader; // only non-null for resources that are not in the cache
@@ -71,7 +71,7 @@ bool CachedSVGFont::ensureCustomFontData(const AtomicString& remoteURI)
 
         m_externalSVGDocument = SVGDocument::create(nullptr, URL());
         RefPtr<TextResourceDecoder> decoder = TextResourceDecoder::create("application/xml");
-        m_externalSVGDocument->setContent(decoder->decodeAndFlush(m_data->data(), m_data->size()));
+        m_externalSVGDocument->setContent(decoder->decodeAndFlush(*m_data));
 
         NoEventDispatchAssertion::restoreDropped(count);
 
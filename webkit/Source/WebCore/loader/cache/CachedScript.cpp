@@ -71,32 +71,20 @@ String CachedScript::mimeType() const
 
 StringView CachedScript::script()
 {
-    if (!m_data)
+    if (!m_data || isLoading())
         return { };
 
-    if (m_decodingState == NeverDecoded
-        && TextEncoding(encoding()).isByteBasedEncoding()
-        && m_data->size()
-        && charactersAreAllASCII(reinterpret_cast<const LChar*>(m_data->data()), m_data->size())) {
-
-        m_decodingState = DataAndDecodedStringHaveSameBytes;
-
-        // If the encoded and decoded data are the same, there is no decoded data cost!
-        setDecodedSize(0);
-        m_decodedDataDeletionTimer.stop();
-
-        m_scriptHash = StringHasher::computeHashAndMaskTop8Bits(reinterpret_cast<const LChar*>(m_data->data()), m_data->size());
+    if (m_decodingState == NeverDecoded) {
+        decodeIncrementally();
+        finishIncrementalDecoding();
     }
 
     if (m_decodingState == DataAndDecodedStringHaveSameBytes)
-        return { reinterpret_cast<const LChar*>(m_data->data()), m_data->size() };
+        return { reinterpret_cast<const LChar*>(m_data->flattenedData()), m_data->size() };
 
     if (!m_script) {
-        m_script = m_decoder->decodeAndFlush(m_data->data(), encodedSize());
-        ASSERT(!m_scriptHash || m_scriptHash == m_script.impl()->hash());
-        if (m_decodingState == NeverDecoded)
-            m_scriptHash = m_script.impl()->hash();
-        m_decodingState = DataAndDecodedStringHaveDifferentBytes;
+        m_script = m_decoder->decodeAndFlush(*m_data);
+        ASSERT(m_scriptHash == m_script.impl()->hash());
         setDecodedSize(m_script.sizeInBytes());
     }
 
@@ -111,15 +99,119 @@ unsigned CachedScript::scriptHash()
     return m_scriptHash;
 }
 
+void CachedScript::addDataBuffer(SharedBuffer& data)
+{
+    ASSERT(dataBufferingPolicy() == BufferData);
+    if (m_data && m_data != &data)
+        resetIncrementalDecoding();
+    m_data = &data;
+    decodeIncrementally();
+    CachedResource::addDataBuffer(data);
+}
+
 void CachedScript::finishLoading(SharedBuffer* data)
 {
+    if (m_data != data)
+        resetIncrementalDecoding();
     m_data = data;
     setEncodedSize(data ? data->size() : 0);
+    if (m_data && m_incrementalDecodingState != IncrementalDecodingState::NotStarted) {
+        decodeIncrementally();
+        finishIncrementalDecoding();
+    }
     CachedResource::finishLoading(data);
 }
 
+void CachedScript::error(CachedResource::Status status)
+{
+    resetIncrementalDecoding();
+    CachedResource::error(status);
+}
+
+void CachedScript::decodeIncrementally()
+{
+    ASSERT(m_data);
+    if (m_incrementalDecodingState == IncrementalDecodingState::Disabled)
+        return;
+
+    if (m_incrementalDecodingState == IncrementalDecodingState::NotStarted)
+        m_incrementalDecodingState = TextEncoding(encoding()).isByteBasedEncoding() ? IncrementalDecodingState::AllASCII : IncrementalDecodingState::Decoding;
+
+    if (m_incrementalDecodingState == IncrementalDecodingState::AllASCII) {
+        bool sawNonASCII = false;
+        m_data->forEachSegment([this, &sawNonASCII](const char* segment, unsigned length) {
+            auto* characters = reinterpret_cast<const LChar*>(segment);
+            if (!charactersAreAllASCII(characters, length)) {
+                sawNonASCII = true;
+                return false;
+            }
+            m_incrementalASCIIHasher.addCharacters(characters, length);
+            m_incrementallyDecodedLength += length;
+            return true;
+        }, m_incrementallyDecodedLength);
+        if (!sawNonASCII)
+            return;
+
+        // The decoder has not seen any data yet, so start over from the first byte.
+        m_incrementalDecodingState = IncrementalDecodingState::Decoding;
+        m_incrementallyDecodedLength = 0;
+        m_incrementalASCIIHasher = StringHasher();
+    }
+
+    m_data->forEachSegment([this](const char* segment, unsigned length) {
+        m_incrementallyDecodedScript.append(m_decoder->decode(segment, length));
+        m_incrementallyDecodedLength += length;
+        return true;
+    }, m_incrementallyDecodedLength);
+    setDecodedSize(m_incrementallyDecodedScript.capacity() * (m_incrementallyDecodedScript.is8Bit() ? sizeof(LChar) : sizeof(UChar)));
+}
+
+void CachedScript::finishIncrementalDecoding()
+{
+    ASSERT(m_data);
+    ASSERT(m_incrementallyDecodedLength == m_data->size() || m_incrementalDecodingState == IncrementalDecodingState::Disabled);
+
+    if (m_incrementalDecodingState == IncrementalDecodingState::AllASCII && m_incrementallyDecodedLength) {
+        m_decodingState = DataAndDecodedStringHaveSameBytes;
+
+        // If the encoded and decoded data are the same, there is no decoded data cost!
+        setDecodedSize(0);
+        m_decodedDataDeletionTimer.stop();
+
+        m_scriptHash = m_incrementalASCIIHasher.hashWithTop8BitsMasked();
+    } else if (m_incrementalDecodingState != IncrementalDecodingState::Disabled) {
+        m_incrementallyDecodedScript.append(m_decoder->flush());
+        m_script = m_incrementallyDecodedScript.toString();
+        m_scriptHash = m_script.impl()->hash();
+        m_decodingState = DataAndDecodedStringHaveDifferentBytes;
+        setDecodedSize(m_script.sizeInBytes());
+    }
+
+    // The decoder was flushed above, so there is nothing left for it to discard.
+    m_incrementalDecodingState = IncrementalDecodingState::NotStarted;
+    resetIncrementalDecoding();
+}
+
+void CachedScript::resetIncrementalDecoding()
+{
+    // Flushing discards what the decoder has buffered and readies it to decode from the start again.
+    if (m_incrementalDecodingState == IncrementalDecodingState::Decoding)
+        m_decoder->flush();
+
+    m_incrementalDecodingState = IncrementalDecodingState::NotStarted;
+    m_incrementallyDecodedLength = 0;
+    m_incrementalASCIIHasher = StringHasher();
+    m_incrementallyDecodedScript.clear();
+}
+
 void CachedScript::destroyDecodedData()
 {
+    if (isLoading() && m_incrementalDecodingState == IncrementalDecodingState::Decoding) {
+        // Decode lazily once the load finishes rather than holding on to a partially decoded script.
+        resetIncrementalDecoding();
+        m_incrementalDecodingState = IncrementalDecodingState::Disabled;
+    }
+
     m_script = String();
     setDecodedSize(0);
 }
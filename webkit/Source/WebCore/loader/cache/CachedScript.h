@@ -27,6 +27,8 @@
 #define CachedScript_h
 
 #include "CachedResource.h"
+#include <wtf/Hasher.h>
+#include <wtf/text/StringBuilder.h>
 
 namespace WebCore {
 
@@ -54,10 +56,16 @@ private:
     void setEncoding(const String&) override;
     String encoding() const override;
     const TextResourceDecoder* textResourceDecoder() const override { return m_decoder.get(); }
+    void addDataBuffer(SharedBuffer&) override;
     void finishLoading(SharedBuffer*) override;
+    void error(CachedResource::Status) override;
 
     void destroyDecodedData() override;
 
+    void decodeIncrementally();
+    void finishIncrementalDecoding();
+    void resetIncrementalDecoding();
+
     String m_script;
     unsigned m_scriptHash { 0 };
 
@@ -65,6 +73,14 @@ private:
     DecodingState m_decodingState { NeverDecoded };
 
     RefPtr<TextResourceDecoder> m_decoder;
+
+    // Scripts are decoded as their data arrives, so that they are ready to run as soon as they finish loading.
+    // While every byte seen so far is ASCII, only the hash is computed since the data can be used as is.
+    enum class IncrementalDecodingState { NotStarted, AllASCII, Decoding, Disabled };
+    IncrementalDecodingState m_incrementalDecodingState { IncrementalDecodingState::NotStarted };
+    unsigned m_incrementallyDecodedLength { 0 };
+    StringHasher m_incrementalASCIIHasher;
+    StringBuilder m_incrementallyDecodedScript;
 };
 
 } // namespace WebCore
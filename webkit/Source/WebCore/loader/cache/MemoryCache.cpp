@@ -51,6 +51,7 @@ namespace WebCore {
 static const int cDefaultCacheCapacity = 8192 * 1024;
 static const double cMinDelayBeforeLiveDecodedPrune = 1; // Seconds.
 static const float cTargetPrunePercentage = .95f; // Percentage of capacity toward which we prune, to avoid immediately pruning again.
+static const float cProtectedSegmentPercentage = .8f; // Percentage of capacity resources used more than once can keep.
 static const auto defaultDecodedDataDeletionInterval = std::chrono::seconds { 0 };
 
 MemoryCache& MemoryCache::singleton()
@@ -69,6 +70,10 @@ MemoryCache::MemoryCache()
     , m_deadDecodedDataDeletionInterval(defaultDecodedDataDeletionInterval)
     , m_liveSize(0)
     , m_deadSize(0)
+    , m_protectedSize(0)
+    , m_hitCount(0)
+    , m_missCount(0)
+    , m_evictionCount(0)
     , m_pruneTimer(*this, &MemoryCache::prune)
 {
 }
@@ -273,12 +278,14 @@ void MemoryCache::pruneLiveResources(bool shouldDestroyDecodedDataForAllLiveReso
 
 void MemoryCache::forEachResource(const std::function<void(CachedResource&)>& function)
 {
-    for (auto& unprotectedLRUList : m_allResources) {
-        Vector<CachedResourceHandle<CachedResource>> lruList;
-        copyToVector(*unprotectedLRUList, lruList);
-        for (auto& resource : lruList)
-            function(*resource);
-    }
+    Vector<CachedResourceHandle<CachedResource>> resources;
+    resources.reserveInitialCapacity(m_probationaryResources.size() + m_protectedResources.size());
+    for (auto* resource : m_probationaryResources)
+        resources.uncheckedAppend(resource);
+    for (auto* resource : m_protectedResources)
+        resources.uncheckedAppend(resource);
+    for (auto& resource : resources)
+        function(*resource);
 }
 
 void MemoryCache::forEachSessionResource(SessionID sessionID, const std::function<void (CachedResource&)>& function)
@@ -339,8 +346,7 @@ void MemoryCache::pruneLiveResourcesToSize(unsigned targetSize, bool shouldDestr
             if (!shouldDestroyDecodedDataForAllLiveResources && elapsedTime < cMinDelayBeforeLiveDecodedPrune)
                 return;
 
-            // Destroy our decoded data. This will remove us from m_liveDecodedResources, and possibly move us
-            // to a different LRU list in m_allResources.
+            // Destroy our decoded data. This will remove us from m_liveDecodedResources.
             current->destroyDecodedData();
 
             if (targetSize && m_liveSize <= targetSize)
@@ -351,6 +357,8 @@ void MemoryCache::pruneLiveResourcesToSize(unsigned targetSize, bool shouldDestr
 
 void MemoryCache::pruneDeadResources()
 {
+    pruneDeadResourcesOverTypeCapacities();
+
     unsigned capacity = deadCapacity();
     if (capacity && m_deadSize <= capacity)
         return;
@@ -368,50 +376,93 @@ void MemoryCache::pruneDeadResourcesToSize(unsigned targetSize)
     if (targetSize && m_deadSize <= targetSize)
         return;
 
-    bool canShrinkLRULists = true;
-    for (int i = m_allResources.size() - 1; i >= 0; i--) {
-        // Make a copy of the LRUList first (and ref the resources) as calling
-        // destroyDecodedData() can alter the LRUList.
-        Vector<CachedResourceHandle<CachedResource>> lruList;
-        copyToVector(*m_allResources[i], lruList);
-
-        // First flush all the decoded data in this queue.
-        // Remove from the head, since this is the least frequently accessed of the objects.
-        for (auto& resource : lruList) {
-            if (!resource->inCache())
-                continue;
+    auto isDone = [this, targetSize] {
+        return targetSize && m_deadSize <= targetSize;
+    };
 
-            if (!resource->hasClients() && !resource->isPreloaded() && resource->isLoaded()) {
-                // Destroy our decoded data. This will remove us from 
-                // m_liveDecodedResources, and possibly move us to a different 
-                // LRU list in m_allResources.
-                resource->destroyDecodedData();
+    // Decoded data can be rebuilt from the encoded data without going back to the network, so it
+    // all goes before any resource is evicted. Resources on probation go first at each step.
+    if (destroyDecodedDataOfDeadResources(m_probationaryResources, nullptr, isDone))
+        return;
+    if (destroyDecodedDataOfDeadResources(m_protectedResources, nullptr, isDone))
+        return;
+    if (evictDeadResources(m_probationaryResources, nullptr, isDone))
+        return;
+    evictDeadResources(m_protectedResources, nullptr, isDone);
+}
 
-                if (targetSize && m_deadSize <= targetSize)
-                    return;
-            }
+void MemoryCache::pruneDeadResourcesOverTypeCapacities()
+{
+    if (m_inPruneResources)
+        return;
+    TemporaryChange<bool> reentrancyProtector(m_inPruneResources, true);
+
+    for (unsigned type = 0; type < m_typeCapacities.size(); ++type) {
+        unsigned capacity = m_typeCapacities[type].capacity;
+        if (!capacity || m_typeCapacities[type].deadSize <= capacity)
+            continue;
+
+        unsigned targetSize = static_cast<unsigned>(capacity * cTargetPrunePercentage);
+        auto isOfType = [type] (CachedResource& resource) {
+            return static_cast<unsigned>(resource.type()) == type;
+        };
+        auto isDone = [this, type, targetSize] {
+            return m_typeCapacities[type].deadSize <= targetSize;
+        };
+
+        if (destroyDecodedDataOfDeadResources(m_probationaryResources, isOfType, isDone))
+            continue;
+        if (destroyDecodedDataOfDeadResources(m_protectedResources, isOfType, isDone))
+            continue;
+        if (evictDeadResources(m_probationaryResources, isOfType, isDone))
+            continue;
+        evictDeadResources(m_protectedResources, isOfType, isDone);
+    }
+}
+
+bool MemoryCache::destroyDecodedDataOfDeadResources(LRUList& list, const std::function<bool (CachedResource&)>& filter, const std::function<bool ()>& isDone)
+{
+    // Make a copy of the LRUList first (and ref the resources) as calling
+    // destroyDecodedData() can alter the LRUList.
+    Vector<CachedResourceHandle<CachedResource>> lruList;
+    copyToVector(list, lruList);
+
+    for (auto& resource : lruList) {
+        if (!resource->inCache())
+            continue;
+        if (filter && !filter(*resource))
+            continue;
+
+        if (!resource->hasClients() && !resource->isPreloaded() && resource->isLoaded()) {
+            // Destroy our decoded data. This will remove us from m_liveDecodedResources.
+            resource->destroyDecodedData();
+
+            if (isDone())
+                return true;
         }
+    }
+    return false;
+}
 
-        // Now evict objects from this list.
-        // Remove from the head, since this is the least frequently accessed of the objects.
-        for (auto& resource : lruList) {
-            if (!resource->inCache())
-                continue;
+bool MemoryCache::evictDeadResources(LRUList& list, const std::function<bool (CachedResource&)>& filter, const std::function<bool ()>& isDone)
+{
+    Vector<CachedResourceHandle<CachedResource>> lruList;
+    copyToVector(list, lruList);
 
-            if (!resource->hasClients() && !resource->isPreloaded() && !resource->isCacheValidator()) {
-                remove(*resource);
-                if (targetSize && m_deadSize <= targetSize)
-                    return;
-            }
+    for (auto& resource : lruList) {
+        if (!resource->inCache())
+            continue;
+        if (filter && !filter(*resource))
+            continue;
+
+        if (!resource->hasClients() && !resource->isPreloaded() && !resource->isCacheValidator()) {
+            ++m_evictionCount;
+            remove(*resource);
+            if (isDone())
+                return true;
         }
-            
-        // Shrink the vector back down so we don't waste time inspecting
-        // empty LRU lists on future prunes.
-        if (!m_allResources[i]->isEmpty())
-            canShrinkLRULists = false;
-        else if (canShrinkLRULists)
-            m_allResources.shrink(i);
     }
+    return false;
 }
 
 void MemoryCache::setCapacities(unsigned minDeadBytes, unsigned maxDeadBytes, unsigned totalBytes)
@@ -421,6 +472,24 @@ void MemoryCache::setCapacities(unsigned minDeadBytes, unsigned maxDeadBytes, un
     m_minDeadCapacity = minDeadBytes;
     m_maxDeadCapacity = maxDeadBytes;
     m_capacity = totalBytes;
+    demoteProtectedResourcesIfNeeded();
+    prune();
+}
+
+void MemoryCache::setCapacityForType(CachedResource::Type type, unsigned bytes)
+{
+    if (m_typeCapacities.size() <= type)
+        m_typeCapacities.grow(type + 1);
+
+    // Dead sizes are only kept up to date for the types in the vector.
+    for (auto& typeCapacity : m_typeCapacities)
+        typeCapacity.deadSize = 0;
+    for (auto* resource : m_probationaryResources)
+        adjustTypeSize(*resource, resource->size());
+    for (auto* resource : m_protectedResources)
+        adjustTypeSize(*resource, resource->size());
+
+    m_typeCapacities[type].capacity = bytes;
     prune();
 }
 
@@ -456,18 +525,21 @@ void MemoryCache::remove(CachedResource& resource)
     resource.deleteIfPossible();
 }
 
-auto MemoryCache::lruListFor(CachedResource& resource) -> LRUList&
+unsigned MemoryCache::protectedCapacity() const
 {
-    unsigned accessCount = std::max(resource.accessCount(), 1U);
-    unsigned queueIndex = WTF::fastLog2(resource.size() / accessCount);
-#ifndef NDEBUG
-    resource.m_lruIndex = queueIndex;
-#endif
+    return static_cast<unsigned>(m_capacity * cProtectedSegmentPercentage);
+}
 
-    m_allResources.reserveCapacity(queueIndex + 1);
-    while (m_allResources.size() <= queueIndex)
-        m_allResources.uncheckedAppend(std::make_unique<LRUList>());
-    return *m_allResources[queueIndex];
+void MemoryCache::demoteProtectedResourcesIfNeeded()
+{
+    // Resources that went unused the longest get another chance on probation.
+    unsigned capacity = protectedCapacity();
+    while (m_protectedSize > capacity && !m_protectedResources.isEmpty()) {
+        CachedResource* resource = m_protectedResources.takeFirst();
+        m_protectedSize -= resource->size();
+        auto addResult = m_probationaryResources.add(resource);
+        ASSERT_UNUSED(addResult, addResult.isNewEntry);
+    }
 }
 
 void MemoryCache::removeFromLRUList(CachedResource& resource)
@@ -476,16 +548,15 @@ void MemoryCache::removeFromLRUList(CachedResource& resource)
     if (!resource.accessCount())
         return;
 
-#if !ASSERT_DISABLED
-    unsigned oldListIndex = resource.m_lruIndex;
-#endif
+    adjustTypeSize(resource, -static_cast<int>(resource.size()));
 
-    LRUList& list = lruListFor(resource);
-
-    // Verify that the list we got is the list we want.
-    ASSERT(resource.m_lruIndex == oldListIndex);
+    if (m_protectedResources.remove(&resource)) {
+        ASSERT(m_protectedSize >= resource.size());
+        m_protectedSize -= resource.size();
+        return;
+    }
 
-    bool removed = list.remove(&resource);
+    bool removed = m_probationaryResources.remove(&resource);
     ASSERT_UNUSED(removed, removed);
 }
 
@@ -493,9 +564,57 @@ void MemoryCache::insertInLRUList(CachedResource& resource)
 {
     ASSERT(resource.inCache());
     ASSERT(resource.accessCount() > 0);
-    
-    auto addResult = lruListFor(resource).add(&resource);
+
+    adjustTypeSize(resource, resource.size());
+
+    if (resource.accessCount() == 1) {
+        auto addResult = m_probationaryResources.add(&resource);
+        ASSERT_UNUSED(addResult, addResult.isNewEntry);
+        return;
+    }
+
+    auto addResult = m_protectedResources.add(&resource);
     ASSERT_UNUSED(addResult, addResult.isNewEntry);
+    m_protectedSize += resource.size();
+    demoteProtectedResourcesIfNeeded();
+}
+
+void MemoryCache::adjustLRUListSize(CachedResource& resource, int delta)
+{
+    if (!resource.accessCount())
+        return;
+
+    adjustTypeSize(resource, delta);
+
+    if (m_protectedResources.contains(&resource)) {
+        ASSERT(delta >= 0 || static_cast<int>(m_protectedSize) + delta >= 0);
+        m_protectedSize += delta;
+        demoteProtectedResourcesIfNeeded();
+    }
+}
+
+void MemoryCache::adjustTypeSize(CachedResource& resource, int delta)
+{
+    // Live resources can't be pruned, so only dead ones count against the type capacities.
+    if (!resource.hasClients())
+        adjustTypeDeadSize(resource.type(), delta);
+}
+
+void MemoryCache::adjustTypeDeadSize(CachedResource::Type type, int delta)
+{
+    if (type < m_typeCapacities.size()) {
+        ASSERT(delta >= 0 || static_cast<int>(m_typeCapacities[type].deadSize) + delta >= 0);
+        m_typeCapacities[type].deadSize += delta;
+    }
+}
+
+bool MemoryCache::typesNeedPruning() const
+{
+    for (auto& typeCapacity : m_typeCapacities) {
+        if (typeCapacity.capacity && typeCapacity.deadSize > typeCapacity.capacity)
+            return true;
+    }
+    return false;
 }
 
 void MemoryCache::resourceAccessed(CachedResource& resource)
@@ -507,8 +626,11 @@ void MemoryCache::resourceAccessed(CachedResource& resource)
     removeFromLRUList(resource);
     
     // If this is the first time the resource has been accessed, adjust the size of the cache to account for its initial size.
-    if (!resource.accessCount())
+    if (!resource.accessCount()) {
         adjustSize(resource.hasClients(), resource.size());
+        ++m_missCount;
+    } else
+        ++m_hitCount;
     
     // Add to our access count.
     resource.increaseAccessCount();
@@ -633,12 +755,17 @@ void MemoryCache::addToLiveResourcesSize(CachedResource& resource)
 {
     m_liveSize += resource.size();
     m_deadSize -= resource.size();
+    // Only resources in the LRU lists are counted per type.
+    if (resource.accessCount())
+        adjustTypeDeadSize(resource.type(), -static_cast<int>(resource.size()));
 }
 
 void MemoryCache::removeFromLiveResourcesSize(CachedResource& resource)
 {
     m_liveSize -= resource.size();
     m_deadSize += resource.size();
+    if (resource.accessCount())
+        adjustTypeDeadSize(resource.type(), resource.size());
 }
 
 void MemoryCache::adjustSize(bool live, int delta)
@@ -708,6 +835,10 @@ MemoryCache::Statistics MemoryCache::getStatistics()
             }
         }
     }
+
+    stats.hitCount = m_hitCount;
+    stats.missCount = m_missCount;
+    stats.evictionCount = m_evictionCount;
     return stats;
 }
 
@@ -745,7 +876,7 @@ void MemoryCache::evictResources(SessionID sessionID)
 
 bool MemoryCache::needsPruning() const
 {
-    return m_liveSize + m_deadSize > m_capacity || m_deadSize > m_maxDeadCapacity;
+    return m_liveSize + m_deadSize > m_capacity || m_deadSize > m_maxDeadCapacity || typesNeedPruning();
 }
 
 void MemoryCache::prune()
@@ -779,21 +910,23 @@ void MemoryCache::dumpStats()
 #endif
     printf("%-13s %13d %13d %13d %13d\n", "JavaScript", s.scripts.count, s.scripts.size, s.scripts.liveSize, s.scripts.decodedSize);
     printf("%-13s %13d %13d %13d %13d\n", "Fonts", s.fonts.count, s.fonts.size, s.fonts.liveSize, s.fonts.decodedSize);
-    printf("%-13s %-13s %-13s %-13s %-13s\n\n", "-------------", "-------------", "-------------", "-------------", "-------------");
+    printf("%-13s %-13s %-13s %-13s %-13s\n", "-------------", "-------------", "-------------", "-------------", "-------------");
+    printf("Hits %u, misses %u, evictions %u\n\n", s.hitCount, s.missCount, s.evictionCount);
 }
 
 void MemoryCache::dumpLRULists(bool includeLive) const
 {
-    printf("LRU-SP lists in eviction order (Kilobytes decoded, Kilobytes encoded, Access count, Referenced):\n");
+    printf("SLRU segments in eviction order (Kilobytes decoded, Kilobytes encoded, Access count, Referenced):\n");
 
-    int size = m_allResources.size();
-    for (int i = size - 1; i >= 0; i--) {
-        printf("\n\nList %d: ", i);
-        for (auto* resource : *m_allResources[i]) {
+    auto dumpList = [includeLive] (const char* name, const LRUList& list) {
+        printf("\n\n%s: ", name);
+        for (auto* resource : list) {
             if (includeLive || !resource->hasClients())
                 printf("(%.1fK, %.1fK, %uA, %dR); ", resource->decodedSize() / 1024.0f, (resource->encodedSize() + resource->overheadSize()) / 1024.0f, resource->accessCount(), resource->hasClients());
         }
-    }
+    };
+    dumpList("Probationary", m_probationaryResources);
+    dumpList("Protected", m_protectedResources);
 }
 #endif
 
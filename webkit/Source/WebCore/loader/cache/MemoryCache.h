@@ -25,6 +25,7 @@
 #ifndef Cache_h
 #define Cache_h
 
+#include "CachedResource.h"
 #include "NativeImagePtr.h"
 #include "SecurityOriginHash.h"
 #include "SessionID.h"
@@ -40,7 +41,6 @@
 
 namespace WebCore  {
 
-class CachedResource;
 class URL;
 class ResourceRequest;
 class ResourceResponse;
@@ -60,6 +60,11 @@ class SecurityOrigin;
 // -------|-----+++++++++++++++|
 // -------|-----+++++++++++++++|+++++
 
+// Resources are kept in a segmented LRU. They enter the probationary segment and move to the
+// protected segment when they are used again, so a page loading many resources only once can't
+// push out the ones that keep being reused. Optional per-type capacities keep one type of
+// resource from taking over the cache.
+
 class MemoryCache {
     WTF_MAKE_NONCOPYABLE(MemoryCache); WTF_MAKE_FAST_ALLOCATED;
     friend NeverDestroyed<MemoryCache>;
@@ -88,6 +93,11 @@ public:
         TypeStatistic scripts;
         TypeStatistic xslStyleSheets;
         TypeStatistic fonts;
+
+        // Since the cache was created. Evictions only count resources pruned to stay within capacity.
+        unsigned hitCount { 0 };
+        unsigned missCount { 0 };
+        unsigned evictionCount { 0 };
     };
 
     WEBCORE_EXPORT static MemoryCache& singleton();
@@ -112,6 +122,11 @@ public:
     //  - maxDeadBytes: The maximum number of bytes that dead resources should consume when the cache is not under pressure.
     //  - totalBytes: The maximum number of bytes that the cache should consume overall.
     WEBCORE_EXPORT void setCapacities(unsigned minDeadBytes, unsigned maxDeadBytes, unsigned totalBytes);
+    unsigned maxDeadCapacity() const { return m_maxDeadCapacity; }
+
+    // Sets the maximum number of bytes that dead resources of the given type should consume, 0 meaning no limit.
+    // Dead resources of a type over its capacity are pruned before any other.
+    WEBCORE_EXPORT void setCapacityForType(CachedResource::Type, unsigned bytes);
 
     // Turn the cache on and off.  Disabling the cache will remove all resources from the cache.  They may
     // still live on if they are referenced by some Web page though.
@@ -134,6 +149,8 @@ public:
 
     // Called to adjust the cache totals when a resource changes size.
     void adjustSize(bool live, int delta);
+    // Called before adjustSize() for resources in the LRU lists, which stay where they are.
+    void adjustLRUListSize(CachedResource&, int delta);
 
     // Track decoded resources that are in the cache and referenced by a Web page.
     void insertInLiveDecodedResourcesList(CachedResource&);
@@ -178,7 +195,22 @@ private:
     MemoryCache();
     ~MemoryCache(); // Not implemented to make sure nobody accidentally calls delete -- WebCore does not delete singletons.
 
-    LRUList& lruListFor(CachedResource&);
+    struct TypeCapacity {
+        unsigned capacity { 0 };
+        unsigned deadSize { 0 };
+    };
+
+    unsigned protectedCapacity() const;
+    void demoteProtectedResourcesIfNeeded();
+    void adjustTypeSize(CachedResource&, int delta);
+    void adjustTypeDeadSize(CachedResource::Type, int delta);
+    bool typesNeedPruning() const;
+    void pruneDeadResourcesOverTypeCapacities();
+
+    // Return true once isDone() does, going from the least recently used resource.
+    bool destroyDecodedDataOfDeadResources(LRUList&, const std::function<bool (CachedResource&)>& filter, const std::function<bool ()>& isDone);
+    bool evictDeadResources(LRUList&, const std::function<bool (CachedResource&)>& filter, const std::function<bool ()>& isDone);
+
 #ifndef NDEBUG
     void dumpStats();
     void dumpLRULists(bool includeLive) const;
@@ -204,11 +236,20 @@ private:
     unsigned m_liveSize; // The number of bytes currently consumed by "live" resources in the cache.
     unsigned m_deadSize; // The number of bytes currently consumed by "dead" resources in the cache.
 
-    // Size-adjusted and popularity-aware LRU list collection for cache objects.  This collection can hold
-    // more resources than the cached resource map, since it can also hold "stale" multiple versions of objects that are
-    // waiting to die when the clients referencing them go away.
-    Vector<std::unique_ptr<LRUList>, 32> m_allResources;
-    
+    // Segmented LRU lists for cache objects, least recently used first. These can hold more resources than the
+    // cached resource map, since they can also hold "stale" multiple versions of objects that are waiting to die
+    // when the clients referencing them go away.
+    LRUList m_probationaryResources;
+    LRUList m_protectedResources;
+    unsigned m_protectedSize; // The number of bytes consumed by resources in the protected segment.
+
+    // Indexed by CachedResource::Type.
+    Vector<TypeCapacity> m_typeCapacities;
+
+    unsigned m_hitCount;
+    unsigned m_missCount;
+    unsigned m_evictionCount;
+
     // List just for live resources with decoded data.  Access to this list is based off of painting the resource.
     LRUList m_liveDecodedResources;
     
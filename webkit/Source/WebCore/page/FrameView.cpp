@@ -133,7 +133,8 @@ static RenderLayer::UpdateLayerPositionsFlags updateLayerPositionFlags(RenderLay
     if (didFullRepaint) {
         flags &= ~RenderLayer::CheckForRepaint;
         flags |= RenderLayer::NeedsFullRepaintInBacking;
-    }
+    } else
+        flags |= RenderLayer::UpdateOnlyDirtyLayers;
     if (isRelayoutingSubtree && layer->enclosingPaginationLayer(RenderLayer::IncludeCompositedPaginatedLayers))
         flags |= RenderLayer::UpdatePagination;
     return flags;
@@ -1454,6 +1455,9 @@ void FrameView::layout(bool allowSubtree)
 
     ASSERT(!root->needsLayout());
 
+    // Only renderers with layers mark themselves when laid out. The layout root may have moved the layers it
+    // contains without having one.
+    layer->setNeedsPositionUpdate();
     layer->updateLayerPositionsAfterLayout(renderView()->layer(), updateLayerPositionFlags(layer, subtree, m_needsFullRepaint));
 
     updateCompositingLayersAfterLayout();
@@ -46,6 +46,10 @@
 #include <wtf/FastMalloc.h>
 #include <wtf/StdLibExtras.h>
 
+#if USE(HARFBUZZ)
+#include "HarfBuzzShapeCache.h"
+#endif
+
 namespace WebCore {
 
 WEBCORE_EXPORT bool MemoryPressureHandler::ReliefLogger::s_loggingEnabled = false;
@@ -76,6 +80,14 @@ MemoryPressureHandler::MemoryPressureHandler()
 
 void MemoryPressureHandler::releaseNoncriticalMemory()
 {
+#if USE(HARFBUZZ)
+    {
+        // The shaped words keep their fonts alive, so drop them before purging the fonts.
+        ReliefLogger log("Clear HarfBuzz shape cache");
+        HarfBuzzShapeCache::singleton().clear();
+    }
+#endif
+
     {
         ReliefLogger log("Purge inactive FontData");
         FontCache::singleton().purgeInactiveFontData();
@@ -36,28 +36,9 @@ namespace WebCore {
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
 
 static const unsigned segmentSize = 0x1000;
-static const unsigned segmentPositionMask = 0x0FFF;
 
-static inline unsigned segmentIndex(unsigned position)
-{
-    return position / segmentSize;
-}
-
-static inline unsigned offsetInSegment(unsigned position)
-{
-    return position & segmentPositionMask;
-}
-
-static inline char* allocateSegment() WARN_UNUSED_RETURN;
-static inline char* allocateSegment()
-{
-    return static_cast<char*>(fastMalloc(segmentSize));
-}
-
-static inline void freeSegment(char* p)
-{
-    fastFree(p);
-}
+// Below this size appending a buffer copies its bytes rather than adding references to its segments.
+static const unsigned minimumSharedAppendSize = segmentSize;
 
 #endif
 
@@ -125,7 +106,7 @@ unsigned SharedBuffer::size() const
     return m_size;
 }
 
-const char* SharedBuffer::data() const
+const char* SharedBuffer::flattenedData() const
 {
     if (hasPlatformData())
         return platformData();
@@ -172,6 +153,11 @@ void SharedBuffer::append(SharedBuffer& data)
 #if USE(NETWORK_CFDATA_ARRAY_CALLBACK)
     if (maybeAppendDataArray(data))
         return;
+#else
+    if (data.size() >= minimumSharedAppendSize && &data != this) {
+        appendSharedSegments(data, 0, data.size());
+        return;
+    }
 #endif
 
     const char* segment;
@@ -191,37 +177,38 @@ void SharedBuffer::append(const char* data, unsigned length)
     maybeTransferPlatformData();
 
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    unsigned positionInSegment = offsetInSegment(m_size - m_buffer->data.size());
-    m_size += length;
-
-    if (m_size <= segmentSize) {
+    if (m_size + length <= segmentSize && m_segments.isEmpty()) {
         // No need to use segments for small resource data
+        m_size += length;
         if (m_buffer->data.isEmpty())
             m_buffer->data.reserveInitialCapacity(length);
         appendToDataBuffer(data, length);
         return;
     }
 
-    char* segment;
-    if (!positionInSegment) {
-        segment = allocateSegment();
-        m_segments.append(segment);
-    } else
-        segment = m_segments.last() + positionInSegment;
-
-    unsigned segmentFreeSpace = segmentSize - positionInSegment;
-    unsigned bytesToCopy = std::min(length, segmentFreeSpace);
-
-    for (;;) {
-        memcpy(segment, data, bytesToCopy);
-        if (static_cast<unsigned>(length) == bytesToCopy)
-            break;
+    while (length) {
+        // The last segment may only grow in place if no other buffer shares it. Its capacity is
+        // fixed, so pointers handed out by getSomeData() stay valid.
+        bool canGrowLastSegment = false;
+        if (!m_segments.isEmpty()) {
+            auto& last = m_segments.last();
+            auto& lastData = last.buffer->data;
+            canGrowLastSegment = last.buffer->hasOneRef() && last.offset + last.length == lastData.size() && lastData.size() < lastData.capacity();
+        }
+        if (!canGrowLastSegment) {
+            auto buffer = adoptRef(*new DataBuffer);
+            buffer->data.reserveInitialCapacity(segmentSize);
+            appendSegment(WTFMove(buffer), 0, 0);
+        }
 
-        length -= bytesToCopy;
+        auto& segment = m_segments.last();
+        auto& segmentData = segment.buffer->data;
+        unsigned bytesToCopy = std::min<unsigned>(length, segmentData.capacity() - segmentData.size());
+        segmentData.append(data, bytesToCopy);
+        segment.length += bytesToCopy;
+        m_size += bytesToCopy;
         data += bytesToCopy;
-        segment = allocateSegment();
-        m_segments.append(segment);
-        bytesToCopy = std::min(length, segmentSize);
+        length -= bytesToCopy;
     }
 #else
     m_size += length;
@@ -243,8 +230,6 @@ void SharedBuffer::clear()
     clearPlatformData();
     
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    for (char* segment : m_segments)
-        freeSegment(segment);
     m_segments.clear();
 #else
     m_dataArray.clear();
@@ -259,24 +244,17 @@ Ref<SharedBuffer> SharedBuffer::copy() const
     Ref<SharedBuffer> clone { adoptRef(*new SharedBuffer) };
 
     if (hasPlatformData() || m_fileData) {
-        clone->append(data(), size());
+        clone->append(flattenedData(), size());
         return clone;
     }
 
+#if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
+    clone->appendSharedSegments(*this, 0, m_size);
+#else
     clone->m_size = m_size;
     clone->m_buffer->data.reserveCapacity(m_size);
     clone->m_buffer->data.append(m_buffer->data.data(), m_buffer->data.size());
 
-#if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    if (!m_segments.isEmpty()) {
-        unsigned lastIndex = m_segments.size() - 1;
-        for (unsigned i = 0; i < lastIndex; ++i)
-            clone->m_buffer->data.append(m_segments[i], segmentSize);
-
-        unsigned sizeOfLastSegment = m_size - m_buffer->data.size() - lastIndex * segmentSize;
-        clone->m_buffer->data.append(m_segments.last(), sizeOfLastSegment);
-    }
-#else
     for (auto& data : m_dataArray)
         clone->m_dataArray.append(data.get());
 #endif
@@ -285,6 +263,63 @@ Ref<SharedBuffer> SharedBuffer::copy() const
     return clone;
 }
 
+Ref<SharedBuffer> SharedBuffer::slice(unsigned offset, unsigned length) const
+{
+    ASSERT(offset <= size());
+    ASSERT(length <= size() - offset);
+
+    Ref<SharedBuffer> slice { adoptRef(*new SharedBuffer) };
+    slice->appendSharedSegments(*this, offset, length);
+    ASSERT(slice->size() == length);
+    return slice;
+}
+
+void SharedBuffer::appendSharedSegments(const SharedBuffer& source, unsigned offset, unsigned length)
+{
+#if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
+    if (!source.hasPlatformData() && !source.m_fileData) {
+        maybeTransferMappedFileData();
+        maybeTransferPlatformData();
+
+        // Collect first as the source may be this buffer.
+        Vector<DataSegment> segments;
+        unsigned consecutiveSize = source.m_buffer->data.size();
+        if (offset < consecutiveSize && length) {
+            unsigned segmentLength = std::min(length, consecutiveSize - offset);
+            segments.append({ source.m_buffer.ptr(), offset, segmentLength, 0 });
+            length -= segmentLength;
+            offset = consecutiveSize;
+        }
+        offset -= std::min(offset, consecutiveSize);
+        for (auto& segment : source.m_segments) {
+            if (!length)
+                break;
+            if (offset >= segment.length) {
+                offset -= segment.length;
+                continue;
+            }
+            unsigned segmentLength = std::min(length, segment.length - offset);
+            segments.append({ segment.buffer, segment.offset + offset, segmentLength, 0 });
+            length -= segmentLength;
+            offset = 0;
+        }
+        ASSERT(!length);
+
+        for (auto& segment : segments)
+            appendSegment(WTFMove(segment.buffer), segment.offset, segment.length);
+        return;
+    }
+#endif
+
+    // Platform data can't be shared, copy the bytes instead.
+    source.forEachSegment([this, &length](const char* segment, unsigned segmentLength) {
+        segmentLength = std::min(segmentLength, length);
+        append(segment, segmentLength);
+        length -= segmentLength;
+        return length > 0;
+    }, offset);
+}
+
 void SharedBuffer::duplicateDataBufferIfNecessary() const
 {
     size_t currentCapacity = m_buffer->data.capacity();
@@ -322,16 +357,30 @@ void SharedBuffer::hintMemoryNotNeededSoon()
 
 void SharedBuffer::copyBufferAndClear(char* destination, unsigned bytesToCopy) const
 {
-    for (char* segment : m_segments) {
-        unsigned effectiveBytesToCopy = std::min(bytesToCopy, segmentSize);
-        memcpy(destination, segment, effectiveBytesToCopy);
+    for (auto& segment : m_segments) {
+        unsigned effectiveBytesToCopy = std::min(bytesToCopy, segment.length);
+        memcpy(destination, segment.data(), effectiveBytesToCopy);
         destination += effectiveBytesToCopy;
         bytesToCopy -= effectiveBytesToCopy;
-        freeSegment(segment);
     }
     m_segments.clear();
 }
 
+unsigned SharedBuffer::segmentedSize() const
+{
+    if (m_segments.isEmpty())
+        return 0;
+    auto& last = m_segments.last();
+    return last.position + last.length;
+}
+
+void SharedBuffer::appendSegment(RefPtr<DataBuffer>&& segmentBuffer, unsigned offset, unsigned length)
+{
+    unsigned position = segmentedSize();
+    m_segments.append({ WTFMove(segmentBuffer), offset, length, position });
+    m_size += length;
+}
+
 #endif
 
 const Vector<char>& SharedBuffer::buffer() const
@@ -355,7 +404,7 @@ unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) con
 
     if (hasPlatformData() || m_fileData) {
         ASSERT_WITH_SECURITY_IMPLICATION(position < size());
-        someData = data() + position;
+        someData = flattenedData() + position;
         return totalSize - position;
     }
 
@@ -368,16 +417,17 @@ unsigned SharedBuffer::getSomeData(const char*& someData, unsigned position) con
  
     position -= consecutiveSize;
 #if !USE(NETWORK_CFDATA_ARRAY_CALLBACK)
-    unsigned segments = m_segments.size();
-    unsigned maxSegmentedSize = segments * segmentSize;
-    unsigned segment = segmentIndex(position);
-    if (segment < segments) {
-        unsigned bytesLeft = totalSize - consecutiveSize;
-        unsigned segmentedSize = std::min(maxSegmentedSize, bytesLeft);
-
-        unsigned positionInSegment = offsetInSegment(position);
-        someData = m_segments[segment] + positionInSegment;
-        return segment == segments - 1 ? segmentedSize - position : segmentSize - positionInSegment;
+    // Segments can have different lengths once buffers share them, find the last one starting at or before the position.
+    auto next = std::upper_bound(m_segments.begin(), m_segments.end(), position, [](unsigned position, const DataSegment& segment) {
+        return position < segment.position;
+    });
+    if (next != m_segments.begin()) {
+        auto& segment = *(next - 1);
+        unsigned positionInSegment = position - segment.position;
+        if (positionInSegment < segment.length) {
+            someData = segment.data() + positionInSegment;
+            return segment.length - positionInSegment;
+        }
     }
     ASSERT_NOT_REACHED();
     return 0;
@@ -77,9 +77,11 @@ public:
 #endif
 
     // Calling this function will force internal segmented buffers
-    // to be merged into a flat buffer. Use getSomeData() whenever possible
-    // for better performance.
-    WEBCORE_EXPORT const char* data() const;
+    // to be merged into a flat buffer, copying every byte. Use forEachSegment()
+    // or getSomeData() whenever possible for better performance.
+    WEBCORE_EXPORT const char* flattenedData() const;
+    // Same as flattenedData(), kept for existing callers. New code should not use it.
+    const char* data() const { return flattenedData(); }
     // Creates an ArrayBuffer and copies this SharedBuffer's contents to that
     // ArrayBuffer without merging segmented buffers into a flat buffer.
     WEBCORE_EXPORT RefPtr<ArrayBuffer> createArrayBuffer() const;
@@ -102,7 +104,10 @@ public:
     void append(CFDataRef);
 #endif
 
+    // The copy and the slice share the segments of this buffer rather than copying the bytes.
+    // Buffers backed by platform or mapped file data are still copied.
     WEBCORE_EXPORT Ref<SharedBuffer> copy() const;
+    WEBCORE_EXPORT Ref<SharedBuffer> slice(unsigned offset, unsigned length) const;
     
     // Return the number of consecutive bytes after "position". "data"
     // points to the first byte.
@@ -118,6 +123,18 @@ public:
     //      }
     WEBCORE_EXPORT unsigned getSomeData(const char*& data, unsigned position = 0) const;
 
+    // Calls the functor with each run of consecutive bytes from "position" on, without
+    // flattening. Iteration stops early when the functor returns false.
+    template<typename Functor> void forEachSegment(const Functor& functor, unsigned position = 0) const
+    {
+        const char* segment;
+        while (unsigned length = getSomeData(segment, position)) {
+            if (!functor(segment, length))
+                return;
+            position += length;
+        }
+    }
+
     bool tryReplaceContentsWithPlatformBuffer(SharedBuffer&);
     WEBCORE_EXPORT bool hasPlatformData() const;
 
@@ -148,6 +165,7 @@ private:
     void maybeTransferMappedFileData();
 
     void copyBufferAndClear(char* destination, unsigned bytesToCopy) const;
+    void appendSharedSegments(const SharedBuffer&, unsigned offset, unsigned length);
 
     void appendToDataBuffer(const char *, unsigned) const;
     void duplicateDataBufferIfNecessary() const;
@@ -163,7 +181,21 @@ private:
     const char *singleDataArrayBuffer() const;
     bool maybeAppendDataArray(SharedBuffer&);
 #else
-    mutable Vector<char*> m_segments;
+    // A run of bytes in a segment buffer. Bytes are never modified or moved once written, and
+    // a buffer is only appended to while nothing else refers to it, so segments can be shared.
+    struct DataSegment {
+        RefPtr<DataBuffer> buffer;
+        unsigned offset;
+        unsigned length;
+        // Position of the first byte relative to the end of m_buffer.
+        unsigned position;
+
+        const char* data() const { return buffer->data.data() + offset; }
+    };
+    void appendSegment(RefPtr<DataBuffer>&&, unsigned offset, unsigned length);
+    unsigned segmentedSize() const;
+
+    mutable Vector<DataSegment> m_segments;
 #endif
 
 #if USE(CF)
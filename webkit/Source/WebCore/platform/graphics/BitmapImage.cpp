@@ -130,6 +130,9 @@ void BitmapImage::destroyDecodedData(bool destroyAll)
             frameBytesCleared += frameBytes;
     }
 
+    ++m_decodingGeneration;
+    m_isDecodingAsynchronously = false;
+
     m_source.clear(destroyAll, clearBeforeFrame, data(), m_allDataReceived);
     destroyMetadataAndNotify(frameBytesCleared, ClearedSource::Yes);
 }
@@ -200,6 +203,11 @@ void BitmapImage::cacheFrame(size_t index, SubsamplingLevel subsamplingLevel, Im
     m_frames[index].m_hasAlpha = m_source.frameHasAlphaAtIndex(index);
     m_frames[index].m_frameBytes = m_source.frameBytesAtIndex(index, subsamplingLevel);
 
+    didCacheFrame(index, frameCaching);
+}
+
+void BitmapImage::didCacheFrame(size_t index, ImageFrameCaching frameCaching)
+{
     LOG(Images, "BitmapImage %p cacheFrame %lu (%s%u bytes, complete %d)", this, index, frameCaching == CacheMetadataOnly ? "metadata only, " : "", m_frames[index].m_frameBytes, m_frames[index].m_isComplete);
 
     if (m_frames[index].m_image) {
@@ -334,6 +342,11 @@ bool BitmapImage::dataChanged(bool allDataReceived)
 
     m_haveFrameCount = false;
     m_source.setNeedsUpdateMetadata();
+
+    ++m_decodingGeneration;
+    m_isDecodingAsynchronously = false;
+    m_asynchronousDecodingFailed = false;
+
     return isSizeAvailable();
 }
 
@@ -405,6 +418,83 @@ NativeImagePtr BitmapImage::frameImageAtIndex(size_t index, float presentationSc
     return m_frames[index].m_image;
 }
 
+bool BitmapImage::ensureCurrentFrameIsDecodedAsynchronously()
+{
+    // Small frames decode faster than the extra paint would take.
+    static const unsigned minimumFrameBytesForAsynchronousDecoding = 64 * 1024;
+
+    // Animated and partially loaded images keep decoding as they draw.
+    if (!m_allDataReceived || !data() || frameCount() != 1 || m_source.m_maximumSubsamplingLevel.valueOr(0))
+        return true;
+
+    if (m_asynchronousDecodingFailed)
+        return true;
+
+    if (haveFrameImageAtIndex(0))
+        return true;
+
+    if (m_isDecodingAsynchronously)
+        return false;
+
+    unsigned frameBytes = m_source.frameBytesAtIndex(0, 0);
+    if (frameBytes < minimumFrameBytesForAsynchronousDecoding)
+        return true;
+
+    // The copy shares the segments of the encoded data instead of copying the bytes.
+    auto weakThis = m_weakFactory.createWeakPtr();
+    unsigned decodingGeneration = m_decodingGeneration;
+    bool started = ImageDecodingQueue::singleton().decodeFrame(data()->copy(), m_source.m_alphaOption, m_source.m_gammaAndColorProfileOption, 0, frameBytes, [weakThis, decodingGeneration](ImageDecodingQueue::DecodedFrame&& frame) {
+        if (weakThis)
+            weakThis->didDecodeFrameAsynchronously(decodingGeneration, WTFMove(frame));
+    });
+    if (!started)
+        return true;
+
+    LOG(Images, "BitmapImage %p ensureCurrentFrameIsDecodedAsynchronously started decoding %u bytes", this, frameBytes);
+    m_isDecodingAsynchronously = true;
+    return false;
+}
+
+void BitmapImage::didDecodeFrameAsynchronously(unsigned decodingGeneration, ImageDecodingQueue::DecodedFrame&& decodedFrame)
+{
+    if (decodingGeneration != m_decodingGeneration)
+        return;
+
+    m_isDecodingAsynchronously = false;
+
+    // A synchronous draw may have decoded the frame in the meantime.
+    if (haveFrameImageAtIndex(0))
+        return;
+
+    // The draw that started the decode painted nothing, so repaint and let the next draw decode on this thread.
+    if (!decodedFrame.image) {
+        LOG(Images, "BitmapImage %p didDecodeFrameAsynchronously failed, falling back to synchronous decoding", this);
+        m_asynchronousDecodingFailed = true;
+        if (imageObserver())
+            imageObserver()->changedInRect(this, IntRect(IntPoint(), expandedIntSize(size())));
+        return;
+    }
+
+    // Asking m_source for the metadata would decode the frame again on this thread, so it comes from the worker's decoder.
+    if (m_frames.isEmpty())
+        m_frames.grow(1);
+    FrameData& frame = m_frames[0];
+    frame.m_image = WTFMove(decodedFrame.image);
+    frame.m_subsamplingLevel = 0;
+    frame.m_orientation = m_source.orientationAtIndex(0);
+    frame.m_haveMetadata = true;
+    frame.m_isComplete = decodedFrame.isComplete;
+    frame.m_hasAlpha = decodedFrame.hasAlpha;
+    frame.m_frameBytes = m_source.frameBytesAtIndex(0, 0);
+
+    // Reporting the bytes to the observer is how the MemoryCache budgets and evicts this frame along
+    // with the rest of the decoded data.
+    didCacheFrame(0, CacheMetadataAndFrame);
+
+    if (imageObserver())
+        imageObserver()->changedInRect(this, IntRect(IntPoint(), expandedIntSize(size())));
+}
+
 bool BitmapImage::frameIsCompleteAtIndex(size_t index)
 {
     if (!ensureFrameIsCached(index, CacheMetadataOnly))
@@ -439,6 +529,10 @@ bool BitmapImage::frameHasAlphaAtIndex(size_t index)
 
 bool BitmapImage::currentFrameKnownToBeOpaque()
 {
+    // Don't decode the frame here while it is being decoded elsewhere.
+    if (m_isDecodingAsynchronously && !haveFrameImageAtIndex(currentFrame()))
+        return false;
+
     return !frameHasAlphaAtIndex(currentFrame());
 }
 
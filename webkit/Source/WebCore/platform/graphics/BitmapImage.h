@@ -30,10 +30,13 @@
 
 #include "Image.h"
 #include "Color.h"
+#include "ImageDecodingQueue.h"
 #include "ImageOrientation.h"
 #include "ImageSource.h"
 #include "IntSize.h"
 
+#include <wtf/WeakPtr.h>
+
 #if USE(CG) || USE(APPKIT)
 #include <wtf/RetainPtr.h>
 #endif
@@ -186,6 +189,10 @@ public:
     void setAllowSubsampling(bool allowSubsampling) { m_source.setAllowSubsampling(allowSubsampling); }
 
     size_t currentFrame() const { return m_currentFrame; }
+
+    // Returns true if the current frame can be drawn without decoding it here. Otherwise, the frame is
+    // being decoded on the ImageDecodingQueue, and the observer is told when it can be drawn.
+    bool ensureCurrentFrameIsDecodedAsynchronously();
     
 private:
     bool isBitmapImage() const override { return true; }
@@ -227,6 +234,7 @@ protected:
     // Decodes and caches a frame. Never accessed except internally.
     enum ImageFrameCaching { CacheMetadataOnly, CacheMetadataAndFrame };
     void cacheFrame(size_t index, SubsamplingLevel, ImageFrameCaching = CacheMetadataAndFrame);
+    void didCacheFrame(size_t index, ImageFrameCaching);
 
     // Called before accessing m_frames[index] for info without decoding. Returns false on index out of bounds.
     bool ensureFrameIsCached(size_t index, ImageFrameCaching = CacheMetadataAndFrame);
@@ -287,6 +295,8 @@ private:
 
     void dump(TextStream&) const override;
 
+    void didDecodeFrameAsynchronously(unsigned decodingGeneration, ImageDecodingQueue::DecodedFrame&&);
+
     ImageSource m_source;
     mutable IntSize m_size; // The size to use for the overall image (will just be the size of the first image).
     mutable IntSize m_sizeRespectingOrientation;
@@ -328,8 +338,16 @@ private:
     bool m_sizeAvailable : 1; // Whether or not we can obtain the size of the first image frame yet from ImageIO.
     mutable bool m_haveFrameCount : 1;
     bool m_animationFinishedWhenCatchingUp : 1;
+    bool m_isDecodingAsynchronously { false };
+    // Set when the worker could not decode the data; draws then decode synchronously until the data changes.
+    bool m_asynchronousDecodingFailed { false };
+
+    // Bumped whenever the data or the decoded frames change, so a stale asynchronous decode is dropped.
+    unsigned m_decodingGeneration { 0 };
 
     RefPtr<Image> m_cachedImage;
+
+    WeakPtrFactory<BitmapImage> m_weakFactory { this };
 };
 
 } // namespace WebCore
@@ -700,6 +700,13 @@ void GraphicsContext::drawBidiText(const FontCascade& font, const TextRun& run,
     bidiRuns.clear();
 }
 
+static bool isImageReadyToDraw(Image& image, const ImagePaintingOptions& imagePaintingOptions)
+{
+    if (imagePaintingOptions.m_decodingMode == DecodingMode::Synchronous || !is<BitmapImage>(image))
+        return true;
+    return downcast<BitmapImage>(image).ensureCurrentFrameIsDecodedAsynchronously();
+}
+
 void GraphicsContext::drawImage(Image& image, const FloatPoint& destination, const ImagePaintingOptions& imagePaintingOptions)
 {
     drawImage(image, FloatRect(destination, image.size()), FloatRect(FloatPoint(), image.size()), imagePaintingOptions);
@@ -718,7 +725,7 @@ void GraphicsContext::drawImage(Image& image, const FloatRect& destination, cons
 
 void GraphicsContext::drawImage(Image& image, const FloatRect& destination, const FloatRect& source, const ImagePaintingOptions& imagePaintingOptions)
 {
-    if (paintingDisabled())
+    if (paintingDisabled() || !isImageReadyToDraw(image, imagePaintingOptions))
         return;
 
     if (isRecording()) {
@@ -732,7 +739,7 @@ void GraphicsContext::drawImage(Image& image, const FloatRect& destination, cons
 
 void GraphicsContext::drawTiledImage(Image& image, const FloatRect& destination, const FloatPoint& source, const FloatSize& tileSize, const FloatSize& spacing, const ImagePaintingOptions& imagePaintingOptions)
 {
-    if (paintingDisabled())
+    if (paintingDisabled() || !isImageReadyToDraw(image, imagePaintingOptions))
         return;
 
     if (isRecording()) {
@@ -747,7 +754,7 @@ void GraphicsContext::drawTiledImage(Image& image, const FloatRect& destination,
 void GraphicsContext::drawTiledImage(Image& image, const FloatRect& destination, const FloatRect& source, const FloatSize& tileScaleFactor,
     Image::TileRule hRule, Image::TileRule vRule, const ImagePaintingOptions& imagePaintingOptions)
 {
-    if (paintingDisabled())
+    if (paintingDisabled() || !isImageReadyToDraw(image, imagePaintingOptions))
         return;
 
     if (isRecording()) {
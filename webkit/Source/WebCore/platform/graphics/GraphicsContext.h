@@ -212,6 +212,7 @@ struct ImagePaintingOptions {
     BlendMode m_blendMode;
     ImageOrientationDescription m_orientationDescription;
     InterpolationQuality m_interpolationQuality;
+    DecodingMode m_decodingMode { DecodingMode::Synchronous };
 };
 
 struct GraphicsContextStateChange {
@@ -83,6 +83,9 @@ enum InterpolationQuality {
     InterpolationHigh
 };
 
+// Asynchronous lets a BitmapImage skip the draw while its frame is decoded on the ImageDecodingQueue.
+enum class DecodingMode { Synchronous, Asynchronous };
+
 enum LineCap { ButtCap, RoundCap, SquareCap };
 
 enum LineJoin { MiterJoin, RoundJoin, BevelJoin };
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ImageDecodingQueue.h"
+
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/WorkQueue.h>
+
+#if USE(CG)
+#include "ImageDecoderCG.h"
+#else
+#include "ImageDecoder.h"
+#endif
+
+namespace WebCore {
+
+// Decoded frames that are still on their way back to the main thread are not seen by the MemoryCache yet.
+static const unsigned maximumPendingFrameBytes = 32 * 1024 * 1024;
+
+static WorkQueue& decodingQueue()
+{
+    static NeverDestroyed<Ref<WorkQueue>> queue(WorkQueue::create("org.webkit.ImageDecodingQueue", WorkQueue::Type::Concurrent, WorkQueue::QOS::UserInitiated));
+    return queue.get();
+}
+
+ImageDecodingQueue& ImageDecodingQueue::singleton()
+{
+    static NeverDestroyed<ImageDecodingQueue> queue;
+    return queue;
+}
+
+bool ImageDecodingQueue::decodeFrame(Ref<SharedBuffer>&& data, ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption, SubsamplingLevel subsamplingLevel, unsigned frameBytes, CompletionHandler&& completionHandler)
+{
+    ASSERT(isMainThread());
+
+    if (m_pendingFrameBytes + frameBytes > maximumPendingFrameBytes)
+        return false;
+    m_pendingFrameBytes += frameBytes;
+
+    decodingQueue().dispatch([data = WTFMove(data), alphaOption, gammaAndColorProfileOption, subsamplingLevel, frameBytes, completionHandler = WTFMove(completionHandler)]() mutable {
+        DecodedFrame frame;
+        if (auto decoder = ImageDecoder::create(data, alphaOption, gammaAndColorProfileOption)) {
+            decoder->setData(data, true);
+            frame.image = decoder->createFrameImageAtIndex(0, subsamplingLevel);
+            frame.isComplete = decoder->frameIsCompleteAtIndex(0);
+            frame.hasAlpha = decoder->frameHasAlphaAtIndex(0);
+        }
+
+        callOnMainThread([frame = WTFMove(frame), frameBytes, completionHandler = WTFMove(completionHandler)]() mutable {
+            ImageDecodingQueue& queue = ImageDecodingQueue::singleton();
+            ASSERT(queue.m_pendingFrameBytes >= frameBytes);
+            queue.m_pendingFrameBytes -= frameBytes;
+            completionHandler(WTFMove(frame));
+        });
+    });
+    return true;
+}
+
+}
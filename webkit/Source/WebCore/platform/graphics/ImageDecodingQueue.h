@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ImageDecodingQueue_h
+#define ImageDecodingQueue_h
+
+#include "ImageSource.h"
+#include "NativeImagePtr.h"
+#include "SharedBuffer.h"
+#include <functional>
+#include <wtf/NeverDestroyed.h>
+
+namespace WebCore {
+
+// Decodes image frames on a pool of worker threads. Each job gets a decoder of its own over its own
+// SharedBuffer, so the ImageSource on the main thread is never touched. The buffer may share its
+// segments with the main thread's; those bytes are never modified once written. The decoded
+// frame is handed back on the main thread, where its owner accounts for it like any other frame.
+class ImageDecodingQueue {
+    WTF_MAKE_NONCOPYABLE(ImageDecodingQueue); WTF_MAKE_FAST_ALLOCATED;
+    friend class NeverDestroyed<ImageDecodingQueue>;
+public:
+    static ImageDecodingQueue& singleton();
+
+    struct DecodedFrame {
+        NativeImagePtr image;
+        bool isComplete { false };
+        bool hasAlpha { true };
+    };
+    typedef std::function<void (DecodedFrame&&)> CompletionHandler;
+
+    // Decodes the first frame of |data|. Returns false, and does nothing, if the frames being decoded
+    // would go over the byte budget; the caller should then decode synchronously.
+    bool decodeFrame(Ref<SharedBuffer>&& data, ImageSource::AlphaOption, ImageSource::GammaAndColorProfileOption, SubsamplingLevel, unsigned frameBytes, CompletionHandler&&);
+
+    unsigned pendingFrameBytes() const { return m_pendingFrameBytes; }
+
+private:
+    ImageDecodingQueue() = default;
+
+    unsigned m_pendingFrameBytes { 0 };
+};
+
+}
+
+#endif
@@ -29,18 +29,21 @@
 
 #if HAVE(ARM_NEON_INTRINSICS)
 
-#include "FEGaussianBlur.h"
 #include "NEONHelpers.h"
+#include <algorithm>
 
 namespace WebCore {
 
-inline void boxBlurNEON(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+// Truncating (sum + 0.5) / dx yields the integer division boxBlur() does: the error of the reciprocal
+// stays well below 0.5 / dx for every kernel size a blur can have.
+inline void boxBlurNEON(const uint8_t* source, uint8_t* destination,
                         unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
 {
-    uint32_t* sourcePixel = reinterpret_cast<uint32_t*>(srcPixelArray->data());
-    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(dstPixelArray->data());
+    const uint32_t* sourcePixel = reinterpret_cast<const uint32_t*>(source);
+    uint32_t* destinationPixel = reinterpret_cast<uint32_t*>(destination);
 
     float32x4_t deltaX = vdupq_n_f32(1.0 / dx);
+    float32x4_t half = vdupq_n_f32(0.5);
     int pixelLine = strideLine / 4;
     int pixelStride = stride / 4;
 
@@ -57,7 +60,7 @@ inline void boxBlurNEON(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dst
         // Blurring
         for (int x = 0; x < effectWidth; ++x) {
             int pixelOffset = line + x * pixelStride;
-            float32x4_t result = vmulq_f32(sum, deltaX);
+            float32x4_t result = vmulq_f32(vaddq_f32(sum, half), deltaX);
             storeFloatAsRGBA8(result, destinationPixel + pixelOffset);
             if (x >= dxLeft) {
                 float32x4_t sourcePixelAsFloat = loadRGBA8AsFloat(sourcePixel + pixelOffset - dxLeft * pixelStride);
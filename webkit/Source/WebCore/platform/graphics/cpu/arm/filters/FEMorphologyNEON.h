@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEMorphologyNEON_h
+#define FEMorphologyNEON_h
+
+#if HAVE(ARM_NEON_INTRINSICS)
+
+#include "FEMorphologySIMD.h"
+#include <arm_neon.h>
+
+namespace WebCore {
+
+struct MorphologyOperationsNEON {
+    typedef uint8x16_t Vector;
+
+    static Vector load(const uint8_t* source) { return vld1q_u8(source); }
+    static void store(uint8_t* destination, Vector data) { vst1q_u8(destination, data); }
+    static Vector extremum(Vector a, Vector b, bool dilate) { return dilate ? vmaxq_u8(a, b) : vminq_u8(a, b); }
+};
+
+} // namespace WebCore
+
+#endif // HAVE(ARM_NEON_INTRINSICS)
+
+#endif // FEMorphologyNEON_h
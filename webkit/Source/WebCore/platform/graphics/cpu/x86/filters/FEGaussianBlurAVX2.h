@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEGaussianBlurAVX2_h
+#define FEGaussianBlurAVX2_h
+
+#if HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#include "FEGaussianBlurSSE2.h"
+#include <immintrin.h>
+
+// These are built for AVX2 regardless of the compiler flags, so callers have to check cpuSupportsAVX2() first.
+#define WEBCORE_TARGET_AVX2 __attribute__((target("avx2")))
+
+namespace WebCore {
+
+WEBCORE_TARGET_AVX2 inline __m256i loadRGBA8PairAsInt32(const uint8_t* first, const uint8_t* second)
+{
+    __m128i pixels = _mm_unpacklo_epi32(_mm_cvtsi32_si128(*reinterpret_cast<const int32_t*>(first)),
+        _mm_cvtsi32_si128(*reinterpret_cast<const int32_t*>(second)));
+    return _mm256_cvtepu8_epi32(pixels);
+}
+
+WEBCORE_TARGET_AVX2 inline void storeInt32PairAsRGBA8(__m256i data, uint8_t* first, uint8_t* second)
+{
+    // Both packs work within 128-bit lanes, so each pixel ends up in the low bytes of its own lane.
+    __m256i packed = _mm256_packs_epi32(data, data);
+    packed = _mm256_packus_epi16(packed, packed);
+    *reinterpret_cast<int32_t*>(first) = _mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+    *reinterpret_cast<int32_t*>(second) = _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+}
+
+// boxBlurSSE2() on two lines at once, one per 128-bit lane.
+WEBCORE_TARGET_AVX2 inline void boxBlurAVX2(const uint8_t* source, uint8_t* destination,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+    const __m256 reciprocal = _mm256_set1_ps(1.0f / dx);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const int maxKernelSize = std::min(dxRight, effectWidth);
+
+    int y = 0;
+    for (; y + 1 < effectHeight; y += 2) {
+        const uint8_t* firstSourceLine = source + y * strideLine;
+        const uint8_t* secondSourceLine = firstSourceLine + strideLine;
+        uint8_t* firstDestinationLine = destination + y * strideLine;
+        uint8_t* secondDestinationLine = firstDestinationLine + strideLine;
+
+        // Fill the kernel.
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm256_add_epi32(sum, loadRGBA8PairAsInt32(firstSourceLine + i * stride, secondSourceLine + i * stride));
+
+        // Blurring.
+        for (int x = 0; x < effectWidth; ++x) {
+            __m256 average = _mm256_mul_ps(_mm256_add_ps(_mm256_cvtepi32_ps(sum), half), reciprocal);
+            storeInt32PairAsRGBA8(_mm256_cvttps_epi32(average), firstDestinationLine + x * stride, secondDestinationLine + x * stride);
+
+            if (x >= dxLeft) {
+                int offset = (x - dxLeft) * stride;
+                sum = _mm256_sub_epi32(sum, loadRGBA8PairAsInt32(firstSourceLine + offset, secondSourceLine + offset));
+            }
+            if (x + dxRight < effectWidth) {
+                int offset = (x + dxRight) * stride;
+                sum = _mm256_add_epi32(sum, loadRGBA8PairAsInt32(firstSourceLine + offset, secondSourceLine + offset));
+            }
+        }
+    }
+
+    if (y < effectHeight)
+        boxBlurSSE2(source + y * strideLine, destination + y * strideLine, dx, dxLeft, dxRight, stride, strideLine, effectWidth, 1);
+}
+
+} // namespace WebCore
+
+#undef WEBCORE_TARGET_AVX2
+
+#endif // HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#endif // FEGaussianBlurAVX2_h
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEGaussianBlurSSE2_h
+#define FEGaussianBlurSSE2_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include "SSE2Helpers.h"
+#include <algorithm>
+
+namespace WebCore {
+
+// Same sliding window as boxBlur() with EDGEMODE_NONE, with the four channels of a pixel summed in one register.
+// Truncating (sum + 0.5) / dx yields the integer division boxBlur() does: the error of the reciprocal stays
+// well below 0.5 / dx for every kernel size a blur can have.
+inline void boxBlurSSE2(const uint8_t* source, uint8_t* destination,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+    const __m128 reciprocal = _mm_set1_ps(1.0f / dx);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const int maxKernelSize = std::min(dxRight, effectWidth);
+
+    for (int y = 0; y < effectHeight; ++y) {
+        const uint8_t* sourceLine = source + y * strideLine;
+        uint8_t* destinationLine = destination + y * strideLine;
+
+        // Fill the kernel.
+        __m128i sum = _mm_setzero_si128();
+        for (int i = 0; i < maxKernelSize; ++i)
+            sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourceLine + i * stride));
+
+        // Blurring.
+        for (int x = 0; x < effectWidth; ++x) {
+            __m128 average = _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(sum), half), reciprocal);
+            storeInt32AsRGBA8(_mm_cvttps_epi32(average), destinationLine + x * stride);
+
+            if (x >= dxLeft)
+                sum = _mm_sub_epi32(sum, loadRGBA8AsInt32(sourceLine + (x - dxLeft) * stride));
+            if (x + dxRight < effectWidth)
+                sum = _mm_add_epi32(sum, loadRGBA8AsInt32(sourceLine + (x + dxRight) * stride));
+        }
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // FEGaussianBlurSSE2_h
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SSE2Helpers_h
+#define SSE2Helpers_h
+
+#if HAVE(X86_SSE2_INTRINSICS)
+
+#include <emmintrin.h>
+#include <stdint.h>
+
+namespace WebCore {
+
+inline __m128i loadUnaligned16(const uint8_t* source)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+}
+
+inline void storeUnaligned16(uint8_t* destination, __m128i data)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), data);
+}
+
+inline __m128i loadRGBA8AsInt32(const uint8_t* source)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i pixel = _mm_cvtsi32_si128(*reinterpret_cast<const int32_t*>(source));
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+}
+
+inline void storeInt32AsRGBA8(__m128i data, uint8_t* destination)
+{
+    __m128i packed = _mm_packs_epi32(data, data);
+    packed = _mm_packus_epi16(packed, packed);
+    *reinterpret_cast<int32_t*>(destination) = _mm_cvtsi128_si32(packed);
+}
+
+} // namespace WebCore
+
+#endif // HAVE(X86_SSE2_INTRINSICS)
+
+#endif // SSE2Helpers_h
@@ -26,7 +26,10 @@
 #include "config.h"
 #include "FEGaussianBlur.h"
 
+#include "CPUFeaturesX86.h"
+#include "FEGaussianBlurAVX2.h"
 #include "FEGaussianBlurNEON.h"
+#include "FEGaussianBlurSSE2.h"
 #include "Filter.h"
 #include "GraphicsContext.h"
 #include "TextStream.h"
@@ -295,6 +298,12 @@ inline void boxBlur(const Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* d
     }
 }
 
+void FEGaussianBlur::scalarBoxBlur(const Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage, EdgeModeType edgeMode)
+{
+    boxBlur(srcPixelArray, dstPixelArray, dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight, alphaImage, edgeMode);
+}
+
 #if USE(ACCELERATE)
 inline void accelerateBoxBlur(const Uint8ClampedArray* src, Uint8ClampedArray* dst, unsigned kernelSize, int stride, int effectWidth, int effectHeight)
 {
@@ -334,6 +343,20 @@ inline void accelerateBoxBlur(const Uint8ClampedArray* src, Uint8ClampedArray* d
 }
 #endif
 
+#if HAVE(X86_SSE2_INTRINSICS)
+inline void boxBlurX86(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+    unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight)
+{
+#if COMPILER(GCC_OR_CLANG)
+    if (cpuSupportsAVX2()) {
+        boxBlurAVX2(srcPixelArray->data(), dstPixelArray->data(), dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+        return;
+    }
+#endif
+    boxBlurSSE2(srcPixelArray->data(), dstPixelArray->data(), dx, dxLeft, dxRight, stride, strideLine, effectWidth, effectHeight);
+}
+#endif
+
 inline void standardBoxBlur(Uint8ClampedArray* src, Uint8ClampedArray* dst, unsigned kernelSizeX, unsigned kernelSizeY, int stride, IntSize& paintSize, bool isAlphaImage, EdgeModeType edgeMode)
 {
     int dxLeft = 0;
@@ -346,9 +369,14 @@ inline void standardBoxBlur(Uint8ClampedArray* src, Uint8ClampedArray* dst, unsi
             kernelPosition(i, kernelSizeX, dxLeft, dxRight);
 #if HAVE(ARM_NEON_INTRINSICS)
             if (!isAlphaImage)
-                boxBlurNEON(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height());
+                boxBlurNEON(src->data(), dst->data(), kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height());
             else
                 boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), true, edgeMode);
+#elif HAVE(X86_SSE2_INTRINSICS)
+            if (!isAlphaImage && edgeMode == EDGEMODE_NONE)
+                boxBlurX86(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height());
+            else
+                boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), isAlphaImage, edgeMode);
 #else
             boxBlur(src, dst, kernelSizeX, dxLeft, dxRight, 4, stride, paintSize.width(), paintSize.height(), isAlphaImage, edgeMode);
 #endif
@@ -359,9 +387,14 @@ inline void standardBoxBlur(Uint8ClampedArray* src, Uint8ClampedArray* dst, unsi
             kernelPosition(i, kernelSizeY, dyLeft, dyRight);
 #if HAVE(ARM_NEON_INTRINSICS)
             if (!isAlphaImage)
-                boxBlurNEON(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
+                boxBlurNEON(src->data(), dst->data(), kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
             else
                 boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), true, edgeMode);
+#elif HAVE(X86_SSE2_INTRINSICS)
+            if (!isAlphaImage && edgeMode == EDGEMODE_NONE)
+                boxBlurX86(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width());
+            else
+                boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), isAlphaImage, edgeMode);
 #else
             boxBlur(src, dst, kernelSizeY, dyLeft, dyRight, stride, 4, paintSize.height(), paintSize.width(), isAlphaImage, edgeMode);
 #endif
@@ -48,6 +48,10 @@ public:
     static IntSize calculateKernelSize(const Filter&, const FloatPoint& stdDeviation);
     static IntSize calculateUnscaledKernelSize(const FloatPoint& stdDeviation);
 
+    // One portable box blur pass. The SIMD kernels must match it byte for byte.
+    WEBCORE_EXPORT static void scalarBoxBlur(const Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+        unsigned dx, int dxLeft, int dxRight, int stride, int strideLine, int effectWidth, int effectHeight, bool alphaImage, EdgeModeType);
+
     virtual TextStream& externalRepresentation(TextStream&, int indention) const;
 
 private:
@@ -24,6 +24,8 @@
 #include "config.h"
 #include "FEMorphology.h"
 
+#include "FEMorphologyNEON.h"
+#include "FEMorphologySSE2.h"
 #include "Filter.h"
 #include "TextStream.h"
 
@@ -116,18 +118,36 @@ static inline unsigned char kernelExtremum(const Vector<unsigned char>& kernel,
     return extremum;
 }
 
-void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart, int yEnd)
+#if HAVE(ARM_NEON_INTRINSICS)
+typedef MorphologyOperationsNEON MorphologyOperations;
+#elif HAVE(X86_SSE2_INTRINSICS)
+typedef MorphologyOperationsSSE2 MorphologyOperations;
+#endif
+
+#if HAVE(X86_SSE2_INTRINSICS) || HAVE(ARM_NEON_INTRINSICS)
+// The kernel is separable: take the extremum of each column over the vertical window first, then
+// slide the horizontal window over those. Both passes work on all four channels at once.
+static void platformApplySeparable(Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray, int radiusX, int radiusY,
+    int width, int height, int yStart, int yEnd, bool dilate)
 {
-    Uint8ClampedArray* srcPixelArray = paintingData->srcPixelArray;
-    Uint8ClampedArray* dstPixelArray = paintingData->dstPixelArray;
-    const int radiusX = paintingData->radiusX;
-    const int radiusY = paintingData->radiusY;
-    const int width = paintingData->width;
-    const int height = paintingData->height;
+    const int strideLine = width * 4;
+    Vector<uint8_t> extrema(strideLine);
 
-    ASSERT(radiusX <= width || radiusY <= height);
-    ASSERT(yStart >= 0 && yEnd <= height && yStart < yEnd);
+    for (int y = yStart; y < yEnd; ++y) {
+        int yStartExtrema = std::max(0, y - radiusY);
+        int yEndExtrema = std::min(height - 1, y + radiusY);
+        const uint8_t* source = srcPixelArray->data() + yStartExtrema * strideLine;
+        uint8_t* destination = dstPixelArray->data() + y * strideLine;
+
+        morphologyColumnExtrema<MorphologyOperations>(source, strideLine, yEndExtrema - yStartExtrema + 1, extrema.data(), dilate);
+        morphologyRowExtrema<MorphologyOperations>(extrema.data(), width, radiusX, destination, dilate);
+    }
+}
+#endif
 
+void FEMorphology::scalarMorphology(MorphologyOperatorType type, const Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+    int width, int height, int radiusX, int radiusY, int yStart, int yEnd)
+{
     Vector<unsigned char> extrema;
     for (int y = yStart; y < yEnd; ++y) {
         int yStartExtrema = std::max(0, y - radiusY);
@@ -137,13 +157,13 @@ void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart,
             extrema.clear();
             // Compute extremas for each columns
             for (int x = 0; x < radiusX; ++x)
-                extrema.append(columnExtremum(srcPixelArray, x, yStartExtrema, yEndExtrema, width, colorChannel, m_type));
+                extrema.append(columnExtremum(srcPixelArray, x, yStartExtrema, yEndExtrema + 1, width, colorChannel, type));
 
             // Kernel is filled, get extrema of next column
             for (int x = 0; x < width; ++x) {
                 if (x < width - radiusX) {
                     int xEnd = std::min(x + radiusX, width - 1);
-                    extrema.append(columnExtremum(srcPixelArray, xEnd, yStartExtrema, yEndExtrema + 1, width, colorChannel, m_type));
+                    extrema.append(columnExtremum(srcPixelArray, xEnd, yStartExtrema, yEndExtrema + 1, width, colorChannel, type));
                 }
 
                 if (x > radiusX)
@@ -153,12 +173,34 @@ void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart,
                 // Number of new addition = width - radiusX.
                 // Number of removals = width - radiusX - 1.
                 ASSERT(extrema.size() >= static_cast<size_t>(radiusX + 1));
-                dstPixelArray->set(pixelArrayIndex(x, y, width, colorChannel), kernelExtremum(extrema, m_type));
+                dstPixelArray->set(pixelArrayIndex(x, y, width, colorChannel), kernelExtremum(extrema, type));
             }
         }
     }
 }
 
+void FEMorphology::platformApplyGeneric(PaintingData* paintingData, int yStart, int yEnd)
+{
+    Uint8ClampedArray* srcPixelArray = paintingData->srcPixelArray;
+    Uint8ClampedArray* dstPixelArray = paintingData->dstPixelArray;
+    const int radiusX = paintingData->radiusX;
+    const int radiusY = paintingData->radiusY;
+    const int width = paintingData->width;
+    const int height = paintingData->height;
+
+    ASSERT(radiusX <= width || radiusY <= height);
+    ASSERT(yStart >= 0 && yEnd <= height && yStart < yEnd);
+
+#if HAVE(X86_SSE2_INTRINSICS) || HAVE(ARM_NEON_INTRINSICS)
+    if (m_type == FEMORPHOLOGY_OPERATOR_ERODE || m_type == FEMORPHOLOGY_OPERATOR_DILATE) {
+        platformApplySeparable(srcPixelArray, dstPixelArray, radiusX, radiusY, width, height, yStart, yEnd, m_type == FEMORPHOLOGY_OPERATOR_DILATE);
+        return;
+    }
+#endif
+
+    scalarMorphology(m_type, srcPixelArray, dstPixelArray, width, height, radiusX, radiusY, yStart, yEnd);
+}
+
 void FEMorphology::platformApplyWorker(PlatformApplyParameters* param)
 {
     param->filter->platformApplyGeneric(param->paintingData, param->startY, param->endY);
@@ -73,6 +73,10 @@ public:
 
     static void platformApplyWorker(PlatformApplyParameters*);
 
+    // The portable loop over the rows [yStart, yEnd). The SIMD kernels must match it byte for byte.
+    WEBCORE_EXPORT static void scalarMorphology(MorphologyOperatorType, const Uint8ClampedArray* srcPixelArray, Uint8ClampedArray* dstPixelArray,
+        int width, int height, int radiusX, int radiusY, int yStart, int yEnd);
+
     inline void platformApply(PaintingData*);
     inline void platformApplyGeneric(PaintingData*, const int yStart, const int yEnd);
 private:
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef FEMorphologySIMD_h
+#define FEMorphologySIMD_h
+
+#include <algorithm>
+#include <stdint.h>
+
+namespace WebCore {
+
+// The separable erode/dilate passes, written once for every instruction set. Operations provides
+// a Vector type of sixteen bytes, with load(), store() and extremum(a, b, dilate) over it.
+
+// Vertical pass: the per channel extremum of lineCount lines, sixteen bytes at a time.
+template<typename Operations>
+inline void morphologyColumnExtrema(const uint8_t* source, int strideLine, int lineCount, uint8_t* extrema, bool dilate)
+{
+    int i = 0;
+    for (; i + 16 <= strideLine; i += 16) {
+        typename Operations::Vector extremum = Operations::load(source + i);
+        for (int line = 1; line < lineCount; ++line)
+            extremum = Operations::extremum(extremum, Operations::load(source + line * strideLine + i), dilate);
+        Operations::store(extrema + i, extremum);
+    }
+
+    for (; i < strideLine; ++i) {
+        uint8_t extremum = source[i];
+        for (int line = 1; line < lineCount; ++line) {
+            uint8_t value = source[line * strideLine + i];
+            extremum = dilate ? std::max(extremum, value) : std::min(extremum, value);
+        }
+        extrema[i] = extremum;
+    }
+}
+
+// Horizontal pass over the column extrema. Four pixels are computed at a time wherever the whole
+// window fits in the line; the pixels within radius of either edge use a clamped window.
+template<typename Operations>
+inline void morphologyRowExtrema(const uint8_t* extrema, int width, int radius, uint8_t* destination, bool dilate)
+{
+    auto clampedPixelExtremum = [&](int x) {
+        int start = std::max(0, x - radius);
+        int end = std::min(width - 1, x + radius);
+        for (int channel = 0; channel < 4; ++channel) {
+            uint8_t extremum = extrema[start * 4 + channel];
+            for (int column = start + 1; column <= end; ++column) {
+                uint8_t value = extrema[column * 4 + channel];
+                extremum = dilate ? std::max(extremum, value) : std::min(extremum, value);
+            }
+            destination[x * 4 + channel] = extremum;
+        }
+    };
+
+    int x = 0;
+    for (int end = std::min(radius, width); x < end; ++x)
+        clampedPixelExtremum(x);
+
+    for (; x + 3 + radius < width; x += 4) {
+        const uint8_t* window = extrema + (x - radius) * 4;
+        typename Operations::Vector extremum = Operations::load(window);
+        for (int column = 1; column <= 2 * radius; ++column)
+            extremum = Operations::extremum(extremum, Operations::load(window + column * 4), dilate);
+        Operations::store(destination + x * 4, extremum);
+    }
+
+    for (; x < width; ++x)
+        clampedPixelExtremum(x);
+}
+
+} // namespace WebCore
+
+#endif // FEMorphologySIMD_h
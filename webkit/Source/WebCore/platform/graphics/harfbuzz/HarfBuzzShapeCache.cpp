@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "HarfBuzzShapeCache.h"
+
+#include <wtf/Hasher.h>
+#include <wtf/NeverDestroyed.h>
+
+namespace WebCore {
+
+static const unsigned maximumCachedResults = 4096;
+
+static bool featuresAreEqual(const Vector<hb_feature_t, 4>& a, const Vector<hb_feature_t, 4>& b)
+{
+    if (a.size() != b.size())
+        return false;
+    return !memcmp(a.data(), b.data(), a.size() * sizeof(hb_feature_t));
+}
+
+bool HarfBuzzShapeCacheKey::operator==(const HarfBuzzShapeCacheKey& other) const
+{
+    if (font != other.font || script != other.script || direction != other.direction || text != other.text)
+        return false;
+    return featuresAreEqual(features, other.features);
+}
+
+bool HarfBuzzShapeCacheKey::operator==(const HarfBuzzShapeCacheLookupKey& other) const
+{
+    if (font != &other.font || script != other.script || direction != other.direction || isHashTableDeletedValue() || StringView(text) != other.text)
+        return false;
+    return featuresAreEqual(features, other.features);
+}
+
+static unsigned hashKey(const Font* font, StringView text, hb_script_t script, hb_direction_t direction, const Vector<hb_feature_t, 4>& features)
+{
+    IntegerHasher hasher;
+    hasher.add(text.is8Bit() ? StringHasher::computeHashAndMaskTop8Bits(text.characters8(), text.length()) : StringHasher::computeHashAndMaskTop8Bits(text.characters16(), text.length()));
+    hasher.add(PtrHash<const Font*>::hash(font));
+    hasher.add(script);
+    hasher.add(direction);
+    if (!features.isEmpty())
+        hasher.add(StringHasher::hashMemory(features.data(), features.size() * sizeof(hb_feature_t)));
+    return hasher.hash();
+}
+
+unsigned HarfBuzzShapeCacheKeyHash::hash(const HarfBuzzShapeCacheKey& key)
+{
+    return hashKey(key.font.get(), key.text, key.script, key.direction, key.features);
+}
+
+unsigned HarfBuzzShapeCacheLookupKeyTranslator::hash(const HarfBuzzShapeCacheLookupKey& key)
+{
+    return hashKey(&key.font, key.text, key.script, key.direction, key.features);
+}
+
+HarfBuzzShapeCache& HarfBuzzShapeCache::singleton()
+{
+    static NeverDestroyed<HarfBuzzShapeCache> cache;
+    return cache;
+}
+
+const HarfBuzzShapeResult* HarfBuzzShapeCache::find(const HarfBuzzShapeCacheLookupKey& key)
+{
+    auto iterator = m_results.find<HarfBuzzShapeCacheLookupKeyTranslator>(key);
+    if (iterator == m_results.end())
+        return nullptr;
+
+    m_recentlyUsed.appendOrMoveToLast(iterator->key);
+    return iterator->value.get();
+}
+
+const HarfBuzzShapeResult& HarfBuzzShapeCache::add(const HarfBuzzShapeCacheLookupKey& lookupKey, std::unique_ptr<HarfBuzzShapeResult> result)
+{
+    ASSERT(lookupKey.text.length() <= maximumCachedTextLength);
+
+    if (m_results.size() >= maximumCachedResults)
+        m_results.remove(m_recentlyUsed.takeFirst());
+
+    HarfBuzzShapeCacheKey key(lookupKey);
+    m_recentlyUsed.appendOrMoveToLast(key);
+    auto addResult = m_results.set(key, WTFMove(result));
+    return *addResult.iterator->value;
+}
+
+void HarfBuzzShapeCache::clear()
+{
+    m_results.clear();
+    m_recentlyUsed.clear();
+}
+
+} // namespace WebCore
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HarfBuzzShapeCache_h
+#define HarfBuzzShapeCache_h
+
+#include "FloatPoint.h"
+#include "Font.h"
+#include "hb.h"
+#include <wtf/HashMap.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringView.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebCore {
+
+// The glyphs HarfBuzz produced for one word or segment of a run, in visual order and before
+// letter-spacing, word-spacing and justification are applied.
+struct HarfBuzzShapeResult {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    Vector<uint16_t> glyphs;
+    Vector<unsigned> clusters;
+    Vector<float> advances;
+    Vector<FloatPoint> offsets;
+    bool isRightToLeft { false };
+};
+
+// What a lookup has at hand. The text is only copied when a result is added.
+struct HarfBuzzShapeCacheLookupKey {
+    const Font& font;
+    StringView text;
+    hb_script_t script;
+    // HB_DIRECTION_INVALID when HarfBuzz guesses the direction from the script.
+    hb_direction_t direction;
+    const Vector<hb_feature_t, 4>& features;
+};
+
+struct HarfBuzzShapeCacheKey {
+    HarfBuzzShapeCacheKey() { }
+    explicit HarfBuzzShapeCacheKey(const HarfBuzzShapeCacheLookupKey& key)
+        : font(const_cast<Font*>(&key.font))
+        , text(key.text.toString())
+        , script(key.script)
+        , direction(key.direction)
+        , features(key.features)
+    {
+    }
+
+    explicit HarfBuzzShapeCacheKey(WTF::HashTableDeletedValueType)
+        : text(WTF::HashTableDeletedValue)
+    {
+    }
+
+    bool isHashTableDeletedValue() const { return text.isHashTableDeletedValue(); }
+
+    bool operator==(const HarfBuzzShapeCacheKey&) const;
+    bool operator==(const HarfBuzzShapeCacheLookupKey&) const;
+
+    // The cache keeps the font alive so that its address cannot be reused by another one.
+    RefPtr<Font> font;
+    String text;
+    hb_script_t script { HB_SCRIPT_INVALID };
+    hb_direction_t direction { HB_DIRECTION_INVALID };
+    Vector<hb_feature_t, 4> features;
+};
+
+struct HarfBuzzShapeCacheKeyHash {
+    static unsigned hash(const HarfBuzzShapeCacheKey&);
+    static bool equal(const HarfBuzzShapeCacheKey& a, const HarfBuzzShapeCacheKey& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct HarfBuzzShapeCacheLookupKeyTranslator {
+    static unsigned hash(const HarfBuzzShapeCacheLookupKey&);
+    static bool equal(const HarfBuzzShapeCacheKey& a, const HarfBuzzShapeCacheLookupKey& b) { return a == b; }
+};
+
+// A most-recently-used cache of shaped words, so that the same text is not sent to HarfBuzz again for
+// width measurement, line breaking and painting, or when a page is laid out again.
+class HarfBuzzShapeCache {
+    WTF_MAKE_NONCOPYABLE(HarfBuzzShapeCache); WTF_MAKE_FAST_ALLOCATED;
+public:
+    static HarfBuzzShapeCache& singleton();
+
+    // Longer segments are shaped every time; they rarely repeat and would crowd out the words.
+    static const unsigned maximumCachedTextLength = 128;
+
+    const HarfBuzzShapeResult* find(const HarfBuzzShapeCacheLookupKey&);
+    const HarfBuzzShapeResult& add(const HarfBuzzShapeCacheLookupKey&, std::unique_ptr<HarfBuzzShapeResult>);
+
+    void clear();
+
+private:
+    friend class NeverDestroyed<HarfBuzzShapeCache>;
+    HarfBuzzShapeCache() { }
+
+    typedef HashMap<HarfBuzzShapeCacheKey, std::unique_ptr<HarfBuzzShapeResult>, HarfBuzzShapeCacheKeyHash, WTF::SimpleClassHashTraits<HarfBuzzShapeCacheKey>> ResultMap;
+    ResultMap m_results;
+    ListHashSet<HarfBuzzShapeCacheKey, HarfBuzzShapeCacheKeyHash> m_recentlyUsed;
+};
+
+} // namespace WebCore
+
+#endif // HarfBuzzShapeCache_h
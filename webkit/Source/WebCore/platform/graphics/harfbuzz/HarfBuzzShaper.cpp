@@ -33,6 +33,7 @@
 
 #include "FontCascade.h"
 #include "HarfBuzzFace.h"
+#include "HarfBuzzShapeCache.h"
 #include "SurrogatePairAwareTextIterator.h"
 #include <hb-icu.h>
 #include <unicode/normlzr.h>
@@ -41,6 +42,7 @@
 #include <wtf/StdLibExtras.h>
 #include <wtf/Vector.h>
 #include <wtf/text/StringView.h>
+#include <wtf/text/TextBreakIterator.h>
 
 namespace WebCore {
 
@@ -81,9 +83,9 @@ HarfBuzzShaper::HarfBuzzRun::HarfBuzzRun(const Font* fontData, unsigned startInd
 {
 }
 
-void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::HarfBuzzRun::applyShapeResult(const HarfBuzzShapeResult& shapeResult)
 {
-    m_numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    m_numGlyphs = shapeResult.glyphs.size();
     m_glyphs.resize(m_numGlyphs);
     m_advances.resize(m_numGlyphs);
     m_glyphToCharacterIndexes.resize(m_numGlyphs);
@@ -456,6 +458,24 @@ bool HarfBuzzShaper::collectHarfBuzzRuns()
     return !m_harfBuzzRuns.isEmpty();
 }
 
+static void appendShapeResult(HarfBuzzShapeResult& runResult, const HarfBuzzShapeResult& segmentResult, unsigned segmentStart)
+{
+    // Glyphs are in visual order, so the segments of a right-to-left run are laid out back to front.
+    size_t position = segmentResult.isRightToLeft ? 0 : runResult.glyphs.size();
+    size_t numGlyphs = segmentResult.glyphs.size();
+
+    Vector<unsigned> clusters;
+    clusters.reserveInitialCapacity(numGlyphs);
+    for (auto cluster : segmentResult.clusters)
+        clusters.uncheckedAppend(cluster + segmentStart);
+
+    runResult.glyphs.insert(position, segmentResult.glyphs.data(), numGlyphs);
+    runResult.clusters.insert(position, clusters.data(), numGlyphs);
+    runResult.advances.insert(position, segmentResult.advances.data(), numGlyphs);
+    runResult.offsets.insert(position, segmentResult.offsets.data(), numGlyphs);
+    runResult.isRightToLeft = segmentResult.isRightToLeft;
+}
+
 bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
 {
     HarfBuzzScopedPtr<hb_buffer_t> harfBuzzBuffer(hb_buffer_create(), hb_buffer_destroy);
@@ -467,52 +487,115 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns(bool shouldSetDirection)
         HarfBuzzRun* currentRun = m_harfBuzzRuns[runIndex].get();
         const Font* currentFontData = currentRun->fontData();
 
-        hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
+        String upperText;
+        StringView text(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters());
+        if (m_font->isSmallCaps() && u_islower(text[0])) {
+            upperText = text.toString().convertToUppercaseWithoutLocale();
+            text = upperText;
+            currentFontData = m_font->glyphDataForCharacter(text[0], false, SmallCapsVariant).font;
+        }
+
+        // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
+        hb_direction_t direction = HB_DIRECTION_INVALID;
         if (shouldSetDirection)
-            hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-        else
-            // Leaving direction to HarfBuzz to guess is *really* bad, but will do for now.
-            hb_buffer_guess_segment_properties(harfBuzzBuffer.get());
-
-        // Add a space as pre-context to the buffer. This prevents showing dotted-circle
-        // for combining marks at the beginning of runs.
-        static const uint16_t preContext = ' ';
-        hb_buffer_add_utf16(harfBuzzBuffer.get(), &preContext, 1, 1, 0);
-
-        if (m_font->isSmallCaps() && u_islower(m_normalizedBuffer[currentRun->startIndex()])) {
-            String upperText = String(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters()).convertToUppercaseWithoutLocale();
-            currentFontData = m_font->glyphDataForCharacter(upperText[0], false, SmallCapsVariant).font;
-            const UChar* characters = StringView(upperText).upconvertedCharacters();
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(characters), currentRun->numCharacters(), 0, currentRun->numCharacters());
-        } else
-            hb_buffer_add_utf16(harfBuzzBuffer.get(), reinterpret_cast<const uint16_t*>(m_normalizedBuffer.get() + currentRun->startIndex()), currentRun->numCharacters(), 0, currentRun->numCharacters());
+            direction = currentRun->rtl() ? HB_DIRECTION_RTL : HB_DIRECTION_LTR;
+
+        // The run is shaped one line break opportunity at a time: a word together with the spaces that follow it,
+        // or a single ideograph. Each segment's result can then be shared by every run and line it appears in.
+        HarfBuzzShapeResult runResult;
+        unsigned length = std::min(text.length(), currentRun->numCharacters());
+        TextBreakIterator* lineBreakIterator = acquireLineBreakIterator(text.substring(0, length), AtomicString(), nullptr, 0, LineBreakIteratorModeUAX14, false);
+        unsigned segmentStart = 0;
+        while (segmentStart < length) {
+            int nextBreak = lineBreakIterator ? textBreakFollowing(lineBreakIterator, segmentStart) : TextBreakDone;
+            unsigned segmentEnd = nextBreak == TextBreakDone ? length : std::min<unsigned>(nextBreak, length);
+
+            std::unique_ptr<HarfBuzzShapeResult> uncachedResult;
+            const HarfBuzzShapeResult* segmentResult = shapeSegment(harfBuzzBuffer.get(), *currentFontData, text.substring(segmentStart, segmentEnd - segmentStart), currentRun->script(), direction, uncachedResult);
+            if (!segmentResult) {
+                if (lineBreakIterator)
+                    releaseLineBreakIterator(lineBreakIterator);
+                return false;
+            }
+            appendShapeResult(runResult, *segmentResult, segmentStart);
 
-        FontPlatformData* platformData = const_cast<FontPlatformData*>(&currentFontData->platformData());
-        HarfBuzzFace* face = platformData->harfBuzzFace();
-        if (!face)
-            return false;
+            segmentStart = segmentEnd;
+        }
+        if (lineBreakIterator)
+            releaseLineBreakIterator(lineBreakIterator);
 
-        if (m_font->fontDescription().orientation() == Vertical)
-            face->setScriptForVerticalGlyphSubstitution(harfBuzzBuffer.get());
+        currentRun->applyShapeResult(runResult);
+        setGlyphPositionsForHarfBuzzRun(currentRun, runResult);
+    }
 
-        HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
+    return true;
+}
 
-        hb_shape(harfBuzzFont.get(), harfBuzzBuffer.get(), m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
+const HarfBuzzShapeResult* HarfBuzzShaper::shapeSegment(hb_buffer_t* harfBuzzBuffer, const Font& font, StringView text, hb_script_t script, hb_direction_t direction, std::unique_ptr<HarfBuzzShapeResult>& uncachedResult)
+{
+    auto& cache = HarfBuzzShapeCache::singleton();
+    bool isCacheable = text.length() <= HarfBuzzShapeCache::maximumCachedTextLength;
+    HarfBuzzShapeCacheLookupKey key { font, text, script, direction, m_features };
+    if (isCacheable) {
+        if (auto* cachedResult = cache.find(key))
+            return cachedResult;
+    }
 
-        currentRun->applyShapeResult(harfBuzzBuffer.get());
-        setGlyphPositionsForHarfBuzzRun(currentRun, harfBuzzBuffer.get());
+    hb_buffer_set_script(harfBuzzBuffer, script);
+    if (direction != HB_DIRECTION_INVALID)
+        hb_buffer_set_direction(harfBuzzBuffer, direction);
+    else
+        hb_buffer_guess_segment_properties(harfBuzzBuffer);
 
-        hb_buffer_reset(harfBuzzBuffer.get());
+    // Add a space as pre-context to the buffer. This prevents showing dotted-circle
+    // for combining marks at the beginning of runs.
+    static const uint16_t preContext = ' ';
+    hb_buffer_add_utf16(harfBuzzBuffer, &preContext, 1, 1, 0);
+
+    auto characters = text.upconvertedCharacters();
+    hb_buffer_add_utf16(harfBuzzBuffer, reinterpret_cast<const uint16_t*>(characters.get()), text.length(), 0, text.length());
+
+    FontPlatformData* platformData = const_cast<FontPlatformData*>(&font.platformData());
+    HarfBuzzFace* face = platformData->harfBuzzFace();
+    if (!face)
+        return nullptr;
+
+    if (m_font->fontDescription().orientation() == Vertical)
+        face->setScriptForVerticalGlyphSubstitution(harfBuzzBuffer);
+
+    HarfBuzzScopedPtr<hb_font_t> harfBuzzFont(face->createFont(), hb_font_destroy);
+
+    hb_shape(harfBuzzFont.get(), harfBuzzBuffer, m_features.isEmpty() ? 0 : m_features.data(), m_features.size());
+
+    auto result = std::make_unique<HarfBuzzShapeResult>();
+    unsigned numGlyphs = hb_buffer_get_length(harfBuzzBuffer);
+    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
+    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
+    result->glyphs.reserveInitialCapacity(numGlyphs);
+    result->clusters.reserveInitialCapacity(numGlyphs);
+    result->advances.reserveInitialCapacity(numGlyphs);
+    result->offsets.reserveInitialCapacity(numGlyphs);
+    for (unsigned i = 0; i < numGlyphs; ++i) {
+        result->glyphs.uncheckedAppend(glyphInfos[i].codepoint);
+        result->clusters.uncheckedAppend(glyphInfos[i].cluster);
+        result->advances.uncheckedAppend(harfBuzzPositionToFloat(glyphPositions[i].x_advance));
+        result->offsets.uncheckedAppend(FloatPoint(harfBuzzPositionToFloat(glyphPositions[i].x_offset), -harfBuzzPositionToFloat(glyphPositions[i].y_offset)));
     }
+    result->isRightToLeft = HB_DIRECTION_IS_BACKWARD(hb_buffer_get_direction(harfBuzzBuffer));
 
-    return true;
+    hb_buffer_reset(harfBuzzBuffer);
+    hb_buffer_set_unicode_funcs(harfBuzzBuffer, hb_icu_get_unicode_funcs());
+
+    if (!isCacheable) {
+        uncachedResult = WTFMove(result);
+        return uncachedResult.get();
+    }
+    return &cache.add(key, WTFMove(result));
 }
 
-void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb_buffer_t* harfBuzzBuffer)
+void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, const HarfBuzzShapeResult& shapeResult)
 {
     const Font* currentFontData = currentRun->fontData();
-    hb_glyph_info_t* glyphInfos = hb_buffer_get_glyph_infos(harfBuzzBuffer, 0);
-    hb_glyph_position_t* glyphPositions = hb_buffer_get_glyph_positions(harfBuzzBuffer, 0);
 
     unsigned numGlyphs = currentRun->numGlyphs();
     uint16_t* glyphToCharacterIndexes = currentRun->glyphToCharacterIndexes();
@@ -521,16 +604,16 @@ void HarfBuzzShaper::setGlyphPositionsForHarfBuzzRun(HarfBuzzRun* currentRun, hb
     // HarfBuzz returns the shaping result in visual order. We need not to flip for RTL.
     for (size_t i = 0; i < numGlyphs; ++i) {
         bool runEnd = i + 1 == numGlyphs;
-        uint16_t glyph = glyphInfos[i].codepoint;
-        float offsetX = harfBuzzPositionToFloat(glyphPositions[i].x_offset);
-        float offsetY = -harfBuzzPositionToFloat(glyphPositions[i].y_offset);
-        float advance = harfBuzzPositionToFloat(glyphPositions[i].x_advance);
+        uint16_t glyph = shapeResult.glyphs[i];
+        float offsetX = shapeResult.offsets[i].x();
+        float offsetY = shapeResult.offsets[i].y();
+        float advance = shapeResult.advances[i];
 
-        unsigned currentCharacterIndex = currentRun->startIndex() + glyphInfos[i].cluster;
-        bool isClusterEnd = runEnd || glyphInfos[i].cluster != glyphInfos[i + 1].cluster;
+        unsigned currentCharacterIndex = currentRun->startIndex() + shapeResult.clusters[i];
+        bool isClusterEnd = runEnd || shapeResult.clusters[i] != shapeResult.clusters[i + 1];
         float spacing = 0;
 
-        glyphToCharacterIndexes[i] = glyphInfos[i].cluster;
+        glyphToCharacterIndexes[i] = shapeResult.clusters[i];
 
         if (isClusterEnd && !FontCascade::treatAsZeroWidthSpace(m_normalizedBuffer[currentCharacterIndex]))
             spacing += m_letterSpacing;
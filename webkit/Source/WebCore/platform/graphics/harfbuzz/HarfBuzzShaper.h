@@ -38,12 +38,14 @@
 #include <memory>
 #include <wtf/HashSet.h>
 #include <wtf/Vector.h>
+#include <wtf/text/StringView.h>
 #include <wtf/unicode/CharacterNames.h>
 
 namespace WebCore {
 
 class Font;
 class FontCascade;
+struct HarfBuzzShapeResult;
 
 class HarfBuzzShaper {
 public:
@@ -66,7 +68,7 @@ private:
     public:
         HarfBuzzRun(const Font*, unsigned startIndex, unsigned numCharacters, TextDirection, hb_script_t);
 
-        void applyShapeResult(hb_buffer_t*);
+        void applyShapeResult(const HarfBuzzShapeResult&);
         void setGlyphAndPositions(unsigned index, uint16_t glyphId, float advance, float offsetX, float offsetY);
         void setWidth(float width) { m_width = width; }
 
@@ -114,9 +116,10 @@ private:
 
     bool collectHarfBuzzRuns();
     bool shapeHarfBuzzRuns(bool shouldSetDirection);
+    const HarfBuzzShapeResult* shapeSegment(hb_buffer_t*, const Font&, StringView, hb_script_t, hb_direction_t, std::unique_ptr<HarfBuzzShapeResult>& uncachedResult);
     bool fillGlyphBuffer(GlyphBuffer*);
     void fillGlyphBufferFromHarfBuzzRun(GlyphBuffer*, HarfBuzzRun*, FloatPoint& firstOffsetOfNextRun);
-    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, hb_buffer_t*);
+    void setGlyphPositionsForHarfBuzzRun(HarfBuzzRun*, const HarfBuzzShapeResult&);
 
     GlyphBufferAdvance createGlyphBufferAdvance(float, float);
 
@@ -205,7 +205,7 @@ namespace WebCore {
                 // of the return value here in little-endian mode, the caller
                 // won't read it.
                 uint32_t pixel;
-                memcpy(&pixel, &m_data->data()[m_decodedOffset + offset], 3);
+                memcpy(&pixel, &m_data->flattenedData()[m_decodedOffset + offset], 3);
         #if CPU(BIG_ENDIAN)
                 pixel = ((pixel & 0xff00) << 8) | ((pixel & 0xff0000) >> 8) | ((pixel & 0xff000000) >> 24);
         #endif
@@ -291,7 +291,7 @@ private:
 
     const unsigned char* data(size_t dataPosition) const
     {
-        return reinterpret_cast<const unsigned char*>(m_data->data()) + dataPosition;
+        return reinterpret_cast<const unsigned char*>(m_data->flattenedData()) + dataPosition;
     }
 
     void addFrameIfNecessary();
@@ -94,7 +94,7 @@ bool WEBPImageDecoder::decode(bool onlySize)
     if (failed())
         return false;
 
-    const uint8_t* dataBytes = reinterpret_cast<const uint8_t*>(m_data->data());
+    const uint8_t* dataBytes = reinterpret_cast<const uint8_t*>(m_data->flattenedData());
     const size_t dataSize = m_data->size();
 
     if (!ImageDecoder::isSizeAvailable()) {
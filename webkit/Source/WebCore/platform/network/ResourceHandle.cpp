@@ -241,6 +241,14 @@ void ResourceHandle::setDefersLoading(bool defers)
     platformSetDefersLoading(defers);
 }
 
+void ResourceHandle::setPriority(ResourceLoadPriority priority)
+{
+    LOG(Network, "Handle %p setPriority(%u)", this, static_cast<unsigned>(priority));
+
+    d->m_firstRequest.setPriority(priority);
+    platformSetPriority(priority);
+}
+
 bool ResourceHandle::usesAsyncCallbacks() const
 {
     return d->m_usesAsyncCallbacks;
@@ -232,6 +232,7 @@ public:
 #endif
 
     WEBCORE_EXPORT void setDefersLoading(bool);
+    WEBCORE_EXPORT void setPriority(ResourceLoadPriority);
 
     WEBCORE_EXPORT ResourceRequest& firstRequest();
     const String& lastHTTPMethod() const;
@@ -286,6 +287,7 @@ private:
     };
 
     void platformSetDefersLoading(bool);
+    void platformSetPriority(ResourceLoadPriority);
 
     void scheduleFailure(FailureType);
 
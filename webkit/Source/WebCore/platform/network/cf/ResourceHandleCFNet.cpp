@@ -623,6 +623,11 @@ void ResourceHandle::platformSetDefersLoading(bool defers)
         CFURLConnectionResume(d->m_connection.get());
 }
 
+void ResourceHandle::platformSetPriority(ResourceLoadPriority)
+{
+    // CFURLConnection reads the priority of the request when it schedules it and offers no way to change it afterwards.
+}
+
 #if PLATFORM(COCOA)
 void ResourceHandle::schedule(SchedulePair& pair)
 {
@@ -1003,6 +1003,11 @@ void ResourceHandle::platformSetDefersLoading(bool)
     notImplemented();
 }
 
+void ResourceHandle::platformSetPriority(ResourceLoadPriority)
+{
+    notImplemented();
+}
+
 bool ResourceHandle::shouldUseCredentialStorage()
 {
     return (!client() || client()->shouldUseCredentialStorage(this)) && firstRequest().url().protocolIsInHTTPFamily();
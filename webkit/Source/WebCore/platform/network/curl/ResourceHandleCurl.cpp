@@ -154,6 +154,11 @@ void ResourceHandle::platformSetDefersLoading(bool defers)
     }
 }
 
+void ResourceHandle::platformSetPriority(ResourceLoadPriority)
+{
+    // Requests are handed to curl in order and it has no notion of priority.
+}
+
 bool ResourceHandle::shouldUseCredentialStorage()
 {
     return (!client() || client()->shouldUseCredentialStorage(this)) && firstRequest().url().protocolIsInHTTPFamily();
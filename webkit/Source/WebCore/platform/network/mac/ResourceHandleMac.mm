@@ -329,6 +329,11 @@ void ResourceHandle::platformSetDefersLoading(bool defers)
         [d->m_connection setDefersCallbacks:defers];
 }
 
+void ResourceHandle::platformSetPriority(ResourceLoadPriority)
+{
+    // NSURLConnection reads the priority of the request when it schedules it and offers no way to change it afterwards.
+}
+
 #if !USE(CFNETWORK)
 
 void ResourceHandle::schedule(SchedulePair& pair)
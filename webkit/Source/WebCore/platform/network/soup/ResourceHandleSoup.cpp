@@ -1286,6 +1286,17 @@ void ResourceHandle::platformSetDefersLoading(bool defersLoading)
     }
 }
 
+void ResourceHandle::platformSetPriority(ResourceLoadPriority priority)
+{
+#if SOUP_CHECK_VERSION(2, 43, 1)
+    // libsoup reorders its queue of messages waiting for a connection by priority.
+    if (d->m_soupMessage)
+        soup_message_set_priority(d->m_soupMessage.get(), toSoupMessagePriority(priority));
+#else
+    UNUSED_PARAM(priority);
+#endif
+}
+
 void ResourceHandle::platformLoadResourceSynchronously(NetworkingContext* context, const ResourceRequest& request, StoredCredentials storedCredentials, ResourceError& error, ResourceResponse& response, Vector<char>& data)
 {
     ASSERT(!loadingSynchronousRequest);
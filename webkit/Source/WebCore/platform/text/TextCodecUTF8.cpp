@@ -26,7 +26,11 @@
 #include "config.h"
 #include "TextCodecUTF8.h"
 
+#include "CPUFeaturesX86.h"
 #include "TextCodecASCIIFastPath.h"
+#include "UTF8BlockDecodingAVX2.h"
+#include "UTF8BlockDecodingNEON.h"
+#include "UTF8BlockDecodingSSE41.h"
 #include <wtf/text/CString.h>
 #include <wtf/text/StringBuffer.h>
 #include <wtf/unicode/CharacterNames.h>
@@ -150,10 +154,29 @@ static inline UChar* appendCharacter(UChar* destination, int character)
     return destination;
 }
 
-void TextCodecUTF8::consumePartialSequenceByte()
+// Decodes whole blocks with the vector decoders, and stops where the scalar loop has to take over:
+// at an invalid or four-byte sequence, or near the end of the input.
+static inline void decodeUTF8Blocks(const uint8_t*& source, const uint8_t* end, UChar*& destination)
 {
-    --m_partialSequenceSize;
-    memmove(m_partialSequence, m_partialSequence + 1, m_partialSequenceSize);
+#if HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+    if (cpuSupportsAVX2())
+        decodeUTF8ToUTF16AVX2(source, end, destination);
+    else if (cpuSupportsSSE41())
+        decodeUTF8ToUTF16SSE41(source, end, destination);
+#elif HAVE(ARM_NEON_INTRINSICS)
+    decodeUTF8ToUTF16NEON(source, end, destination);
+#else
+    UNUSED_PARAM(source);
+    UNUSED_PARAM(end);
+    UNUSED_PARAM(destination);
+#endif
+}
+
+void TextCodecUTF8::consumePartialSequenceBytes(int count)
+{
+    // After an error the buffer can hold more than one sequence, so what follows the consumed bytes has to move up.
+    m_partialSequenceSize -= count;
+    memmove(m_partialSequence, m_partialSequence + count, m_partialSequenceSize);
 }
 
 void TextCodecUTF8::handleError(UChar*& destination, bool stopOnError, bool& sawError)
@@ -163,7 +186,7 @@ void TextCodecUTF8::handleError(UChar*& destination, bool stopOnError, bool& saw
         return;
     // Each error generates a replacement character and consumes one byte.
     *destination++ = replacementCharacter;
-    consumePartialSequenceByte();
+    consumePartialSequenceBytes(1);
 }
 
 template <>
@@ -173,7 +196,7 @@ bool TextCodecUTF8::handlePartialSequence<LChar>(LChar*& destination, const uint
     do {
         if (isASCII(m_partialSequence[0])) {
             *destination++ = m_partialSequence[0];
-            consumePartialSequenceByte();
+            consumePartialSequenceBytes(1);
             continue;
         }
         int count = nonASCIISequenceLength(m_partialSequence[0]);
@@ -202,7 +225,7 @@ bool TextCodecUTF8::handlePartialSequence<LChar>(LChar*& destination, const uint
         if ((character == nonCharacter) || (character > 0xff))
             return true;
 
-        m_partialSequenceSize -= count;
+        consumePartialSequenceBytes(count);
         *destination++ = character;
     } while (m_partialSequenceSize);
 
@@ -216,7 +239,7 @@ bool TextCodecUTF8::handlePartialSequence<UChar>(UChar*& destination, const uint
     do {
         if (isASCII(m_partialSequence[0])) {
             *destination++ = m_partialSequence[0];
-            consumePartialSequenceByte();
+            consumePartialSequenceBytes(1);
             continue;
         }
         int count = nonASCIISequenceLength(m_partialSequence[0]);
@@ -253,7 +276,7 @@ bool TextCodecUTF8::handlePartialSequence<UChar>(UChar*& destination, const uint
             continue;
         }
 
-        m_partialSequenceSize -= count;
+        consumePartialSequenceBytes(count);
         destination = appendCharacter(destination, character);
     } while (m_partialSequenceSize);
 
@@ -367,6 +390,7 @@ upConvertTo16Bit:
         }
         
         while (source < end) {
+            decodeUTF8Blocks(source, end, destination16);
             if (isASCII(*source)) {
                 // Fast path for ASCII. Most UTF-8 text will be ASCII.
                 if (isAlignedToMachineWord(source)) {
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTF8BlockDecoding_h
+#define UTF8BlockDecoding_h
+
+#include <stdint.h>
+#include <wtf/StdLibExtras.h>
+
+namespace WebCore {
+
+// What the vector UTF-8 decoders know about a block of up to 32 bytes, as one bit per byte.
+struct UTF8ByteClasses {
+    uint32_t continuation; // 80 to BF.
+    uint32_t lowContinuation; // 80 to 9F.
+    uint32_t twoByteLead; // C0 to DF.
+    uint32_t threeByteLead; // E0 to EF.
+    uint32_t leadE0;
+    uint32_t leadED;
+    uint32_t unsupportedLead; // C0, C1, and F0 to FF, which are invalid or start a surrogate pair.
+};
+
+// Returns the bits of the bytes at the start of the block that form complete and valid sequences of one
+// to three bytes, each of which decodes to a single UTF-16 code unit. The rest is left to the scalar
+// decoder, which handles four-byte sequences and turns invalid ones into replacement characters.
+inline uint32_t decodableUTF8Prefix(const UTF8ByteClasses& classes, uint32_t blockMask)
+{
+    uint32_t expectedContinuation = (classes.twoByteLead << 1) | (classes.threeByteLead << 1) | (classes.threeByteLead << 2);
+    uint32_t highContinuation = classes.continuation & ~classes.lowContinuation;
+    uint32_t errors = (expectedContinuation ^ classes.continuation) | classes.unsupportedLead
+        | (classes.leadE0 & (classes.lowContinuation >> 1)) // Overlong.
+        | (classes.leadED & (highContinuation >> 1)); // Surrogate.
+    errors &= blockMask;
+
+    uint32_t prefix = errors ? (errors & -errors) - 1 : blockMask;
+
+    // Everything before the first error is valid, but the last sequence may continue past it.
+    uint32_t lastByte = prefix ^ (prefix >> 1);
+    if ((classes.twoByteLead | classes.threeByteLead) & lastByte)
+        prefix >>= 1;
+    else if (classes.threeByteLead & (lastByte >> 1))
+        prefix >>= 2;
+    return prefix;
+}
+
+inline unsigned decodableUTF8Length(uint32_t prefix)
+{
+    return WTF::bitCount(static_cast<unsigned>(prefix));
+}
+
+// Byte shuffles that move the 16-bit lanes picked by a 4-bit mask to the front of a group of four lanes.
+// Indices with the high bit set produce zero, for both pshufb and vtbl.
+static const uint8_t utf16LaneCompaction[16][8] = {
+    { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 2, 3, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 0x80, 0x80, 0x80, 0x80 },
+    { 4, 5, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 4, 5, 0x80, 0x80, 0x80, 0x80 },
+    { 2, 3, 4, 5, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 5, 0x80, 0x80 },
+    { 6, 7, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 6, 7, 0x80, 0x80, 0x80, 0x80 },
+    { 2, 3, 6, 7, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 2, 3, 6, 7, 0x80, 0x80 },
+    { 4, 5, 6, 7, 0x80, 0x80, 0x80, 0x80 },
+    { 0, 1, 4, 5, 6, 7, 0x80, 0x80 },
+    { 2, 3, 4, 5, 6, 7, 0x80, 0x80 },
+    { 0, 1, 2, 3, 4, 5, 6, 7 },
+};
+
+} // namespace WebCore
+
+#endif // UTF8BlockDecoding_h
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTF8BlockDecodingNEON_h
+#define UTF8BlockDecodingNEON_h
+
+#if HAVE(ARM_NEON_INTRINSICS)
+
+#include "UTF8BlockDecoding.h"
+#include <arm_neon.h>
+#include <unicode/utypes.h>
+
+namespace WebCore {
+
+// NEON has no movemask, so add up the bits each lane stands for, a byte for each half of the vector.
+inline uint32_t byteMaskNEON(uint8x16_t bytes, uint8_t mask, uint8_t value)
+{
+    static const uint8_t laneBits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t matches = vceqq_u8(vandq_u8(bytes, vdupq_n_u8(mask)), vdupq_n_u8(value));
+    uint8x16_t bits = vandq_u8(matches, vld1q_u8(laneBits));
+    uint8x8_t sums = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+    sums = vpadd_u8(sums, sums);
+    sums = vpadd_u8(sums, sums);
+    return vget_lane_u8(sums, 0) | (vget_lane_u8(sums, 1) << 8);
+}
+
+inline UTF8ByteClasses classifyUTF8BytesNEON(uint8x16_t bytes)
+{
+    UTF8ByteClasses classes;
+    classes.continuation = byteMaskNEON(bytes, 0xC0, 0x80);
+    classes.lowContinuation = byteMaskNEON(bytes, 0xE0, 0x80);
+    classes.twoByteLead = byteMaskNEON(bytes, 0xE0, 0xC0);
+    classes.threeByteLead = byteMaskNEON(bytes, 0xF0, 0xE0);
+    classes.leadE0 = byteMaskNEON(bytes, 0xFF, 0xE0);
+    classes.leadED = byteMaskNEON(bytes, 0xFF, 0xED);
+    classes.unsupportedLead = byteMaskNEON(bytes, 0xFE, 0xC0) | byteMaskNEON(bytes, 0xF0, 0xF0);
+    return classes;
+}
+
+// Each argument holds eight zero-extended bytes: the byte at each position, and the two after it.
+// Lanes that start a sequence get its character; the others get garbage.
+inline uint16x8_t decodeUTF8LanesNEON(uint16x8_t first, uint16x8_t second, uint16x8_t third)
+{
+    const uint16x8_t low6Bits = vdupq_n_u16(0x3F);
+    uint16x8_t twoBytes = vorrq_u16(vshlq_n_u16(vandq_u16(first, vdupq_n_u16(0x1F)), 6), vandq_u16(second, low6Bits));
+    uint16x8_t threeBytes = vorrq_u16(vshlq_n_u16(first, 12), vshlq_n_u16(vandq_u16(second, low6Bits), 6));
+    threeBytes = vorrq_u16(threeBytes, vandq_u16(third, low6Bits));
+
+    uint16x8_t characters = vbslq_u16(vcgtq_u16(first, vdupq_n_u16(0xBF)), twoBytes, first);
+    return vbslq_u16(vcgtq_u16(first, vdupq_n_u16(0xDF)), threeBytes, characters);
+}
+
+inline UChar* storeUTF16LaneGroupNEON(uint16x4_t characters, unsigned leads, UChar* destination)
+{
+    uint8x8_t compacted = vtbl1_u8(vreinterpret_u8_u16(characters), vld1_u8(utf16LaneCompaction[leads]));
+    vst1_u8(reinterpret_cast<uint8_t*>(destination), compacted);
+    return destination + WTF::bitCount(leads);
+}
+
+// Stores the lanes picked by the low eight bits of leads, and returns the end of what it stored.
+// Writes up to eight characters regardless.
+inline UChar* storeUTF16LanesNEON(uint16x8_t characters, uint32_t leads, UChar* destination)
+{
+    destination = storeUTF16LaneGroupNEON(vget_low_u16(characters), leads & 0xF, destination);
+    return storeUTF16LaneGroupNEON(vget_high_u16(characters), (leads >> 4) & 0xF, destination);
+}
+
+// Decodes sixteen bytes at a time for as long as they are valid and have no four-byte sequences, and leaves source
+// at the first byte it could not decode. The destination needs room for as many characters as there are source bytes.
+inline void decodeUTF8ToUTF16NEON(const uint8_t*& source, const uint8_t* end, UChar*& destination)
+{
+    // Sequences that start at the end of a block are decoded from the two bytes that follow it.
+    while (end - source >= 18) {
+        uint8x16_t bytes = vld1q_u8(source);
+        if (!byteMaskNEON(bytes, 0x80, 0x80)) {
+            vst1q_u16(reinterpret_cast<uint16_t*>(destination), vmovl_u8(vget_low_u8(bytes)));
+            vst1q_u16(reinterpret_cast<uint16_t*>(destination + 8), vmovl_u8(vget_high_u8(bytes)));
+            source += 16;
+            destination += 16;
+            continue;
+        }
+
+        UTF8ByteClasses classes = classifyUTF8BytesNEON(bytes);
+        uint32_t decodable = decodableUTF8Prefix(classes, 0xFFFF);
+        if (!decodable)
+            return;
+        uint32_t leads = decodable & ~classes.continuation;
+
+        uint8x16_t second = vld1q_u8(source + 1);
+        uint8x16_t third = vld1q_u8(source + 2);
+        uint16x8_t characters = decodeUTF8LanesNEON(vmovl_u8(vget_low_u8(bytes)), vmovl_u8(vget_low_u8(second)), vmovl_u8(vget_low_u8(third)));
+        destination = storeUTF16LanesNEON(characters, leads, destination);
+        characters = decodeUTF8LanesNEON(vmovl_u8(vget_high_u8(bytes)), vmovl_u8(vget_high_u8(second)), vmovl_u8(vget_high_u8(third)));
+        destination = storeUTF16LanesNEON(characters, leads >> 8, destination);
+        source += decodableUTF8Length(decodable);
+    }
+}
+
+} // namespace WebCore
+
+#endif // HAVE(ARM_NEON_INTRINSICS)
+
+#endif // UTF8BlockDecodingNEON_h
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTF8BlockDecodingAVX2_h
+#define UTF8BlockDecodingAVX2_h
+
+#if HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#include "UTF8BlockDecodingSSE41.h"
+#include <immintrin.h>
+
+// These are built for AVX2 regardless of the compiler flags, so callers have to check cpuSupportsAVX2() first.
+#define WEBCORE_TARGET_AVX2 __attribute__((target("avx2")))
+
+namespace WebCore {
+
+WEBCORE_TARGET_AVX2 inline uint32_t byteMaskAVX2(__m256i bytes, uint8_t mask, uint8_t value)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(bytes, _mm256_set1_epi8(mask)), _mm256_set1_epi8(value)));
+}
+
+WEBCORE_TARGET_AVX2 inline UTF8ByteClasses classifyUTF8BytesAVX2(__m256i bytes)
+{
+    UTF8ByteClasses classes;
+    classes.continuation = byteMaskAVX2(bytes, 0xC0, 0x80);
+    classes.lowContinuation = byteMaskAVX2(bytes, 0xE0, 0x80);
+    classes.twoByteLead = byteMaskAVX2(bytes, 0xE0, 0xC0);
+    classes.threeByteLead = byteMaskAVX2(bytes, 0xF0, 0xE0);
+    classes.leadE0 = byteMaskAVX2(bytes, 0xFF, 0xE0);
+    classes.leadED = byteMaskAVX2(bytes, 0xFF, 0xED);
+    classes.unsupportedLead = byteMaskAVX2(bytes, 0xFE, 0xC0) | byteMaskAVX2(bytes, 0xF0, 0xF0);
+    return classes;
+}
+
+// decodeUTF8LanesSSE41() on sixteen positions, starting at source.
+WEBCORE_TARGET_AVX2 inline __m256i decodeUTF8LanesAVX2(const uint8_t* source)
+{
+    __m256i first = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+    __m256i second = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 1)));
+    __m256i third = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 2)));
+
+    const __m256i low6Bits = _mm256_set1_epi16(0x3F);
+    __m256i twoBytes = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(first, _mm256_set1_epi16(0x1F)), 6), _mm256_and_si256(second, low6Bits));
+    __m256i threeBytes = _mm256_or_si256(_mm256_slli_epi16(first, 12), _mm256_slli_epi16(_mm256_and_si256(second, low6Bits), 6));
+    threeBytes = _mm256_or_si256(threeBytes, _mm256_and_si256(third, low6Bits));
+
+    __m256i characters = _mm256_blendv_epi8(first, twoBytes, _mm256_cmpgt_epi16(first, _mm256_set1_epi16(0xBF)));
+    return _mm256_blendv_epi8(characters, threeBytes, _mm256_cmpgt_epi16(first, _mm256_set1_epi16(0xDF)));
+}
+
+// decodeUTF8ToUTF16SSE41() on 32 bytes at a time. The SSE4.1 loop takes over for the last few blocks.
+WEBCORE_TARGET_AVX2 inline void decodeUTF8ToUTF16AVX2(const uint8_t*& source, const uint8_t* end, UChar*& destination)
+{
+    while (end - source >= 34) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+        if (!_mm256_movemask_epi8(bytes)) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1)));
+            source += 32;
+            destination += 32;
+            continue;
+        }
+
+        UTF8ByteClasses classes = classifyUTF8BytesAVX2(bytes);
+        uint32_t decodable = decodableUTF8Prefix(classes, 0xFFFFFFFF);
+        if (!decodable)
+            return;
+        uint32_t leads = decodable & ~classes.continuation;
+
+        for (unsigned offset = 0; offset < 32 && (leads >> offset); offset += 16) {
+            __m256i characters = decodeUTF8LanesAVX2(source + offset);
+            destination = storeUTF16LanesSSE41(_mm256_castsi256_si128(characters), leads >> offset, destination);
+            destination = storeUTF16LanesSSE41(_mm256_extracti128_si256(characters, 1), leads >> (offset + 8), destination);
+        }
+        source += decodableUTF8Length(decodable);
+    }
+
+    decodeUTF8ToUTF16SSE41(source, end, destination);
+}
+
+} // namespace WebCore
+
+#undef WEBCORE_TARGET_AVX2
+
+#endif // HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#endif // UTF8BlockDecodingAVX2_h
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef UTF8BlockDecodingSSE41_h
+#define UTF8BlockDecodingSSE41_h
+
+#if HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#include "UTF8BlockDecoding.h"
+#include <smmintrin.h>
+#include <unicode/utypes.h>
+
+// These are built for SSE4.1 regardless of the compiler flags, so callers have to check cpuSupportsSSE41() first.
+#define WEBCORE_TARGET_SSE41 __attribute__((target("sse4.1")))
+
+namespace WebCore {
+
+WEBCORE_TARGET_SSE41 inline uint32_t byteMaskSSE41(__m128i bytes, uint8_t mask, uint8_t value)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(mask)), _mm_set1_epi8(value)));
+}
+
+WEBCORE_TARGET_SSE41 inline UTF8ByteClasses classifyUTF8BytesSSE41(__m128i bytes)
+{
+    UTF8ByteClasses classes;
+    classes.continuation = byteMaskSSE41(bytes, 0xC0, 0x80);
+    classes.lowContinuation = byteMaskSSE41(bytes, 0xE0, 0x80);
+    classes.twoByteLead = byteMaskSSE41(bytes, 0xE0, 0xC0);
+    classes.threeByteLead = byteMaskSSE41(bytes, 0xF0, 0xE0);
+    classes.leadE0 = byteMaskSSE41(bytes, 0xFF, 0xE0);
+    classes.leadED = byteMaskSSE41(bytes, 0xFF, 0xED);
+    classes.unsupportedLead = byteMaskSSE41(bytes, 0xFE, 0xC0) | byteMaskSSE41(bytes, 0xF0, 0xF0);
+    return classes;
+}
+
+// Each argument holds eight zero-extended bytes: the byte at each position, and the two after it.
+// Lanes that start a sequence get its character; the others get garbage.
+WEBCORE_TARGET_SSE41 inline __m128i decodeUTF8LanesSSE41(__m128i first, __m128i second, __m128i third)
+{
+    const __m128i low6Bits = _mm_set1_epi16(0x3F);
+    __m128i twoBytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, _mm_set1_epi16(0x1F)), 6), _mm_and_si128(second, low6Bits));
+    __m128i threeBytes = _mm_or_si128(_mm_slli_epi16(first, 12), _mm_slli_epi16(_mm_and_si128(second, low6Bits), 6));
+    threeBytes = _mm_or_si128(threeBytes, _mm_and_si128(third, low6Bits));
+
+    __m128i characters = _mm_blendv_epi8(first, twoBytes, _mm_cmpgt_epi16(first, _mm_set1_epi16(0xBF)));
+    return _mm_blendv_epi8(characters, threeBytes, _mm_cmpgt_epi16(first, _mm_set1_epi16(0xDF)));
+}
+
+// Stores the lanes picked by the low eight bits of leads, and returns the end of what it stored.
+// Writes up to eight characters regardless.
+WEBCORE_TARGET_SSE41 inline UChar* storeUTF16LanesSSE41(__m128i characters, uint32_t leads, UChar* destination)
+{
+    unsigned low = leads & 0xF;
+    unsigned high = (leads >> 4) & 0xF;
+    __m128i shuffle = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(utf16LaneCompaction[low])),
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(utf16LaneCompaction[high])));
+    shuffle = _mm_or_si128(shuffle, _mm_set_epi64x(0x0808080808080808, 0));
+    characters = _mm_shuffle_epi8(characters, shuffle);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), characters);
+    destination += WTF::bitCount(low);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_unpackhi_epi64(characters, characters));
+    return destination + WTF::bitCount(high);
+}
+
+WEBCORE_TARGET_SSE41 inline __m128i loadUTF8BytesSSE41(const uint8_t* source)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+}
+
+WEBCORE_TARGET_SSE41 inline __m128i zeroExtendHighBytesSSE41(__m128i bytes)
+{
+    return _mm_unpackhi_epi8(bytes, _mm_setzero_si128());
+}
+
+// Decodes sixteen bytes at a time for as long as they are valid and have no four-byte sequences, and leaves source
+// at the first byte it could not decode. The destination needs room for as many characters as there are source bytes.
+WEBCORE_TARGET_SSE41 inline void decodeUTF8ToUTF16SSE41(const uint8_t*& source, const uint8_t* end, UChar*& destination)
+{
+    // Sequences that start at the end of a block are decoded from the two bytes that follow it.
+    while (end - source >= 18) {
+        __m128i bytes = loadUTF8BytesSSE41(source);
+        if (!_mm_movemask_epi8(bytes)) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_cvtepu8_epi16(bytes));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 8), zeroExtendHighBytesSSE41(bytes));
+            source += 16;
+            destination += 16;
+            continue;
+        }
+
+        UTF8ByteClasses classes = classifyUTF8BytesSSE41(bytes);
+        uint32_t decodable = decodableUTF8Prefix(classes, 0xFFFF);
+        if (!decodable)
+            return;
+        uint32_t leads = decodable & ~classes.continuation;
+
+        __m128i second = loadUTF8BytesSSE41(source + 1);
+        __m128i third = loadUTF8BytesSSE41(source + 2);
+        __m128i characters = decodeUTF8LanesSSE41(_mm_cvtepu8_epi16(bytes), _mm_cvtepu8_epi16(second), _mm_cvtepu8_epi16(third));
+        destination = storeUTF16LanesSSE41(characters, leads, destination);
+        characters = decodeUTF8LanesSSE41(zeroExtendHighBytesSSE41(bytes), zeroExtendHighBytesSSE41(second), zeroExtendHighBytesSSE41(third));
+        destination = storeUTF16LanesSSE41(characters, leads >> 8, destination);
+        source += decodableUTF8Length(decodable);
+    }
+}
+
+} // namespace WebCore
+
+#undef WEBCORE_TARGET_SSE41
+
+#endif // HAVE(X86_SSE2_INTRINSICS) && COMPILER(GCC_OR_CLANG)
+
+#endif // UTF8BlockDecodingSSE41_h
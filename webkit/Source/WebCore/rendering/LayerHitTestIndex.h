@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LayerHitTestIndex_h
+#define LayerHitTestIndex_h
+
+#include "LayoutRectGrid.h"
+
+namespace WebCore {
+
+// The bounds of the layers in one of a stacking container's layer lists, bucketed into a coarse grid so that
+// hit testing a long list only visits the layers whose bounds contain the hit test area. Layers are
+// identified by their position in the list. Layers that can be hit outside of their bounds are
+// always returned.
+class LayerHitTestIndex {
+    WTF_MAKE_NONCOPYABLE(LayerHitTestIndex); WTF_MAKE_FAST_ALLOCATED;
+public:
+    // Shorter lists are cheaper to walk than to index.
+    static const unsigned minimumLayerCount = 32;
+
+    LayerHitTestIndex() { }
+
+    void append(const LayoutRect& bounds)
+    {
+        unsigned index = m_layerCount++;
+        // Empty bounds never contain anything.
+        if (bounds.isEmpty())
+            return;
+
+        m_layerRects.append(std::make_pair(index, bounds));
+        m_grid.add(m_layerRects.size() - 1, bounds);
+    }
+
+    void appendAlwaysTested()
+    {
+        m_alwaysTestedIndexes.append(m_layerCount++);
+    }
+
+    unsigned layerCount() const { return m_layerCount; }
+
+    // Fills candidates with the list positions of the layers that may be hit in area, in list order.
+    // Returns false if area covers too much of the grid for the index to help.
+    bool collectCandidates(const LayoutRect& area, Vector<unsigned>& candidates) const
+    {
+        LayoutRectGrid::CellRange cells;
+        if (!LayoutRectGrid::cellRangeForRect(area, cells))
+            return false;
+
+        candidates.clear();
+        candidates.appendVector(m_alwaysTestedIndexes);
+
+        m_grid.findCandidate(cells, [&](unsigned rectIndex) {
+            if (m_layerRects[rectIndex].second.intersects(area))
+                candidates.append(m_layerRects[rectIndex].first);
+            return false;
+        });
+
+        std::sort(candidates.begin(), candidates.end());
+        candidates.shrink(std::unique(candidates.begin(), candidates.end()) - candidates.begin());
+        return true;
+    }
+
+private:
+    unsigned m_layerCount { 0 };
+    Vector<std::pair<unsigned, LayoutRect>> m_layerRects;
+    LayoutRectGrid m_grid;
+    Vector<unsigned> m_alwaysTestedIndexes;
+};
+
+} // namespace WebCore
+
+#endif // LayerHitTestIndex_h
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LayoutRectGrid_h
+#define LayoutRectGrid_h
+
+#include "IntPoint.h"
+#include "IntPointHash.h"
+#include "LayoutRect.h"
+#include <wtf/HashMap.h>
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// Buckets rects into a coarse grid so that a query only has to test the rects near it. The grid only
+// holds indexes, the rects themselves are kept by the owner. Rects spanning many cells are kept in a
+// separate list that every query visits.
+class LayoutRectGrid {
+public:
+    struct CellRange {
+        int minX;
+        int minY;
+        int maxX;
+        int maxY;
+    };
+
+    // Returns false if rect covers too much of the grid for it to help.
+    static bool cellRangeForRect(const LayoutRect& rect, CellRange& cells)
+    {
+        cells.minX = cellCoordinate(rect.x().floor());
+        cells.minY = cellCoordinate(rect.y().floor());
+        cells.maxX = cellCoordinate(std::max(rect.x().floor(), rect.maxX().ceil() - 1));
+        cells.maxY = cellCoordinate(std::max(rect.y().floor(), rect.maxY().ceil() - 1));
+        return static_cast<int64_t>(cells.maxX - cells.minX + 1) * (cells.maxY - cells.minY + 1) <= maximumCellsPerRect;
+    }
+
+    void add(unsigned index, const LayoutRect& rect)
+    {
+        // Empty rects never intersect anything.
+        if (rect.isEmpty())
+            return;
+
+        CellRange cells;
+        if (!cellRangeForRect(rect, cells)) {
+            m_largeRectIndexes.append(index);
+            return;
+        }
+
+        for (int y = cells.minY; y <= cells.maxY; ++y) {
+            for (int x = cells.minX; x <= cells.maxX; ++x)
+                m_grid.add(IntPoint(x, y), Vector<unsigned>()).iterator->value.append(index);
+        }
+    }
+
+    // Calls function with the index of every rect that may intersect cells, until it returns true. Rects
+    // spanning several of the cells are visited more than once. Returns whether function returned true.
+    template<typename Function>
+    bool findCandidate(const CellRange& cells, const Function& function) const
+    {
+        for (auto index : m_largeRectIndexes) {
+            if (function(index))
+                return true;
+        }
+
+        for (int y = cells.minY; y <= cells.maxY; ++y) {
+            for (int x = cells.minX; x <= cells.maxX; ++x) {
+                auto iterator = m_grid.find(IntPoint(x, y));
+                if (iterator == m_grid.end())
+                    continue;
+                for (auto index : iterator->value) {
+                    if (function(index))
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    static const int cellSize = 256;
+    // Rects spanning more cells than this are kept in a list that is always visited.
+    static const int maximumCellsPerRect = 64;
+
+    static int cellCoordinate(int value)
+    {
+        return value >= 0 ? value / cellSize : -((-value + cellSize - 1) / cellSize);
+    }
+
+    HashMap<IntPoint, Vector<unsigned>> m_grid;
+    Vector<unsigned> m_largeRectIndexes;
+};
+
+} // namespace WebCore
+
+#endif // LayoutRectGrid_h
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OverlapMapContainer_h
+#define OverlapMapContainer_h
+
+#include "LayoutRectGrid.h"
+#include <wtf/Vector.h>
+
+namespace WebCore {
+
+// The bounds of the layers composited so far in one compositing container, used by
+// RenderLayerCompositor to decide whether a later layer has to be composited because it overlaps them.
+// Once there are enough rects, they are also bucketed into a coarse grid so that a query only
+// tests the rects near it instead of every composited layer on the page.
+class OverlapMapContainer {
+public:
+    void add(const LayoutRect& bounds)
+    {
+        m_layerRects.append(bounds);
+        m_boundingBox.unite(bounds);
+
+        if (m_layerRects.size() == minimumRectCountForGrid) {
+            for (unsigned i = 0; i < m_layerRects.size(); ++i)
+                m_grid.add(i, m_layerRects[i]);
+        } else if (m_layerRects.size() > minimumRectCountForGrid)
+            m_grid.add(m_layerRects.size() - 1, bounds);
+    }
+
+    bool overlapsLayers(const LayoutRect& bounds) const
+    {
+        // Checking with the bounding box will quickly reject cases when
+        // layers are created for lists of items going in one direction and
+        // never overlap with each other.
+        if (!bounds.intersects(m_boundingBox))
+            return false;
+
+        LayoutRectGrid::CellRange cells;
+        if (m_layerRects.size() < minimumRectCountForGrid || !LayoutRectGrid::cellRangeForRect(bounds, cells))
+            return overlapsAnyLayer(bounds);
+
+        return m_grid.findCandidate(cells, [&](unsigned index) {
+            return m_layerRects[index].intersects(bounds);
+        });
+    }
+
+    void unite(const OverlapMapContainer& otherContainer)
+    {
+        m_layerRects.reserveCapacity(m_layerRects.size() + otherContainer.m_layerRects.size());
+        for (const auto& layerRect : otherContainer.m_layerRects)
+            add(layerRect);
+    }
+
+private:
+    static const unsigned minimumRectCountForGrid = 32;
+
+    bool overlapsAnyLayer(const LayoutRect& bounds) const
+    {
+        for (const auto& layerRect : m_layerRects) {
+            if (layerRect.intersects(bounds))
+                return true;
+        }
+        return false;
+    }
+
+    Vector<LayoutRect> m_layerRects;
+    LayoutRect m_boundingBox;
+    LayoutRectGrid m_grid;
+};
+
+} // namespace WebCore
+
+#endif // OverlapMapContainer_h
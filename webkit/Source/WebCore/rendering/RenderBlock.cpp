@@ -365,8 +365,9 @@ bool RenderBlock::hasRareData() const
 
 void RenderBlock::removePositionedObjectsIfNeeded(const RenderStyle& oldStyle, const RenderStyle& newStyle)
 {
-    bool hadTransform = oldStyle.hasTransformRelatedProperty();
-    bool willHaveTransform = newStyle.hasTransformRelatedProperty();
+    // Layout and paint containment make a containing block for positioned descendants, just like a transform.
+    bool hadTransform = oldStyle.hasTransformRelatedProperty() || oldStyle.containsLayout() || oldStyle.containsPaint();
+    bool willHaveTransform = newStyle.hasTransformRelatedProperty() || newStyle.containsLayout() || newStyle.containsPaint();
     if (oldStyle.position() == newStyle.position() && hadTransform == willHaveTransform)
         return;
 
@@ -2763,6 +2764,8 @@ void RenderBlock::computePreferredLogicalWidths()
     if (!isTableCell() && styleToUse.logicalWidth().isFixed() && styleToUse.logicalWidth().value() >= 0
         && !(isDeprecatedFlexItem() && !styleToUse.logicalWidth().intValue()))
         m_minPreferredLogicalWidth = m_maxPreferredLogicalWidth = adjustContentBoxLogicalWidthForBoxSizing(styleToUse.logicalWidth().value());
+    else if (shouldApplySizeContainment())
+        m_minPreferredLogicalWidth = m_maxPreferredLogicalWidth = intrinsicScrollbarLogicalWidth();
     else
         computeIntrinsicLogicalWidths(m_minPreferredLogicalWidth, m_maxPreferredLogicalWidth);
     
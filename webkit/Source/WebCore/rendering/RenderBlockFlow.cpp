@@ -497,6 +497,10 @@ void RenderBlockFlow::layoutBlock(bool relayoutChildren, LayoutUnit pageLogicalH
         return;
     }
 
+    // Size containment lays the box out as if it had no content.
+    if (shouldApplySizeContainment())
+        setLogicalHeight(borderAndPaddingLogicalHeight() + scrollbarLogicalHeight());
+
     // Calculate our new height.
     LayoutUnit oldHeight = logicalHeight();
     LayoutUnit oldClientAfterEdge = clientLogicalBottom();
@@ -3530,6 +3534,10 @@ VisiblePosition RenderBlockFlow::positionForPoint(const LayoutPoint& point, cons
 void RenderBlockFlow::addFocusRingRectsForInlineChildren(Vector<LayoutRect>& rects, const LayoutPoint& additionalOffset, const RenderLayerModelObject*)
 {
     ASSERT(childrenInline());
+    if (auto simpleLineLayout = this->simpleLineLayout()) {
+        SimpleLineLayout::collectFocusRingRects(*this, *simpleLineLayout, rects, additionalOffset);
+        return;
+    }
     for (RootInlineBox* curr = firstRootBox(); curr; curr = curr->nextRootBox()) {
         LayoutUnit top = std::max<LayoutUnit>(curr->lineTop(), curr->top());
         LayoutUnit bottom = std::min<LayoutUnit>(curr->lineBottom(), curr->top() + curr->height());
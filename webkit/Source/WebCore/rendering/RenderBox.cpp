@@ -503,9 +503,10 @@ void RenderBox::updateFromStyle()
     setFloating(!isOutOfFlowPositioned() && styleToUse.isFloating());
 
     // We also handle <body> and <html>, whose overflow applies to the viewport.
-    if (styleToUse.overflowX() != OVISIBLE && !isDocElementRenderer && isRenderBlock()) {
+    // Paint containment clips like overflow: hidden does.
+    if ((styleToUse.overflowX() != OVISIBLE || shouldApplyPaintContainment()) && !isDocElementRenderer && isRenderBlock()) {
         bool boxHasOverflowClip = true;
-        if (isBody()) {
+        if (isBody() && styleToUse.overflowX() != OVISIBLE) {
             // Overflow on the body can propagate to the viewport under the following conditions.
             // (1) The root element is <html>.
             // (2) We are the primary <body> (can be checked by looking at document.body).
@@ -4519,6 +4520,7 @@ bool RenderBox::createsNewFormattingContext() const
 {
     return (isInlineBlockOrInlineTable() && !isAnonymousInlineBlock()) || isFloatingOrOutOfFlowPositioned() || hasOverflowClip() || isFlexItemIncludingDeprecated()
         || isTableCell() || isTableCaption() || isFieldset() || isWritingModeRoot() || isDocumentElementRenderer() || isRenderFlowThread() || isRenderRegion()
+        || shouldApplyLayoutContainment() || shouldApplyPaintContainment()
 #if ENABLE(CSS_GRID_LAYOUT)
         || isGridItem()
 #endif
@@ -4872,9 +4874,10 @@ LayoutRect RenderBox::logicalLayoutOverflowRectForPropagation(const RenderStyle*
 
 LayoutRect RenderBox::layoutOverflowRectForPropagation(const RenderStyle* parentStyle) const
 {
-    // Only propagate interior layout overflow if we don't clip it.
+    // Only propagate interior layout overflow if we don't clip it. Layout containment
+    // turns it into visual overflow.
     LayoutRect rect = borderBoxRect();
-    if (!hasOverflowClip())
+    if (!hasOverflowClip() && !shouldApplyLayoutContainment())
         rect.unite(layoutOverflowRect());
 
     bool hasTransform = this->hasTransform();
@@ -600,6 +600,18 @@ InterpolationQuality RenderBoxModelObject::chooseInterpolationQuality(GraphicsCo
     return view().imageQualityController().chooseInterpolationQuality(context, this, image, layer, size);
 }
 
+DecodingMode RenderBoxModelObject::decodingModeForImageDraw(const PaintInfo& paintInfo) const
+{
+    if (!frame().settings().asynchronousImageDecodingEnabled())
+        return DecodingMode::Synchronous;
+
+    // Printing and snapshots only get one chance to paint.
+    if (document().printing() || ((paintInfo.paintBehavior | view().frameView().paintBehavior()) & PaintBehaviorFlattenCompositingLayers))
+        return DecodingMode::Synchronous;
+
+    return DecodingMode::Asynchronous;
+}
+
 void RenderBoxModelObject::paintMaskForTextFillBox(ImageBuffer* maskImage, const IntRect& maskRect, InlineFlowBox* box, const LayoutRect& scrolledPaintRect)
 {
     GraphicsContext& maskImageContext = maskImage->context();
@@ -841,7 +853,9 @@ void RenderBoxModelObject::paintFillLayerExtended(const PaintInfo& paintInfo, co
             context.setDrawLuminanceMask(bgLayer->maskSourceType() == MaskLuminance);
 
             InterpolationQuality interpolation = chooseInterpolationQuality(context, *image, bgLayer, geometry.tileSize());
-            context.drawTiledImage(*image, geometry.destRect(), toLayoutPoint(geometry.relativePhase()), geometry.tileSize(), geometry.spaceSize(), ImagePaintingOptions(compositeOp, bgLayer->blendMode(), ImageOrientationDescription(), interpolation));
+            ImagePaintingOptions options(compositeOp, bgLayer->blendMode(), ImageOrientationDescription(), interpolation);
+            options.m_decodingMode = decodingModeForImageDraw(paintInfo);
+            context.drawTiledImage(*image, geometry.destRect(), toLayoutPoint(geometry.relativePhase()), geometry.tileSize(), geometry.spaceSize(), options);
         }
     }
 
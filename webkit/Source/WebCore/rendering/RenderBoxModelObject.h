@@ -254,6 +254,7 @@ protected:
     LayoutRect borderInnerRectAdjustedForBleedAvoidance(const GraphicsContext&, const LayoutRect&, BackgroundBleedAvoidance) const;
 
     InterpolationQuality chooseInterpolationQuality(GraphicsContext&, Image&, const void*, const LayoutSize&);
+    DecodingMode decodingModeForImageDraw(const PaintInfo&) const;
 
     void setContinuation(RenderBoxModelObject*);
 
@@ -73,6 +73,11 @@ public:
     bool canContainFixedPositionObjects() const;
     bool canContainAbsolutelyPositionedObjects() const;
 
+    // CSS containment applies to block containers and atomic inlines, not to internal table boxes.
+    bool shouldApplyLayoutContainment() const { return style().containsLayout() && isRenderBlock() && !isTablePart(); }
+    bool shouldApplyPaintContainment() const { return style().containsPaint() && isRenderBlock() && !isTablePart(); }
+    bool shouldApplySizeContainment() const { return style().containsSize() && isRenderBlock() && !isTablePart() && !isTable(); }
+
     Color selectionColor(int colorProperty) const;
     std::unique_ptr<RenderStyle> selectionPseudoStyle() const;
 
@@ -193,7 +198,7 @@ public:
 
     void registerForVisibleInViewportCallback();
     void unregisterForVisibleInViewportCallback();
-    void visibleInViewportStateChanged(VisibleInViewportState);
+    virtual void visibleInViewportStateChanged(VisibleInViewportState);
 
     bool repaintForPausedImageAnimationsIfNeeded(const IntRect& visibleRect);
     bool hasPausedImageAnimations() const { return m_hasPausedImageAnimations; }
@@ -418,6 +423,8 @@ inline bool RenderElement::canContainFixedPositionObjects() const
 {
     return isRenderView()
         || (hasTransform() && isRenderBlock())
+        || shouldApplyLayoutContainment()
+        || shouldApplyPaintContainment()
         || isSVGForeignObject()
         || isOutOfFlowRenderFlowThread();
 }
@@ -426,6 +433,8 @@ inline bool RenderElement::canContainAbsolutelyPositionedObjects() const
 {
     return style().position() != StaticPosition
         || (isRenderBlock() && hasTransformRelatedProperty())
+        || shouldApplyLayoutContainment()
+        || shouldApplyPaintContainment()
         || isSVGForeignObject()
         || isRenderView();
 }
@@ -240,6 +240,11 @@ public:
 
     SizingOperation sizingOperation { TrackSizing };
 
+    // Set when no grid item changed since the previous layout, so the cached track sizes are still valid inputs.
+    bool canReuseCachedTrackSizes { false };
+    // Row sizes depend on the column sizes through the items' logical heights.
+    bool columnTrackSizesChanged { true };
+
     enum SizingState { ColumnSizingFirstIteration, RowSizingFirstIteration, ColumnSizingSecondIteration, RowSizingSecondIteration};
     SizingState sizingState { ColumnSizingFirstIteration };
     void advanceNextState()
@@ -348,6 +353,8 @@ void RenderGrid::styleDidChange(StyleDifference diff, const RenderStyle* oldStyl
     if (!oldStyle || diff != StyleDifferenceLayout)
         return;
 
+    clearTrackSizingCaches();
+
     const RenderStyle& newStyle = style();
     if (defaultAlignmentChangedToStretchInRowAxis(*oldStyle, newStyle) || defaultAlignmentChangedFromStretchInRowAxis(*oldStyle, newStyle)
         || defaultAlignmentChangedFromStretchInColumnAxis(*oldStyle, newStyle)) {
@@ -365,6 +372,18 @@ void RenderGrid::styleDidChange(StyleDifference diff, const RenderStyle* oldStyl
     }
 }
 
+void RenderGrid::removeChild(RenderObject& child)
+{
+    if (is<RenderBox>(child)) {
+        m_logicalHeightContributions.remove(&downcast<RenderBox>(child));
+        m_gridItemSizingInputs.remove(&downcast<RenderBox>(child));
+    }
+    m_columnTrackSizesCache.isValid = false;
+    m_rowTrackSizesCache.isValid = false;
+    m_intrinsicRowTrackSizesCache.isValid = false;
+    RenderBlock::removeChild(child);
+}
+
 unsigned RenderGrid::gridColumnCount() const
 {
     ASSERT(!m_gridIsDirty);
@@ -401,12 +420,123 @@ void RenderGrid::computeTrackSizesForDirection(GridTrackSizingDirection directio
     sizingData.setFreeSpaceForDirection(direction, freeSpace - totalGuttersSize);
     sizingData.sizingOperation = TrackSizing;
 
-    LayoutUnit baseSizes, growthLimits;
-    computeUsedBreadthOfGridTracks(direction, sizingData, baseSizes, growthLimits);
+    Vector<GridTrack>& tracks = direction == ForColumns ? sizingData.columnTracks : sizingData.rowTracks;
+    TrackSizesCache& cache = direction == ForColumns ? m_columnTrackSizesCache : m_rowTrackSizesCache;
+    bool canReuseCache = sizingData.canReuseCachedTrackSizes && (direction == ForColumns || !sizingData.columnTrackSizesChanged)
+        && cache.isValid && cache.availableSpace == freeSpace && cache.baseSizes.size() == tracks.size();
+
+    if (canReuseCache) {
+        restoreTrackSizes(tracks, cache);
+        sizingData.setFreeSpaceForDirection(direction, cache.freeSpace);
+        if (direction == ForColumns)
+            sizingData.columnTrackSizesChanged = false;
+    } else {
+        LayoutUnit baseSizes, growthLimits;
+        computeUsedBreadthOfGridTracks(direction, sizingData, baseSizes, growthLimits);
+        ++m_trackSizingPassCount;
+
+        bool trackSizesChanged = storeTrackSizes(tracks, cache, baseSizes, growthLimits);
+        cache.availableSpace = freeSpace;
+        cache.freeSpace = sizingData.freeSpaceForDirection(direction);
+        if (direction == ForColumns)
+            sizingData.columnTrackSizesChanged = trackSizesChanged;
+    }
+
     ASSERT(tracksAreWiderThanMinTrackBreadth(direction, sizingData));
     sizingData.advanceNextState();
 }
 
+void RenderGrid::restoreTrackSizes(Vector<GridTrack>& tracks, const TrackSizesCache& cache)
+{
+    ASSERT(cache.isValid && cache.baseSizes.size() == tracks.size());
+    for (unsigned i = 0; i < tracks.size(); ++i) {
+        tracks[i].setBaseSize(cache.baseSizes[i]);
+        tracks[i].setGrowthLimit(cache.growthLimits[i]);
+    }
+}
+
+bool RenderGrid::storeTrackSizes(const Vector<GridTrack>& tracks, TrackSizesCache& cache, LayoutUnit baseSizesWithoutMaximization, LayoutUnit growthLimitsWithoutMaximization)
+{
+    bool trackSizesChanged = !cache.isValid || cache.baseSizes.size() != tracks.size();
+    cache.baseSizes.resize(tracks.size());
+    cache.growthLimits.resize(tracks.size());
+    for (unsigned i = 0; i < tracks.size(); ++i) {
+        trackSizesChanged = trackSizesChanged || cache.baseSizes[i] != tracks[i].baseSize();
+        cache.baseSizes[i] = tracks[i].baseSize();
+        cache.growthLimits[i] = tracks[i].growthLimit();
+    }
+    cache.isValid = true;
+    cache.baseSizesWithoutMaximization = baseSizesWithoutMaximization;
+    cache.growthLimitsWithoutMaximization = growthLimitsWithoutMaximization;
+    return trackSizesChanged;
+}
+
+RenderGrid::GridItemSizingInputs RenderGrid::sizingInputsForChild(RenderBox& child) const
+{
+    const RenderStyle& childStyle = child.style();
+    return {
+        cachedGridArea(child),
+        child.minPreferredLogicalWidth(),
+        child.maxPreferredLogicalWidth(),
+        childStyle.logicalWidth(),
+        childStyle.logicalMinWidth(),
+        childStyle.logicalHeight(),
+        childStyle.logicalMinHeight(),
+        childStyle.marginStartUsing(&style()),
+        childStyle.marginEndUsing(&style())
+    };
+}
+
+bool RenderGrid::dirtyGridItemContributionsAreUnchanged()
+{
+    for (RenderBox* child = firstChildBox(); child; child = child->nextSiblingBox()) {
+        if (child->isOutOfFlowPositioned())
+            continue;
+        if (!child->needsLayout() && !child->preferredLogicalWidthsDirty())
+            continue;
+
+        auto inputs = m_gridItemSizingInputs.find(child);
+        if (inputs == m_gridItemSizingInputs.end() || inputs->value != sizingInputsForChild(*child))
+            return false;
+
+        // The rows never asked for the logical height of an item that only spans fixed rows.
+        auto contribution = m_logicalHeightContributions.find(child);
+        if (contribution == m_logicalHeightContributions.end())
+            continue;
+
+        // The item has to be laid out anyway. Doing it at the column breadth it had lets us see whether
+        // its block-axis contribution moved.
+        LayoutUnit overrideSize = contribution->value.overrideContainingBlockLogicalWidth;
+        if (!hasOverrideContainingBlockContentSizeForChild(*child, ForColumns) || overrideContainingBlockContentSizeForChild(*child, ForColumns) != overrideSize) {
+            setOverrideContainingBlockContentSizeForChild(*child, ForColumns, overrideSize);
+            child->setNeedsLayout(MarkOnlyThis);
+        }
+        LayoutUnit logicalHeight = logicalHeightForChild(*child);
+        bool contributionChanged = logicalHeight != contribution->value.logicalHeight;
+        contribution->value.logicalHeight = logicalHeight;
+        if (contributionChanged)
+            return false;
+    }
+    return true;
+}
+
+void RenderGrid::recordGridItemSizingInputs()
+{
+    for (RenderBox* child = firstChildBox(); child; child = child->nextSiblingBox()) {
+        if (!child->isOutOfFlowPositioned())
+            m_gridItemSizingInputs.set(child, sizingInputsForChild(*child));
+    }
+}
+
+void RenderGrid::clearTrackSizingCaches()
+{
+    m_logicalHeightContributions.clear();
+    m_gridItemSizingInputs.clear();
+    m_columnTrackSizesCache.isValid = false;
+    m_rowTrackSizesCache.isValid = false;
+    m_intrinsicRowTrackSizesCache.isValid = false;
+}
+
 void RenderGrid::repeatTracksSizingIfNeeded(GridSizingData& sizingData, LayoutUnit availableSpaceForColumns, LayoutUnit availableSpaceForRows)
 {
     ASSERT(!m_gridIsDirty);
@@ -444,9 +574,14 @@ void RenderGrid::layoutBlock(bool relayoutChildren, LayoutUnit)
     updateLogicalWidth();
     bool logicalHeightWasIndefinite = !computeContentLogicalHeight(MainOrPreferredSize, style().logicalHeight(), Nullopt);
 
+    // Item contributions might depend on the position in the fragmentation context, so they cannot be kept across layouts.
+    if (relayoutChildren || view().layoutState()->isPaginated())
+        clearTrackSizingCaches();
+
     placeItemsOnGrid();
 
     GridSizingData sizingData(gridColumnCount(), gridRowCount());
+    sizingData.canReuseCachedTrackSizes = !m_hasAnyOrthogonalChild && dirtyGridItemContributionsAreUnchanged();
 
     // At this point the logical width is always definite as the above call to updateLogicalWidth()
     // properly resolves intrinsic sizes. We cannot do the same for heights though because many code
@@ -487,6 +622,8 @@ void RenderGrid::layoutBlock(bool relayoutChildren, LayoutUnit)
     applyStretchAlignmentToTracksIfNeeded(ForRows, sizingData);
 
     layoutGridItems(sizingData);
+    if (!m_hasAnyOrthogonalChild)
+        recordGridItemSizingInputs();
 
     if (size() != previousSize)
         relayoutChildren = true;
@@ -552,7 +689,16 @@ void RenderGrid::computeIntrinsicLogicalHeight(GridSizingData& sizingData)
     sizingData.setFreeSpaceForDirection(ForRows, Nullopt);
     sizingData.sizingOperation = IntrinsicSizeComputation;
     LayoutUnit minHeight, maxHeight;
-    computeUsedBreadthOfGridTracks(ForRows, sizingData, minHeight, maxHeight);
+    TrackSizesCache& cache = m_intrinsicRowTrackSizesCache;
+    if (sizingData.canReuseCachedTrackSizes && !sizingData.columnTrackSizesChanged && cache.isValid && cache.baseSizes.size() == sizingData.rowTracks.size()) {
+        restoreTrackSizes(sizingData.rowTracks, cache);
+        minHeight = cache.baseSizesWithoutMaximization;
+        maxHeight = cache.growthLimitsWithoutMaximization;
+    } else {
+        computeUsedBreadthOfGridTracks(ForRows, sizingData, minHeight, maxHeight);
+        ++m_trackSizingPassCount;
+        storeTrackSizes(sizingData.rowTracks, cache, minHeight, maxHeight);
+    }
 
     // FIXME: This should be really added to the intrinsic height in RenderBox::computeContentAndScrollbarLogicalHeightUsing().
     // Remove this when that is fixed.
@@ -898,6 +1044,27 @@ LayoutUnit RenderGrid::logicalHeightForChild(RenderBox& child) const
     return child.logicalHeight() + child.marginLogicalHeight();
 }
 
+LayoutUnit RenderGrid::logicalHeightContributionForChild(RenderBox& child, GridSizingData& sizingData) const
+{
+    GridTrackSizingDirection childInlineDirection = flowAwareDirectionForChild(child, ForColumns);
+    LayoutUnit overrideSize = gridAreaBreadthForChild(child, childInlineDirection, sizingData);
+
+    // Once its block-axis override size is cleared, the logical height of |child| only depends on its own content
+    // and on its inline-axis override size. If neither changed we can skip laying it out again.
+    bool isCacheable = !isOrthogonalChild(child) && shouldClearOverrideContainingBlockContentSizeForChild(child, ForRows);
+    if (isCacheable && !child.needsLayout()) {
+        auto it = m_logicalHeightContributions.find(&child);
+        if (it != m_logicalHeightContributions.end() && it->value.overrideContainingBlockLogicalWidth == overrideSize)
+            return it->value.logicalHeight;
+    }
+
+    if (updateOverrideContainingBlockContentSizeForChild(child, childInlineDirection, sizingData))
+        child.setNeedsLayout(MarkOnlyThis);
+    LayoutUnit logicalHeight = logicalHeightForChild(child);
+    m_logicalHeightContributions.set(&child, LogicalHeightContribution { overrideSize, logicalHeight });
+    return logicalHeight;
+}
+
 LayoutUnit RenderGrid::minSizeForChild(RenderBox& child, GridTrackSizingDirection direction, GridSizingData& sizingData) const
 {
     GridTrackSizingDirection childInlineDirection = flowAwareDirectionForChild(child, ForColumns);
@@ -952,9 +1119,7 @@ LayoutUnit RenderGrid::minContentForChild(RenderBox& child, GridTrackSizingDirec
         return child.logicalHeight() + child.marginLogicalHeight();
     }
 
-    if (updateOverrideContainingBlockContentSizeForChild(child, childInlineDirection, sizingData))
-        child.setNeedsLayout(MarkOnlyThis);
-    return logicalHeightForChild(child);
+    return logicalHeightContributionForChild(child, sizingData);
 }
 
 LayoutUnit RenderGrid::maxContentForChild(RenderBox& child, GridTrackSizingDirection direction, GridSizingData& sizingData) const
@@ -980,9 +1145,7 @@ LayoutUnit RenderGrid::maxContentForChild(RenderBox& child, GridTrackSizingDirec
         return child.logicalHeight() + child.marginLogicalHeight();
     }
 
-    if (updateOverrideContainingBlockContentSizeForChild(child, childInlineDirection, sizingData))
-        child.setNeedsLayout(MarkOnlyThis);
-    return logicalHeightForChild(child);
+    return logicalHeightContributionForChild(child, sizingData);
 }
 
 class GridItemWithSpan {
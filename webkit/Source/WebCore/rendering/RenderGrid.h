@@ -52,6 +52,7 @@ public:
     Element& element() const { return downcast<Element>(nodeForNonAnonymous()); }
 
     void styleDidChange(StyleDifference, const RenderStyle* oldStyle) override;
+    void removeChild(RenderObject&) override;
     void layoutBlock(bool relayoutChildren, LayoutUnit pageLogicalHeight = 0) override;
 
     bool avoidsFloats() const override { return true; }
@@ -65,6 +66,9 @@ public:
 
     size_t autoRepeatCountForDirection(GridTrackSizingDirection) const;
 
+    // How many times the tracks of either direction were sized rather than taken from the last layout. For testing.
+    unsigned trackSizingPassCount() const { return m_trackSizingPassCount; }
+
 private:
     const char* renderName() const override;
     bool isRenderGrid() const override { return true; }
@@ -102,6 +106,14 @@ private:
     void computeIntrinsicLogicalHeight(GridSizingData&);
     LayoutUnit computeTrackBasedLogicalHeight(const GridSizingData&) const;
     void computeTrackSizesForDirection(GridTrackSizingDirection, GridSizingData&, LayoutUnit freeSpace);
+    struct TrackSizesCache;
+    static void restoreTrackSizes(Vector<GridTrack>&, const TrackSizesCache&);
+    static bool storeTrackSizes(const Vector<GridTrack>&, TrackSizesCache&, LayoutUnit baseSizesWithoutMaximization, LayoutUnit growthLimitsWithoutMaximization);
+    struct GridItemSizingInputs;
+    GridItemSizingInputs sizingInputsForChild(RenderBox&) const;
+    bool dirtyGridItemContributionsAreUnchanged();
+    void recordGridItemSizingInputs();
+    void clearTrackSizingCaches();
 
     void repeatTracksSizingIfNeeded(GridSizingData&, LayoutUnit availableSpaceForColumns, LayoutUnit availableSpaceForRows);
 
@@ -142,6 +154,7 @@ private:
 
     bool updateOverrideContainingBlockContentSizeForChild(RenderBox&, GridTrackSizingDirection, GridSizingData&) const;
     LayoutUnit logicalHeightForChild(RenderBox&) const;
+    LayoutUnit logicalHeightContributionForChild(RenderBox&, GridSizingData&) const;
     LayoutUnit minSizeForChild(RenderBox&, GridTrackSizingDirection, GridSizingData&) const;
     LayoutUnit minContentForChild(RenderBox&, GridTrackSizingDirection, GridSizingData&) const;
     LayoutUnit maxContentForChild(RenderBox&, GridTrackSizingDirection, GridSizingData&) const;
@@ -206,6 +219,53 @@ private:
 
     bool m_hasAnyOrthogonalChild;
 
+    // Block-axis contributions the track sizing asked for, with the inline-axis override size they were laid out with.
+    // Those of items whose logical height does not depend on the row sizes are reused while that size is the same.
+    struct LogicalHeightContribution {
+        LayoutUnit overrideContainingBlockLogicalWidth;
+        LayoutUnit logicalHeight;
+    };
+    mutable HashMap<const RenderBox*, LogicalHeightContribution> m_logicalHeightContributions;
+
+    // What the last track sizing read from each in-flow item besides its logical height. An item that needs layout
+    // leaves the track sizes as they were if these, and its logical height once laid out again, did not change.
+    struct GridItemSizingInputs {
+        GridArea area;
+        LayoutUnit minPreferredLogicalWidth;
+        LayoutUnit maxPreferredLogicalWidth;
+        Length logicalWidth;
+        Length logicalMinWidth;
+        Length logicalHeight;
+        Length logicalMinHeight;
+        Length marginStart;
+        Length marginEnd;
+
+        bool operator==(const GridItemSizingInputs& other) const
+        {
+            return area == other.area && minPreferredLogicalWidth == other.minPreferredLogicalWidth && maxPreferredLogicalWidth == other.maxPreferredLogicalWidth
+                && logicalWidth == other.logicalWidth && logicalMinWidth == other.logicalMinWidth && logicalHeight == other.logicalHeight
+                && logicalMinHeight == other.logicalMinHeight && marginStart == other.marginStart && marginEnd == other.marginEnd;
+        }
+        bool operator!=(const GridItemSizingInputs& other) const { return !(*this == other); }
+    };
+    HashMap<const RenderBox*, GridItemSizingInputs> m_gridItemSizingInputs;
+
+    // Track sizes resolved by the last layout, reused while neither the available space nor any item contribution changed.
+    struct TrackSizesCache {
+        bool isValid { false };
+        LayoutUnit availableSpace;
+        Optional<LayoutUnit> freeSpace;
+        Vector<LayoutUnit> baseSizes;
+        Vector<LayoutUnit> growthLimits;
+        LayoutUnit baseSizesWithoutMaximization;
+        LayoutUnit growthLimitsWithoutMaximization;
+    };
+    TrackSizesCache m_columnTrackSizesCache;
+    TrackSizesCache m_rowTrackSizesCache;
+    // The row sizes computeIntrinsicLogicalHeight() found for a grid of indefinite height.
+    TrackSizesCache m_intrinsicRowTrackSizesCache;
+    unsigned m_trackSizingPassCount { 0 };
+
     bool m_gridIsDirty { true };
 };
 
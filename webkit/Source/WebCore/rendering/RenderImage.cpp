@@ -339,9 +339,26 @@ void RenderImage::notifyFinished(CachedResource* newImage)
         // tell any potential compositing layers
         // that the image is done and they can reference it directly.
         contentChanged(ImageChanged);
+
+        if (!isMedia())
+            unregisterForVisibleInViewportCallback();
     }
 }
 
+void RenderImage::visibleInViewportStateChanged(VisibleInViewportState state)
+{
+    bool becameVisible = state == VisibleInViewport && visibleInViewportState() != VisibleInViewport;
+    RenderReplaced::visibleInViewportStateChanged(state);
+    if (!becameVisible)
+        return;
+
+    // An image that came into view goes ahead of the images that are still out of view.
+    // It stays behind the stylesheets and scripts that block rendering.
+    CachedImage* cachedImage = imageResource().cachedImage();
+    if (cachedImage && cachedImage->isLoading())
+        cachedImage->setLoadPriority(ResourceLoadPriority::Medium);
+}
+
 void RenderImage::paintReplaced(PaintInfo& paintInfo, const LayoutPoint& paintOffset)
 {
     LayoutUnit cWidth = contentWidth();
@@ -441,7 +458,7 @@ void RenderImage::paintReplaced(PaintInfo& paintInfo, const LayoutPoint& paintOf
         if (clip)
             context.clip(contentBoxRect);
 
-        paintIntoRect(context, snapRectToDevicePixels(replacedContentRect, deviceScaleFactor));
+        paintIntoRect(context, snapRectToDevicePixels(replacedContentRect, deviceScaleFactor), decodingModeForImageDraw(paintInfo));
         
         if (cachedImage() && page && paintInfo.phase == PaintPhaseForeground) {
             // For now, count images as unpainted if they are still progressively loading. We may want 
@@ -529,7 +546,7 @@ void RenderImage::areaElementFocusChanged(HTMLAreaElement* element)
     repaint();
 }
 
-void RenderImage::paintIntoRect(GraphicsContext& context, const FloatRect& rect)
+void RenderImage::paintIntoRect(GraphicsContext& context, const FloatRect& rect, DecodingMode decodingMode)
 {
     if (!imageResource().hasImage() || imageResource().errorOccurred() || rect.width() <= 0 || rect.height() <= 0)
         return;
@@ -546,7 +563,9 @@ void RenderImage::paintIntoRect(GraphicsContext& context, const FloatRect& rect)
     InterpolationQuality interpolation = image ? chooseInterpolationQuality(context, *image, image, LayoutSize(rect.size())) : InterpolationDefault;
 
     ImageOrientationDescription orientationDescription(shouldRespectImageOrientation(), style().imageOrientation());
-    context.drawImage(*img, rect, ImagePaintingOptions(compositeOperator, BlendModeNormal, orientationDescription, interpolation));
+    ImagePaintingOptions options(compositeOperator, BlendModeNormal, orientationDescription, interpolation);
+    options.m_decodingMode = decodingMode;
+    context.drawImage(*img, rect, options);
 }
 
 bool RenderImage::boxShadowShouldBeAppliedToBackground(const LayoutPoint& paintOffset, BackgroundBleedAvoidance bleedAvoidance, InlineFlowBox*) const
@@ -661,6 +680,12 @@ void RenderImage::layout()
 
     updateInnerContentRect();
 
+    // Find out when an image that is still loading comes into view, see visibleInViewportStateChanged().
+    // Media elements register for their own reasons.
+    CachedImage* cachedImage = imageResource().cachedImage();
+    if (cachedImage && cachedImage->isLoading() && !isMedia())
+        registerForVisibleInViewportCallback();
+
     if (m_hasShadowControls)
         layoutShadowControls(oldSize);
 }
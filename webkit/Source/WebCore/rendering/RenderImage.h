@@ -81,7 +81,7 @@ protected:
 
     void imageChanged(WrappedImagePtr, const IntRect* = nullptr) override;
 
-    void paintIntoRect(GraphicsContext&, const FloatRect&);
+    void paintIntoRect(GraphicsContext&, const FloatRect&, DecodingMode = DecodingMode::Synchronous);
     void paint(PaintInfo&, const LayoutPoint&) final;
     void layout() override;
 
@@ -105,6 +105,7 @@ private:
     LayoutUnit minimumReplacedHeight() const override;
 
     void notifyFinished(CachedResource*) final;
+    void visibleInViewportStateChanged(VisibleInViewportState) final;
     bool nodeAtPoint(const HitTestRequest&, HitTestResult&, const HitTestLocation& locationInContainer, const LayoutPoint& accumulatedOffset, HitTestAction) final;
 
     bool boxShadowShouldBeAppliedToBackground(const LayoutPoint& paintOffset, BackgroundBleedAvoidance, InlineFlowBox*) const final;
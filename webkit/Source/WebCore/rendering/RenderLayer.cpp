@@ -79,6 +79,7 @@
 #include "HitTestingTransformState.h"
 #include "HitTestRequest.h"
 #include "HitTestResult.h"
+#include "LayerHitTestIndex.h"
 #include "Logging.h"
 #include "MainFrame.h"
 #include "NoEventDispatchAssertion.h"
@@ -252,6 +253,20 @@ private:
     RefPtr<ClipRects> m_clipRects[NumCachedClipRectsTypes * 2];
 };
 
+struct RenderLayer::HitTestIndexes {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit HitTestIndexes(unsigned generation)
+        : generation(generation)
+    {
+    }
+
+    unsigned generation;
+    std::unique_ptr<LayerHitTestIndex> posZOrderList;
+    std::unique_ptr<LayerHitTestIndex> normalFlowList;
+    std::unique_ptr<LayerHitTestIndex> negZOrderList;
+};
+
 void makeMatrixRenderable(TransformationMatrix& matrix, bool has3DRendering)
 {
 #if !ENABLE(3D_TRANSFORMS)
@@ -273,6 +288,11 @@ RenderLayer::RenderLayer(RenderLayerModelObject& rendererLayerModelObject)
     , m_hasSelfPaintingLayerDescendantDirty(false)
     , m_hasOutOfFlowPositionedDescendant(false)
     , m_hasOutOfFlowPositionedDescendantDirty(true)
+    , m_hasViewportConstrainedDescendant(false)
+    , m_hasViewportConstrainedDescendantDirty(false)
+    , m_needsPositionUpdate(true)
+    , m_subtreeNeedsPositionUpdate(false)
+    , m_hasDescendantNeedingPositionUpdate(false)
     , m_needsCompositedScrolling(false)
     , m_descendantsAreContiguousInStackingOrder(false)
     , m_usedTransparency(false)
@@ -469,16 +489,70 @@ void RenderLayer::updateLayerPositionsAfterLayout(const RenderLayer* rootLayer,
     updateLayerPositions(&geometryMap, flags);
 }
 
+void RenderLayer::setNeedsPositionUpdate()
+{
+    if (m_needsPositionUpdate)
+        return;
+
+    m_needsPositionUpdate = true;
+    if (parent())
+        parent()->setAncestorChainHasDescendantNeedingPositionUpdate();
+}
+
+void RenderLayer::setSubtreeNeedsPositionUpdate()
+{
+    m_subtreeNeedsPositionUpdate = true;
+    if (parent())
+        parent()->setAncestorChainHasDescendantNeedingPositionUpdate();
+}
+
+void RenderLayer::setAncestorChainHasDescendantNeedingPositionUpdate()
+{
+    for (RenderLayer* layer = this; layer; layer = layer->parent()) {
+        if (layer->m_hasDescendantNeedingPositionUpdate)
+            break;
+        layer->m_hasDescendantNeedingPositionUpdate = true;
+    }
+}
+
+bool RenderLayer::needsPositionUpdate(UpdateLayerPositionsFlags flags) const
+{
+    if (m_needsPositionUpdate || m_subtreeNeedsPositionUpdate || m_hasDescendantNeedingPositionUpdate)
+        return true;
+
+    // The transformed ancestor bits are only refreshed by this walk.
+    return m_hasTransformedAncestor != static_cast<bool>(flags & SeenTransformedLayer)
+        || m_has3DTransformedAncestor != static_cast<bool>(flags & Seen3DTransformedLayer);
+}
+
 void RenderLayer::updateLayerPositions(RenderGeometryMap* geometryMap, UpdateLayerPositionsFlags flags)
 {
-    updateLayerPosition(); // For relpositioned layers or non-positioned layers,
-                           // we need to keep in sync, since we may have shifted relative
-                           // to our parent layer.
+    // Children of a layer that was laid out may have been moved by it, so they are all visited. Below
+    // that, only marked layers are, unless something on the way moved or resized.
+    bool wasLaidOut = m_needsPositionUpdate;
+    if (m_subtreeNeedsPositionUpdate)
+        flags &= ~UpdateOnlyDirtyLayers;
+    m_needsPositionUpdate = false;
+    m_subtreeNeedsPositionUpdate = false;
+    m_hasDescendantNeedingPositionUpdate = false;
+
+    IntSize oldSize = size();
+    bool positionChanged = updateLayerPosition(); // For relpositioned layers or non-positioned layers,
+                                                  // we need to keep in sync, since we may have shifted relative
+                                                  // to our parent layer.
+    // RenderView::layout() has already dropped the hit test indexes, layers only move without a layout when
+    // scrolled or transformed.
+    if (positionChanged || size() != oldSize)
+        flags &= ~UpdateOnlyDirtyLayers;
+
     if (geometryMap)
         geometryMap->pushMappingsToAncestor(this, parent());
 
-    // Clear our cached clip rect information.
-    clearClipRects();
+    // Clear our cached clip rect information. Descendants that are skipped below still have ours in theirs.
+    if ((flags & UpdateOnlyDirtyLayers) && renderer().hasClipOrOverflowClip())
+        clearClipRectsIncludingDescendants();
+    else
+        clearClipRects();
     
     if (hasOverflowControls()) {
         LayoutSize offsetFromRoot;
@@ -556,14 +630,19 @@ void RenderLayer::updateLayerPositions(RenderGeometryMap* geometryMap, UpdateLay
         flags |= UpdatePagination;
     }
 
+    if (flags & UpdatePagination)
+        flags &= ~UpdateOnlyDirtyLayers;
+
     if (transform()) {
         flags |= SeenTransformedLayer;
         if (!transform()->isAffine())
             flags |= Seen3DTransformedLayer;
     }
 
-    for (RenderLayer* child = firstChild(); child; child = child->nextSibling())
-        child->updateLayerPositions(geometryMap, flags);
+    for (RenderLayer* child = firstChild(); child; child = child->nextSibling()) {
+        if (!(flags & UpdateOnlyDirtyLayers) || wasLaidOut || child->needsPositionUpdate(flags))
+            child->updateLayerPositions(geometryMap, flags);
+    }
 
     if ((flags & UpdateCompositingLayers) && isComposited()) {
         RenderLayerBacking::UpdateAfterLayoutFlags updateFlags = RenderLayerBacking::CompositingChildrenOnly;
@@ -626,6 +705,26 @@ void RenderLayer::dirtyAncestorChainHasSelfPaintingLayerDescendantStatus()
     }
 }
 
+void RenderLayer::setAncestorChainHasViewportConstrainedDescendant()
+{
+    for (RenderLayer* layer = this; layer; layer = layer->parent()) {
+        if (!layer->m_hasViewportConstrainedDescendantDirty && layer->hasViewportConstrainedDescendant())
+            break;
+
+        layer->m_hasViewportConstrainedDescendantDirty = false;
+        layer->m_hasViewportConstrainedDescendant = true;
+    }
+}
+
+void RenderLayer::dirtyAncestorChainHasViewportConstrainedDescendantStatus()
+{
+    for (RenderLayer* layer = this; layer; layer = layer->parent()) {
+        if (layer->m_hasViewportConstrainedDescendantDirty)
+            break;
+        layer->m_hasViewportConstrainedDescendantDirty = true;
+    }
+}
+
 bool RenderLayer::acceleratedCompositingForOverflowScrollEnabled() const
 {
     return renderer().frame().settings().acceleratedCompositingForOverflowScrollEnabled();
@@ -829,6 +928,8 @@ void RenderLayer::updateLayerPositionsAfterDocumentScroll()
 
 void RenderLayer::updateLayerPositionsAfterOverflowScroll()
 {
+    renderer().view().invalidateLayerHitTestIndexes();
+
     RenderGeometryMap geometryMap(UseTransforms);
     if (this != renderer().view().layer())
         geometryMap.pushMappingsToAncestor(parent(), nullptr);
@@ -844,6 +945,11 @@ void RenderLayer::updateLayerPositionsAfterScroll(RenderGeometryMap* geometryMap
     // these flags are still dirty. Update so that the check below is valid.
     updateDescendantDependentFlags();
 
+    // The hit test indexes hold bounds relative to the indexing layer, so a document scroll only changes
+    // them where fixed and sticky layers moved relative to an ancestor.
+    if (!(flags & IsOverflowScroll) && hasViewportConstrainedDescendant())
+        m_hitTestIndexes = nullptr;
+
     // If we have no visible content and no visible descendants, there is no point recomputing
     // our rectangles as they will be empty. If our visibility changes, we are expected to
     // recompute all our positions anyway.
@@ -881,8 +987,12 @@ void RenderLayer::updateLayerPositionsAfterScroll(RenderGeometryMap* geometryMap
         ASSERT(!m_hasComputedRepaintRect || m_outlineBox == renderer().outlineBoundsForRepaint(renderer().containerForRepaint()));
     }
     
-    for (RenderLayer* child = firstChild(); child; child = child->nextSibling())
-        child->updateLayerPositionsAfterScroll(geometryMap, flags);
+    // A document scroll only moves viewport-constrained layers and what they contain, so the other
+    // subtrees can keep their rects.
+    if ((flags & (IsOverflowScroll | HasSeenViewportConstrainedAncestor | HasChangedAncestor)) || hasViewportConstrainedDescendant()) {
+        for (RenderLayer* child = firstChild(); child; child = child->nextSibling())
+            child->updateLayerPositionsAfterScroll(geometryMap, flags);
+    }
 
     // We don't update our reflection as scrolling is a translation which does not change the size()
     // of an object, thus RenderReplica will still repaint itself properly as the layer position was
@@ -1157,6 +1267,7 @@ void RenderLayer::setHasVisibleContent()
 void RenderLayer::dirtyVisibleContentStatus() 
 { 
     m_visibleContentStatusDirty = true; 
+    setNeedsPositionUpdate();
     if (parent())
         parent()->dirtyAncestorChainVisibleDescendantStatus();
 }
@@ -1184,10 +1295,11 @@ void RenderLayer::setAncestorChainHasVisibleDescendant()
 
 void RenderLayer::updateDescendantDependentFlags(HashSet<const RenderObject*>* outOfFlowDescendantContainingBlocks)
 {
-    if (m_visibleDescendantStatusDirty || m_hasSelfPaintingLayerDescendantDirty || m_hasOutOfFlowPositionedDescendantDirty || hasNotIsolatedBlendingDescendantsStatusDirty()) {
+    if (m_visibleDescendantStatusDirty || m_hasSelfPaintingLayerDescendantDirty || m_hasOutOfFlowPositionedDescendantDirty || m_hasViewportConstrainedDescendantDirty || hasNotIsolatedBlendingDescendantsStatusDirty()) {
         bool hasVisibleDescendant = false;
         bool hasSelfPaintingLayerDescendant = false;
         bool hasOutOfFlowPositionedDescendant = false;
+        bool hasViewportConstrainedDescendant = false;
 #if ENABLE(CSS_COMPOSITING)
         bool hasNotIsolatedBlendingDescendants = false;
 #endif
@@ -1210,11 +1322,12 @@ void RenderLayer::updateDescendantDependentFlags(HashSet<const RenderObject*>* o
             hasVisibleDescendant |= child->m_hasVisibleContent || child->m_hasVisibleDescendant;
             hasSelfPaintingLayerDescendant |= child->isSelfPaintingLayer() || child->hasSelfPaintingLayerDescendant();
             hasOutOfFlowPositionedDescendant |= !childOutOfFlowDescendantContainingBlocks.isEmpty();
+            hasViewportConstrainedDescendant |= child->renderer().style().hasViewportConstrainedPosition() || child->hasViewportConstrainedDescendant();
 #if ENABLE(CSS_COMPOSITING)
             hasNotIsolatedBlendingDescendants |= child->hasBlendMode() || (child->hasNotIsolatedBlendingDescendants() && !child->isolatesBlending());
 #endif
 
-            bool allFlagsSet = hasVisibleDescendant && hasSelfPaintingLayerDescendant && hasOutOfFlowPositionedDescendant;
+            bool allFlagsSet = hasVisibleDescendant && hasSelfPaintingLayerDescendant && hasOutOfFlowPositionedDescendant && hasViewportConstrainedDescendant;
 #if ENABLE(CSS_COMPOSITING)
             allFlagsSet &= hasNotIsolatedBlendingDescendants;
 #endif
@@ -1235,6 +1348,9 @@ void RenderLayer::updateDescendantDependentFlags(HashSet<const RenderObject*>* o
             updateNeedsCompositedScrolling();
 
         m_hasOutOfFlowPositionedDescendantDirty = false;
+
+        m_hasViewportConstrainedDescendant = hasViewportConstrainedDescendant;
+        m_hasViewportConstrainedDescendantDirty = false;
 #if ENABLE(CSS_COMPOSITING)
         m_hasNotIsolatedBlendingDescendants = hasNotIsolatedBlendingDescendants;
         if (m_hasNotIsolatedBlendingDescendantsStatusDirty) {
@@ -1865,16 +1981,24 @@ void RenderLayer::addChild(RenderLayer* child, RenderLayer* beforeChild)
     if (child->isNormalFlowOnly())
         dirtyNormalFlowList();
 
+    child->updateDescendantDependentFlags();
+    if (child->m_hasVisibleContent || child->m_hasVisibleDescendant)
+        setAncestorChainHasVisibleDescendant();
+
     if (!child->isNormalFlowOnly() || child->firstChild()) {
-        // Dirty the z-order list in which we are contained. The stackingContainer() can be null in the
+        // Update the z-order list in which we are contained. The stackingContainer() can be null in the
         // case where we're building up generated content layers. This is ok, since the lists will start
         // off dirty in that case anyway.
-        child->dirtyStackingContainerZOrderLists();
+        RenderLayer* stackingContainer = child->stackingContainer();
+        if (stackingContainer && !stackingContainer->insertIntoZOrderLists(*child))
+            stackingContainer->dirtyZOrderLists();
     }
 
-    child->updateDescendantDependentFlags();
-    if (child->m_hasVisibleContent || child->m_hasVisibleDescendant)
-        setAncestorChainHasVisibleDescendant();
+    if (child->renderer().style().hasViewportConstrainedPosition() || child->hasViewportConstrainedDescendant())
+        setAncestorChainHasViewportConstrainedDescendant();
+
+    if (child->m_needsPositionUpdate || child->m_subtreeNeedsPositionUpdate || child->m_hasDescendantNeedingPositionUpdate)
+        setAncestorChainHasDescendantNeedingPositionUpdate();
 
     if (child->isSelfPaintingLayer() || child->hasSelfPaintingLayerDescendant())
         setAncestorChainHasSelfPaintingLayerDescendant();
@@ -1909,15 +2033,20 @@ RenderLayer* RenderLayer::removeChild(RenderLayer* oldChild)
     if (oldChild->isNormalFlowOnly())
         dirtyNormalFlowList();
     if (!oldChild->isNormalFlowOnly() || oldChild->firstChild()) { 
-        // Dirty the z-order list in which we are contained.  When called via the
+        // Update the z-order list in which we are contained.  When called via the
         // reattachment process in removeOnlyThisLayer, the layer may already be disconnected
         // from the main layer tree, so we need to null-check the |stackingContainer| value.
-        oldChild->dirtyStackingContainerZOrderLists();
+        RenderLayer* stackingContainer = oldChild->stackingContainer();
+        if (stackingContainer && !stackingContainer->removeFromZOrderLists(*oldChild))
+            stackingContainer->dirtyZOrderLists();
     }
 
     if (oldChild->renderer().isOutOfFlowPositioned() || oldChild->hasOutOfFlowPositionedDescendant())
         dirtyAncestorChainHasOutOfFlowPositionedDescendantStatus();
 
+    if (oldChild->renderer().style().hasViewportConstrainedPosition() || oldChild->hasViewportConstrainedDescendant())
+        dirtyAncestorChainHasViewportConstrainedDescendantStatus();
+
     oldChild->setPreviousSibling(nullptr);
     oldChild->setNextSibling(nullptr);
     oldChild->setParent(nullptr);
@@ -5379,9 +5508,14 @@ RenderLayer* RenderLayer::hitTestList(Vector<RenderLayer*>* list, RenderLayer* r
     if (!hasSelfPaintingLayerDescendant())
         return nullptr;
 
+    // With a transform state the hit test location is not in root layer coordinates, and depth sorting
+    // needs every layer that may be hit behind the frontmost one.
+    Vector<unsigned> candidates;
+    bool testCandidatesOnly = !transformState && !depthSortDescendants && collectHitTestCandidates(*list, rootLayer, hitTestLocation, candidates);
+
     RenderLayer* resultLayer = nullptr;
-    for (size_t i = list->size(); i > 0; --i) {
-        RenderLayer* childLayer = list->at(i - 1);
+    for (size_t i = testCandidatesOnly ? candidates.size() : list->size(); i > 0; --i) {
+        RenderLayer* childLayer = list->at(testCandidatesOnly ? candidates[i - 1] : i - 1);
         if (childLayer->isFlowThreadCollectingGraphicsLayersUnderRegions())
             continue;
         RenderLayer* hitLayer = nullptr;
@@ -5405,6 +5539,66 @@ RenderLayer* RenderLayer::hitTestList(Vector<RenderLayer*>* list, RenderLayer* r
     return resultLayer;
 }
 
+bool RenderLayer::collectHitTestCandidates(const Vector<RenderLayer*>& list, const RenderLayer* rootLayer, const HitTestLocation& hitTestLocation, Vector<unsigned>& candidates)
+{
+    if (list.size() < LayerHitTestIndex::minimumLayerCount || !renderer().frame().settings().layerHitTestIndexEnabled())
+        return false;
+
+    // Regions hit test the layers of their flow thread at more than one place.
+    if (renderer().view().hasRenderNamedFlowThreads())
+        return false;
+
+    LayerHitTestIndex* index = hitTestIndexForList(list);
+    if (!index)
+        return false;
+
+    LayoutRect area = hitTestLocation.boundingBox();
+    area.move(-offsetFromAncestor(rootLayer));
+    // Leave room for snapping; the candidates only have to be a superset of the layers that get hit.
+    area.inflate(1);
+    return index->collectCandidates(area, candidates);
+}
+
+// Layers whose hit testing does not stay within calculateLayerBounds() are tested whatever the location.
+static bool canBeHitOutsideLayerBounds(const RenderLayer& layer)
+{
+    return !layer.isSelfPaintingLayer()
+        || layer.transform()
+        || layer.preserves3D()
+        || layer.renderer().hasClipPath()
+        || layer.isFlowThreadCollectingGraphicsLayersUnderRegions();
+}
+
+LayerHitTestIndex* RenderLayer::hitTestIndexForList(const Vector<RenderLayer*>& list)
+{
+    unsigned generation = renderer().view().layerHitTestIndexGeneration();
+    if (!m_hitTestIndexes || m_hitTestIndexes->generation != generation)
+        m_hitTestIndexes = std::make_unique<HitTestIndexes>(generation);
+
+    std::unique_ptr<LayerHitTestIndex>* index;
+    if (&list == m_posZOrderList.get())
+        index = &m_hitTestIndexes->posZOrderList;
+    else if (&list == m_normalFlowList.get())
+        index = &m_hitTestIndexes->normalFlowList;
+    else if (&list == m_negZOrderList.get())
+        index = &m_hitTestIndexes->negZOrderList;
+    else
+        return nullptr;
+
+    if (!*index) {
+        // Masks clip painting, not hit testing.
+        CalculateLayerBoundsFlags flags = (DefaultCalculateLayerBoundsFlags & ~UseLocalClipRectIfPossible) | IncludeCompositedDescendants | DontConstrainForMask;
+        *index = std::make_unique<LayerHitTestIndex>();
+        for (auto* childLayer : list) {
+            if (canBeHitOutsideLayerBounds(*childLayer))
+                (*index)->appendAlwaysTested();
+            else
+                (*index)->append(childLayer->calculateLayerBounds(this, childLayer->offsetFromAncestor(this), flags));
+        }
+    }
+    return index->get();
+}
+
 void RenderLayer::updateClipRects(const ClipRectsContext& clipRectsContext)
 {
     ClipRectsType clipRectsType = clipRectsContext.clipRectsType;
@@ -6245,13 +6439,7 @@ void RenderLayer::dirtyZOrderLists()
         m_negZOrderList->clear();
     m_zOrderListsDirty = true;
 
-    if (!renderer().documentBeingDestroyed()) {
-        if (isFlowThreadCollectingGraphicsLayersUnderRegions())
-            downcast<RenderFlowThread>(renderer()).setNeedsLayerToRegionMappingsUpdate();
-        compositor().setCompositingLayersNeedRebuild();
-        if (acceleratedCompositingForOverflowScrollEnabled())
-            compositor().setShouldReevaluateCompositingAfterLayout();
-    }
+    layerListsChanged();
 }
 
 void RenderLayer::dirtyStackingContainerZOrderLists()
@@ -6269,13 +6457,123 @@ void RenderLayer::dirtyNormalFlowList()
         m_normalFlowList->clear();
     m_normalFlowListDirty = true;
 
-    if (!renderer().documentBeingDestroyed()) {
-        if (isFlowThreadCollectingGraphicsLayersUnderRegions())
-            downcast<RenderFlowThread>(renderer()).setNeedsLayerToRegionMappingsUpdate();
-        compositor().setCompositingLayersNeedRebuild();
-        if (acceleratedCompositingForOverflowScrollEnabled())
-            compositor().setShouldReevaluateCompositingAfterLayout();
+    layerListsChanged();
+}
+
+void RenderLayer::layerListsChanged()
+{
+    if (renderer().documentBeingDestroyed())
+        return;
+
+    m_hitTestIndexes = nullptr;
+
+    if (isFlowThreadCollectingGraphicsLayersUnderRegions())
+        downcast<RenderFlowThread>(renderer()).setNeedsLayerToRegionMappingsUpdate();
+    compositor().setCompositingLayersNeedRebuild();
+    if (acceleratedCompositingForOverflowScrollEnabled())
+        compositor().setShouldReevaluateCompositingAfterLayout();
+}
+
+// Whether the layer whose ancestor chain (starting with itself) is |firstAncestors| is collected
+// before |second| by collectLayers(), which walks the layer tree in pre-order.
+static bool isBeforeInLayerTreeOrder(const Vector<const RenderLayer*, 16>& firstAncestors, const RenderLayer& second)
+{
+    const RenderLayer* secondChild = nullptr;
+    for (const RenderLayer* layer = &second; layer; layer = layer->parent()) {
+        size_t index = firstAncestors.find(layer);
+        if (index == notFound) {
+            secondChild = layer;
+            continue;
+        }
+        if (!index)
+            return true; // The first layer is an ancestor of |second|.
+        if (!secondChild)
+            return false; // |second| is an ancestor of the first layer.
+
+        const RenderLayer* firstChild = firstAncestors[index - 1];
+        for (const RenderLayer* sibling = firstChild->nextSibling(); sibling; sibling = sibling->nextSibling()) {
+            if (sibling == secondChild)
+                return true;
+        }
+        return false;
     }
+    ASSERT_NOT_REACHED();
+    return false;
+}
+
+// Past this size finding the position of a layer costs about as much as collecting the layers again.
+static const size_t maximumIncrementallyUpdatedZOrderListSize = 64;
+
+bool RenderLayer::insertIntoZOrderLists(RenderLayer& layer)
+{
+    ASSERT(m_layerListMutationAllowed);
+    ASSERT(isStackingContainer());
+
+    if (m_zOrderListsDirty)
+        return true;
+
+    // Anything else would pull in the descendants of |layer|, or needs the bookkeeping done on a rebuild.
+    bool isStacking = layer.isStackingContainer();
+    if ((layer.firstChild() && !isStacking) || layer.renderer().isReplica() || isFlowThreadCollectingGraphicsLayersUnderRegions() || acceleratedCompositingForOverflowScrollEnabled())
+        return false;
+
+    // Same filter as collectLayers().
+    bool includeHiddenLayers = compositor().inCompositingMode();
+    if (layer.isNormalFlowOnly() || !(includeHiddenLayers || layer.m_hasVisibleContent || (layer.m_hasVisibleDescendant && isStacking)))
+        return true;
+
+    int zIndex = layer.zIndex();
+    std::unique_ptr<Vector<RenderLayer*>>& list = zIndex >= 0 ? m_posZOrderList : m_negZOrderList;
+    if (!list)
+        list = std::make_unique<Vector<RenderLayer*>>();
+    if (list->size() >= maximumIncrementallyUpdatedZOrderListSize)
+        return false;
+
+    // The lists are stable sorted by z-index, so layers with the same z-index are in tree order. Layers are
+    // usually appended to the end of their parent, so look for the position starting from the end of the list.
+    Vector<const RenderLayer*, 16> ancestors;
+    size_t index = list->size();
+    for (; index; --index) {
+        RenderLayer* current = list->at(index - 1);
+        if (current->zIndex() < zIndex)
+            break;
+        if (current->zIndex() > zIndex)
+            continue;
+        if (ancestors.isEmpty()) {
+            for (const RenderLayer* ancestor = &layer; ancestor; ancestor = ancestor->parent())
+                ancestors.append(ancestor);
+        }
+        if (!isBeforeInLayerTreeOrder(ancestors, *current))
+            break;
+    }
+    list->insert(index, &layer);
+
+    layerListsChanged();
+    return true;
+}
+
+bool RenderLayer::removeFromZOrderLists(RenderLayer& layer)
+{
+    ASSERT(m_layerListMutationAllowed);
+    ASSERT(isStackingContainer());
+
+    if (m_zOrderListsDirty)
+        return true;
+
+    if ((layer.firstChild() && !layer.isStackingContainer()) || isFlowThreadCollectingGraphicsLayersUnderRegions() || acceleratedCompositingForOverflowScrollEnabled())
+        return false;
+
+    for (auto* list : { m_posZOrderList.get(), m_negZOrderList.get() }) {
+        if (!list)
+            continue;
+        size_t index = list->find(&layer);
+        if (index != notFound) {
+            list->remove(index);
+            layerListsChanged();
+            return true;
+        }
+    }
+    return true;
 }
 
 void RenderLayer::rebuildZOrderLists()
@@ -6711,6 +7009,10 @@ void RenderLayer::updateOutOfFlowPositioned(const RenderStyle* oldStyle)
 
 void RenderLayer::styleChanged(StyleDifference diff, const RenderStyle* oldStyle)
 {
+    // Transform changes move layers without a layout.
+    if (diff != StyleDifferenceEqual && (renderer().style().hasTransformRelatedProperty() || (oldStyle && oldStyle->hasTransformRelatedProperty())))
+        renderer().view().invalidateLayerHitTestIndexes();
+
     bool isNormalFlowOnly = shouldBeNormalFlowOnly();
     if (isNormalFlowOnly != m_isNormalFlowOnly) {
         m_isNormalFlowOnly = isNormalFlowOnly;
@@ -6736,6 +7038,18 @@ void RenderLayer::styleChanged(StyleDifference diff, const RenderStyle* oldStyle
     updateSelfPaintingLayer();
     updateOutOfFlowPositioned(oldStyle);
 
+    bool wasViewportConstrained = oldStyle && oldStyle->hasViewportConstrainedPosition();
+    if (parent() && renderer().style().hasViewportConstrainedPosition() != wasViewportConstrained) {
+        if (wasViewportConstrained)
+            parent()->dirtyAncestorChainHasViewportConstrainedDescendantStatus();
+        else
+            parent()->setAncestorChainHasViewportConstrainedDescendant();
+    }
+
+    // Transforms, clips and compositing changes move the rects of every descendant, without laying them out.
+    if (diff == StyleDifferenceRecompositeLayer || diff >= StyleDifferenceRepaintLayer)
+        setSubtreeNeedsPositionUpdate();
+
     if (!hasReflection() && m_reflection)
         removeReflection();
     else if (hasReflection()) {
@@ -63,6 +63,7 @@ class FilterOperations;
 class HitTestRequest;
 class HitTestResult;
 class HitTestingTransformState;
+class LayerHitTestIndex;
 class RenderFlowThread;
 class RenderGeometryMap;
 class RenderLayerBacking;
@@ -297,7 +298,8 @@ public:
         UpdateCompositingLayers = 1 << 3,
         UpdatePagination = 1 << 4,
         SeenTransformedLayer = 1 << 5,
-        Seen3DTransformedLayer = 1 << 6
+        Seen3DTransformedLayer = 1 << 6,
+        UpdateOnlyDirtyLayers = 1 << 7
     };
     typedef unsigned UpdateLayerPositionsFlags;
     static const UpdateLayerPositionsFlags defaultFlags = CheckForRepaint | IsCompositingUpdateRoot | UpdateCompositingLayers;
@@ -307,6 +309,11 @@ public:
     void updateLayerPositionsAfterOverflowScroll();
     void updateLayerPositionsAfterDocumentScroll();
 
+    // Marks this layer for the next updateLayerPositionsAfterLayout(). Layers that are not marked, and did
+    // not move along with an ancestor, keep their cached positions, repaint rects and clip rects.
+    void setNeedsPositionUpdate();
+    void setSubtreeNeedsPositionUpdate();
+
     void positionNewlyCreatedOverflowControls();
 
     bool hasCompositedLayerInEnclosingPaginationChain() const;
@@ -405,6 +412,9 @@ public:
     // FIXME: We should ASSERT(!m_hasOutOfFlowPositionedDescendantDirty); here but we may hit the same bugs as visible content above.
     bool hasOutOfFlowPositionedDescendant() const { return m_hasOutOfFlowPositionedDescendant; }
 
+    // True if a descendant layer is fixed or sticky positioned, and so has to be visited on a document scroll.
+    bool hasViewportConstrainedDescendant() const { return m_hasViewportConstrainedDescendant; }
+
     // Gets the nearest enclosing positioned ancestor layer (also includes
     // the <html> layer and the root layer).
     RenderLayer* enclosingAncestorForPosition(EPosition) const;
@@ -708,6 +718,12 @@ private:
     void rebuildZOrderLists(CollectLayersBehavior, std::unique_ptr<Vector<RenderLayer*>>&, std::unique_ptr<Vector<RenderLayer*>>&);
     void clearZOrderLists();
 
+    // Keep clean z-order lists in sync with a single layer being added or removed. They return false
+    // when the change is not simple enough, and the caller should dirty the lists instead.
+    bool insertIntoZOrderLists(RenderLayer&);
+    bool removeFromZOrderLists(RenderLayer&);
+    void layerListsChanged();
+
     void updateNormalFlowList();
 
     // Non-auto z-index always implies stacking context here, because StyleResolver::adjustRenderStyle already adjusts z-index
@@ -719,6 +735,12 @@ private:
     void setAncestorChainHasSelfPaintingLayerDescendant();
     void dirtyAncestorChainHasSelfPaintingLayerDescendantStatus();
 
+    void setAncestorChainHasViewportConstrainedDescendant();
+    void dirtyAncestorChainHasViewportConstrainedDescendantStatus();
+
+    void setAncestorChainHasDescendantNeedingPositionUpdate();
+    bool needsPositionUpdate(UpdateLayerPositionsFlags) const;
+
     bool acceleratedCompositingForOverflowScrollEnabled() const;
     void updateDescendantsAreContiguousInStackingOrder();
     void updateDescendantsAreContiguousInStackingOrderRecursive(const HashMap<const RenderLayer*, int>&, int& minIndex, int& maxIndex, int& count, bool firstIteration);
@@ -822,6 +844,8 @@ private:
         const LayoutRect& hitTestRect, const HitTestLocation&,
         const HitTestingTransformState*, double* zOffsetForDescendants, double* zOffset,
         const HitTestingTransformState* unflattenedTransformState, bool depthSortDescendants);
+    bool collectHitTestCandidates(const Vector<RenderLayer*>&, const RenderLayer* rootLayer, const HitTestLocation&, Vector<unsigned>& candidates);
+    LayerHitTestIndex* hitTestIndexForList(const Vector<RenderLayer*>&);
 
     RenderLayer* hitTestFixedLayersInNamedFlows(RenderLayer* rootLayer,
         const HitTestRequest&, HitTestResult&,
@@ -1021,6 +1045,13 @@ private:
     bool m_hasOutOfFlowPositionedDescendant : 1;
     bool m_hasOutOfFlowPositionedDescendantDirty : 1;
 
+    bool m_hasViewportConstrainedDescendant : 1;
+    bool m_hasViewportConstrainedDescendantDirty : 1;
+
+    bool m_needsPositionUpdate : 1; // Our renderer was laid out, or is the enclosing layer of the layout root.
+    bool m_subtreeNeedsPositionUpdate : 1; // A style change may have moved all of our descendants.
+    bool m_hasDescendantNeedingPositionUpdate : 1;
+
     bool m_needsCompositedScrolling : 1;
 
     // If this is true, then no non-descendant appears between any of our
@@ -1120,6 +1151,10 @@ private:
     std::unique_ptr<Vector<RenderLayer*>> m_normalFlowList;
 
     std::unique_ptr<ClipRectsCache> m_clipRectsCache;
+
+    // Spatial indexes of the layer lists, built on demand for long lists when the setting is on.
+    struct HitTestIndexes;
+    std::unique_ptr<HitTestIndexes> m_hitTestIndexes;
     
     IntPoint m_cachedOverlayScrollbarOffset;
 
@@ -47,6 +47,7 @@
 #include "MainFrame.h"
 #include "Page.h"
 #include "PseudoElement.h"
+#include "RenderBlockFlow.h"
 #include "RenderChildIterator.h"
 #include "RenderCounter.h"
 #include "RenderFlowThread.h"
@@ -419,7 +420,13 @@ static inline bool objectIsRelayoutBoundary(const RenderElement* object)
     if (object->isSVGRoot())
         return true;
 
-    if (!object->hasOverflowClip())
+    // Nothing inside a box with layout and size containment can change its size or escape it. Size containment
+    // is only applied by RenderBlockFlow::layoutBlock(); flex and grid containers still size to their content.
+    if (object->shouldApplyLayoutContainment() && object->shouldApplySizeContainment() && is<RenderBlockFlow>(*object) && !object->isTablePart())
+        return true;
+
+    // Layout containment keeps the box's overflow from propagating, just like an overflow clip.
+    if (!object->hasOverflowClip() && !object->shouldApplyLayoutContainment())
         return false;
 
     if (object->style().width().isIntrinsicOrAuto() || object->style().height().isIntrinsicOrAuto() || object->style().height().isPercentOrCalculated())
@@ -442,6 +449,9 @@ void RenderObject::clearNeedsLayout()
     setNeedsPositionedMovementLayoutBit(false);
     if (is<RenderElement>(*this))
         downcast<RenderElement>(*this).setAncestorLineBoxDirty(false);
+    // Renderers without a layer are covered by the closest laid out ancestor with one, or by the layout root.
+    if (hasLayer())
+        downcast<RenderLayerModelObject>(*this).layer()->setNeedsPositionUpdate();
 #ifndef NDEBUG
     checkBlockPositionedObjectsNeedLayout();
 #endif
@@ -345,6 +345,7 @@ void RenderView::layoutContentToComputeOverflowInRegions(const LayoutState& stat
 void RenderView::layout()
 {
     StackStats::LayoutCheckPoint layoutCheckPoint;
+    invalidateLayerHitTestIndexes();
     if (!document().paginated())
         setPageLogicalHeight(0);
 
@@ -222,6 +222,11 @@ public:
     void didCreateRenderer() { ++m_rendererCount; }
     void didDestroyRenderer() { --m_rendererCount; }
 
+    // Any change to where layers are, short of a change to the layer lists, throws away the LayerHitTestIndexes
+    // of every stacking container. They are rebuilt on the next hit test.
+    unsigned layerHitTestIndexGeneration() const { return m_layerHitTestIndexGeneration; }
+    void invalidateLayerHitTestIndexes() { ++m_layerHitTestIndexGeneration; }
+
     void updateVisibleViewportRect(const IntRect&);
     void registerForVisibleInViewportCallback(RenderElement&);
     void unregisterForVisibleInViewportCallback(RenderElement&);
@@ -326,6 +331,7 @@ private:
 
     // Include this RenderView.
     uint64_t m_rendererCount { 1 };
+    unsigned m_layerHitTestIndexGeneration { 0 };
 
     mutable std::unique_ptr<Region> m_accumulatedRepaintRegion;
 
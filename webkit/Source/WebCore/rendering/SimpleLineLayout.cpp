@@ -51,6 +51,7 @@
 #include "Text.h"
 #include "TextPaintStyle.h"
 #include "TextStream.h"
+#include <wtf/NeverDestroyed.h>
 
 namespace WebCore {
 namespace SimpleLineLayout {
@@ -64,55 +65,51 @@ void toggleSimpleLineLayout();
 enum AvoidanceReason_ : uint64_t {
     FlowIsInsideRegion                    = 1LLU  << 0,
     FlowHasHorizonalWritingMode           = 1LLU  << 1,
-    FlowHasOutline                        = 1LLU  << 2,
-    FlowIsRuby                            = 1LLU  << 3,
-    FlowIsPaginated                       = 1LLU  << 4,
-    FlowHasTextOverflow                   = 1LLU  << 5,
-    FlowIsDepricatedFlexBox               = 1LLU  << 6,
-    FlowParentIsPlaceholderElement        = 1LLU  << 7,
-    FlowParentIsTextAreaWithWrapping      = 1LLU  << 8,
-    FlowHasNonSupportedChild              = 1LLU  << 9,
-    FlowHasUnsupportedFloat               = 1LLU  << 10,
-    FlowHasUnsupportedUnderlineDecoration = 1LLU  << 11,
-    FlowHasJustifiedNonLatinText          = 1LLU  << 12,
-    FlowHasOverflowVisible                = 1LLU  << 13,
-    FlowIsNotLTR                          = 1LLU  << 14,
-    FlowHasLineBoxContainProperty         = 1LLU  << 15,
-    FlowIsNotTopToBottom                  = 1LLU  << 16,
-    FlowHasLineBreak                      = 1LLU  << 17,
-    FlowHasNonNormalUnicodeBiDi           = 1LLU  << 18,
-    FlowHasRTLOrdering                    = 1LLU  << 19,
-    FlowHasLineAlignEdges                 = 1LLU  << 20,
-    FlowHasLineSnap                       = 1LLU  << 21,
-    FlowHasHypensAuto                     = 1LLU  << 22,
-    FlowHasTextEmphasisFillOrMark         = 1LLU  << 23,
-    FlowHasTextShadow                     = 1LLU  << 24,
-    FlowHasPseudoFirstLine                = 1LLU  << 25,
-    FlowHasPseudoFirstLetter              = 1LLU  << 26,
-    FlowHasTextCombine                    = 1LLU  << 27,
-    FlowHasTextFillBox                    = 1LLU  << 28,
-    FlowHasBorderFitLines                 = 1LLU  << 29,
-    FlowHasNonAutoLineBreak               = 1LLU  << 30,
-    FlowHasNonAutoTrailingWord            = 1LLU  << 31,
-    FlowHasSVGFont                        = 1LLU  << 32,
-    FlowTextIsEmpty                       = 1LLU  << 33,
-    FlowTextHasNoBreakSpace               = 1LLU  << 34,
-    FlowTextHasSoftHyphen                 = 1LLU  << 35,
-    FlowTextHasDirectionCharacter         = 1LLU  << 36,
-    FlowIsMissingPrimaryFont              = 1LLU  << 37,
-    FlowFontIsMissingGlyph                = 1LLU  << 38,
-    FlowTextIsCombineText                 = 1LLU  << 39,
-    FlowTextIsRenderCounter               = 1LLU  << 40,
-    FlowTextIsRenderQuote                 = 1LLU  << 41,
-    FlowTextIsTextFragment                = 1LLU  << 42,
-    FlowTextIsSVGInlineText               = 1LLU  << 43,
-    FlowFontIsNotSimple                   = 1LLU  << 44,
-    FeatureIsDisabled                     = 1LLU  << 45,
-    FlowHasNoParent                       = 1LLU  << 46,
-    FlowHasNoChild                        = 1LLU  << 47,
-    FlowChildIsSelected                   = 1LLU  << 48,
-    FlowHasHangingPunctuation             = 1LLU  << 49,
-    EndOfReasons                          = 1LLU  << 50
+    FlowIsRuby                            = 1LLU  << 2,
+    FlowIsPaginated                       = 1LLU  << 3,
+    FlowHasTextOverflow                   = 1LLU  << 4,
+    FlowIsDepricatedFlexBox               = 1LLU  << 5,
+    FlowParentIsPlaceholderElement        = 1LLU  << 6,
+    FlowParentIsTextAreaWithWrapping      = 1LLU  << 7,
+    FlowHasNonSupportedChild              = 1LLU  << 8,
+    FlowHasUnsupportedFloat               = 1LLU  << 9,
+    FlowHasUnsupportedUnderlineDecoration = 1LLU  << 10,
+    FlowHasJustifiedNonLatinText          = 1LLU  << 11,
+    FlowHasLineBoxContainProperty         = 1LLU  << 12,
+    FlowIsNotTopToBottom                  = 1LLU  << 13,
+    FlowHasLineBreak                      = 1LLU  << 14,
+    FlowHasNonNormalUnicodeBiDi           = 1LLU  << 15,
+    FlowHasRTLOrdering                    = 1LLU  << 16,
+    FlowHasLineAlignEdges                 = 1LLU  << 17,
+    FlowHasLineSnap                       = 1LLU  << 18,
+    FlowHasHypensAuto                     = 1LLU  << 19,
+    FlowHasTextEmphasisFillOrMark         = 1LLU  << 20,
+    FlowHasPseudoFirstLine                = 1LLU  << 21,
+    FlowHasPseudoFirstLetter              = 1LLU  << 22,
+    FlowHasTextCombine                    = 1LLU  << 23,
+    FlowHasTextFillBox                    = 1LLU  << 24,
+    FlowHasBorderFitLines                 = 1LLU  << 25,
+    FlowHasNonAutoLineBreak               = 1LLU  << 26,
+    FlowHasNonAutoTrailingWord            = 1LLU  << 27,
+    FlowHasSVGFont                        = 1LLU  << 28,
+    FlowTextIsEmpty                       = 1LLU  << 29,
+    FlowTextHasNoBreakSpace               = 1LLU  << 30,
+    FlowTextHasSoftHyphen                 = 1LLU  << 31,
+    FlowTextHasDirectionCharacter         = 1LLU  << 32,
+    FlowIsMissingPrimaryFont              = 1LLU  << 33,
+    FlowFontIsMissingGlyph                = 1LLU  << 34,
+    FlowTextIsCombineText                 = 1LLU  << 35,
+    FlowTextIsRenderCounter               = 1LLU  << 36,
+    FlowTextIsRenderQuote                 = 1LLU  << 37,
+    FlowTextIsTextFragment                = 1LLU  << 38,
+    FlowTextIsSVGInlineText               = 1LLU  << 39,
+    FlowFontIsNotSimple                   = 1LLU  << 40,
+    FeatureIsDisabled                     = 1LLU  << 41,
+    FlowHasNoParent                       = 1LLU  << 42,
+    FlowHasNoChild                        = 1LLU  << 43,
+    FlowChildIsSelected                   = 1LLU  << 44,
+    FlowHasHangingPunctuation             = 1LLU  << 45,
+    EndOfReasons                          = 1LLU  << 46
 };
 const unsigned NoReason = 0;
 
@@ -135,8 +132,28 @@ enum class IncludeReasons { First , All };
     }
 #endif
 
+// Right-to-left flows are laid out as left-to-right lines that get mirrored, which is only correct when every character
+// resolves to the paragraph's level: right-to-left letters and neutrals, but no left-to-right letters or numbers.
+static bool isMirrorableInRightToLeftFlow(UCharDirection direction)
+{
+    switch (direction) {
+    case U_RIGHT_TO_LEFT:
+    case U_WHITE_SPACE_NEUTRAL:
+    case U_OTHER_NEUTRAL:
+    case U_SEGMENT_SEPARATOR:
+    case U_BLOCK_SEPARATOR:
+    case U_COMMON_NUMBER_SEPARATOR:
+    case U_EUROPEAN_NUMBER_SEPARATOR:
+    case U_EUROPEAN_NUMBER_TERMINATOR:
+    case U_DIR_NON_SPACING_MARK:
+        return true;
+    default:
+        return false;
+    }
+}
+
 template <typename CharacterType>
-static AvoidanceReasonFlags canUseForText(const CharacterType* text, unsigned length, const Font& font, IncludeReasons includeReasons)
+static AvoidanceReasonFlags canUseForText(const CharacterType* text, unsigned length, const Font& font, TextDirection flowDirection, IncludeReasons includeReasons)
 {
     AvoidanceReasonFlags reasons = { };
     // FIXME: <textarea maxlength=0> generates empty text node.
@@ -155,7 +172,10 @@ static AvoidanceReasonFlags canUseForText(const CharacterType* text, unsigned le
             SET_REASON_AND_RETURN_IF_NEEDED(FlowTextHasSoftHyphen, reasons, includeReasons);
 
         UCharDirection direction = u_charDirection(character);
-        if (direction == U_RIGHT_TO_LEFT || direction == U_RIGHT_TO_LEFT_ARABIC
+        if (flowDirection == RTL) {
+            if (!isMirrorableInRightToLeftFlow(direction))
+                SET_REASON_AND_RETURN_IF_NEEDED(FlowTextHasDirectionCharacter, reasons, includeReasons);
+        } else if (direction == U_RIGHT_TO_LEFT || direction == U_RIGHT_TO_LEFT_ARABIC
             || direction == U_RIGHT_TO_LEFT_EMBEDDING || direction == U_RIGHT_TO_LEFT_OVERRIDE
             || direction == U_LEFT_TO_RIGHT_EMBEDDING || direction == U_LEFT_TO_RIGHT_OVERRIDE
             || direction == U_POP_DIRECTIONAL_FORMAT || direction == U_BOUNDARY_NEUTRAL)
@@ -167,11 +187,11 @@ static AvoidanceReasonFlags canUseForText(const CharacterType* text, unsigned le
     return reasons;
 }
 
-static AvoidanceReasonFlags canUseForText(const RenderText& textRenderer, const Font& font, IncludeReasons includeReasons)
+static AvoidanceReasonFlags canUseForText(const RenderText& textRenderer, const Font& font, TextDirection flowDirection, IncludeReasons includeReasons)
 {
     if (textRenderer.is8Bit())
-        return canUseForText(textRenderer.characters8(), textRenderer.textLength(), font, includeReasons);
-    return canUseForText(textRenderer.characters16(), textRenderer.textLength(), font, includeReasons);
+        return canUseForText(textRenderer.characters8(), textRenderer.textLength(), font, flowDirection, includeReasons);
+    return canUseForText(textRenderer.characters16(), textRenderer.textLength(), font, flowDirection, includeReasons);
 }
 
 static AvoidanceReasonFlags canUseForFontAndText(const RenderBlockFlow& flow, IncludeReasons includeReasons)
@@ -199,7 +219,7 @@ static AvoidanceReasonFlags canUseForFontAndText(const RenderBlockFlow& flow, In
         if (style.fontCascade().codePath(TextRun(textRenderer.text())) != FontCascade::Simple)
             SET_REASON_AND_RETURN_IF_NEEDED(FlowFontIsNotSimple, reasons, includeReasons);
 
-        auto textReasons = canUseForText(textRenderer, primaryFont, includeReasons);
+        auto textReasons = canUseForText(textRenderer, primaryFont, style.direction(), includeReasons);
         if (textReasons != NoReason)
             SET_REASON_AND_RETURN_IF_NEEDED(textReasons, reasons, includeReasons);
     }
@@ -213,18 +233,14 @@ static AvoidanceReasonFlags canUseForStyle(const RenderStyle& style, IncludeReas
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasTextOverflow, reasons, includeReasons);
     if ((style.textDecorationsInEffect() & TextDecorationUnderline) && style.textUnderlinePosition() == TextUnderlinePositionUnder)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasUnsupportedUnderlineDecoration, reasons, includeReasons);
-    // Non-visible overflow should be pretty easy to support.
-    if (style.overflowX() != OVISIBLE || style.overflowY() != OVISIBLE)
-        SET_REASON_AND_RETURN_IF_NEEDED(FlowHasOverflowVisible, reasons, includeReasons);
-    if (!style.isLeftToRightDirection())
-        SET_REASON_AND_RETURN_IF_NEEDED(FlowIsNotLTR, reasons, includeReasons);
     if (style.lineBoxContain() != RenderStyle::initialLineBoxContain())
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasLineBoxContainProperty, reasons, includeReasons);
     if (style.writingMode() != TopToBottomWritingMode)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowIsNotTopToBottom, reasons, includeReasons);
     if (style.lineBreak() != LineBreakAuto)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasLineBreak, reasons, includeReasons);
-    if (style.unicodeBidi() != UBNormal)
+    // Embeddings and isolates on the block itself don't change how its own text is ordered.
+    if (isOverride(style.unicodeBidi()) || style.unicodeBidi() == Plaintext)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasNonNormalUnicodeBiDi, reasons, includeReasons);
     if (style.rtlOrdering() != LogicalOrder)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasRTLOrdering, reasons, includeReasons);
@@ -236,8 +252,6 @@ static AvoidanceReasonFlags canUseForStyle(const RenderStyle& style, IncludeReas
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasHypensAuto, reasons, includeReasons);
     if (style.textEmphasisFill() != TextEmphasisFillFilled || style.textEmphasisMark() != TextEmphasisMarkNone)
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasTextEmphasisFillOrMark, reasons, includeReasons);
-    if (style.textShadow())
-        SET_REASON_AND_RETURN_IF_NEEDED(FlowHasTextShadow, reasons, includeReasons);
     if (style.hasPseudoStyle(FIRST_LINE))
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasPseudoFirstLine, reasons, includeReasons);
     if (style.hasPseudoStyle(FIRST_LETTER))
@@ -278,8 +292,6 @@ static AvoidanceReasonFlags canUseForWithReason(const RenderBlockFlow& flow, Inc
         SET_REASON_AND_RETURN_IF_NEEDED(FlowIsInsideRegion, reasons, includeReasons);
     if (!flow.isHorizontalWritingMode())
         SET_REASON_AND_RETURN_IF_NEEDED(FlowHasHorizonalWritingMode, reasons, includeReasons);
-    if (flow.hasOutline())
-        SET_REASON_AND_RETURN_IF_NEEDED(FlowHasOutline, reasons, includeReasons);
     if (flow.isRubyText() || flow.isRubyBase())
         SET_REASON_AND_RETURN_IF_NEEDED(FlowIsRuby, reasons, includeReasons);
     if (flow.style().hangingPunctuation() != NoHangingPunctuation)
@@ -345,9 +357,29 @@ static AvoidanceReasonFlags canUseForWithReason(const RenderBlockFlow& flow, Inc
     return reasons;
 }
 
+static HashMap<AvoidanceReason, unsigned>& avoidanceReasonCounters()
+{
+    static NeverDestroyed<HashMap<AvoidanceReason, unsigned>> counters;
+    return counters;
+}
+
+static bool avoidanceReasonCountingEnabled = false;
+
+void setAvoidanceReasonCountingEnabled(bool enabled)
+{
+    avoidanceReasonCountingEnabled = enabled;
+    avoidanceReasonCounters().clear();
+}
+
 bool canUseFor(const RenderBlockFlow& flow)
 {
-    return canUseForWithReason(flow, IncludeReasons::First) == NoReason;
+    auto reasons = canUseForWithReason(flow, IncludeReasons::First);
+    if (reasons == NoReason)
+        return true;
+    // IncludeReasons::First stops at the first reason, so this is a single bit.
+    if (avoidanceReasonCountingEnabled)
+        ++avoidanceReasonCounters().add(reasons, 0).iterator->value;
+    return false;
 }
 
 static float computeLineLeft(ETextAlign textAlign, float availableWidth, float committedWidth, float logicalLeftOffset)
@@ -396,10 +428,13 @@ public:
     void setAvailableWidth(float width) { m_availableWidth = width; }
     void setCollapedWhitespaceWidth(float width) { m_collapsedWhitespaceWidth = width; }
     void setLogicalLeftOffset(float offset) { m_logicalLeftOffset = offset; }
+    void setLineEdges(float left, float right) { m_lineLeft = left; m_lineRight = right; }
     void setOverflowedFragment(const TextFragmentIterator::TextFragment& fragment) { m_overflowedFragment = fragment; }
 
     float availableWidth() const { return m_availableWidth; }
     float logicalLeftOffset() const { return m_logicalLeftOffset; }
+    float lineLeft() const { return m_lineLeft; }
+    float lineRight() const { return m_lineRight; }
     const TextFragmentIterator::TextFragment& overflowedFragment() const { return m_overflowedFragment; }
     bool hasTrailingWhitespace() const { return m_trailingWhitespaceLength; }
     Optional<TextFragmentIterator::TextFragment> lastFragment() const
@@ -541,6 +576,9 @@ private:
 
     float m_availableWidth { 0 };
     float m_logicalLeftOffset { 0 };
+    // Available space without text-indent, used to mirror right-to-left lines.
+    float m_lineLeft { 0 };
+    float m_lineRight { 0 };
     TextFragmentIterator::TextFragment m_overflowedFragment;
     float m_runsWidth { 0 };
     TextFragmentIterator::TextFragment m_lastCompleteFragment;
@@ -603,9 +641,10 @@ static void updateLineConstrains(const RenderBlockFlow& flow, LineState& line, b
     bool shouldApplyTextIndent = !flow.isAnonymous() || flow.parent()->firstChild() == &flow;
     LayoutUnit height = flow.logicalHeight();
     LayoutUnit logicalHeight = flow.minLineHeightForReplacedRenderer(false, 0);
+    float logicalLeftOffset = flow.logicalLeftOffsetForLine(height, DoNotIndentText, logicalHeight);
     float logicalRightOffset = flow.logicalRightOffsetForLine(height, DoNotIndentText, logicalHeight);
-    line.setLogicalLeftOffset(flow.logicalLeftOffsetForLine(height, DoNotIndentText, logicalHeight) +
-        (shouldApplyTextIndent && isFirstLine ? flow.textIndentOffset() : LayoutUnit(0)));
+    line.setLineEdges(logicalLeftOffset, logicalRightOffset);
+    line.setLogicalLeftOffset(logicalLeftOffset + (shouldApplyTextIndent && isFirstLine ? flow.textIndentOffset() : LayoutUnit(0)));
     line.setAvailableWidth(std::max<float>(0, logicalRightOffset - line.logicalLeftOffset()));
 }
 
@@ -804,7 +843,7 @@ static ETextAlign textAlignForLine(const TextFragmentIterator::Style& style, boo
     // Fallback to LEFT (START) alignment for non-collapsable content and for the last line before a forced break or the end of the block.
     auto textAlign = style.textAlign;
     if (textAlign == JUSTIFY && (!style.collapseWhitespace || lastLine))
-        textAlign = LEFT;
+        textAlign = TASTART;
     return textAlign;
 }
 
@@ -829,6 +868,16 @@ static void closeLineEndingAndAdjustRuns(LineState& line, Layout::RunVector& run
         runs[i].logicalLeft += lineLogicalLeft;
         runs[i].logicalRight += lineLogicalLeft;
     }
+    // Every character on a right-to-left line is at the paragraph's embedding level (see canUseForText),
+    // so the visual order is the logical order reversed.
+    if (style.direction == RTL) {
+        auto mirrorAxis = line.lineLeft() + line.lineRight();
+        for (auto i = firstRunIndex; i < runs.size(); ++i) {
+            auto logicalLeft = runs[i].logicalLeft;
+            runs[i].logicalLeft = mirrorAxis - runs[i].logicalRight;
+            runs[i].logicalRight = mirrorAxis - logicalLeft;
+        }
+    }
     runs.last().isEndOfLine = true;
     ++lineCount;
 }
@@ -879,7 +928,6 @@ Layout::Layout(const RunVector& runVector, unsigned lineCount)
     memcpy(m_runs, runVector.data(), m_runCount * sizeof(Run));
 }
 
-#ifndef NDEBUG
 static void printReason(AvoidanceReason reason, TextStream& stream)
 {
     switch (reason) {
@@ -889,9 +937,6 @@ static void printReason(AvoidanceReason reason, TextStream& stream)
     case FlowHasHorizonalWritingMode:
         stream << "horizontal writing mode";
         break;
-    case FlowHasOutline:
-        stream << "outline";
-        break;
     case FlowIsRuby:
         stream << "ruby";
         break;
@@ -925,12 +970,6 @@ static void printReason(AvoidanceReason reason, TextStream& stream)
     case FlowHasJustifiedNonLatinText:
         stream << "text-align: justify with non-latin text";
         break;
-    case FlowHasOverflowVisible:
-        stream << "overflow: visible";
-        break;
-    case FlowIsNotLTR:
-        stream << "dir is not LTR";
-        break;
     case FlowHasLineBoxContainProperty:
         stream << "line-box-contain property";
         break;
@@ -1015,9 +1054,6 @@ static void printReason(AvoidanceReason reason, TextStream& stream)
     case FlowFontIsNotSimple:
         stream << "complext font";
         break;
-    case FlowHasTextShadow:
-        stream << "text-shadow";
-        break;
     case FlowChildIsSelected:
         stream << "selected content";
         break;
@@ -1030,6 +1066,27 @@ static void printReason(AvoidanceReason reason, TextStream& stream)
     }
 }
 
+String avoidanceReasonCountersAsText()
+{
+    Vector<std::pair<AvoidanceReason, unsigned>> counters;
+    for (auto& counter : avoidanceReasonCounters())
+        counters.append(std::make_pair(counter.key, counter.value));
+    std::sort(counters.begin(), counters.end(), [](const std::pair<AvoidanceReason, unsigned>& a, const std::pair<AvoidanceReason, unsigned>& b) {
+        return a.second > b.second;
+    });
+
+    TextStream stream;
+    for (auto& counter : counters) {
+        if (counter.first == FlowTextIsEmpty || counter.first == FlowHasNoChild || counter.first == FlowHasNoParent || counter.first == FeatureIsDisabled)
+            continue;
+        printReason(counter.first, stream);
+        stream << ": " << counter.second << "\n";
+    }
+    return stream.release();
+}
+
+#ifndef NDEBUG
+
 static void printReasons(AvoidanceReasonFlags reasons, TextStream& stream)
 {
     bool first = true;
@@ -43,6 +43,12 @@ namespace SimpleLineLayout {
 
 bool canUseFor(const RenderBlockFlow&);
 
+// Counting the reasons that send blocks to the line box path is off by default. Enabling or disabling
+// it clears the counters. Only the first reason found for a block is counted.
+WEBCORE_EXPORT void setAvoidanceReasonCountingEnabled(bool);
+// One line per reason counted since counting was enabled, most frequent first.
+WEBCORE_EXPORT String avoidanceReasonCountersAsText();
+
 struct Run {
 #if COMPILER(MSVC)
     Run() { }
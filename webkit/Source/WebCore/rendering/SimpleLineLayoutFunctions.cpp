@@ -71,6 +71,16 @@ static FloatRect computeOverflow(const RenderBlockFlow& flow, const FloatRect& l
     auto strokeOverflow = std::ceil(flow.style().textStrokeWidth());
     overflowRect.inflate(strokeOverflow);
 
+    if (flow.style().textShadow()) {
+        LayoutUnit shadowTop;
+        LayoutUnit shadowRight;
+        LayoutUnit shadowBottom;
+        LayoutUnit shadowLeft;
+        flow.style().getTextShadowExtent(shadowTop, shadowRight, shadowBottom, shadowLeft);
+        overflowRect.move(shadowLeft, shadowTop);
+        overflowRect.expand(shadowRight - shadowLeft, shadowBottom - shadowTop);
+    }
+
     auto letterSpacing = flow.style().fontCascade().letterSpacing();
     if (letterSpacing >= 0)
         return overflowRect;
@@ -93,6 +103,8 @@ void paintFlow(const RenderBlockFlow& flow, const Layout& layout, PaintInfo& pai
     TextPainter textPainter(paintInfo.context());
     textPainter.setFont(style.fontCascade());
     textPainter.setTextPaintStyle(computeTextPaintStyle(flow.frame(), style, paintInfo));
+    const ShadowData* textShadow = paintInfo.forceTextColor() ? nullptr : style.textShadow();
+    textPainter.addTextShadow(textShadow, nullptr);
 
     Optional<TextDecorationPainter> textDecorationPainter;
     if (style.textDecorationsInEffect() != TextDecorationNone) {
@@ -101,6 +113,7 @@ void paintFlow(const RenderBlockFlow& flow, const Layout& layout, PaintInfo& pai
             textDecorationPainter = TextDecorationPainter(paintInfo.context(), style.textDecorationsInEffect(), *textRenderer, false);
             textDecorationPainter->setFont(style.fontCascade());
             textDecorationPainter->setBaseline(style.fontMetrics().ascent());
+            textDecorationPainter->addTextShadow(textShadow);
         }
     }
 
@@ -119,7 +132,7 @@ void paintFlow(const RenderBlockFlow& flow, const Layout& layout, PaintInfo& pai
             continue;
 
         // x position indicates the line offset from the rootbox. It's always 0 in case of simple line layout.
-        TextRun textRun(run.text(), 0, run.expansion(), run.expansionBehavior());
+        TextRun textRun(run.text(), 0, run.expansion(), run.expansionBehavior(), style.direction());
         textRun.setTabSize(!style.collapseWhiteSpace(), style.tabSize());
         FloatPoint textOrigin = FloatPoint(rect.x() + paintOffset.x(), roundToDevicePixel(run.baselinePosition() + paintOffset.y(), deviceScaleFactor));
         textPainter.paintText(textRun, textRun.length(), rect, textOrigin);
@@ -170,6 +183,16 @@ void collectFlowOverflow(RenderBlockFlow& flow, const Layout& layout)
     }
 }
 
+void collectFocusRingRects(const RenderBlockFlow& flow, const Layout& layout, Vector<LayoutRect>& rects, const LayoutPoint& additionalOffset)
+{
+    for (auto lineRect : lineResolver(flow, layout)) {
+        LayoutRect rect(lineRect);
+        rect.moveBy(additionalOffset);
+        if (!rect.isEmpty())
+            rects.append(rect);
+    }
+}
+
 IntRect computeBoundingBox(const RenderObject& renderer, const Layout& layout)
 {
     auto resolver = runResolver(downcast<RenderBlockFlow>(*renderer.parent()), layout);
@@ -48,6 +48,7 @@ LayoutUnit computeFlowLastLineBaseline(const RenderBlockFlow&, const Layout&);
 void paintFlow(const RenderBlockFlow&, const Layout&, PaintInfo&, const LayoutPoint& paintOffset);
 bool hitTestFlow(const RenderBlockFlow&, const Layout&, const HitTestRequest&, HitTestResult&, const HitTestLocation& locationInContainer, const LayoutPoint& accumulatedOffset, HitTestAction);
 void collectFlowOverflow(RenderBlockFlow&, const Layout&);
+void collectFocusRingRects(const RenderBlockFlow&, const Layout&, Vector<LayoutRect>&, const LayoutPoint& additionalOffset);
 
 bool isTextRendered(const RenderText&, const Layout&);
 bool containsCaretOffset(const RenderObject&, const Layout&, unsigned);
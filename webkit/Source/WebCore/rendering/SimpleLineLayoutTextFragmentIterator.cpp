@@ -33,9 +33,29 @@
 namespace WebCore {
 namespace SimpleLineLayout {
 
+static ETextAlign textAlignBeforeMirroring(const RenderStyle& style)
+{
+    auto textAlign = style.textAlign();
+    if (style.isLeftToRightDirection())
+        return textAlign;
+    switch (textAlign) {
+    case LEFT:
+        return RIGHT;
+    case WEBKIT_LEFT:
+        return WEBKIT_RIGHT;
+    case RIGHT:
+        return LEFT;
+    case WEBKIT_RIGHT:
+        return WEBKIT_LEFT;
+    default:
+        return textAlign;
+    }
+}
+
 TextFragmentIterator::Style::Style(const RenderStyle& style)
     : font(style.fontCascade())
-    , textAlign(style.textAlign())
+    , direction(style.direction())
+    , textAlign(textAlignBeforeMirroring(style))
     , collapseWhitespace(style.collapseWhiteSpace())
     , preserveNewline(style.preserveNewline())
     , wrapLines(style.autoWrap())
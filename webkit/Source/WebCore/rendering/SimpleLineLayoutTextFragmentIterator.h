@@ -99,6 +99,8 @@ public:
         explicit Style(const RenderStyle&);
 
         const FontCascade& font;
+        TextDirection direction;
+        // Lines are laid out left to right and mirrored afterwards when the direction is RTL.
         ETextAlign textAlign;
         bool collapseWhitespace;
         bool preserveNewline;
@@ -707,6 +707,10 @@ bool RenderStyle::changeRequiresLayout(const RenderStyle& other, unsigned& chang
         || rareNonInheritedData->m_breakInside != other.rareNonInheritedData->m_breakInside)
         return true;
 
+    // Containment changes layout roots, formatting contexts and intrinsic sizes.
+    if (rareNonInheritedData->m_contain != other.rareNonInheritedData->m_contain)
+        return true;
+
     // Overflow returns a layout hint.
     if (noninherited_flags.overflowX() != other.noninherited_flags.overflowX()
         || noninherited_flags.overflowY() != other.noninherited_flags.overflowY())
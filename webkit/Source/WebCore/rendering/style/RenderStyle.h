@@ -1027,6 +1027,10 @@ public:
     const AtomicString& locale() const { return fontDescription().locale(); }
     EBorderFit borderFit() const { return static_cast<EBorderFit>(rareNonInheritedData->m_borderFit); }
     EResize resize() const { return static_cast<EResize>(rareNonInheritedData->m_resize); }
+    Containment contain() const { return rareNonInheritedData->m_contain; }
+    bool containsSize() const { return rareNonInheritedData->m_contain & ContainmentSize; }
+    bool containsLayout() const { return rareNonInheritedData->m_contain & ContainmentLayout; }
+    bool containsPaint() const { return rareNonInheritedData->m_contain & ContainmentPaint; }
     ColumnAxis columnAxis() const { return static_cast<ColumnAxis>(rareNonInheritedData->m_multiCol->m_axis); }
     bool hasInlineColumnAxis() const {
         ColumnAxis axis = columnAxis();
@@ -1611,6 +1615,7 @@ public:
     void setHyphenationString(const AtomicString& h) { SET_VAR(rareInheritedData, hyphenationString, h); }
     void setBorderFit(EBorderFit b) { SET_VAR(rareNonInheritedData, m_borderFit, b); }
     void setResize(EResize r) { SET_VAR(rareNonInheritedData, m_resize, r); }
+    void setContain(Containment c) { SET_VAR(rareNonInheritedData, m_contain, c); }
     void setColumnAxis(ColumnAxis axis) { SET_NESTED_VAR(rareNonInheritedData, m_multiCol, m_axis, axis); }
     void setColumnProgression(ColumnProgression progression) { SET_NESTED_VAR(rareNonInheritedData, m_multiCol, m_progression, progression); }
     void setColumnWidth(float f) { SET_NESTED_VAR(rareNonInheritedData, m_multiCol, m_autoWidth, false); SET_NESTED_VAR(rareNonInheritedData, m_multiCol, m_width, f); }
@@ -2029,6 +2034,7 @@ public:
     static const AtomicString& initialHyphenationString() { return nullAtom; }
     static EBorderFit initialBorderFit() { return BorderFitBorder; }
     static EResize initialResize() { return RESIZE_NONE; }
+    static Containment initialContain() { return ContainmentNone; }
     static ControlPart initialAppearance() { return NoControlPart; }
     static AspectRatioType initialAspectRatioType() { return AspectRatioAuto; }
     static float initialAspectRatioDenominator() { return 1; }
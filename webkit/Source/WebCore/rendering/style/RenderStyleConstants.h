@@ -671,6 +671,17 @@ enum TextIndentType { TextIndentNormal, TextIndentHanging };
 
 enum Isolation { IsolationAuto, IsolationIsolate };
 
+enum Containments {
+    ContainmentNone = 0,
+    ContainmentSize = 1 << 0,
+    ContainmentLayout = 1 << 1,
+    ContainmentStyle = 1 << 2,
+    ContainmentPaint = 1 << 3,
+    ContainmentStrict = ContainmentSize | ContainmentLayout | ContainmentStyle | ContainmentPaint,
+    ContainmentContent = ContainmentLayout | ContainmentStyle | ContainmentPaint
+};
+typedef unsigned Containment;
+
 // Fill, Stroke, ViewBox are just used for SVG.
 enum CSSBoxType { BoxMissing = 0, MarginBox, BorderBox, PaddingBox, ContentBox, Fill, Stroke, ViewBox };
 
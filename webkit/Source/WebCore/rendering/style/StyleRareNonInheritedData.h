@@ -226,6 +226,7 @@ public:
     unsigned m_breakAfter : 4;
     unsigned m_breakInside : 3; // BreakInside
     unsigned m_resize : 2; // EResize
+    unsigned m_contain : 4; // Containment
 
     unsigned m_hasAttrContent : 1;
 
@@ -39,11 +39,13 @@
 #include "VisitedLinkState.h"
 #include "WebVTTElement.h"
 #include "XMLNames.h"
+#include <wtf/Hasher.h>
 
 namespace WebCore {
 namespace Style {
 
 static const unsigned cStyleSearchThreshold = 10;
+static const unsigned maximumDocumentSharingCandidates = 512;
 
 struct SharingResolver::Context {
     const Update& update;
@@ -52,7 +54,7 @@ struct SharingResolver::Context {
     EInsideLink elementLinkState;
 };
 
-SharingResolver::SharingResolver(const Document& document, const DocumentRuleSets& ruleSets, const SelectorFilter& selectorFilter)
+SharingResolver::SharingResolver(const Document& document, DocumentRuleSets& ruleSets, const SelectorFilter& selectorFilter)
     : m_document(document)
     , m_ruleSets(ruleSets)
     , m_selectorFilter(selectorFilter)
@@ -70,7 +72,23 @@ static inline bool elementHasDirectionAuto(const Element& element)
     return is<HTMLElement>(element) && downcast<HTMLElement>(element).hasDirectionAuto();
 }
 
-std::unique_ptr<RenderStyle> SharingResolver::resolve(const Element& searchElement, const Update& update)
+std::unique_ptr<RenderStyle> SharingResolver::resolve(const Element& element, const Update& update)
+{
+    auto* shareElement = findElementToShareStyleWith(element, update);
+
+    // Elements that share style are interchangeable as ancestors, so their children may share too.
+    unsigned sharingGroup = shareElement ? m_sharingGroups.get(shareElement) : 0;
+    m_sharingGroups.set(&element, sharingGroup ? sharingGroup : ++m_lastSharingGroup);
+
+    if (!shareElement)
+        return nullptr;
+
+    m_elementsSharingStyle.add(&element, shareElement);
+
+    return RenderStyle::clonePtr(*update.elementStyle(*shareElement));
+}
+
+const StyledElement* SharingResolver::findElementToShareStyleWith(const Element& searchElement, const Update& update)
 {
     if (!is<StyledElement>(searchElement))
         return nullptr;
@@ -118,6 +136,10 @@ std::unique_ptr<RenderStyle> SharingResolver::resolve(const Element& searchEleme
         cousinList = locateCousinList(cousinList->parentElement());
     }
 
+    // Fall back to elements elsewhere in the document with an interchangeable parent.
+    if (!shareElement)
+        shareElement = findDocumentSharingCandidate(context, parentElement);
+
     // If we have exhausted all our budget or our cousins.
     if (!shareElement)
         return nullptr;
@@ -132,9 +154,57 @@ std::unique_ptr<RenderStyle> SharingResolver::resolve(const Element& searchEleme
     if (parentElementPreventsSharing(parentElement))
         return nullptr;
 
-    m_elementsSharingStyle.add(&element, shareElement);
+    return shareElement;
+}
 
-    return RenderStyle::clonePtr(*update.elementStyle(*shareElement));
+unsigned SharingResolver::documentSharingKey(const Context& context, unsigned parentSharingGroup) const
+{
+    auto& element = context.element;
+
+    IntegerHasher hasher;
+    hasher.add(parentSharingGroup);
+    hasher.add(element.localName().impl()->existingHash());
+    hasher.add(context.elementLinkState);
+    if (element.hasClass() && !element.isSVGElement()) {
+        auto& classNames = element.classNames();
+        for (unsigned i = 0; i < classNames.size(); ++i)
+            hasher.add(classNames[i].impl()->existingHash());
+    }
+    return hasher.hash();
+}
+
+StyledElement* SharingResolver::findDocumentSharingCandidate(const Context& context, const Element& parentElement)
+{
+    unsigned parentSharingGroup = m_sharingGroups.get(&parentElement);
+    if (!parentSharingGroup)
+        return nullptr;
+
+    auto& statistics = m_ruleSets.styleSharingStatistics();
+    unsigned key = documentSharingKey(context, parentSharingGroup);
+    auto* candidate = m_documentSharingCandidates.get(key);
+    if (candidate && isValidDocumentSharingCandidate(context, *candidate, parentSharingGroup)) {
+        ++statistics.documentCacheHits;
+        return const_cast<StyledElement*>(candidate);
+    }
+    ++statistics.documentCacheMisses;
+
+    // The element will go through full rule matching, make it the candidate for the next lookup.
+    if (candidate || m_documentSharingCandidates.size() < maximumDocumentSharingCandidates)
+        m_documentSharingCandidates.set(key, &context.element);
+    return nullptr;
+}
+
+bool SharingResolver::isValidDocumentSharingCandidate(const Context& context, const StyledElement& candidate, unsigned parentSharingGroup) const
+{
+    auto* candidateParent = candidate.parentElement();
+    if (!candidateParent)
+        return false;
+    // Hash collisions aside, this guarantees the ancestor chains are interchangeable.
+    if (m_sharingGroups.get(candidateParent) != parentSharingGroup)
+        return false;
+    if (parentElementPreventsSharing(*candidateParent))
+        return false;
+    return canShareStyleWithElement(context, candidate);
 }
 
 StyledElement* SharingResolver::findSibling(const Context& context, Node* node, unsigned& count) const
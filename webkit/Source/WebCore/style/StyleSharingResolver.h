@@ -46,13 +46,17 @@ class Update;
 
 class SharingResolver {
 public:
-    SharingResolver(const Document&, const DocumentRuleSets&, const SelectorFilter&);
+    SharingResolver(const Document&, DocumentRuleSets&, const SelectorFilter&);
 
     std::unique_ptr<RenderStyle> resolve(const Element&, const Update&);
 
 private:
     struct Context;
 
+    const StyledElement* findElementToShareStyleWith(const Element&, const Update&);
+    StyledElement* findDocumentSharingCandidate(const Context&, const Element& parentElement);
+    bool isValidDocumentSharingCandidate(const Context&, const StyledElement& candidate, unsigned parentSharingGroup) const;
+    unsigned documentSharingKey(const Context&, unsigned parentSharingGroup) const;
     StyledElement* findSibling(const Context&, Node*, unsigned& count) const;
     Node* locateCousinList(const Element* parent) const;
     bool canShareStyleWithElement(const Context&, const StyledElement& candidateElement) const;
@@ -61,10 +65,15 @@ private:
     bool classNamesAffectedByRules(const SpaceSplitString& classNames) const;
 
     const Document& m_document;
-    const DocumentRuleSets& m_ruleSets;
+    DocumentRuleSets& m_ruleSets;
     const SelectorFilter& m_selectorFilter;
 
     HashMap<const Element*, const Element*> m_elementsSharingStyle;
+
+    // Elements in the same sharing group have interchangeable styles and ancestor chains.
+    HashMap<const Element*, unsigned> m_sharingGroups;
+    unsigned m_lastSharingGroup { 0 };
+    HashMap<unsigned, const StyledElement*> m_documentSharingCandidates;
 };
 
 }
@@ -83,6 +83,7 @@
 #include "IntRect.h"
 #include "InternalSettings.h"
 #include "Language.h"
+#include "LoaderStrategy.h"
 #include "MainFrame.h"
 #include "MallocStatistics.h"
 #include "MediaPlayer.h"
@@ -95,10 +96,12 @@
 #include "PageOverlay.h"
 #include "PathUtilities.h"
 #include "PlatformMediaSessionManager.h"
+#include "PlatformStrategies.h"
 #include "PrintContext.h"
 #include "PseudoElement.h"
 #include "Range.h"
 #include "RenderEmbeddedObject.h"
+#include "RenderGrid.h"
 #include "RenderLayerBacking.h"
 #include "RenderLayerCompositor.h"
 #include "RenderMenuList.h"
@@ -113,9 +116,11 @@
 #include "SerializedScriptValue.h"
 #include "Settings.h"
 #include "ShadowRoot.h"
+#include "SimpleLineLayout.h"
 #include "SourceBuffer.h"
 #include "SpellChecker.h"
 #include "StaticNodeList.h"
+#include "StyleResolver.h"
 #include "StyleSheetContents.h"
 #include "TextIterator.h"
 #include "TreeScope.h"
@@ -399,6 +404,7 @@ void Internals::resetToConsistentState(Page& page)
 #endif
 
     MockPageOverlayClient::singleton().uninstallAllOverlays();
+    SimpleLineLayout::setAvoidanceReasonCountingEnabled(false);
 
 #if ENABLE(CONTENT_FILTERING)
     MockContentFilterSettings::reset();
@@ -609,6 +615,33 @@ void Internals::setStrictRawResourceValidationPolicyDisabled(bool disabled)
     frame()->loader().setStrictRawResourceValidationPolicyDisabledForTesting(disabled);
 }
 
+unsigned Internals::finishedResourceLoadCount(ResourceLoadPriority priority)
+{
+    return platformStrategies()->loaderStrategy()->loadPhaseTimes(toResourceLoadPriority(priority)).loadCount;
+}
+
+double Internals::resourceLoadPhaseTime(ResourceLoadPriority priority, ResourceLoadPhase phase)
+{
+    auto times = platformStrategies()->loaderStrategy()->loadPhaseTimes(toResourceLoadPriority(priority));
+    switch (phase) {
+    case ResourceLoadPhase::Queued:
+        return times.queuedTime;
+    case ResourceLoadPhase::Connecting:
+        return times.connectingTime;
+    case ResourceLoadPhase::Waiting:
+        return times.waitingTime;
+    case ResourceLoadPhase::Receiving:
+        return times.receivingTime;
+    }
+    ASSERT_NOT_REACHED();
+    return 0;
+}
+
+void Internals::resetResourceLoadPhaseTimes()
+{
+    platformStrategies()->loaderStrategy()->resetLoadPhaseTimes();
+}
+
 void Internals::clearMemoryCache()
 {
     MemoryCache::singleton().evictResources();
@@ -620,6 +653,15 @@ void Internals::pruneMemoryCacheToSize(unsigned size)
     MemoryCache::singleton().pruneLiveResourcesToSize(size, true);
 }
 
+void Internals::destroyDecodedDataForAllScripts()
+{
+    // Unlike pruning, this also reaches scripts that are still loading.
+    MemoryCache::singleton().forEachResource([](CachedResource& resource) {
+        if (resource.type() == CachedResource::Script)
+            resource.destroyDecodedData();
+    });
+}
+
 unsigned Internals::memoryCacheSize() const
 {
     return MemoryCache::singleton().size();
@@ -2347,6 +2389,47 @@ unsigned Internals::styleRecalcCount(ExceptionCode& ec)
     return document->styleRecalcCount();
 }
 
+unsigned Internals::styleSharingCacheHitCount(ExceptionCode& ec)
+{
+    Document* document = contextDocument();
+    if (!document) {
+        ec = INVALID_ACCESS_ERR;
+        return 0;
+    }
+
+    return document->ensureStyleResolver().ruleSets().styleSharingStatistics().documentCacheHits;
+}
+
+unsigned Internals::styleSharingCacheMissCount(ExceptionCode& ec)
+{
+    Document* document = contextDocument();
+    if (!document) {
+        ec = INVALID_ACCESS_ERR;
+        return 0;
+    }
+
+    return document->ensureStyleResolver().ruleSets().styleSharingStatistics().documentCacheMisses;
+}
+
+bool Internals::documentsShareAuthorStyle(Document& document, Document& otherDocument)
+{
+    document.updateStyleIfNeeded();
+    otherDocument.updateStyleIfNeeded();
+    auto& ruleSets = document.ensureStyleResolver().ruleSets();
+    return ruleSets.hasSharedAuthorStyle() && ruleSets.authorStyle() == otherDocument.ensureStyleResolver().ruleSets().authorStyle();
+}
+
+unsigned Internals::preconnectHintCount(ExceptionCode& ec)
+{
+    Document* document = contextDocument();
+    if (!document) {
+        ec = INVALID_ACCESS_ERR;
+        return 0;
+    }
+
+    return document->preconnectHintCount();
+}
+
 void Internals::startTrackingCompositingUpdates(ExceptionCode& ec)
 {
     Document* document = contextDocument();
@@ -2369,6 +2452,19 @@ unsigned Internals::compositingUpdateCount(ExceptionCode& ec)
     return document->renderView()->compositor().compositingUpdateCount();
 }
 
+#if ENABLE(CSS_GRID_LAYOUT)
+unsigned Internals::gridTrackSizingPassCount(Element& element, ExceptionCode& ec)
+{
+    element.document().updateLayoutIgnorePendingStylesheets();
+    if (!is<RenderGrid>(element.renderer())) {
+        ec = INVALID_ACCESS_ERR;
+        return 0;
+    }
+
+    return downcast<RenderGrid>(*element.renderer()).trackSizingPassCount();
+}
+#endif
+
 void Internals::updateLayoutIgnorePendingStylesheetsAndRunPostLayoutTasks(Node* node, ExceptionCode& ec)
 {
     Document* document;
@@ -2394,6 +2490,16 @@ unsigned Internals::layoutCount() const
     return document->view()->layoutCount();
 }
 
+void Internals::startCountingSimpleLineLayoutAvoidanceReasons()
+{
+    SimpleLineLayout::setAvoidanceReasonCountingEnabled(true);
+}
+
+String Internals::simpleLineLayoutAvoidanceReasons() const
+{
+    return SimpleLineLayout::avoidanceReasonCountersAsText();
+}
+
 #if !PLATFORM(IOS)
 static const char* cursorTypeToString(Cursor::Type cursorType)
 {
@@ -97,9 +97,14 @@ public:
     enum class ResourceLoadPriority { ResourceLoadPriorityVeryLow, ResourceLoadPriorityLow, ResourceLoadPriorityMedium, ResourceLoadPriorityHigh, ResourceLoadPriorityVeryHigh };
     void setOverrideResourceLoadPriority(ResourceLoadPriority);
     void setStrictRawResourceValidationPolicyDisabled(bool);
+    unsigned finishedResourceLoadCount(ResourceLoadPriority);
+    enum class ResourceLoadPhase { Queued, Connecting, Waiting, Receiving };
+    double resourceLoadPhaseTime(ResourceLoadPriority, ResourceLoadPhase);
+    void resetResourceLoadPhaseTimes();
 
     void clearMemoryCache();
     void pruneMemoryCacheToSize(unsigned size);
+    void destroyDecodedDataForAllScripts();
     unsigned memoryCacheSize() const;
 
     unsigned imageFrameIndex(HTMLImageElement&);
@@ -325,12 +330,26 @@ public:
     void startTrackingStyleRecalcs(ExceptionCode&);
     unsigned styleRecalcCount(ExceptionCode&);
 
+    unsigned styleSharingCacheHitCount(ExceptionCode&);
+    unsigned styleSharingCacheMissCount(ExceptionCode&);
+
+    bool documentsShareAuthorStyle(Document&, Document&);
+
+    unsigned preconnectHintCount(ExceptionCode&);
+
     void startTrackingCompositingUpdates(ExceptionCode&);
     unsigned compositingUpdateCount(ExceptionCode&);
 
+#if ENABLE(CSS_GRID_LAYOUT)
+    unsigned gridTrackSizingPassCount(Element&, ExceptionCode&);
+#endif
+
     void updateLayoutIgnorePendingStylesheetsAndRunPostLayoutTasks(Node*, ExceptionCode&);
     unsigned layoutCount() const;
 
+    void startCountingSimpleLineLayoutAvoidanceReasons();
+    String simpleLineLayoutAvoidanceReasons() const;
+
     RefPtr<ArrayBuffer> serializeObject(PassRefPtr<SerializedScriptValue>) const;
     RefPtr<SerializedScriptValue> deserializeBuffer(ArrayBuffer&) const;
 
@@ -36,6 +36,7 @@
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/SubresourceLoader.h>
 #include <WebCore/URL.h>
+#include <wtf/CurrentTime.h>
 #include <wtf/MainThread.h>
 #include <wtf/TemporaryChange.h>
 #include <wtf/text/CString.h>
@@ -57,8 +58,19 @@ static const unsigned maxRequestsInFlightForNonHTTPProtocols = 20;
 static const unsigned maxRequestsInFlightForNonHTTPProtocols = 10000;
 #endif
 
+// Servers accept at least 100 concurrent streams on an HTTP/2 connection.
+static const unsigned maxRequestsInFlightPerMultiplexedHost = 100;
+// Streams on a multiplexed connection share its bandwidth, so while render-blocking loads are in flight
+// other loads only get a few streams. On other connections, one connection is kept for render-blocking loads.
+static const unsigned maxRequestsInFlightBehindRenderBlockingLoads = 2;
+
 using namespace WebCore;
 
+static bool isRenderBlocking(ResourceLoadPriority priority)
+{
+    return priority >= ResourceLoadPriority::High;
+}
+
 WebResourceLoadScheduler& webResourceLoadScheduler()
 {
     return static_cast<WebResourceLoadScheduler&>(*platformStrategies()->loaderStrategy());
@@ -73,7 +85,7 @@ WebResourceLoadScheduler::HostInformation* WebResourceLoadScheduler::hostForURL(
     String hostName = url.host();
     HostInformation* host = m_hosts.get(hostName);
     if (!host && createHostPolicy == CreateIfNotFound) {
-        host = new HostInformation(hostName, maxRequestsInFlightPerHost);
+        host = new HostInformation(hostName, maxRequestsInFlightPerHost, m_multiplexedHostNames.contains(hostName));
         m_hosts.add(hostName, host);
     }
     return host;
@@ -149,6 +161,8 @@ void WebResourceLoadScheduler::scheduleLoad(ResourceLoader* resourceLoader)
 
     ResourceLoadPriority priority = resourceLoader->request().priority();
 
+    m_loadTimings.set(resourceLoader, LoadTiming { monotonicallyIncreasingTime(), 0 });
+
     bool hadRequests = host->hasRequests();
     host->schedule(resourceLoader, priority);
 
@@ -184,9 +198,18 @@ void WebResourceLoadScheduler::remove(ResourceLoader* resourceLoader)
 {
     ASSERT(resourceLoader);
 
+    recordLoadPhaseTimes(resourceLoader);
+
     HostInformation* host = hostForURL(resourceLoader->url());
-    if (host)
+    if (host) {
         host->remove(resourceLoader);
+
+        if (!host->name().isNull() && !host->isMultiplexed() && resourceLoader->response().httpVersion().startsWith("HTTP/2")) {
+            LOG(ResourceLoading, "WebResourceLoadScheduler: '%s' is served over a multiplexed connection", host->name().latin1().data());
+            host->setIsMultiplexed(true);
+            m_multiplexedHostNames.add(host->name());
+        }
+    }
 #if PLATFORM(IOS)
     // ResourceLoader::url() doesn't start returning the correct value until the load starts. If we get canceled before that, we need to look for originalRequest url instead.
     // FIXME: ResourceLoader::url() should be made to return a sensible value at all times.
@@ -203,6 +226,26 @@ void WebResourceLoadScheduler::setDefersLoading(ResourceLoader*, bool)
 {
 }
 
+void WebResourceLoadScheduler::setResourceLoadPriority(ResourceLoader* resourceLoader, ResourceLoadPriority priority)
+{
+#if PLATFORM(IOS)
+    HostInformation* host = hostForURL(resourceLoader->iOSOriginalRequest().url());
+#else
+    HostInformation* host = hostForURL(resourceLoader->url());
+#endif
+    if (!host)
+        return;
+
+    // Loads in flight already passed the new priority on to the network layer through their handle.
+    if (!host->reschedule(resourceLoader, priority))
+        return;
+
+    LOG(ResourceLoading, "WebResourceLoadScheduler::setResourceLoadPriority rescheduled '%s' with priority %u", resourceLoader->url().string().latin1().data(), static_cast<unsigned>(priority));
+
+    // This can be called while painting, so serve the load once it is safe to start it.
+    scheduleServePendingRequests();
+}
+
 void WebResourceLoadScheduler::crossOriginRedirectReceived(ResourceLoader* resourceLoader, const URL& redirectURL)
 {
     HostInformation* oldHost = hostForURL(resourceLoader->url());
@@ -260,6 +303,7 @@ void WebResourceLoadScheduler::servePendingRequests(HostInformation* host, Resou
 
             requestsPending.removeFirst();
             host->addLoadInProgress(resourceLoader.get());
+            didStartLoad(resourceLoader.get());
 #if PLATFORM(IOS)
             if (!IOSApplication::isWebProcess()) {
                 resourceLoader->startLoading();
@@ -302,9 +346,43 @@ void WebResourceLoadScheduler::requestTimerFired()
     servePendingRequests();
 }
 
-WebResourceLoadScheduler::HostInformation::HostInformation(const String& name, unsigned maxRequestsInFlight)
+void WebResourceLoadScheduler::didStartLoad(ResourceLoader* resourceLoader)
+{
+    auto it = m_loadTimings.find(resourceLoader);
+    if (it != m_loadTimings.end())
+        it->value.startTime = monotonicallyIncreasingTime();
+}
+
+void WebResourceLoadScheduler::recordLoadPhaseTimes(ResourceLoader* resourceLoader)
+{
+    auto loadTiming = m_loadTimings.take(resourceLoader);
+    if (!loadTiming.startTime || resourceLoader->response().isNull())
+        return;
+
+    double queuedTime = loadTiming.startTime - loadTiming.scheduledTime;
+    double networkTime = monotonicallyIncreasingTime() - loadTiming.startTime;
+
+    ResourceLoadPriority priority = resourceLoader->request().priority();
+    m_loadPhaseTimes[static_cast<unsigned>(priority)].addLoad(queuedTime, networkTime, resourceLoader->response());
+
+    LOG(ResourceLoading, "WebResourceLoadScheduler: '%s' (priority %u) queued %.1fms, on the network %.1fms", resourceLoader->url().string().latin1().data(),
+        static_cast<unsigned>(priority), queuedTime * 1000, networkTime * 1000);
+}
+
+ResourceLoadPhaseTimes WebResourceLoadScheduler::loadPhaseTimes(ResourceLoadPriority priority)
+{
+    return m_loadPhaseTimes[static_cast<unsigned>(priority)];
+}
+
+void WebResourceLoadScheduler::resetLoadPhaseTimes()
+{
+    m_loadPhaseTimes.fill(ResourceLoadPhaseTimes());
+}
+
+WebResourceLoadScheduler::HostInformation::HostInformation(const String& name, unsigned maxRequestsInFlight, bool isMultiplexed)
     : m_name(name)
     , m_maxRequestsInFlight(maxRequestsInFlight)
+    , m_isMultiplexed(isMultiplexed)
 {
 }
 
@@ -336,6 +414,24 @@ void WebResourceLoadScheduler::HostInformation::schedule(ResourceLoader* resourc
     m_requestsPending[priorityToIndex(priority)].append(resourceLoader);
 }
     
+bool WebResourceLoadScheduler::HostInformation::reschedule(ResourceLoader* resourceLoader, ResourceLoadPriority priority)
+{
+    if (m_requestsLoading.contains(resourceLoader))
+        return false;
+
+    for (auto& requestQueue : m_requestsPending) {
+        for (auto it = requestQueue.begin(), end = requestQueue.end(); it != end; ++it) {
+            if (*it == resourceLoader) {
+                RefPtr<ResourceLoader> protectedResourceLoader = WTFMove(*it);
+                requestQueue.remove(it);
+                m_requestsPending[priorityToIndex(priority)].append(WTFMove(protectedResourceLoader));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void WebResourceLoadScheduler::HostInformation::addLoadInProgress(ResourceLoader* resourceLoader)
 {
     LOG(ResourceLoading, "HostInformation '%s' loading '%s'. Current count %d", m_name.latin1().data(), resourceLoader->url().string().latin1().data(), m_requestsLoading.size());
@@ -372,7 +468,24 @@ bool WebResourceLoadScheduler::HostInformation::limitRequests(ResourceLoadPriori
 {
     if (priority == ResourceLoadPriority::VeryLow && !m_requestsLoading.isEmpty())
         return true;
-    return m_requestsLoading.size() >= (webResourceLoadScheduler().isSerialLoadingEnabled() ? 1 : m_maxRequestsInFlight);
+    if (webResourceLoadScheduler().isSerialLoadingEnabled())
+        return m_requestsLoading.size() >= 1;
+
+    unsigned maxRequestsInFlight = m_isMultiplexed ? maxRequestsInFlightPerMultiplexedHost : m_maxRequestsInFlight;
+    if (m_requestsLoading.size() >= maxRequestsInFlight)
+        return true;
+    if (isRenderBlocking(priority) || m_name.isNull())
+        return false;
+
+    if (!m_isMultiplexed)
+        return maxRequestsInFlight > 1 && m_requestsLoading.size() >= maxRequestsInFlight - 1;
+
+    unsigned renderBlockingRequestCount = 0;
+    for (auto& resourceLoader : m_requestsLoading) {
+        if (isRenderBlocking(resourceLoader->request().priority()))
+            ++renderBlockingRequestCount;
+    }
+    return renderBlockingRequestCount && m_requestsLoading.size() - renderBlockingRequestCount >= maxRequestsInFlightBehindRenderBlockingLoads;
 }
 
 void WebResourceLoadScheduler::createPingHandle(NetworkingContext* networkingContext, ResourceRequest& request, bool shouldUseCredentialStorage)
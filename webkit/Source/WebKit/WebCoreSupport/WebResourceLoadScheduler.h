@@ -49,6 +49,7 @@ public:
     void loadResourceSynchronously(WebCore::NetworkingContext*, unsigned long, const WebCore::ResourceRequest&, WebCore::StoredCredentials, WebCore::ClientCredentialPolicy, WebCore::ResourceError&, WebCore::ResourceResponse&, Vector<char>&) override;
     void remove(WebCore::ResourceLoader*) override;
     void setDefersLoading(WebCore::ResourceLoader*, bool) override;
+    void setResourceLoadPriority(WebCore::ResourceLoader*, WebCore::ResourceLoadPriority) override;
     void crossOriginRedirectReceived(WebCore::ResourceLoader*, const WebCore::URL& redirectURL) override;
     
     void servePendingRequests(WebCore::ResourceLoadPriority minimumPriority = WebCore::ResourceLoadPriority::VeryLow) override;
@@ -57,6 +58,9 @@ public:
 
     void createPingHandle(WebCore::NetworkingContext*, WebCore::ResourceRequest&, bool shouldUseCredentialStorage) override;
 
+    WebCore::ResourceLoadPhaseTimes loadPhaseTimes(WebCore::ResourceLoadPriority) override;
+    void resetLoadPhaseTimes() override;
+
     bool isSerialLoadingEnabled() const { return m_isSerialLoadingEnabled; }
     void setSerialLoadingEnabled(bool b) { m_isSerialLoadingEnabled = b; }
 
@@ -69,22 +73,29 @@ private:
     void scheduleLoad(WebCore::ResourceLoader*);
     void scheduleServePendingRequests();
     void requestTimerFired();
+    void didStartLoad(WebCore::ResourceLoader*);
+    void recordLoadPhaseTimes(WebCore::ResourceLoader*);
 
     bool isSuspendingPendingRequests() const { return !!m_suspendPendingRequestsCount; }
 
     class HostInformation {
         WTF_MAKE_NONCOPYABLE(HostInformation); WTF_MAKE_FAST_ALLOCATED;
     public:
-        HostInformation(const String&, unsigned);
+        HostInformation(const String&, unsigned, bool isMultiplexed = false);
         ~HostInformation();
         
         const String& name() const { return m_name; }
         void schedule(WebCore::ResourceLoader*, WebCore::ResourceLoadPriority = WebCore::ResourceLoadPriority::VeryLow);
+        bool reschedule(WebCore::ResourceLoader*, WebCore::ResourceLoadPriority);
         void addLoadInProgress(WebCore::ResourceLoader*);
         void remove(WebCore::ResourceLoader*);
         bool hasRequests() const;
         bool limitRequests(WebCore::ResourceLoadPriority) const;
 
+        // HTTP/2 hosts serve all requests on one connection, so the connection count stops being the limit.
+        bool isMultiplexed() const { return m_isMultiplexed; }
+        void setIsMultiplexed(bool isMultiplexed) { m_isMultiplexed = isMultiplexed; }
+
         typedef Deque<RefPtr<WebCore::ResourceLoader>> RequestQueue;
         RequestQueue& requestsPending(WebCore::ResourceLoadPriority priority) { return m_requestsPending[priorityToIndex(priority)]; }
 
@@ -96,6 +107,7 @@ private:
         RequestMap m_requestsLoading;
         const String m_name;
         const unsigned m_maxRequestsInFlight;
+        bool m_isMultiplexed;
     };
 
     enum CreateHostPolicy {
@@ -109,6 +121,14 @@ private:
     typedef HashMap<String, HostInformation*, StringHash> HostMap;
     HostMap m_hosts;
     HostInformation* m_nonHTTPProtocolHost;
+    HashSet<String> m_multiplexedHostNames;
+
+    struct LoadTiming {
+        double scheduledTime { 0 };
+        double startTime { 0 };
+    };
+    HashMap<WebCore::ResourceLoader*, LoadTiming> m_loadTimings;
+    std::array<WebCore::ResourceLoadPhaseTimes, WebCore::resourceLoadPriorityCount> m_loadPhaseTimes;
         
     WebCore::Timer m_requestTimer;
 
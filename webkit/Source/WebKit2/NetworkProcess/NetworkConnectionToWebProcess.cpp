@@ -27,6 +27,7 @@
 #include "NetworkConnectionToWebProcess.h"
 
 #include "BlobDataFileReferenceWithSandboxExtension.h"
+#include "Logging.h"
 #include "NetworkBlobRegistry.h"
 #include "NetworkConnectionToWebProcessMessages.h"
 #include "NetworkLoad.h"
@@ -43,6 +44,7 @@
 #include <WebCore/PlatformCookieJar.h>
 #include <WebCore/ResourceLoaderOptions.h>
 #include <WebCore/ResourceRequest.h>
+#include <WebCore/ResourceResponse.h>
 #include <WebCore/SessionID.h>
 #include <wtf/RunLoop.h>
 
@@ -171,6 +173,39 @@ void NetworkConnectionToWebProcess::setDefersLoading(ResourceLoadIdentifier iden
     loader->setDefersLoading(defers);
 }
 
+void NetworkConnectionToWebProcess::setResourceLoadPriority(ResourceLoadIdentifier identifier, uint8_t priority)
+{
+    if (priority > static_cast<uint8_t>(ResourceLoadPriority::Highest))
+        return;
+
+    RefPtr<NetworkResourceLoader> loader = m_networkResourceLoaders.get(identifier);
+    if (!loader)
+        return;
+
+    loader->setPriority(static_cast<ResourceLoadPriority>(priority));
+}
+
+void NetworkConnectionToWebProcess::didFinishNetworkLoad(ResourceLoadPriority priority, double queuedTime, double networkTime, const ResourceResponse& response)
+{
+    m_loadPhaseTimes[static_cast<unsigned>(priority)].addLoad(queuedTime, networkTime, response);
+
+    LOG(Network, "(NetworkProcess) '%s' (priority %u) queued %.1fms, on the network %.1fms", response.url().string().latin1().data(),
+        static_cast<unsigned>(priority), queuedTime * 1000, networkTime * 1000);
+}
+
+void NetworkConnectionToWebProcess::getLoadPhaseTimes(uint8_t priority, ResourceLoadPhaseTimes& times)
+{
+    if (priority > static_cast<uint8_t>(ResourceLoadPriority::Highest))
+        return;
+
+    times = m_loadPhaseTimes[priority];
+}
+
+void NetworkConnectionToWebProcess::resetLoadPhaseTimes()
+{
+    m_loadPhaseTimes.fill(ResourceLoadPhaseTimes());
+}
+
 void NetworkConnectionToWebProcess::prefetchDNS(const String& hostname)
 {
     NetworkProcess::singleton().prefetchDNS(hostname);
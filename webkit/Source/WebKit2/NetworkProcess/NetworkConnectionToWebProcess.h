@@ -29,13 +29,16 @@
 #include "Connection.h"
 #include "DownloadID.h"
 #include "NetworkConnectionToWebProcessMessages.h"
+#include <WebCore/ResourceLoadPhaseTimes.h>
 #include <WebCore/ResourceLoadPriority.h>
+#include <array>
 #include <wtf/HashSet.h>
 #include <wtf/RefCounted.h>
 
 namespace WebCore {
 class BlobDataFileReference;
 class ResourceRequest;
+class ResourceResponse;
 }
 
 namespace WebKit {
@@ -56,6 +59,9 @@ public:
 
     RefPtr<WebCore::BlobDataFileReference> getBlobDataFileReferenceForPath(const String& path);
 
+    // Called by the loaders of this connection when a load from the network finished.
+    void didFinishNetworkLoad(WebCore::ResourceLoadPriority, double queuedTime, double networkTime, const WebCore::ResourceResponse&);
+
 private:
     NetworkConnectionToWebProcess(IPC::Connection::Identifier);
 
@@ -78,6 +84,9 @@ private:
 
     void removeLoadIdentifier(ResourceLoadIdentifier);
     void setDefersLoading(ResourceLoadIdentifier, bool);
+    void setResourceLoadPriority(ResourceLoadIdentifier, uint8_t priority);
+    void getLoadPhaseTimes(uint8_t priority, WebCore::ResourceLoadPhaseTimes&);
+    void resetLoadPhaseTimes();
     void crossOriginRedirectReceived(ResourceLoadIdentifier, const WebCore::URL& redirectURL);
     void startDownload(WebCore::SessionID, DownloadID, const WebCore::ResourceRequest&, const String& suggestedName = { });
     void convertMainResourceLoadToDownload(WebCore::SessionID, uint64_t mainResourceLoadIdentifier, DownloadID, const WebCore::ResourceRequest&, const WebCore::ResourceResponse&);
@@ -106,6 +115,8 @@ private:
 
     HashMap<ResourceLoadIdentifier, RefPtr<NetworkResourceLoader>> m_networkResourceLoaders;
     HashMap<String, RefPtr<WebCore::BlobDataFileReference>> m_blobDataFileReferences;
+
+    std::array<WebCore::ResourceLoadPhaseTimes, WebCore::resourceLoadPriorityCount> m_loadPhaseTimes;
 };
 
 } // namespace WebKit
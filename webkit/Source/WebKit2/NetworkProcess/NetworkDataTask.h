@@ -93,6 +93,7 @@ public:
     void suspend();
     void cancel();
     void resume();
+    void setPriority(WebCore::ResourceLoadPriority);
     
     typedef uint64_t TaskIdentifier;
     
@@ -102,6 +102,17 @@ void NetworkLoad::setDefersLoading(bool defers)
         m_handle->setDefersLoading(defers);
 }
 
+void NetworkLoad::setPriority(ResourceLoadPriority priority)
+{
+    m_currentRequest.setPriority(priority);
+#if USE(NETWORK_SESSION)
+    if (m_task)
+        m_task->setPriority(priority);
+#endif
+    if (m_handle)
+        m_handle->setPriority(priority);
+}
+
 void NetworkLoad::cancel()
 {
 #if USE(NETWORK_SESSION)
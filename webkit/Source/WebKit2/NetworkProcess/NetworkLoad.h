@@ -55,6 +55,7 @@ public:
     ~NetworkLoad();
 
     void setDefersLoading(bool);
+    void setPriority(WebCore::ResourceLoadPriority);
     void cancel();
 
     const WebCore::ResourceRequest& currentRequest() const { return m_currentRequest; }
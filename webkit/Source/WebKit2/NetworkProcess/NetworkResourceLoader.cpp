@@ -72,8 +72,13 @@ static void sendReplyToSynchronousRequest(NetworkResourceLoader::SynchronousLoad
     ASSERT(!data.response.isNull() || !data.error.isNull());
 
     Vector<char> responseBuffer;
-    if (buffer && buffer->size())
-        responseBuffer.append(buffer->data(), buffer->size());
+    if (buffer && buffer->size()) {
+        responseBuffer.reserveInitialCapacity(buffer->size());
+        buffer->forEachSegment([&responseBuffer](const char* segment, unsigned length) {
+            responseBuffer.append(segment, length);
+            return true;
+        });
+    }
 
     data.delayedReply->send(data.error, data.response, responseBuffer);
     data.delayedReply = nullptr;
@@ -83,6 +88,8 @@ NetworkResourceLoader::NetworkResourceLoader(const NetworkResourceLoadParameters
     : m_parameters(parameters)
     , m_connection(connection)
     , m_defersLoading(parameters.defersLoading)
+    , m_priority(parameters.request.priority())
+    , m_scheduledTime(monotonicallyIncreasingTime())
     , m_bufferingTimer(*this, &NetworkResourceLoader::bufferingTimerFired)
 {
     ASSERT(RunLoop::isMain());
@@ -208,9 +215,12 @@ void NetworkResourceLoader::startNetworkLoad(const ResourceRequest& request)
 
     NETWORKRESOURCELOADER_LOG_ALWAYS("Starting network resource load: loader = %p, pageID = %llu, frameID = %llu, isMainResource = %d, isSynchronous = %d", this, m_parameters.webPageID, m_parameters.webFrameID, isMainResource(), isSynchronous());
 
+    m_networkLoadStartTime = monotonicallyIncreasingTime();
+
     NetworkLoadParameters parameters = m_parameters;
     parameters.defersLoading = m_defersLoading;
     parameters.request = request;
+    parameters.request.setPriority(m_priority);
 
 #if USE(NETWORK_SESSION)
     auto* networkSession = SessionTracker::networkSession(parameters.sessionID);
@@ -240,6 +250,17 @@ void NetworkResourceLoader::setDefersLoading(bool defers)
         start();
 }
 
+void NetworkResourceLoader::setPriority(ResourceLoadPriority priority)
+{
+    if (m_priority == priority)
+        return;
+    m_priority = priority;
+
+    // Loads that have not reached the network yet pick the new priority up in startNetworkLoad().
+    if (m_networkLoad)
+        m_networkLoad->setPriority(priority);
+}
+
 void NetworkResourceLoader::cleanup()
 {
     ASSERT(RunLoop::isMain());
@@ -376,6 +397,9 @@ void NetworkResourceLoader::didFinishLoading(double finishTime)
 {
     NETWORKRESOURCELOADER_LOG_ALWAYS("Finished loading network resource: loader = %p, pageID = %llu, frameID = %llu, isMainResource = %d, isSynchronous = %d", this, static_cast<unsigned long long>(m_parameters.webPageID), static_cast<unsigned long long>(m_parameters.webFrameID), isMainResource(), isSynchronous());
 
+    // The time before the network load started includes looking the resource up in the disk cache.
+    m_connection->didFinishNetworkLoad(m_priority, m_networkLoadStartTime - m_scheduledTime, monotonicallyIncreasingTime() - m_networkLoadStartTime, m_response);
+
 #if ENABLE(NETWORK_CACHE)
     if (m_cacheEntryForValidation) {
         // 304 Not Modified
@@ -65,6 +65,7 @@ public:
     void abort();
 
     void setDefersLoading(bool);
+    void setPriority(WebCore::ResourceLoadPriority);
 
     // Message handlers.
     void didReceiveNetworkResourceLoaderMessage(IPC::Connection&, IPC::MessageDecoder&);
@@ -156,6 +157,9 @@ private:
     bool m_didConvertToDownload { false };
     bool m_didConsumeSandboxExtensions { false };
     bool m_defersLoading { false };
+    WebCore::ResourceLoadPriority m_priority;
+    double m_scheduledTime;
+    double m_networkLoadStartTime { 0 };
 
     WebCore::Timer m_bufferingTimer;
 #if ENABLE(NETWORK_CACHE)
@@ -74,7 +74,7 @@ static void dumpFileChanged(Cache* cache)
 
 bool Cache::initialize(const String& cachePath, const Parameters& parameters)
 {
-    m_storage = Storage::open(cachePath);
+    m_storage = Storage::open(cachePath, parameters.enableSegmentedStorage ? Storage::Layout::SegmentFiles : Storage::Layout::RecordFiles);
 
 #if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
     if (parameters.enableNetworkCacheSpeculativeRevalidation)
@@ -257,6 +257,32 @@ static bool isMediaMIMEType(const String& mimeType)
     return false;
 }
 
+static bool isCompressibleMIMEType(const String& mimeType)
+{
+    if (mimeType.startsWith("text/", /*caseSensitive*/ false))
+        return true;
+    // Covers image/svg+xml too.
+    if (mimeType.endsWith("+xml", /*caseSensitive*/ false) || mimeType.endsWith("+json", /*caseSensitive*/ false))
+        return true;
+    return equalLettersIgnoringASCIICase(mimeType, "application/javascript")
+        || equalLettersIgnoringASCIICase(mimeType, "application/x-javascript")
+        || equalLettersIgnoringASCIICase(mimeType, "application/ecmascript")
+        || equalLettersIgnoringASCIICase(mimeType, "application/json")
+        || equalLettersIgnoringASCIICase(mimeType, "application/xml");
+}
+
+static Storage::BodyCompression makeBodyCompressionDecision(const WebCore::ResourceResponse& response, const WebCore::SharedBuffer* buffer)
+{
+    // Small bodies don't save enough disk space to be worth inflating on every read.
+    const size_t minimumCompressibleBodySize = 1024;
+    if (!buffer || buffer->size() < minimumCompressibleBodySize)
+        return Storage::BodyCompression::None;
+    // Images, media and fonts are typically compressed already.
+    if (!isCompressibleMIMEType(response.mimeType()))
+        return Storage::BodyCompression::None;
+    return Storage::BodyCompression::Deflate;
+}
+
 static StoreDecision makeStoreDecision(const WebCore::ResourceRequest& originalRequest, const WebCore::ResourceResponse& response)
 {
     if (!originalRequest.url().protocolIsInHTTPFamily() || !response.isHTTP())
@@ -406,6 +432,7 @@ std::unique_ptr<Entry> Cache::store(const WebCore::ResourceRequest& request, con
         return nullptr;
     }
 
+    auto bodyCompression = makeBodyCompressionDecision(response, responseData.get());
     auto cacheEntry = std::make_unique<Entry>(makeCacheKey(request), response, WTFMove(responseData), WebCore::collectVaryingRequestHeaders(request, response));
     auto record = cacheEntry->encodeAsStorageRecord();
 
@@ -420,7 +447,7 @@ std::unique_ptr<Entry> Cache::store(const WebCore::ResourceRequest& request, con
 #endif
         completionHandler(mappedBody);
         LOG(NetworkCache, "(NetworkProcess) stored");
-    });
+    }, bodyCompression);
 
     return cacheEntry;
 }
@@ -460,7 +487,7 @@ std::unique_ptr<Entry> Cache::update(const WebCore::ResourceRequest& originalReq
     auto updateEntry = std::make_unique<Entry>(existingEntry.key(), response, existingEntry.buffer(), WebCore::collectVaryingRequestHeaders(originalRequest, response));
     auto updateRecord = updateEntry->encodeAsStorageRecord();
 
-    m_storage->store(updateRecord, { });
+    m_storage->store(updateRecord, { }, makeBodyCompressionDecision(response, existingEntry.buffer()));
 
     if (m_statistics)
         m_statistics->recordRevalidationSuccess(frameID.first, existingEntry.key(), originalRequest);
@@ -98,6 +98,7 @@ public:
 #if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
         bool enableNetworkCacheSpeculativeRevalidation;
 #endif
+        bool enableSegmentedStorage;
     };
     bool initialize(const String& cachePath, const Parameters&);
     void setCapacity(size_t);
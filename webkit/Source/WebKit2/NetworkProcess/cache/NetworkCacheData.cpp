@@ -32,6 +32,10 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 
+#if ENABLE(NETWORK_CACHE_BODY_COMPRESSION)
+#include <zlib.h>
+#endif
+
 namespace WebKit {
 namespace NetworkCache {
 
@@ -124,6 +128,84 @@ bool bytesEqual(const Data& a, const Data& b)
     return !memcmp(a.data(), b.data(), a.size());
 }
 
+#if ENABLE(NETWORK_CACHE_BODY_COMPRESSION)
+Data compressData(const Data& data)
+{
+    if (data.isNull() || data.size() > std::numeric_limits<uInt>::max())
+        return { };
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // Negative window bits produce a raw deflate stream without the zlib header and adler32 trailer.
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return { };
+
+    size_t capacity = deflateBound(&stream, data.size());
+    uint8_t* buffer = static_cast<uint8_t*>(fastMalloc(capacity));
+    stream.next_out = buffer;
+    stream.avail_out = capacity;
+
+    bool success = true;
+    data.apply([&stream, &success](const uint8_t* bytes, size_t bytesSize) {
+        stream.next_in = const_cast<uint8_t*>(bytes);
+        stream.avail_in = bytesSize;
+        // The output buffer is sized by deflateBound so the input is always consumed.
+        if (deflate(&stream, Z_NO_FLUSH) != Z_OK || stream.avail_in) {
+            success = false;
+            return false;
+        }
+        return true;
+    });
+    if (success) {
+        stream.avail_in = 0;
+        success = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+    }
+    size_t compressedSize = stream.total_out;
+    deflateEnd(&stream);
+
+    if (!success) {
+        fastFree(buffer);
+        return { };
+    }
+    buffer = static_cast<uint8_t*>(fastRealloc(buffer, compressedSize));
+    return Data::adoptMalloc(buffer, compressedSize);
+}
+
+Data decompressData(const Data& data, size_t decompressedSize)
+{
+    if (data.isNull() || decompressedSize > std::numeric_limits<uInt>::max())
+        return { };
+    if (!decompressedSize)
+        return Data::empty();
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return { };
+
+    // The size is known from the record meta data so the output can be inflated in place, one input chunk at a time.
+    uint8_t* buffer = static_cast<uint8_t*>(fastMalloc(decompressedSize));
+    stream.next_out = buffer;
+    stream.avail_out = decompressedSize;
+
+    int result = Z_OK;
+    data.apply([&stream, &result](const uint8_t* bytes, size_t bytesSize) {
+        stream.next_in = const_cast<uint8_t*>(bytes);
+        stream.avail_in = bytesSize;
+        result = inflate(&stream, Z_NO_FLUSH);
+        return result == Z_OK;
+    });
+    bool success = result == Z_STREAM_END && stream.total_out == decompressedSize;
+    inflateEnd(&stream);
+
+    if (!success) {
+        fastFree(buffer);
+        return { };
+    }
+    return Data::adoptMalloc(buffer, decompressedSize);
+}
+#endif
+
 } // namespace NetworkCache
 } // namespace WebKit
 
@@ -108,6 +108,8 @@ public:
 
     static Data empty();
     static Data adoptMap(void* map, size_t, int fd);
+    // Takes ownership of a fastMalloc'ed buffer.
+    static Data adoptMalloc(uint8_t*, size_t);
 
 #if PLATFORM(COCOA)
     enum class Backing { Buffer, Map };
@@ -156,6 +158,12 @@ Data adoptAndMapFile(int fd, size_t offset, size_t);
 Data mapFile(const char* path);
 SHA1::Digest computeSHA1(const Data&);
 
+#if ENABLE(NETWORK_CACHE_BODY_COMPRESSION)
+// Raw deflate streams. The integrity of the stored bytes is checked separately with SHA1.
+Data compressData(const Data&);
+Data decompressData(const Data&, size_t decompressedSize);
+#endif
+
 }
 }
 
@@ -49,6 +49,13 @@ Data::Data(DispatchPtr<dispatch_data_t> dispatchData, Backing backing)
 {
 }
 
+Data Data::adoptMalloc(uint8_t* data, size_t size)
+{
+    return { adoptDispatch(dispatch_data_create(data, size, nullptr, ^{
+        fastFree(data);
+    })) };
+}
+
 Data Data::empty()
 {
     return { DispatchPtr<dispatch_data_t>(dispatch_data_empty) };
@@ -54,6 +54,12 @@ Data::Data(GRefPtr<SoupBuffer>&& buffer, int fd)
 {
 }
 
+Data Data::adoptMalloc(uint8_t* data, size_t size)
+{
+    GRefPtr<SoupBuffer> buffer = adoptGRef(soup_buffer_new_with_owner(data, size, data, fastFree));
+    return { WTFMove(buffer) };
+}
+
 Data Data::empty()
 {
     GRefPtr<SoupBuffer> buffer = adoptGRef(soup_buffer_new(SOUP_MEMORY_TAKE, nullptr, 0));
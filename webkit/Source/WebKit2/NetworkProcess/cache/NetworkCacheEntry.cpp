@@ -101,7 +101,7 @@ Storage::Record Entry::encodeAsStorageRecord() const
     Data header(encoder.buffer(), encoder.bufferSize());
     Data body;
     if (m_buffer)
-        body = { reinterpret_cast<const uint8_t*>(m_buffer->data()), m_buffer->size() };
+        body = { reinterpret_cast<const uint8_t*>(m_buffer->flattenedData()), m_buffer->size() };
 
     return { m_key, m_timeStamp, header, body };
 }
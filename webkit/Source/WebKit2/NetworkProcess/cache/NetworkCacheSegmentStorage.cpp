@@ -0,0 +1,620 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "NetworkCacheSegmentStorage.h"
+
+#if ENABLE(NETWORK_CACHE)
+
+#include "Logging.h"
+#include "NetworkCacheCoders.h"
+#include "NetworkCacheFileSystem.h"
+#include <WebCore/FileSystem.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wtf/RunLoop.h>
+#include <wtf/text/CString.h>
+
+namespace WebKit {
+namespace NetworkCache {
+
+static const char segmentFilePrefix[] = "segment-";
+static const char indexFileName[] = "index";
+static const char newIndexFileName[] = "index.new";
+static const unsigned indexVersion = 1;
+
+// Records are at most a few tens of kilobytes since larger bodies are stored as blobs.
+static const uint32_t maximumSegmentSize = 4 * 1024 * 1024;
+
+// Each record is preceded by a frame header so segments can be scanned without the index.
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t size;
+    Key::HashType hash;
+};
+static const uint32_t frameMagic = 0x4e435347;
+
+static size_t frameSize(uint32_t recordSize)
+{
+    return sizeof(FrameHeader) + recordSize;
+}
+
+static bool writeAt(int fd, const uint8_t* data, size_t size, off_t offset)
+{
+    while (size) {
+        ssize_t written = pwrite(fd, data, size, offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
+
+SegmentStorage::SegmentStorage(const String& segmentDirectoryPath)
+    : m_segmentDirectoryPath(segmentDirectoryPath)
+{
+}
+
+SegmentStorage::~SegmentStorage()
+{
+    for (auto& segment : m_segments.values())
+        close(segment->fileDescriptor);
+}
+
+String SegmentStorage::segmentDirectoryPath() const
+{
+    return m_segmentDirectoryPath.isolatedCopy();
+}
+
+String SegmentStorage::segmentPath(unsigned number) const
+{
+    return WebCore::pathByAppendingComponent(segmentDirectoryPath(), segmentFilePrefix + String::number(number));
+}
+
+String SegmentStorage::indexPath() const
+{
+    return WebCore::pathByAppendingComponent(segmentDirectoryPath(), indexFileName);
+}
+
+SegmentStorage::Segment* SegmentStorage::openSegmentLocked(unsigned number, bool create)
+{
+    ASSERT(number);
+    auto& slot = m_segments.add(number, nullptr).iterator->value;
+    if (slot)
+        return slot.get();
+
+    auto path = WebCore::fileSystemRepresentation(segmentPath(number));
+    int fd = open(path.data(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, S_IRUSR | S_IWUSR);
+    struct stat stat;
+    if (fd < 0 || fstat(fd, &stat) < 0 || stat.st_size > std::numeric_limits<uint32_t>::max()) {
+        if (fd >= 0)
+            close(fd);
+        m_segments.remove(number);
+        return nullptr;
+    }
+
+    slot = std::make_unique<Segment>();
+    slot->fileDescriptor = fd;
+    slot->size = stat.st_size;
+    return slot.get();
+}
+
+Data SegmentStorage::mapLocked(unsigned number, size_t minimumSize)
+{
+    auto* segment = m_segments.get(number);
+    if (!segment)
+        return { };
+    // The segment being appended to grows after it was mapped, map it again to see the new records.
+    if (segment->map.isNull() || segment->map.size() < minimumSize)
+        segment->map = mapFile(WebCore::fileSystemRepresentation(segmentPath(number)).data());
+    return segment->map;
+}
+
+void SegmentStorage::deleteSegmentLocked(unsigned number)
+{
+    auto segment = m_segments.take(number);
+    if (!segment)
+        return;
+    // Records handed out earlier stay readable, they keep their own mapping of the file.
+    close(segment->fileDescriptor);
+    WebCore::deleteFile(segmentPath(number));
+}
+
+void SegmentStorage::markDeadLocked(const Location& location)
+{
+    if (auto* segment = m_segments.get(location.segment))
+        segment->deadSize += frameSize(location.size);
+    m_approximateSize -= frameSize(location.size);
+}
+
+bool SegmentStorage::readIndex(HashMap<unsigned, uint32_t>& indexedSegmentSizes)
+{
+    auto indexData = mapFile(WebCore::fileSystemRepresentation(indexPath()).data());
+    if (indexData.isNull() || indexData.isEmpty())
+        return false;
+
+    Decoder decoder(indexData.data(), indexData.size());
+    unsigned version;
+    if (!decoder.decode(version) || version != indexVersion)
+        return false;
+
+    uint64_t segmentCount;
+    if (!decoder.decode(segmentCount))
+        return false;
+    for (uint64_t i = 0; i < segmentCount; ++i) {
+        unsigned number;
+        uint32_t size;
+        if (!decoder.decode(number) || !decoder.decode(size) || !number)
+            return false;
+        indexedSegmentSizes.set(number, size);
+    }
+
+    uint64_t entryCount;
+    if (!decoder.decode(entryCount))
+        return false;
+    for (uint64_t i = 0; i < entryCount; ++i) {
+        Key::HashType hash;
+        Location location;
+        std::chrono::milliseconds creation;
+        std::chrono::milliseconds access;
+        if (!decoder.decode(hash) || !decoder.decode(location.segment) || !decoder.decode(location.offset) || !decoder.decode(location.size))
+            return false;
+        if (!decoder.decode(creation) || !decoder.decode(access))
+            return false;
+        location.creation = std::chrono::system_clock::time_point(creation);
+        location.access = std::chrono::system_clock::time_point(access);
+        m_index.set(hash, location);
+    }
+
+    return decoder.verifyChecksum();
+}
+
+void SegmentStorage::recoverSegmentTail(unsigned number, uint32_t indexedSize)
+{
+    auto* segment = openSegmentLocked(number, false);
+    if (!segment || segment->size <= indexedSize)
+        return;
+
+    // Records appended after the index was last written, or after a crash.
+    auto map = mapLocked(number, segment->size);
+    if (map.size() < segment->size)
+        return;
+
+    auto now = std::chrono::system_clock::now();
+    uint32_t offset = indexedSize;
+    while (segment->size - offset >= sizeof(FrameHeader)) {
+        FrameHeader header;
+        memcpy(&header, map.data() + offset, sizeof(header));
+        if (header.magic != frameMagic || header.size > segment->size - offset - sizeof(FrameHeader))
+            break;
+        m_index.set(header.hash, Location { number, offset, header.size, now, now });
+        offset += frameSize(header.size);
+        m_indexIsDirty = true;
+    }
+
+    if (offset == segment->size)
+        return;
+
+    // Drop a partially written record at the end.
+    if (!ftruncate(segment->fileDescriptor, offset)) {
+        segment->size = offset;
+        segment->map = { };
+    }
+}
+
+void SegmentStorage::synchronize()
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    // Once loaded, the index in memory is authoritative.
+    if (m_hasSynchronized)
+        return;
+    m_hasSynchronized = true;
+
+    auto directoryPath = segmentDirectoryPath();
+    WebCore::makeAllDirectories(directoryPath);
+
+    HashMap<unsigned, uint32_t> indexedSegmentSizes;
+    if (!readIndex(indexedSegmentSizes)) {
+        m_index.clear();
+        indexedSegmentSizes.clear();
+    }
+
+    Vector<unsigned> segmentNumbers;
+    traverseDirectory(directoryPath, [&segmentNumbers](const String& fileName, DirectoryEntryType type) {
+        if (type != DirectoryEntryType::File || !fileName.startsWith(segmentFilePrefix))
+            return;
+        bool success;
+        unsigned number = fileName.substring(strlen(segmentFilePrefix)).toUIntStrict(&success);
+        if (success && number)
+            segmentNumbers.append(number);
+    });
+    std::sort(segmentNumbers.begin(), segmentNumbers.end());
+
+    for (auto number : segmentNumbers)
+        recoverSegmentTail(number, indexedSegmentSizes.get(number));
+
+    HashMap<unsigned, uint64_t> liveSizes;
+    Vector<Key::HashType> invalidHashes;
+    for (auto& entry : m_index) {
+        auto* segment = m_segments.get(entry.value.segment);
+        if (!segment || entry.value.offset + frameSize(entry.value.size) > segment->size) {
+            invalidHashes.append(entry.key);
+            continue;
+        }
+        liveSizes.add(entry.value.segment, 0).iterator->value += frameSize(entry.value.size);
+    }
+    for (auto& hash : invalidHashes)
+        m_index.remove(hash);
+    if (!invalidHashes.isEmpty())
+        m_indexIsDirty = true;
+
+    size_t totalSize = 0;
+    Vector<unsigned> emptySegments;
+    for (auto& segment : m_segments) {
+        uint64_t liveSize = liveSizes.get(segment.key);
+        segment.value->deadSize = segment.value->size - liveSize;
+        totalSize += liveSize;
+        if (!liveSize)
+            emptySegments.append(segment.key);
+        m_lastSegment = std::max(m_lastSegment, segment.key);
+    }
+    m_activeSegment = m_lastSegment;
+    for (auto number : emptySegments)
+        deleteSegmentLocked(number);
+    m_approximateSize = totalSize;
+
+    flushIndexLocked();
+
+    LOG(NetworkCacheStorage, "(NetworkProcess) segment synchronization completed approximateSize=%zu count=%u segments=%u", totalSize, m_index.size(), m_segments.size());
+}
+
+bool SegmentStorage::appendLocked(const Key::HashType& hash, const uint8_t* data, size_t size, Location& location)
+{
+    if (size > maximumSegmentSize)
+        return false;
+
+    auto* segment = m_activeSegment ? m_segments.get(m_activeSegment) : nullptr;
+    if (!segment || segment->size + frameSize(size) > maximumSegmentSize) {
+        segment = openSegmentLocked(m_lastSegment + 1, true);
+        if (!segment)
+            return false;
+        m_activeSegment = ++m_lastSegment;
+    }
+
+    FrameHeader header { frameMagic, static_cast<uint32_t>(size), hash };
+    if (!writeAt(segment->fileDescriptor, reinterpret_cast<const uint8_t*>(&header), sizeof(header), segment->size)
+        || !writeAt(segment->fileDescriptor, data, size, segment->size + sizeof(header))) {
+        ftruncate(segment->fileDescriptor, segment->size);
+        return false;
+    }
+
+    location.segment = m_activeSegment;
+    location.offset = segment->size;
+    location.size = size;
+    segment->size += frameSize(size);
+    segment->needsSync = true;
+    return true;
+}
+
+bool SegmentStorage::add(const Key::HashType& hash, const Data& data)
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    Location location;
+    if (!appendLocked(hash, data.data(), data.size(), location))
+        return false;
+    location.creation = location.access = std::chrono::system_clock::now();
+
+    auto addResult = m_index.add(hash, location);
+    if (!addResult.isNewEntry) {
+        markDeadLocked(addResult.iterator->value);
+        addResult.iterator->value = location;
+    }
+    m_approximateSize += frameSize(location.size);
+    m_indexIsDirty = true;
+    return true;
+}
+
+Data SegmentStorage::get(const Key::HashType& hash)
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    auto it = m_index.find(hash);
+    if (it == m_index.end())
+        return { };
+    auto& location = it->value;
+
+    size_t end = location.offset + frameSize(location.size);
+    auto map = mapLocked(location.segment, end);
+    if (map.size() < end)
+        return { };
+
+    FrameHeader header;
+    memcpy(&header, map.data() + location.offset, sizeof(header));
+    if (header.magic != frameMagic || header.size != location.size || header.hash != hash)
+        return { };
+
+    return map.subrange(location.offset + sizeof(FrameHeader), location.size);
+}
+
+void SegmentStorage::remove(const Key::HashType& hash)
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    auto it = m_index.find(hash);
+    if (it == m_index.end())
+        return;
+    markDeadLocked(it->value);
+    m_index.remove(it);
+    m_indexIsDirty = true;
+}
+
+void SegmentStorage::touch(const Key::HashType& hash)
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    auto it = m_index.find(hash);
+    if (it == m_index.end())
+        return;
+    it->value.access = std::chrono::system_clock::now();
+    m_indexIsDirty = true;
+}
+
+void SegmentStorage::clear()
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    Vector<unsigned> segmentNumbers;
+    copyKeysToVector(m_segments, segmentNumbers);
+    for (auto number : segmentNumbers)
+        deleteSegmentLocked(number);
+    m_index.clear();
+    m_approximateSize = 0;
+
+    WebCore::deleteFile(indexPath());
+    m_indexIsDirty = false;
+}
+
+Vector<SegmentStorage::Entry> SegmentStorage::entries()
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+
+    Vector<Entry> entries;
+    entries.reserveInitialCapacity(m_index.size());
+    for (auto& entry : m_index)
+        entries.uncheckedAppend({ entry.key, entry.value.size, entry.value.creation, entry.value.access });
+    return entries;
+}
+
+void SegmentStorage::flushIndex()
+{
+    ASSERT(!RunLoop::isMain());
+
+    std::lock_guard<Lock> lock(m_lock);
+    flushIndexLocked();
+}
+
+void SegmentStorage::flushIndexLocked()
+{
+    if (!m_indexIsDirty)
+        return;
+
+    // The index must never point past what is on disk.
+    for (auto& segment : m_segments.values()) {
+        if (!segment->needsSync)
+            continue;
+        if (fsync(segment->fileDescriptor) < 0)
+            return;
+        segment->needsSync = false;
+    }
+
+    Encoder encoder;
+    encoder << indexVersion;
+    encoder << static_cast<uint64_t>(m_segments.size());
+    for (auto& segment : m_segments) {
+        encoder << segment.key;
+        encoder << segment.value->size;
+    }
+    encoder << static_cast<uint64_t>(m_index.size());
+    for (auto& entry : m_index) {
+        encoder << entry.key;
+        encoder << entry.value.segment;
+        encoder << entry.value.offset;
+        encoder << entry.value.size;
+        encoder << std::chrono::duration_cast<std::chrono::milliseconds>(entry.value.creation.time_since_epoch());
+        encoder << std::chrono::duration_cast<std::chrono::milliseconds>(entry.value.access.time_since_epoch());
+    }
+    encoder.encodeChecksum();
+
+    // Write a new index next to the old one and swap them, so a crash leaves either one intact.
+    auto newIndexPath = WebCore::fileSystemRepresentation(WebCore::pathByAppendingComponent(segmentDirectoryPath(), newIndexFileName));
+    int fd = open(newIndexPath.data(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        return;
+    bool success = writeAt(fd, encoder.buffer(), encoder.bufferSize(), 0) && !fsync(fd);
+    close(fd);
+    if (!success || rename(newIndexPath.data(), WebCore::fileSystemRepresentation(indexPath()).data()) < 0) {
+        unlink(newIndexPath.data());
+        return;
+    }
+
+    m_indexIsDirty = false;
+}
+
+void SegmentStorage::compactIfNeeded()
+{
+    ASSERT(!RunLoop::isMain());
+
+    struct Move {
+        Key::HashType hash;
+        Location from;
+        Location to;
+    };
+    Vector<Move> moves;
+    HashMap<unsigned, Data> segmentsToCompact;
+    {
+        std::lock_guard<Lock> lock(m_lock);
+
+        if (m_isCompacting)
+            return;
+
+        for (auto& segment : m_segments) {
+            if (segment.key == m_activeSegment)
+                continue;
+            if (segment.value->deadSize * 2 > segment.value->size)
+                segmentsToCompact.set(segment.key, mapLocked(segment.key, segment.value->size));
+        }
+        if (segmentsToCompact.isEmpty())
+            return;
+
+        // Only the active segment is appended to, so the live records of the others can be copied without the lock.
+        for (auto& entry : m_index) {
+            if (segmentsToCompact.contains(entry.value.segment))
+                moves.append({ entry.key, entry.value, { } });
+        }
+
+        m_isCompacting = true;
+    }
+
+    // Copy the live records to new segments and make them durable, all without blocking the readers and writers.
+    // A target segment is started whenever the previous one is full, so any number of half dead segments can go at once.
+    struct Target {
+        unsigned number;
+        int fileDescriptor;
+        uint32_t size;
+    };
+    Vector<Target> targets;
+    auto startTarget = [this, &targets] {
+        unsigned number;
+        {
+            std::lock_guard<Lock> lock(m_lock);
+            number = ++m_lastSegment;
+        }
+        int fd = open(WebCore::fileSystemRepresentation(segmentPath(number)).data(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+        if (fd < 0)
+            return false;
+        targets.append({ number, fd, 0 });
+        return true;
+    };
+
+    bool success = true;
+    for (auto& move : moves) {
+        auto map = segmentsToCompact.get(move.from.segment);
+        if (map.size() < move.from.offset + frameSize(move.from.size)) {
+            success = false;
+            break;
+        }
+        if (targets.isEmpty() || targets.last().size + frameSize(move.from.size) > maximumSegmentSize) {
+            if (!startTarget()) {
+                success = false;
+                break;
+            }
+        }
+        auto& target = targets.last();
+        if (!writeAt(target.fileDescriptor, map.data() + move.from.offset, frameSize(move.from.size), target.size)) {
+            success = false;
+            break;
+        }
+        move.to = { target.number, target.size, move.from.size, move.from.creation, move.from.access };
+        target.size += frameSize(move.from.size);
+    }
+    for (auto& target : targets)
+        success = success && !fsync(target.fileDescriptor);
+    if (!success) {
+        for (auto& target : targets) {
+            close(target.fileDescriptor);
+            WebCore::deleteFile(segmentPath(target.number));
+        }
+        std::lock_guard<Lock> lock(m_lock);
+        m_isCompacting = false;
+        return;
+    }
+
+    std::lock_guard<Lock> lock(m_lock);
+    m_isCompacting = false;
+
+    HashMap<unsigned, std::unique_ptr<Segment>> newSegments;
+    for (auto& target : targets) {
+        auto segment = std::make_unique<Segment>();
+        segment->fileDescriptor = target.fileDescriptor;
+        segment->size = target.size;
+        newSegments.set(target.number, WTFMove(segment));
+    }
+
+    // Records removed or replaced during the copy stay behind as dead space in the new segments.
+    for (auto& move : moves) {
+        auto it = m_index.find(move.hash);
+        if (it == m_index.end() || it->value.segment != move.from.segment || it->value.offset != move.from.offset) {
+            newSegments.get(move.to.segment)->deadSize += frameSize(move.to.size);
+            continue;
+        }
+        move.to.access = it->value.access;
+        it->value = move.to;
+        m_indexIsDirty = true;
+    }
+    for (auto& segment : newSegments) {
+        if (segment.value->deadSize == segment.value->size) {
+            close(segment.value->fileDescriptor);
+            WebCore::deleteFile(segmentPath(segment.key));
+        } else
+            m_segments.set(segment.key, WTFMove(segment.value));
+    }
+
+    // The copies have to be in the index on disk before the old segments go away.
+    flushIndexLocked();
+    if (m_indexIsDirty)
+        return;
+
+    for (auto number : segmentsToCompact.keys())
+        deleteSegmentLocked(number);
+
+    LOG(NetworkCacheStorage, "(NetworkProcess) compacted %u segments into %zu", segmentsToCompact.size(), targets.size());
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NetworkCacheSegmentStorage_h
+#define NetworkCacheSegmentStorage_h
+
+#if ENABLE(NETWORK_CACHE)
+
+#include "NetworkCacheData.h"
+#include "NetworkCacheKey.h"
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+
+namespace WebKit {
+namespace NetworkCache {
+
+struct SegmentStorageHash {
+    static unsigned hash(const Key::HashType& hash)
+    {
+        unsigned result;
+        memcpy(&result, hash.data(), sizeof(result));
+        return result;
+    }
+    static bool equal(const Key::HashType& a, const Key::HashType& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+struct SegmentStorageHashTraits : WTF::GenericHashTraits<Key::HashType> {
+    static const bool emptyValueIsZero = true;
+    static void constructDeletedValue(Key::HashType& slot) { slot.fill(0xff); }
+    static bool isDeletedValue(const Key::HashType& value) { return std::all_of(value.begin(), value.end(), [](uint8_t byte) { return byte == 0xff; }); }
+};
+
+// SegmentStorage packs records into append-only segment files instead of keeping one file per record.
+// Record locations live in an index that is written to disk as a whole, so startup only needs to read
+// the index and scan whatever was appended after it was last written. Removed and replaced records
+// leave dead space behind that compaction reclaims by copying the live records out of mostly dead segments.
+class SegmentStorage {
+    WTF_MAKE_NONCOPYABLE(SegmentStorage);
+public:
+    SegmentStorage(const String& segmentDirectoryPath);
+    ~SegmentStorage();
+
+    struct Entry {
+        Key::HashType hash;
+        size_t size;
+        std::chrono::system_clock::time_point creation;
+        std::chrono::system_clock::time_point access;
+    };
+
+    // These are all synchronous and should not be used from the main thread.
+    void synchronize();
+
+    bool add(const Key::HashType&, const Data&);
+    Data get(const Key::HashType&);
+    void remove(const Key::HashType&);
+    void touch(const Key::HashType&);
+    void clear();
+
+    Vector<Entry> entries();
+
+    // Makes the appended records durable and writes the index if anything changed since it was last written.
+    void flushIndex();
+    void compactIfNeeded();
+
+    size_t approximateSize() const { return m_approximateSize; }
+
+private:
+    struct Location {
+        unsigned segment;
+        uint32_t offset;
+        uint32_t size;
+        std::chrono::system_clock::time_point creation;
+        std::chrono::system_clock::time_point access;
+    };
+
+    struct Segment {
+        int fileDescriptor { -1 };
+        uint32_t size { 0 };
+        uint32_t deadSize { 0 };
+        bool needsSync { false };
+        Data map;
+    };
+
+    String segmentDirectoryPath() const;
+    String segmentPath(unsigned number) const;
+    String indexPath() const;
+
+    bool readIndex(HashMap<unsigned, uint32_t>& indexedSegmentSizes);
+    void recoverSegmentTail(unsigned number, uint32_t indexedSize);
+    bool appendLocked(const Key::HashType&, const uint8_t*, size_t, Location&);
+    Segment* openSegmentLocked(unsigned number, bool create);
+    Data mapLocked(unsigned number, size_t minimumSize);
+    void markDeadLocked(const Location&);
+    void deleteSegmentLocked(unsigned number);
+    void flushIndexLocked();
+
+    const String m_segmentDirectoryPath;
+
+    Lock m_lock;
+    HashMap<Key::HashType, Location, SegmentStorageHash, SegmentStorageHashTraits> m_index;
+    // Segments are numbered from 1 in the order they were started. Records are appended to the active one,
+    // compaction copies them to a segment of its own.
+    HashMap<unsigned, std::unique_ptr<Segment>> m_segments;
+    unsigned m_activeSegment { 0 };
+    unsigned m_lastSegment { 0 };
+    bool m_isCompacting { false };
+    bool m_hasSynchronized { false };
+    bool m_indexIsDirty { false };
+
+    std::atomic<size_t> m_approximateSize { 0 };
+};
+
+}
+}
+
+#endif
+#endif
@@ -48,6 +48,15 @@ using namespace WebCore;
 
 static const auto preloadedEntryLifetime = 10s;
 
+// Subresources are only preloaded when their confidence reaches a threshold that moves with the outcome of
+// past speculative loads. Each used (or missed) preload lowers it by (1 - target) steps and each wasted one
+// raises it by target steps, so it settles where about targetSpeculativeLoadHitRate of the preloads get used.
+static const double initialConfidenceThreshold = 0.5;
+static const double minimumConfidenceThreshold = 0.35;
+static const double maximumConfidenceThreshold = 0.9;
+static const double confidenceThresholdAdjustmentStep = 0.04;
+static const double targetSpeculativeLoadHitRate = 0.75;
+
 #if !LOG_DISABLED
 static HashCountedSet<String>& allSpeculativeLoadingDiagnosticMessages()
 {
@@ -89,6 +98,7 @@ static inline ResourceRequest constructRevalidationRequest(const Entry& entry, c
     ResourceRequest revalidationRequest(entry.key().identifier());
     revalidationRequest.setHTTPHeaderFields(subResourceInfo.requestHeaders());
     revalidationRequest.setFirstPartyForCookies(subResourceInfo.firstPartyForCookies());
+    revalidationRequest.setPriority(subResourceInfo.priority());
 #if ENABLE(CACHE_PARTITIONING)
     if (entry.key().hasPartition())
         revalidationRequest.setCachePartition(entry.key().partition());
@@ -241,6 +251,7 @@ private:
 
 SpeculativeLoadManager::SpeculativeLoadManager(Storage& storage)
     : m_storage(storage)
+    , m_confidenceThreshold(initialConfidenceThreshold)
 {
 }
 
@@ -306,11 +317,13 @@ bool SpeculativeLoadManager::retrieve(const GlobalFrameID& frameID, const Key& s
         if (!canUsePreloadedEntry(*preloadedEntry, request)) {
             LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Retrieval: Could not use preloaded entry to satisfy request for '%s' due to HTTP headers mismatch:", storageKey.identifier().utf8().data());
             logSpeculativeLoadingDiagnosticMessage(frameID, preloadedEntry->wasRevalidated() ? DiagnosticLoggingKeys::wastedSpeculativeWarmupWithRevalidationKey() : DiagnosticLoggingKeys::wastedSpeculativeWarmupWithoutRevalidationKey());
+            adjustConfidenceThreshold(SpeculativeLoadOutcome::Wasted);
             return false;
         }
 
         LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Retrieval: Using preloaded entry to satisfy request for '%s':", storageKey.identifier().utf8().data());
         logSpeculativeLoadingDiagnosticMessage(frameID, preloadedEntry->wasRevalidated() ? DiagnosticLoggingKeys::successfulSpeculativeWarmupWithRevalidationKey() : DiagnosticLoggingKeys::successfulSpeculativeWarmupWithoutRevalidationKey());
+        adjustConfidenceThreshold(SpeculativeLoadOutcome::Used);
 
         completionHandler(preloadedEntry->takeCacheEntry());
         return true;
@@ -319,9 +332,10 @@ bool SpeculativeLoadManager::retrieve(const GlobalFrameID& frameID, const Key& s
     // Check pending speculative revalidations.
     auto* pendingPreload = m_pendingPreloads.get(storageKey);
     if (!pendingPreload) {
-        if (m_notPreloadedEntries.remove(storageKey))
+        if (m_notPreloadedEntries.remove(storageKey)) {
             logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::entryWronglyNotWarmedUpKey());
-        else
+            adjustConfidenceThreshold(SpeculativeLoadOutcome::Missed);
+        } else
             logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::unknownEntryRequestKey());
 
         return false;
@@ -330,6 +344,7 @@ bool SpeculativeLoadManager::retrieve(const GlobalFrameID& frameID, const Key& s
     if (!canUsePendingPreload(*pendingPreload, request)) {
         LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Retrieval: revalidation already in progress for '%s' but unusable due to HTTP headers mismatch:", storageKey.identifier().utf8().data());
         logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::wastedSpeculativeWarmupWithRevalidationKey());
+        adjustConfidenceThreshold(SpeculativeLoadOutcome::Wasted);
         return false;
     }
 
@@ -338,9 +353,24 @@ bool SpeculativeLoadManager::retrieve(const GlobalFrameID& frameID, const Key& s
     // FIXME: This breaks incremental loading when the revalidation is not successful.
     auto addResult = m_pendingRetrieveRequests.ensure(storageKey, [] { return std::make_unique<Vector<RetrieveCompletionHandler>>(); });
     addResult.iterator->value->append(WTFMove(completionHandler));
+    adjustConfidenceThreshold(SpeculativeLoadOutcome::Used);
     return true;
 }
 
+void SpeculativeLoadManager::adjustConfidenceThreshold(SpeculativeLoadOutcome outcome)
+{
+    switch (outcome) {
+    case SpeculativeLoadOutcome::Used:
+    case SpeculativeLoadOutcome::Missed:
+        m_confidenceThreshold -= confidenceThresholdAdjustmentStep * (1 - targetSpeculativeLoadHitRate);
+        break;
+    case SpeculativeLoadOutcome::Wasted:
+        m_confidenceThreshold += confidenceThresholdAdjustmentStep * targetSpeculativeLoadHitRate;
+        break;
+    }
+    m_confidenceThreshold = std::max(minimumConfidenceThreshold, std::min(m_confidenceThreshold, maximumConfidenceThreshold));
+}
+
 void SpeculativeLoadManager::registerLoad(const GlobalFrameID& frameID, const ResourceRequest& request, const Key& resourceKey)
 {
     ASSERT(RunLoop::isMain());
@@ -390,12 +420,13 @@ void SpeculativeLoadManager::addPreloadedEntry(std::unique_ptr<Entry> entry, con
             logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::wastedSpeculativeWarmupWithRevalidationKey());
         else
             logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::wastedSpeculativeWarmupWithoutRevalidationKey());
+        adjustConfidenceThreshold(SpeculativeLoadOutcome::Wasted);
     }));
 }
 
-void SpeculativeLoadManager::retrieveEntryFromStorage(const Key& key, RetrieveCompletionHandler&& completionHandler)
+void SpeculativeLoadManager::retrieveEntryFromStorage(const Key& key, ResourceLoadPriority priority, RetrieveCompletionHandler&& completionHandler)
 {
-    m_storage.retrieve(key, static_cast<unsigned>(ResourceLoadPriority::Medium), [completionHandler = WTFMove(completionHandler)](auto record) {
+    m_storage.retrieve(key, static_cast<unsigned>(priority), [completionHandler = WTFMove(completionHandler)](auto record) {
         if (!record) {
             completionHandler(nullptr);
             return false;
@@ -478,7 +509,7 @@ void SpeculativeLoadManager::preloadEntry(const Key& key, const SubresourceInfo&
         return;
 
     m_pendingPreloads.add(key, nullptr);
-    retrieveEntryFromStorage(key, [this, key, subResourceInfo, frameID](std::unique_ptr<Entry> entry) {
+    retrieveEntryFromStorage(key, subResourceInfo.priority(), [this, key, subResourceInfo, frameID](std::unique_ptr<Entry> entry) {
         ASSERT(!m_pendingPreloads.get(key));
         bool removed = m_pendingPreloads.remove(key);
         ASSERT_UNUSED(removed, removed);
@@ -501,19 +532,30 @@ void SpeculativeLoadManager::preloadEntry(const Key& key, const SubresourceInfo&
 
 void SpeculativeLoadManager::startSpeculativeRevalidation(const GlobalFrameID& frameID, SubresourcesEntry& entry)
 {
+    Vector<std::pair<const Key*, const SubresourceInfo*>> subresourcesToPreload;
     for (auto& subresourcePair : entry.subresources()) {
         auto& key = subresourcePair.key;
         auto& subresourceInfo = subresourcePair.value;
-        if (!subresourceInfo.isTransient())
-            preloadEntry(key, subresourceInfo, frameID);
+        if (subresourceInfo.confidence() >= m_confidenceThreshold)
+            subresourcesToPreload.append(std::make_pair(&key, &subresourceInfo));
         else {
-            LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Not preloading '%s' because it is marked as transient", key.identifier().utf8().data());
+            LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Not preloading '%s' because its confidence (%.2f) is below the threshold (%.2f)", key.identifier().utf8().data(), subresourceInfo.confidence(), m_confidenceThreshold);
             m_notPreloadedEntries.add(key, std::make_unique<ExpiringEntry>([this, key, frameID] {
                 logSpeculativeLoadingDiagnosticMessage(frameID, DiagnosticLoggingKeys::entryRightlyNotWarmedUpKey());
                 m_notPreloadedEntries.remove(key);
             }));
         }
     }
+
+    // Start with the subresources the page needs first, the disk and network queues are served in order within a priority.
+    std::sort(subresourcesToPreload.begin(), subresourcesToPreload.end(), [](auto& a, auto& b) {
+        if (a.second->priority() != b.second->priority())
+            return a.second->priority() > b.second->priority();
+        return a.second->confidence() > b.second->confidence();
+    });
+
+    for (auto& subresource : subresourcesToPreload)
+        preloadEntry(*subresource.first, *subresource.second, frameID);
 }
 
 void SpeculativeLoadManager::retrieveSubresourcesEntry(const Key& storageKey, std::function<void (std::unique_ptr<SubresourcesEntry>)>&& completionHandler)
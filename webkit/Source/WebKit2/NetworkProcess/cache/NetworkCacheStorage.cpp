@@ -46,6 +46,7 @@ namespace NetworkCache {
 static const char versionDirectoryPrefix[] = "Version ";
 static const char recordsDirectoryName[] = "Records";
 static const char blobsDirectoryName[] = "Blobs";
+static const char segmentsDirectoryName[] = "Segments";
 static const char blobSuffix[] = "-blob";
 
 static double computeRecordWorth(FileTimes);
@@ -67,6 +68,8 @@ public:
     std::unique_ptr<Record> resultRecord;
     SHA1::Digest expectedBodyHash;
     BlobStorage::Blob resultBodyBlob;
+    bool isBodyCompressed { false };
+    uint64_t decompressedBodySize { 0 };
     std::atomic<unsigned> activeCount { 0 };
     bool isCanceled { false };
 };
@@ -99,13 +102,19 @@ bool Storage::ReadOperation::finish()
 struct Storage::WriteOperation {
     WTF_MAKE_FAST_ALLOCATED;
 public:
-    WriteOperation(const Record& record, MappedBodyHandler&& mappedBodyHandler)
+    WriteOperation(const Record& record, MappedBodyHandler&& mappedBodyHandler, BodyCompression bodyCompression)
         : record(record)
         , mappedBodyHandler(WTFMove(mappedBodyHandler))
+        , bodyCompression(bodyCompression)
     { }
     
     const Record record;
     const MappedBodyHandler mappedBodyHandler;
+    const BodyCompression bodyCompression;
+
+    // The bytes written for the body, compressed or not. Set on the background queue.
+    Data storedBody;
+    bool isBodyCompressed { false };
 
     std::atomic<unsigned> activeCount { 0 };
 };
@@ -128,13 +137,13 @@ public:
     unsigned activeCount { 0 };
 };
 
-std::unique_ptr<Storage> Storage::open(const String& cachePath)
+std::unique_ptr<Storage> Storage::open(const String& cachePath, Layout layout)
 {
     ASSERT(RunLoop::isMain());
 
     if (!WebCore::makeAllDirectories(cachePath))
         return nullptr;
-    return std::unique_ptr<Storage>(new Storage(cachePath));
+    return std::unique_ptr<Storage>(new Storage(cachePath, layout));
 }
 
 static String makeVersionedDirectoryPath(const String& baseDirectoryPath)
@@ -153,6 +162,11 @@ static String makeBlobDirectoryPath(const String& baseDirectoryPath)
     return WebCore::pathByAppendingComponent(makeVersionedDirectoryPath(baseDirectoryPath), blobsDirectoryName);
 }
 
+static String makeSegmentDirectoryPath(const String& baseDirectoryPath)
+{
+    return WebCore::pathByAppendingComponent(makeVersionedDirectoryPath(baseDirectoryPath), segmentsDirectoryName);
+}
+
 void traverseRecordsFiles(const String& recordsPath, const String& expectedType, const std::function<void (const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath)>& function)
 {
     traverseDirectory(recordsPath, [&recordsPath, &function, &expectedType](const String& partitionName, DirectoryEntryType entryType) {
@@ -199,16 +213,20 @@ static void deleteEmptyRecordsDirectories(const String& recordsPath)
     });
 }
 
-Storage::Storage(const String& baseDirectoryPath)
+Storage::Storage(const String& baseDirectoryPath, Layout layout)
     : m_basePath(baseDirectoryPath)
     , m_recordsPath(makeRecordsDirectoryPath(baseDirectoryPath))
     , m_readOperationTimeoutTimer(*this, &Storage::cancelAllReadOperations)
     , m_writeOperationDispatchTimer(*this, &Storage::dispatchPendingWriteOperations)
+    , m_segmentIndexFlushTimer(*this, &Storage::flushSegmentIndex)
     , m_ioQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage", WorkQueue::Type::Concurrent))
     , m_backgroundIOQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage.background", WorkQueue::Type::Concurrent, WorkQueue::QOS::Background))
     , m_serialBackgroundIOQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage.serialBackground", WorkQueue::Type::Serial, WorkQueue::QOS::Background))
     , m_blobStorage(makeBlobDirectoryPath(baseDirectoryPath))
 {
+    if (layout == Layout::SegmentFiles)
+        m_segmentStorage = std::make_unique<SegmentStorage>(makeSegmentDirectoryPath(baseDirectoryPath));
+
     deleteOldVersions();
     synchronize();
 }
@@ -252,31 +270,53 @@ void Storage::synchronize()
         auto blobFilter = std::make_unique<ContentsFilter>();
         size_t recordsSize = 0;
         unsigned count = 0;
-        String anyType;
-        traverseRecordsFiles(recordsPath(), anyType, [&recordFilter, &blobFilter, &recordsSize, &count](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
-            auto filePath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
-
-            Key::HashType hash;
-            if (!Key::stringToHash(hashString, hash)) {
-                WebCore::deleteFile(filePath);
-                return;
-            }
-            long long fileSize = 0;
-            WebCore::getFileSize(filePath, fileSize);
-            if (!fileSize) {
-                WebCore::deleteFile(filePath);
-                return;
+        if (m_segmentStorage) {
+            // The segment index knows every record so there is no need to look at the record files.
+            m_segmentStorage->synchronize();
+            for (auto& entry : m_segmentStorage->entries()) {
+                recordFilter->add(entry.hash);
+                ++count;
             }
-
-            if (isBlob) {
+            recordsSize = m_segmentStorage->approximateSize();
+
+            // The records directory only holds blob links now. Record files are left over from the file per record layout.
+            String anyType;
+            traverseRecordsFiles(recordsPath(), anyType, [&blobFilter](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
+                auto filePath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
+                Key::HashType hash;
+                if (!isBlob || !Key::stringToHash(hashString, hash)) {
+                    WebCore::deleteFile(filePath);
+                    return;
+                }
                 blobFilter->add(hash);
-                return;
-            }
+            });
+        } else {
+            String anyType;
+            traverseRecordsFiles(recordsPath(), anyType, [&recordFilter, &blobFilter, &recordsSize, &count](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
+                auto filePath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
+
+                Key::HashType hash;
+                if (!Key::stringToHash(hashString, hash)) {
+                    WebCore::deleteFile(filePath);
+                    return;
+                }
+                long long fileSize = 0;
+                WebCore::getFileSize(filePath, fileSize);
+                if (!fileSize) {
+                    WebCore::deleteFile(filePath);
+                    return;
+                }
 
-            recordFilter->add(hash);
-            recordsSize += fileSize;
-            ++count;
-        });
+                if (isBlob) {
+                    blobFilter->add(hash);
+                    return;
+                }
+
+                recordFilter->add(hash);
+                recordsSize += fileSize;
+                ++count;
+            });
+        }
 
         RunLoop::main().dispatch([this, recordFilter = WTFMove(recordFilter), blobFilter = WTFMove(blobFilter), recordsSize]() mutable {
             for (auto& recordFilterKey : m_recordFilterHashesAddedDuringSynchronization)
@@ -363,6 +403,9 @@ struct RecordMetaData {
     SHA1::Digest bodyHash;
     uint64_t bodySize;
     bool isBodyInline;
+    // bodyHash and bodySize describe the stored bytes; this is the size after decompression.
+    bool isBodyCompressed;
+    uint64_t decompressedBodySize;
 
     // Not encoded as a field. Header starts immediately after meta data.
     uint64_t headerOffset;
@@ -389,6 +432,10 @@ static bool decodeRecordMetaData(RecordMetaData& metaData, const Data& fileData)
             return false;
         if (!decoder.decode(metaData.isBodyInline))
             return false;
+        if (!decoder.decode(metaData.isBodyCompressed))
+            return false;
+        if (!decoder.decode(metaData.decompressedBodySize))
+            return false;
         if (!decoder.verifyChecksum())
             return false;
         metaData.headerOffset = decoder.currentOffset();
@@ -446,6 +493,8 @@ void Storage::readRecord(ReadOperation& readOperation, const Data& recordData)
     }
 
     readOperation.expectedBodyHash = metaData.bodyHash;
+    readOperation.isBodyCompressed = metaData.isBodyCompressed;
+    readOperation.decompressedBodySize = metaData.decompressedBodySize;
     readOperation.resultRecord = std::make_unique<Storage::Record>(Storage::Record {
         metaData.key,
         timeStamp,
@@ -454,6 +503,32 @@ void Storage::readRecord(ReadOperation& readOperation, const Data& recordData)
     });
 }
 
+void Storage::decompressRecordBody(ReadOperation& readOperation)
+{
+    ASSERT(!RunLoop::isMain());
+
+    auto& record = readOperation.resultRecord;
+    if (!record || !readOperation.isBodyCompressed)
+        return;
+
+    // Blob hashes are normally verified on the main thread but the compressed bytes need checking before inflating them.
+    if (record->body.isNull()) {
+        if (readOperation.resultBodyBlob.hash != readOperation.expectedBodyHash) {
+            record = nullptr;
+            return;
+        }
+        record->body = readOperation.resultBodyBlob.data;
+    }
+
+#if ENABLE(NETWORK_CACHE_BODY_COMPRESSION)
+    record->body = decompressData(record->body, readOperation.decompressedBodySize);
+    if (!record->body.isNull())
+        return;
+    LOG(NetworkCacheStorage, "(NetworkProcess) body decompression failure");
+#endif
+    record = nullptr;
+}
+
 static Data encodeRecordMetaData(const RecordMetaData& metaData)
 {
     Encoder encoder;
@@ -466,6 +541,8 @@ static Data encodeRecordMetaData(const RecordMetaData& metaData)
     encoder << metaData.bodyHash;
     encoder << metaData.bodySize;
     encoder << metaData.isBodyInline;
+    encoder << metaData.isBodyCompressed;
+    encoder << metaData.decompressedBodySize;
 
     encoder.encodeChecksum();
 
@@ -477,7 +554,7 @@ Optional<BlobStorage::Blob> Storage::storeBodyAsBlob(WriteOperation& writeOperat
     auto blobPath = blobPathForKey(writeOperation.record.key);
 
     // Store the body.
-    auto blob = m_blobStorage.add(blobPath, writeOperation.record.body);
+    auto blob = m_blobStorage.add(blobPath, writeOperation.storedBody);
     if (blob.data.isNull())
         return { };
 
@@ -489,7 +566,7 @@ Optional<BlobStorage::Blob> Storage::storeBodyAsBlob(WriteOperation& writeOperat
         if (m_synchronizationInProgress)
             m_blobFilterHashesAddedDuringSynchronization.append(writeOperation.record.key.hash());
 
-        if (writeOperation.mappedBodyHandler)
+        if (writeOperation.mappedBodyHandler && !writeOperation.isBodyCompressed)
             writeOperation.mappedBodyHandler(blob.data);
 
         finishWriteOperation(writeOperation);
@@ -497,23 +574,27 @@ Optional<BlobStorage::Blob> Storage::storeBodyAsBlob(WriteOperation& writeOperat
     return blob;
 }
 
-Data Storage::encodeRecord(const Record& record, Optional<BlobStorage::Blob> blob)
+Data Storage::encodeRecord(const WriteOperation& writeOperation, Optional<BlobStorage::Blob> blob)
 {
-    ASSERT(!blob || bytesEqual(blob.value().data, record.body));
+    auto& record = writeOperation.record;
+    auto& body = writeOperation.storedBody;
+    ASSERT(!blob || bytesEqual(blob.value().data, body));
 
     RecordMetaData metaData(record.key);
     metaData.epochRelativeTimeStamp = std::chrono::duration_cast<std::chrono::milliseconds>(record.timeStamp.time_since_epoch());
     metaData.headerHash = computeSHA1(record.header);
     metaData.headerSize = record.header.size();
-    metaData.bodyHash = blob ? blob.value().hash : computeSHA1(record.body);
-    metaData.bodySize = record.body.size();
+    metaData.bodyHash = blob ? blob.value().hash : computeSHA1(body);
+    metaData.bodySize = body.size();
     metaData.isBodyInline = !blob;
+    metaData.isBodyCompressed = writeOperation.isBodyCompressed;
+    metaData.decompressedBodySize = record.body.size();
 
     auto encodedMetaData = encodeRecordMetaData(metaData);
     auto headerData = concatenate(encodedMetaData, record.header);
 
     if (metaData.isBodyInline)
-        return concatenate(headerData, record.body);
+        return concatenate(headerData, body);
 
     return { headerData };
 }
@@ -546,7 +627,10 @@ void Storage::remove(const Key& key)
     removeFromPendingWriteOperations(key);
 
     serialBackgroundIOQueue().dispatch([this, key] {
-        WebCore::deleteFile(recordPathForKey(key));
+        if (m_segmentStorage)
+            m_segmentStorage->remove(key.hash());
+        else
+            WebCore::deleteFile(recordPathForKey(key));
         m_blobStorage.remove(blobPathForKey(key));
     });
 }
@@ -558,6 +642,17 @@ void Storage::updateFileModificationTime(const String& path)
     });
 }
 
+void Storage::updateRecordAccessTime(const Key& key)
+{
+    if (!m_segmentStorage) {
+        updateFileModificationTime(recordPathForKey(key));
+        return;
+    }
+    serialBackgroundIOQueue().dispatch([this, hash = key.hash()] {
+        m_segmentStorage->touch(hash);
+    });
+}
+
 void Storage::dispatchReadOperation(std::unique_ptr<ReadOperation> readOperationPtr)
 {
     ASSERT(RunLoop::isMain());
@@ -569,6 +664,23 @@ void Storage::dispatchReadOperation(std::unique_ptr<ReadOperation> readOperation
     const auto readTimeout = 1500ms;
     m_readOperationTimeoutTimer.startOneShot(readTimeout);
 
+    if (m_segmentStorage) {
+        ioQueue().dispatch([this, &readOperation] {
+            ++readOperation.activeCount;
+
+            auto recordData = m_segmentStorage->get(readOperation.key.hash());
+            if (!recordData.isNull())
+                readRecord(readOperation, recordData);
+
+            // The record tells whether there is a blob, so we don't need the blob filter here.
+            if (readOperation.resultRecord && readOperation.resultRecord->body.isNull())
+                readOperation.resultBodyBlob = m_blobStorage.get(blobPathForKey(readOperation.key));
+
+            finishReadOperation(readOperation);
+        });
+        return;
+    }
+
     bool shouldGetBodyBlob = mayContainBlob(readOperation.key);
 
     ioQueue().dispatch([this, &readOperation, shouldGetBodyBlob] {
@@ -601,10 +713,12 @@ void Storage::finishReadOperation(ReadOperation& readOperation)
     if (--readOperation.activeCount)
         return;
 
+    decompressRecordBody(readOperation);
+
     RunLoop::main().dispatch([this, &readOperation] {
         bool success = readOperation.finish();
         if (success)
-            updateFileModificationTime(recordPathForKey(readOperation.key));
+            updateRecordAccessTime(readOperation.key);
         else if (!readOperation.isCanceled)
             remove(readOperation.key);
 
@@ -706,14 +820,41 @@ void Storage::dispatchWriteOperation(std::unique_ptr<WriteOperation> writeOperat
         auto recordDirectorPath = recordDirectoryPathForKey(writeOperation.record.key);
         auto recordPath = recordPathForKey(writeOperation.record.key);
 
-        WebCore::makeAllDirectories(recordDirectorPath);
+        writeOperation.storedBody = writeOperation.record.body;
+#if ENABLE(NETWORK_CACHE_BODY_COMPRESSION)
+        if (writeOperation.bodyCompression == BodyCompression::Deflate) {
+            auto compressedBody = compressData(writeOperation.record.body);
+            // Keep the original bytes if compression doesn't pay for inflating on every read.
+            if (!compressedBody.isNull() && compressedBody.size() < writeOperation.record.body.size() * 9 / 10) {
+                writeOperation.storedBody = compressedBody;
+                writeOperation.isBodyCompressed = true;
+            }
+        }
+#endif
+
+        bool shouldStoreAsBlob = shouldStoreBodyAsBlob(writeOperation.storedBody);
+
+        // With segments the record directory only holds the blob links.
+        if (!m_segmentStorage || shouldStoreAsBlob)
+            WebCore::makeAllDirectories(recordDirectorPath);
 
         ++writeOperation.activeCount;
 
-        bool shouldStoreAsBlob = shouldStoreBodyAsBlob(writeOperation.record.body);
         auto blob = shouldStoreAsBlob ? storeBodyAsBlob(writeOperation) : Nullopt;
 
-        auto recordData = encodeRecord(writeOperation.record, blob);
+        auto recordData = encodeRecord(writeOperation, blob);
+
+        if (m_segmentStorage) {
+            bool success = m_segmentStorage->add(writeOperation.record.key.hash(), recordData);
+            RunLoop::main().dispatch([this, &writeOperation, recordSize = recordData.size(), success] {
+                if (success)
+                    m_approximateRecordsSize += recordSize;
+                finishWriteOperation(writeOperation);
+
+                LOG(NetworkCacheStorage, "(NetworkProcess) segment write complete success=%d", success);
+            });
+            return;
+        }
 
         auto channel = IOChannel::open(recordPath, IOChannel::Type::Create);
         size_t recordSize = recordData.size();
@@ -739,9 +880,25 @@ void Storage::finishWriteOperation(WriteOperation& writeOperation)
     m_activeWriteOperations.remove(&writeOperation);
     dispatchPendingWriteOperations();
 
+    // Writing the segment index means encoding all of it, so changes are collected for a while before it is written.
+    // Records appended in the meantime are recovered from the segment tails if the process goes away.
+    static const auto segmentIndexFlushDelay = 5s;
+    if (m_segmentStorage && !m_segmentIndexFlushTimer.isActive())
+        m_segmentIndexFlushTimer.startOneShot(segmentIndexFlushDelay);
+
     shrinkIfNeeded();
 }
 
+void Storage::flushSegmentIndex()
+{
+    ASSERT(RunLoop::isMain());
+    ASSERT(m_segmentStorage);
+
+    serialBackgroundIOQueue().dispatch([this] {
+        m_segmentStorage->flushIndex();
+    });
+}
+
 void Storage::retrieve(const Key& key, unsigned priority, RetrieveCompletionHandler&& completionHandler)
 {
     ASSERT(RunLoop::isMain());
@@ -768,7 +925,7 @@ void Storage::retrieve(const Key& key, unsigned priority, RetrieveCompletionHand
     dispatchPendingReadOperations();
 }
 
-void Storage::store(const Record& record, MappedBodyHandler&& mappedBodyHandler)
+void Storage::store(const Record& record, MappedBodyHandler&& mappedBodyHandler, BodyCompression bodyCompression)
 {
     ASSERT(RunLoop::isMain());
     ASSERT(!record.key.isNull());
@@ -776,7 +933,7 @@ void Storage::store(const Record& record, MappedBodyHandler&& mappedBodyHandler)
     if (!m_capacity)
         return;
 
-    auto writeOperation = std::make_unique<WriteOperation>(record, WTFMove(mappedBodyHandler));
+    auto writeOperation = std::make_unique<WriteOperation>(record, WTFMove(mappedBodyHandler), bodyCompression);
     m_pendingWriteOperations.prepend(WTFMove(writeOperation));
 
     // Add key to the filter already here as we do lookups from the pending operations too.
@@ -803,6 +960,43 @@ void Storage::traverse(const String& type, TraverseFlags flags, TraverseHandler&
     m_activeTraverseOperations.add(WTFMove(traverseOperationPtr));
 
     ioQueue().dispatch([this, &traverseOperation] {
+        if (m_segmentStorage) {
+            for (auto& entry : m_segmentStorage->entries()) {
+                RecordMetaData metaData;
+                Data headerData;
+                if (!decodeRecordHeader(m_segmentStorage->get(entry.hash), metaData, headerData))
+                    continue;
+                if (!traverseOperation.type.isEmpty() && metaData.key.type() != traverseOperation.type)
+                    continue;
+
+                double worth = -1;
+                if (traverseOperation.flags & TraverseFlag::ComputeWorth)
+                    worth = computeRecordWorth({ entry.creation, entry.access });
+                unsigned bodyShareCount = 0;
+                if ((traverseOperation.flags & TraverseFlag::ShareCount) && !metaData.isBodyInline)
+                    bodyShareCount = m_blobStorage.shareCount(blobPathForKey(metaData.key));
+
+                Record record {
+                    metaData.key,
+                    std::chrono::system_clock::time_point(metaData.epochRelativeTimeStamp),
+                    headerData,
+                    { }
+                };
+                RecordInfo info {
+                    static_cast<size_t>(metaData.bodySize),
+                    worth,
+                    bodyShareCount,
+                    String::fromUTF8(SHA1::hexDigest(metaData.bodyHash))
+                };
+                traverseOperation.handler(&record, info);
+            }
+            RunLoop::main().dispatch([this, &traverseOperation] {
+                traverseOperation.handler(nullptr, { });
+                m_activeTraverseOperations.remove(&traverseOperation);
+            });
+            return;
+        }
+
         traverseRecordsFiles(recordsPath(), traverseOperation.type, [this, &traverseOperation](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
             ASSERT(type == traverseOperation.type);
             if (isBlob)
@@ -892,6 +1086,24 @@ void Storage::clear(const String& type, std::chrono::system_clock::time_point mo
     m_approximateRecordsSize = 0;
 
     ioQueue().dispatch([this, modifiedSinceTime, completionHandler = WTFMove(completionHandler), type = type.isolatedCopy()] () mutable {
+        if (m_segmentStorage) {
+            if (type.isEmpty() && modifiedSinceTime == std::chrono::system_clock::time_point::min())
+                m_segmentStorage->clear();
+            else {
+                for (auto& entry : m_segmentStorage->entries()) {
+                    if (entry.access < modifiedSinceTime)
+                        continue;
+                    RecordMetaData metaData;
+                    Data headerData;
+                    if (decodeRecordHeader(m_segmentStorage->get(entry.hash), metaData, headerData) && !type.isEmpty() && metaData.key.type() != type)
+                        continue;
+                    m_segmentStorage->remove(entry.hash);
+                }
+                m_segmentStorage->compactIfNeeded();
+                m_segmentStorage->flushIndex();
+            }
+        }
+
         auto recordsPath = this->recordsPath();
         traverseRecordsFiles(recordsPath, type, [modifiedSinceTime](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
             auto filePath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
@@ -969,28 +1181,52 @@ void Storage::shrink()
     LOG(NetworkCacheStorage, "(NetworkProcess) shrinking cache approximateSize=%zu capacity=%zu", approximateSize(), m_capacity);
 
     backgroundIOQueue().dispatch([this] {
-        auto recordsPath = this->recordsPath();
-        String anyType;
-        traverseRecordsFiles(recordsPath, anyType, [this](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
-            if (isBlob)
-                return;
+        if (m_segmentStorage) {
+            for (auto& entry : m_segmentStorage->entries()) {
+                RecordMetaData metaData;
+                Data headerData;
+                if (!decodeRecordHeader(m_segmentStorage->get(entry.hash), metaData, headerData)) {
+                    m_segmentStorage->remove(entry.hash);
+                    continue;
+                }
 
-            auto recordPath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
-            auto blobPath = blobPathForRecordPath(recordPath);
+                auto blobPath = metaData.isBodyInline ? String() : blobPathForKey(metaData.key);
+                unsigned bodyShareCount = blobPath.isNull() ? 0 : m_blobStorage.shareCount(blobPath);
+                auto probability = deletionProbability({ entry.creation, entry.access }, bodyShareCount);
 
-            auto times = fileTimes(recordPath);
-            unsigned bodyShareCount = m_blobStorage.shareCount(blobPath);
-            auto probability = deletionProbability(times, bodyShareCount);
+                if (randomNumber() < probability) {
+                    m_segmentStorage->remove(entry.hash);
+                    if (!blobPath.isNull())
+                        m_blobStorage.remove(blobPath);
+                }
+            }
+            // Deleted records only become dead space, compaction is what gives it back.
+            m_segmentStorage->compactIfNeeded();
+            m_segmentStorage->flushIndex();
+        } else {
+            auto recordsPath = this->recordsPath();
+            String anyType;
+            traverseRecordsFiles(recordsPath, anyType, [this](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
+                if (isBlob)
+                    return;
 
-            bool shouldDelete = randomNumber() < probability;
+                auto recordPath = WebCore::pathByAppendingComponent(recordDirectoryPath, fileName);
+                auto blobPath = blobPathForRecordPath(recordPath);
 
-            LOG(NetworkCacheStorage, "Deletion probability=%f bodyLinkCount=%d shouldDelete=%d", probability, bodyShareCount, shouldDelete);
+                auto times = fileTimes(recordPath);
+                unsigned bodyShareCount = m_blobStorage.shareCount(blobPath);
+                auto probability = deletionProbability(times, bodyShareCount);
 
-            if (shouldDelete) {
-                WebCore::deleteFile(recordPath);
-                m_blobStorage.remove(blobPath);
-            }
-        });
+                bool shouldDelete = randomNumber() < probability;
+
+                LOG(NetworkCacheStorage, "Deletion probability=%f bodyLinkCount=%d shouldDelete=%d", probability, bodyShareCount, shouldDelete);
+
+                if (shouldDelete) {
+                    WebCore::deleteFile(recordPath);
+                    m_blobStorage.remove(blobPath);
+                }
+            });
+        }
 
         RunLoop::main().dispatch([this] {
             m_shrinkInProgress = false;
@@ -31,6 +31,7 @@
 #include "NetworkCacheBlobStorage.h"
 #include "NetworkCacheData.h"
 #include "NetworkCacheKey.h"
+#include "NetworkCacheSegmentStorage.h"
 #include <WebCore/Timer.h>
 #include <wtf/BloomFilter.h>
 #include <wtf/Deque.h>
@@ -48,7 +49,9 @@ class IOChannel;
 class Storage {
     WTF_MAKE_NONCOPYABLE(Storage);
 public:
-    static std::unique_ptr<Storage> open(const String& cachePath);
+    // With SegmentFiles the records are packed into a few append-only files with an index instead of one file each.
+    enum class Layout { RecordFiles, SegmentFiles };
+    static std::unique_ptr<Storage> open(const String& cachePath, Layout = Layout::RecordFiles);
 
     struct Record {
         WTF_MAKE_FAST_ALLOCATED;
@@ -63,7 +66,10 @@ public:
     void retrieve(const Key&, unsigned priority, RetrieveCompletionHandler&&);
 
     typedef Function<void (const Data& mappedBody)> MappedBodyHandler;
-    void store(const Record&, MappedBodyHandler&&);
+    // Whether compressing is worthwhile depends on the content type so the client decides.
+    // Compressed bodies are not handed to the MappedBodyHandler as the stored bytes are not the body.
+    enum class BodyCompression { None, Deflate };
+    void store(const Record&, MappedBodyHandler&&, BodyCompression = BodyCompression::None);
 
     void remove(const Key&);
     void clear(const String& type, std::chrono::system_clock::time_point modifiedSinceTime, std::function<void ()>&& completionHandler);
@@ -87,7 +93,7 @@ public:
     size_t capacity() const { return m_capacity; }
     size_t approximateSize() const;
 
-    static const unsigned version = 8;
+    static const unsigned version = 10;
 #if PLATFORM(MAC)
     /// Allow the last stable version of the cache to co-exist with the latest development one.
     static const unsigned lastStableVersion = 8;
@@ -100,7 +106,7 @@ public:
     ~Storage();
 
 private:
-    Storage(const String& directoryPath);
+    Storage(const String& directoryPath, Layout);
 
     String recordDirectoryPathForKey(const Key&) const;
     String recordPathForKey(const Key&) const;
@@ -121,12 +127,15 @@ private:
     void dispatchWriteOperation(std::unique_ptr<WriteOperation>);
     void dispatchPendingWriteOperations();
     void finishWriteOperation(WriteOperation&);
+    void flushSegmentIndex();
 
     Optional<BlobStorage::Blob> storeBodyAsBlob(WriteOperation&);
-    Data encodeRecord(const Record&, Optional<BlobStorage::Blob>);
+    Data encodeRecord(const WriteOperation&, Optional<BlobStorage::Blob>);
     void readRecord(ReadOperation&, const Data&);
+    void decompressRecordBody(ReadOperation&);
 
     void updateFileModificationTime(const String& path);
+    void updateRecordAccessTime(const Key&);
     void removeFromPendingWriteOperations(const Key&);
 
     WorkQueue& ioQueue() { return m_ioQueue.get(); }
@@ -163,6 +172,7 @@ private:
     Deque<std::unique_ptr<WriteOperation>> m_pendingWriteOperations;
     HashSet<std::unique_ptr<WriteOperation>> m_activeWriteOperations;
     WebCore::Timer m_writeOperationDispatchTimer;
+    WebCore::Timer m_segmentIndexFlushTimer;
 
     struct TraverseOperation;
     HashSet<std::unique_ptr<TraverseOperation>> m_activeTraverseOperations;
@@ -172,6 +182,7 @@ private:
     Ref<WorkQueue> m_serialBackgroundIOQueue;
 
     BlobStorage m_blobStorage;
+    std::unique_ptr<SegmentStorage> m_segmentStorage;
 };
 
 // FIXME: Remove, used by NetworkCacheStatistics only.
@@ -36,25 +36,36 @@
 namespace WebKit {
 namespace NetworkCache {
 
-void SubresourceInfo::encode(Encoder& encoder) const
-{
-    encoder << m_isTransient;
+// Weight of the latest load in the confidence moving average. Two loads in a row put a subresource
+// over the default preloading threshold, like it used to take for it not to be transient anymore.
+static const double confidenceUpdateWeight = 0.4;
+// Subresources that were not loaded recently are forgotten once their confidence drops below this.
+static const double minimumRetainedConfidence = 0.15;
 
-    // Do not bother serializing other data members of transient resources as they are empty.
-    if (m_isTransient)
-        return;
+static double updatedConfidence(double confidence, bool wasLoaded)
+{
+    return confidence * (1 - confidenceUpdateWeight) + (wasLoaded ? confidenceUpdateWeight : 0);
+}
 
+void SubresourceInfo::encode(Encoder& encoder) const
+{
+    encoder << m_confidence;
+    encoder.encodeEnum(m_priority);
     encoder << m_firstPartyForCookies;
     encoder << m_requestHeaders;
 }
 
 bool SubresourceInfo::decode(Decoder& decoder, SubresourceInfo& info)
 {
-    if (!decoder.decode(info.m_isTransient))
+    if (!decoder.decode(info.m_confidence))
+        return false;
+    if (!(info.m_confidence >= 0 && info.m_confidence <= 1))
         return false;
 
-    if (info.m_isTransient)
-        return true;
+    if (!decoder.decodeEnum(info.m_priority))
+        return false;
+    if (info.m_priority < WebCore::ResourceLoadPriority::Lowest || info.m_priority > WebCore::ResourceLoadPriority::Highest)
+        return false;
 
     if (!decoder.decode(info.m_firstPartyForCookies))
         return false;
@@ -104,17 +115,28 @@ SubresourcesEntry::SubresourcesEntry(Key&& key, const Vector<std::unique_ptr<Sub
 {
     ASSERT(m_key.type() == "SubResources");
     for (auto& subresourceLoad : subresourceLoads)
-        m_subresources.add(subresourceLoad->key, SubresourceInfo(subresourceLoad->request));
+        m_subresources.add(subresourceLoad->key, SubresourceInfo(subresourceLoad->request, updatedConfidence(0, true)));
 }
 
 void SubresourcesEntry::updateSubresourceLoads(const Vector<std::unique_ptr<SubresourceLoad>>& subresourceLoads)
 {
     auto oldSubresources = WTFMove(m_subresources);
 
-    // Mark keys that are common with last load as non-Transient.
     for (auto& subresourceLoad : subresourceLoads) {
-        bool isTransient = !oldSubresources.contains(subresourceLoad->key);
-        m_subresources.add(subresourceLoad->key, SubresourceInfo(subresourceLoad->request, isTransient));
+        auto it = oldSubresources.find(subresourceLoad->key);
+        double confidence = it != oldSubresources.end() ? it->value.confidence() : 0;
+        m_subresources.add(subresourceLoad->key, SubresourceInfo(subresourceLoad->request, updatedConfidence(confidence, true)));
+    }
+
+    // Keep subresources that were not loaded this time for a while, some pages alternate between sets of subresources.
+    for (auto& oldSubresource : oldSubresources) {
+        if (m_subresources.contains(oldSubresource.key))
+            continue;
+        double confidence = updatedConfidence(oldSubresource.value.confidence(), false);
+        if (confidence < minimumRetainedConfidence)
+            continue;
+        oldSubresource.value.setConfidence(confidence);
+        m_subresources.add(oldSubresource.key, WTFMove(oldSubresource.value));
     }
 }
 
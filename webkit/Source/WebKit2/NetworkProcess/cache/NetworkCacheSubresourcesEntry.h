@@ -45,19 +45,24 @@ public:
     static bool decode(Decoder&, SubresourceInfo&);
 
     SubresourceInfo() = default;
-    SubresourceInfo(const WebCore::ResourceRequest& request, bool isTransient = false)
-        : m_isTransient(isTransient)
-        , m_firstPartyForCookies(isTransient ? WebCore::URL() : request.firstPartyForCookies())
-        , m_requestHeaders(isTransient ? WebCore::HTTPHeaderMap() : request.httpHeaderFields())
+    SubresourceInfo(const WebCore::ResourceRequest& request, double confidence)
+        : m_confidence(confidence)
+        , m_priority(request.priority())
+        , m_firstPartyForCookies(request.firstPartyForCookies())
+        , m_requestHeaders(request.httpHeaderFields())
     {
     }
 
-    bool isTransient() const { return m_isTransient; }
-    const WebCore::URL& firstPartyForCookies() const { ASSERT(!m_isTransient); return m_firstPartyForCookies; }
-    const WebCore::HTTPHeaderMap& requestHeaders() const { ASSERT(!m_isTransient); return m_requestHeaders; }
+    // Moving average of whether the subresource was loaded along with the page, from 0 to 1.
+    double confidence() const { return m_confidence; }
+    void setConfidence(double confidence) { m_confidence = confidence; }
+    WebCore::ResourceLoadPriority priority() const { return m_priority; }
+    const WebCore::URL& firstPartyForCookies() const { return m_firstPartyForCookies; }
+    const WebCore::HTTPHeaderMap& requestHeaders() const { return m_requestHeaders; }
 
 private:
-    bool m_isTransient { true };
+    double m_confidence { 0 };
+    WebCore::ResourceLoadPriority m_priority { WebCore::ResourceLoadPriority::Low };
     WebCore::URL m_firstPartyForCookies;
     WebCore::HTTPHeaderMap m_requestHeaders;
 };
@@ -398,6 +398,28 @@ void NetworkDataTask::suspend()
     [m_task suspend];
 }
 
+void NetworkDataTask::setPriority(WebCore::ResourceLoadPriority priority)
+{
+    // NSURLSession passes task priorities on to HTTP/2 stream priorities.
+    switch (priority) {
+    case WebCore::ResourceLoadPriority::VeryLow:
+        m_task.get().priority = 0;
+        break;
+    case WebCore::ResourceLoadPriority::Low:
+        m_task.get().priority = NSURLSessionTaskPriorityLow;
+        break;
+    case WebCore::ResourceLoadPriority::Medium:
+        m_task.get().priority = NSURLSessionTaskPriorityDefault;
+        break;
+    case WebCore::ResourceLoadPriority::High:
+        m_task.get().priority = (NSURLSessionTaskPriorityDefault + NSURLSessionTaskPriorityHigh) / 2;
+        break;
+    case WebCore::ResourceLoadPriority::VeryHigh:
+        m_task.get().priority = NSURLSessionTaskPriorityHigh;
+        break;
+    }
+}
+
 WebCore::Credential serverTrustCredential(const WebCore::AuthenticationChallenge& challenge)
 {
     return WebCore::Credential([NSURLCredential credentialForTrust:challenge.nsURLAuthenticationChallenge().protectionSpace.serverTrust]);
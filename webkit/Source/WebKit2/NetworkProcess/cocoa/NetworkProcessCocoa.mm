@@ -103,6 +103,7 @@ void NetworkProcess::platformInitializeNetworkProcessCocoa(const NetworkProcessC
 #if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
                 , parameters.shouldEnableNetworkCacheSpeculativeRevalidation
 #endif
+                , parameters.shouldEnableNetworkCacheSegmentedStorage
             };
             if (NetworkCache::singleton().initialize(m_diskCacheDirectory, cacheParameters)) {
                 auto urlCache(adoptNS([[NSURLCache alloc] initWithMemoryCapacity:0 diskCapacity:0 diskPath:nil]));
@@ -78,6 +78,7 @@ void NetworkProcess::platformInitializeNetworkProcess(const NetworkProcessCreati
 #if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
         , parameters.shouldEnableNetworkCacheSpeculativeRevalidation
 #endif
+        , parameters.shouldEnableNetworkCacheSegmentedStorage
     };
     NetworkCache::singleton().initialize(m_diskCacheDirectory, cacheParameters);
 #else
@@ -48,6 +48,10 @@
 #include <wtf/spi/darwin/XPCSPI.h>
 #endif
 
+#if USE(UNIX_DOMAIN_SOCKETS)
+#include "SharedMemoryRingBuffer.h"
+#endif
+
 #if PLATFORM(GTK)
 #include "GSocketMonitor.h"
 #endif
@@ -56,6 +60,10 @@ namespace IPC {
 
 struct WaitForMessageState;
 
+#if USE(UNIX_DOMAIN_SOCKETS)
+class MessageInfo;
+#endif
+
 enum MessageSendFlags {
     // Whether this message should be dispatched when waiting for a sync reply.
     // This is the default for synchronous messages.
@@ -323,10 +331,26 @@ private:
     // Called on the connection queue.
     void readyReadHandler();
     bool processMessage();
+    void processIncomingRingBufferMessages();
+    void setUpOutgoingRingBuffer();
+    bool sendOutgoingMessageThroughRingBuffer(MessageEncoder&, Vector<Attachment>&&);
+    bool sendRingBufferWakeUp();
+    bool sendMessageOverSocket(MessageInfo&, const Vector<Attachment>&, const uint8_t* inlineBody);
 
     Vector<uint8_t> m_readBuffer;
     Vector<int> m_fileDescriptors;
     int m_socketDescriptor;
+
+    // Once set up, message bodies go through shared memory and the socket only carries
+    // file descriptors and wake ups.
+    std::unique_ptr<SharedMemoryRingBuffer> m_outgoingRingBuffer;
+    std::unique_ptr<SharedMemoryRingBuffer> m_incomingRingBuffer;
+    struct PendingRingBufferAttachments {
+        Vector<Attachment> attachments;
+        RefPtr<WebKit::SharedMemory> oolMessageBody;
+        size_t bodySize;
+    };
+    Deque<PendingRingBufferAttachments> m_pendingRingBufferAttachments;
 #if PLATFORM(GTK)
     GSocketMonitor m_socketMonitor;
 #endif
@@ -30,11 +30,13 @@
 
 #include "DataReference.h"
 #include "SharedMemory.h"
+#include "SharedMemoryRingBuffer.h"
 #include <sys/socket.h>
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <poll.h>
+#include <sched.h>
 #include <wtf/Assertions.h>
 #include <wtf/StdLibExtras.h>
 #include <wtf/UniStdExtras.h>
@@ -59,6 +61,7 @@ namespace IPC {
 
 static const size_t messageMaxSize = 4096;
 static const size_t attachmentMaxAmount = 255;
+static const unsigned ringBufferFullYieldCount = 1000;
 
 enum {
     MessageBodyIsOutOfLine = 1U << 31
@@ -66,10 +69,21 @@ enum {
 
 class MessageInfo {
 public:
+    enum class Type : uint32_t {
+        Message,
+        // The attachment is the shared memory ring buffer the sender will write its messages to from now on.
+        RingBufferSetup,
+        // Attachments, and possibly the out of line body, of the next ring buffer message that has them.
+        RingBufferAttachments,
+        // The sender wrote to the ring buffer while the receiver was waiting.
+        RingBufferWakeUp,
+    };
+
     MessageInfo() { }
 
-    MessageInfo(size_t bodySize, size_t initialAttachmentCount)
-        : m_bodySize(bodySize)
+    MessageInfo(Type type, size_t bodySize, size_t initialAttachmentCount)
+        : m_type(type)
+        , m_bodySize(bodySize)
         , m_attachmentCount(initialAttachmentCount)
         , m_isMessageBodyOutOfLine(false)
     {
@@ -85,11 +99,14 @@ public:
 
     bool isMessageBodyIsOutOfLine() const { return m_isMessageBodyOutOfLine; }
 
+    Type type() const { return m_type; }
+
     size_t bodySize() const { return m_bodySize; }
 
     size_t attachmentCount() const { return m_attachmentCount; }
 
 private:
+    Type m_type;
     size_t m_bodySize;
     size_t m_attachmentCount;
     bool m_isMessageBodyOutOfLine;
@@ -155,6 +172,10 @@ void Connection::platformInvalidate()
 
     m_socketDescriptor = -1;
     m_isConnected = false;
+
+    m_outgoingRingBuffer = nullptr;
+    m_incomingRingBuffer = nullptr;
+    m_pendingRingBufferAttachments.clear();
 }
 
 bool Connection::processMessage()
@@ -241,13 +262,49 @@ bool Connection::processMessage()
 
     ASSERT(attachments.size() == (messageInfo.isMessageBodyIsOutOfLine() ? messageInfo.attachmentCount() - 1 : messageInfo.attachmentCount()));
 
-    uint8_t* messageBody = messageData;
-    if (messageInfo.isMessageBodyIsOutOfLine())
-        messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data());
+    switch (messageInfo.type()) {
+    case MessageInfo::Type::Message: {
+        uint8_t* messageBody = messageData;
+        if (messageInfo.isMessageBodyIsOutOfLine())
+            messageBody = reinterpret_cast<uint8_t*>(oolMessageBody->data());
 
-    auto decoder = std::make_unique<MessageDecoder>(DataReference(messageBody, messageInfo.bodySize()), WTFMove(attachments));
+        auto decoder = std::make_unique<MessageDecoder>(DataReference(messageBody, messageInfo.bodySize()), WTFMove(attachments));
 
-    processIncomingMessage(WTFMove(decoder));
+        processIncomingMessage(WTFMove(decoder));
+        break;
+    }
+    case MessageInfo::Type::RingBufferSetup:
+        if (m_incomingRingBuffer || attachments.size() != 1 || attachments[0].type() != Attachment::MappedMemoryType) {
+            ASSERT_NOT_REACHED();
+            return false;
+        }
+        {
+            WebKit::SharedMemory::Handle handle;
+            handle.adoptAttachment(WTFMove(attachments[0]));
+            m_incomingRingBuffer = SharedMemoryRingBuffer::map(handle);
+        }
+        if (!m_incomingRingBuffer) {
+            ASSERT_NOT_REACHED();
+            return false;
+        }
+        break;
+    case MessageInfo::Type::RingBufferAttachments:
+        // The sender queues these ahead of ring buffer records and blocks while the ring is full,
+        // so there can't be more of them than records in the ring plus the one being written.
+        if (!m_incomingRingBuffer || m_pendingRingBufferAttachments.size() > m_incomingRingBuffer->maximumRecordCount()) {
+            WTFLogAlways("Too many pending IPC ring buffer attachments in process %d", getpid());
+            connectionDidClose();
+            return false;
+        }
+        m_pendingRingBufferAttachments.append(PendingRingBufferAttachments { WTFMove(attachments), WTFMove(oolMessageBody), messageInfo.bodySize() });
+        break;
+    case MessageInfo::Type::RingBufferWakeUp:
+        // Nothing to do, the ring buffer is read once the socket is drained.
+        break;
+    default:
+        ASSERT_NOT_REACHED();
+        return false;
+    }
 
     if (m_readBuffer.size() > messageLength) {
         memmove(m_readBuffer.data(), m_readBuffer.data() + messageLength, m_readBuffer.size() - messageLength);
@@ -324,6 +381,62 @@ static ssize_t readBytesFromSocket(int socketDescriptor, Vector<uint8_t>& buffer
     return -1;
 }
 
+void Connection::processIncomingRingBufferMessages()
+{
+    if (!m_incomingRingBuffer)
+        return;
+
+    while (true) {
+        SharedMemoryRingBuffer::Record record;
+        switch (m_incomingRingBuffer->peek(record)) {
+        case SharedMemoryRingBuffer::ReadResult::Empty:
+            // Ask for a wake up unless a message was written in the meantime.
+            if (m_incomingRingBuffer->prepareToWait())
+                return;
+            continue;
+        case SharedMemoryRingBuffer::ReadResult::Invalid:
+            WTFLogAlways("Invalid IPC ring buffer in process %d", getpid());
+            connectionDidClose();
+            return;
+        case SharedMemoryRingBuffer::ReadResult::Record:
+            break;
+        }
+
+        Vector<Attachment> attachments;
+        RefPtr<WebKit::SharedMemory> oolMessageBody;
+        DataReference messageBody(record.body, record.bodySize);
+
+        if (record.flags & SharedMemoryRingBuffer::HasSocketAttachments) {
+            // The attachments are sent before the ring buffer is written to, but they may still be on
+            // their way. Reading them will bring us back here.
+            if (m_pendingRingBufferAttachments.isEmpty())
+                return;
+
+            PendingRingBufferAttachments pendingAttachments = m_pendingRingBufferAttachments.takeFirst();
+            if (!(record.flags & SharedMemoryRingBuffer::BodyIsOutOfLine) != !pendingAttachments.oolMessageBody) {
+                WTFLogAlways("Mismatched IPC ring buffer attachments in process %d", getpid());
+                connectionDidClose();
+                return;
+            }
+
+            attachments = WTFMove(pendingAttachments.attachments);
+            oolMessageBody = WTFMove(pendingAttachments.oolMessageBody);
+            if (oolMessageBody)
+                messageBody = DataReference(static_cast<uint8_t*>(oolMessageBody->data()), pendingAttachments.bodySize);
+        } else if (record.flags & SharedMemoryRingBuffer::BodyIsOutOfLine) {
+            WTFLogAlways("Missing IPC ring buffer attachments in process %d", getpid());
+            connectionDidClose();
+            return;
+        }
+
+        // The decoder copies the body, so the space can be given back to the sender right away.
+        auto decoder = std::make_unique<MessageDecoder>(messageBody, WTFMove(attachments));
+        m_incomingRingBuffer->consume();
+
+        processIncomingMessage(WTFMove(decoder));
+    }
+}
+
 void Connection::readyReadHandler()
 {
     while (true) {
@@ -331,8 +444,10 @@ void Connection::readyReadHandler()
 
         if (bytesRead < 0) {
             // EINTR was already handled by readBytesFromSocket.
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                processIncomingRingBufferMessages();
                 return;
+            }
 
             if (m_isConnected) {
                 WTFLogAlways("Error receiving IPC message on socket %d in process %d: %s", m_socketDescriptor, getpid(), strerror(errno));
@@ -351,6 +466,9 @@ void Connection::readyReadHandler()
             if (!processMessage())
                 break;
         }
+
+        if (!m_isConnected)
+            return;
     }
 }
 
@@ -394,6 +512,10 @@ bool Connection::open()
         protectedThis->readyReadHandler();
     });
 
+    m_connectionQueue->dispatch([protectedThis] {
+        protectedThis->setUpOutgoingRingBuffer();
+    });
+
     return true;
 }
 
@@ -402,6 +524,22 @@ bool Connection::platformCanSendOutgoingMessages() const
     return m_isConnected;
 }
 
+static bool appendOutOfLineMessageBody(const uint8_t* body, size_t bodySize, Vector<Attachment>& attachments)
+{
+    RefPtr<WebKit::SharedMemory> oolMessageBody = WebKit::SharedMemory::allocate(bodySize);
+    if (!oolMessageBody)
+        return false;
+
+    WebKit::SharedMemory::Handle handle;
+    if (!oolMessageBody->createHandle(handle, WebKit::SharedMemory::Protection::ReadOnly))
+        return false;
+
+    memcpy(oolMessageBody->data(), body, bodySize);
+
+    attachments.append(handle.releaseAttachment());
+    return true;
+}
+
 bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
 {
     COMPILE_ASSERT(sizeof(MessageInfo) + attachmentMaxAmount * sizeof(size_t) <= messageMaxSize, AttachmentsFitToMessageInline);
@@ -412,24 +550,109 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
         return false;
     }
 
-    MessageInfo messageInfo(encoder->bufferSize(), attachments.size());
+    if (m_outgoingRingBuffer)
+        return sendOutgoingMessageThroughRingBuffer(*encoder, WTFMove(attachments));
+
+    MessageInfo messageInfo(MessageInfo::Type::Message, encoder->bufferSize(), attachments.size());
     size_t messageSizeWithBodyInline = sizeof(messageInfo) + (attachments.size() * sizeof(AttachmentInfo)) + encoder->bufferSize();
     if (messageSizeWithBodyInline > messageMaxSize && encoder->bufferSize()) {
-        RefPtr<WebKit::SharedMemory> oolMessageBody = WebKit::SharedMemory::allocate(encoder->bufferSize());
-        if (!oolMessageBody)
+        if (!appendOutOfLineMessageBody(encoder->buffer(), encoder->bufferSize(), attachments))
             return false;
 
-        WebKit::SharedMemory::Handle handle;
-        if (!oolMessageBody->createHandle(handle, WebKit::SharedMemory::Protection::ReadOnly))
+        messageInfo.setMessageBodyIsOutOfLine();
+    }
+
+    return sendMessageOverSocket(messageInfo, attachments, messageInfo.isMessageBodyIsOutOfLine() ? nullptr : encoder->buffer());
+}
+
+bool Connection::sendOutgoingMessageThroughRingBuffer(MessageEncoder& encoder, Vector<Attachment>&& attachments)
+{
+    uint32_t flags = 0;
+    bool bodyIsOutOfLine = encoder.bufferSize() > m_outgoingRingBuffer->maximumBodySize();
+
+    // File descriptors can only travel on the socket. They are sent ahead of the ring buffer record
+    // so that the receiver finds them queued, in order, when it reads the record.
+    if (!attachments.isEmpty() || bodyIsOutOfLine) {
+        MessageInfo messageInfo(MessageInfo::Type::RingBufferAttachments, bodyIsOutOfLine ? encoder.bufferSize() : 0, attachments.size());
+        if (bodyIsOutOfLine) {
+            if (!appendOutOfLineMessageBody(encoder.buffer(), encoder.bufferSize(), attachments))
+                return false;
+
+            messageInfo.setMessageBodyIsOutOfLine();
+            flags |= SharedMemoryRingBuffer::BodyIsOutOfLine;
+        }
+
+        if (!sendMessageOverSocket(messageInfo, attachments, nullptr))
             return false;
+        flags |= SharedMemoryRingBuffer::HasSocketAttachments;
+    }
 
-        messageInfo.setMessageBodyIsOutOfLine();
+    const uint8_t* body = bodyIsOutOfLine ? nullptr : encoder.buffer();
+    size_t bodySize = bodyIsOutOfLine ? 0 : encoder.bufferSize();
+    for (unsigned attempt = 0; ; ++attempt) {
+        auto result = m_outgoingRingBuffer->tryWrite(body, bodySize, flags);
+        if (result == SharedMemoryRingBuffer::WriteResult::Written)
+            break;
+        if (result == SharedMemoryRingBuffer::WriteResult::Invalid) {
+            WTFLogAlways("Invalid IPC ring buffer in process %d", getpid());
+            connectionDidClose();
+            return false;
+        }
+
+        // The receiver is behind. Make sure it's awake and give it some time, unless it went away.
+        if (m_outgoingRingBuffer->takeConsumerIsWaiting() && !sendRingBufferWakeUp())
+            return false;
 
-        memcpy(oolMessageBody->data(), encoder->buffer(), encoder->bufferSize());
+        // It usually makes room quickly, so only start sleeping after a while.
+        if (attempt < ringBufferFullYieldCount) {
+            sched_yield();
+            continue;
+        }
 
-        attachments.append(handle.releaseAttachment());
+        struct pollfd pollfd;
+        pollfd.fd = m_socketDescriptor;
+        pollfd.events = 0;
+        pollfd.revents = 0;
+        if (poll(&pollfd, 1, 1) > 0 && (pollfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+            return false;
     }
 
+    if (m_outgoingRingBuffer->takeConsumerIsWaiting())
+        return sendRingBufferWakeUp();
+    return true;
+}
+
+bool Connection::sendRingBufferWakeUp()
+{
+    MessageInfo messageInfo(MessageInfo::Type::RingBufferWakeUp, 0, 0);
+    return sendMessageOverSocket(messageInfo, Vector<Attachment>(), nullptr);
+}
+
+void Connection::setUpOutgoingRingBuffer()
+{
+    if (!m_isConnected || m_outgoingRingBuffer)
+        return;
+
+    // Keep sending everything over the socket if the ring buffer can't be set up.
+    auto ringBuffer = SharedMemoryRingBuffer::create();
+    if (!ringBuffer)
+        return;
+
+    WebKit::SharedMemory::Handle handle;
+    if (!ringBuffer->createHandle(handle))
+        return;
+
+    Vector<Attachment> attachments;
+    attachments.append(handle.releaseAttachment());
+    MessageInfo messageInfo(MessageInfo::Type::RingBufferSetup, 0, attachments.size());
+    if (!sendMessageOverSocket(messageInfo, attachments, nullptr))
+        return;
+
+    m_outgoingRingBuffer = WTFMove(ringBuffer);
+}
+
+bool Connection::sendMessageOverSocket(MessageInfo& messageInfo, const Vector<Attachment>& attachments, const uint8_t* inlineBody)
+{
     struct msghdr message;
     memset(&message, 0, sizeof(message));
 
@@ -495,9 +718,9 @@ bool Connection::sendOutgoingMessage(std::unique_ptr<MessageEncoder> encoder)
         ++iovLength;
     }
 
-    if (!messageInfo.isMessageBodyIsOutOfLine() && encoder->bufferSize()) {
-        iov[iovLength].iov_base = reinterpret_cast<void*>(encoder->buffer());
-        iov[iovLength].iov_len = encoder->bufferSize();
+    if (inlineBody && messageInfo.bodySize()) {
+        iov[iovLength].iov_base = const_cast<uint8_t*>(inlineBody);
+        iov[iovLength].iov_len = messageInfo.bodySize();
         ++iovLength;
     }
 
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "SharedMemoryRingBuffer.h"
+
+#include <wtf/StdLibExtras.h>
+
+namespace IPC {
+
+struct SharedMemoryRingBuffer::Header {
+    // Written by the producer only.
+    alignas(64) std::atomic<uint32_t> writePosition;
+    // Written by the consumer only.
+    alignas(64) std::atomic<uint32_t> readPosition;
+    // Set by the consumer before sleeping, cleared by the producer when it sends a wake up.
+    alignas(64) std::atomic<uint32_t> consumerIsWaiting;
+};
+
+static const size_t recordAlignment = 8;
+const size_t SharedMemoryRingBuffer::headerSize = WTF::roundUpToMultipleOf<64>(sizeof(SharedMemoryRingBuffer::Header));
+
+static bool isPowerOfTwo(size_t value)
+{
+    return value && !(value & (value - 1));
+}
+
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::create(size_t capacity)
+{
+    ASSERT(isPowerOfTwo(capacity));
+    auto sharedMemory = WebKit::SharedMemory::allocate(headerSize + capacity);
+    if (!sharedMemory)
+        return nullptr;
+
+    auto ringBuffer = std::unique_ptr<SharedMemoryRingBuffer>(new SharedMemoryRingBuffer(WTFMove(sharedMemory), capacity));
+    auto& header = ringBuffer->header();
+    header.writePosition.store(0);
+    header.readPosition.store(0);
+    // The consumer hasn't looked at the ring yet so the first message needs to wake it up.
+    header.consumerIsWaiting.store(1);
+    return ringBuffer;
+}
+
+std::unique_ptr<SharedMemoryRingBuffer> SharedMemoryRingBuffer::map(const WebKit::SharedMemory::Handle& handle)
+{
+    auto sharedMemory = WebKit::SharedMemory::map(handle, WebKit::SharedMemory::Protection::ReadWrite);
+    if (!sharedMemory || sharedMemory->size() <= headerSize)
+        return nullptr;
+
+    size_t capacity = sharedMemory->size() - headerSize;
+    if (!isPowerOfTwo(capacity))
+        return nullptr;
+
+    auto ringBuffer = std::unique_ptr<SharedMemoryRingBuffer>(new SharedMemoryRingBuffer(WTFMove(sharedMemory), capacity));
+    ringBuffer->m_readPosition = ringBuffer->header().readPosition.load();
+    return ringBuffer;
+}
+
+SharedMemoryRingBuffer::SharedMemoryRingBuffer(RefPtr<WebKit::SharedMemory>&& sharedMemory, size_t capacity)
+    : m_sharedMemory(WTFMove(sharedMemory))
+    , m_capacity(capacity)
+{
+}
+
+bool SharedMemoryRingBuffer::createHandle(WebKit::SharedMemory::Handle& handle)
+{
+    return m_sharedMemory->createHandle(handle, WebKit::SharedMemory::Protection::ReadWrite);
+}
+
+SharedMemoryRingBuffer::Header& SharedMemoryRingBuffer::header() const
+{
+    return *static_cast<Header*>(m_sharedMemory->data());
+}
+
+uint8_t* SharedMemoryRingBuffer::data() const
+{
+    return static_cast<uint8_t*>(m_sharedMemory->data()) + headerSize;
+}
+
+SharedMemoryRingBuffer::WriteResult SharedMemoryRingBuffer::tryWrite(const uint8_t* body, size_t bodySize, uint32_t flags)
+{
+    ASSERT(bodySize <= maximumBodySize());
+
+    uint32_t readPosition = header().readPosition.load(std::memory_order_acquire);
+    uint32_t usedSpace = m_writePosition - readPosition;
+    if (usedSpace > m_capacity)
+        return WriteResult::Invalid;
+
+    size_t recordSize = WTF::roundUpToMultipleOf<recordAlignment>(sizeof(RecordHeader) + bodySize);
+    size_t offset = m_writePosition & (m_capacity - 1);
+    size_t spaceBeforeEnd = m_capacity - offset;
+    // Records are contiguous. When one doesn't fit before the end, the rest of the ring is skipped.
+    size_t paddingSize = recordSize > spaceBeforeEnd ? spaceBeforeEnd : 0;
+    if (paddingSize + recordSize > m_capacity - usedSpace)
+        return WriteResult::Full;
+
+    if (paddingSize) {
+        RecordHeader padding { static_cast<uint32_t>(paddingSize), 0 };
+        memcpy(data() + offset, &padding, sizeof(padding));
+        offset = 0;
+    }
+
+    RecordHeader recordHeader { static_cast<uint32_t>(bodySize), flags };
+    memcpy(data() + offset, &recordHeader, sizeof(recordHeader));
+    if (bodySize)
+        memcpy(data() + offset + sizeof(recordHeader), body, bodySize);
+
+    m_writePosition += paddingSize + recordSize;
+    // Sequentially consistent so that either this store is seen by prepareToWait() or the waiting flag is seen here.
+    header().writePosition.store(m_writePosition);
+    return WriteResult::Written;
+}
+
+bool SharedMemoryRingBuffer::takeConsumerIsWaiting()
+{
+    return header().consumerIsWaiting.exchange(0);
+}
+
+SharedMemoryRingBuffer::ReadResult SharedMemoryRingBuffer::peek(Record& record)
+{
+    while (true) {
+        uint32_t availableSize = header().writePosition.load(std::memory_order_acquire) - m_readPosition;
+        if (!availableSize)
+            return ReadResult::Empty;
+        if (availableSize > m_capacity || availableSize < sizeof(RecordHeader))
+            return ReadResult::Invalid;
+
+        size_t offset = m_readPosition & (m_capacity - 1);
+        size_t spaceBeforeEnd = m_capacity - offset;
+
+        RecordHeader recordHeader;
+        memcpy(&recordHeader, data() + offset, sizeof(recordHeader));
+
+        size_t recordSize = WTF::roundUpToMultipleOf<recordAlignment>(sizeof(RecordHeader) + static_cast<size_t>(recordHeader.size));
+        if (recordSize > spaceBeforeEnd || recordSize > availableSize) {
+            // Padding at the end of the ring, start over at the beginning.
+            if (recordHeader.size != spaceBeforeEnd || recordHeader.flags)
+                return ReadResult::Invalid;
+            m_readPosition += spaceBeforeEnd;
+            header().readPosition.store(m_readPosition, std::memory_order_release);
+            continue;
+        }
+
+        record.flags = recordHeader.flags;
+        record.body = data() + offset + sizeof(recordHeader);
+        record.bodySize = recordHeader.size;
+        m_peekedRecordSize = recordSize;
+        return ReadResult::Record;
+    }
+}
+
+void SharedMemoryRingBuffer::consume()
+{
+    ASSERT(m_peekedRecordSize);
+    m_readPosition += m_peekedRecordSize;
+    m_peekedRecordSize = 0;
+    header().readPosition.store(m_readPosition, std::memory_order_release);
+}
+
+bool SharedMemoryRingBuffer::prepareToWait()
+{
+    header().consumerIsWaiting.store(1);
+    if (header().writePosition.load() == m_readPosition)
+        return true;
+    header().consumerIsWaiting.store(0);
+    return false;
+}
+
+size_t SharedMemoryRingBuffer::maximumRecordCount() const
+{
+    return m_capacity / WTF::roundUpToMultipleOf<recordAlignment>(sizeof(RecordHeader));
+}
+
+} // namespace IPC
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SharedMemoryRingBuffer_h
+#define SharedMemoryRingBuffer_h
+
+#include "SharedMemory.h"
+#include <atomic>
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/RefPtr.h>
+
+namespace IPC {
+
+// A single producer, single consumer queue of message bodies in memory shared between two processes.
+// The producer and the consumer each stay on one thread. Positions only grow, wrapping around at 2^32,
+// so the difference between the write and the read position is the amount of unread data.
+// Everything read from the ring is validated as the other process may not be trustworthy.
+class SharedMemoryRingBuffer {
+    WTF_MAKE_NONCOPYABLE(SharedMemoryRingBuffer);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static const size_t defaultCapacity = 256 * 1024;
+
+    static std::unique_ptr<SharedMemoryRingBuffer> create(size_t capacity = defaultCapacity);
+    static std::unique_ptr<SharedMemoryRingBuffer> map(const WebKit::SharedMemory::Handle&);
+
+    bool createHandle(WebKit::SharedMemory::Handle&);
+
+    size_t capacity() const { return m_capacity; }
+    // Larger bodies travel out of line so a single message can't fill most of the ring.
+    size_t maximumBodySize() const { return m_capacity / 4; }
+
+    enum RecordFlag : uint32_t {
+        // The attachments of the message, including an out of line body, were sent on the socket.
+        HasSocketAttachments = 1 << 0,
+        BodyIsOutOfLine = 1 << 1,
+    };
+
+    // Producer. Full means there isn't enough free space for the record yet, Invalid that the
+    // consumer moved its read position somewhere it can't be and won't ever make room.
+    enum class WriteResult { Written, Full, Invalid };
+    WriteResult tryWrite(const uint8_t* body, size_t bodySize, uint32_t flags);
+    // Returns whether the consumer went to sleep since the last call and needs waking up.
+    bool takeConsumerIsWaiting();
+
+    // Consumer.
+    struct Record {
+        uint32_t flags;
+        const uint8_t* body;
+        size_t bodySize;
+    };
+    enum class ReadResult { Empty, Record, Invalid };
+    // Returns the oldest unread record, again and again until it is consumed.
+    ReadResult peek(Record&);
+    // Releases the space of the record returned by the last peek().
+    void consume();
+    // Marks the consumer as waiting for a wake up. Returns false instead if there is unread data.
+    bool prepareToWait();
+    // The most records the ring can hold at once, each with at least a record header.
+    size_t maximumRecordCount() const;
+
+private:
+    struct Header;
+    static const size_t headerSize;
+
+    struct RecordHeader {
+        uint32_t size;
+        uint32_t flags;
+    };
+
+    SharedMemoryRingBuffer(RefPtr<WebKit::SharedMemory>&&, size_t capacity);
+
+    Header& header() const;
+    uint8_t* data() const;
+
+    RefPtr<WebKit::SharedMemory> m_sharedMemory;
+    size_t m_capacity;
+    // Local copies of the positions this side owns.
+    uint32_t m_writePosition { 0 };
+    uint32_t m_readPosition { 0 };
+    uint32_t m_peekedRecordSize { 0 };
+};
+
+} // namespace IPC
+
+#endif // SharedMemoryRingBuffer_h
@@ -44,6 +44,7 @@ list(APPEND WebKit2_SOURCES
     Platform/IPC/glib/GSocketMonitor.cpp
     Platform/IPC/unix/AttachmentUnix.cpp
     Platform/IPC/unix/ConnectionUnix.cpp
+    Platform/IPC/unix/SharedMemoryRingBuffer.cpp
 
     Platform/glib/ModuleGlib.cpp
 
@@ -497,6 +498,7 @@ list(APPEND WebKit2_INCLUDE_DIRECTORIES
     "${WEBKIT2_DIR}/NetworkProcess/gtk"
     "${WEBKIT2_DIR}/NetworkProcess/unix"
     "${WEBKIT2_DIR}/Platform/IPC/glib"
+    "${WEBKIT2_DIR}/Platform/IPC/unix"
     "${WEBKIT2_DIR}/Shared/API/c/gtk"
     "${WEBKIT2_DIR}/Shared/Plugins/unix"
     "${WEBKIT2_DIR}/Shared/glib"
@@ -536,6 +538,7 @@ list(APPEND WebKit2_SYSTEM_INCLUDE_DIRECTORIES
     ${GSTREAMER_INCLUDE_DIRS}
     ${HARFBUZZ_INCLUDE_DIRS}
     ${LIBSOUP_INCLUDE_DIRS}
+    ${ZLIB_INCLUDE_DIRS}
 )
 
 if (USE_LIBNOTIFY)
@@ -582,6 +585,7 @@ list(APPEND WebKit2_LIBRARIES
     GObjectDOMBindings
     WebCorePlatformGTK
     ${GTK_UNIX_PRINT_LIBRARIES}
+    ${ZLIB_LIBRARIES}
 )
 
 if (LIBNOTIFY_FOUND)
@@ -702,6 +706,7 @@ if (ENABLE_PLUGIN_PROCESS_GTK2)
         Platform/IPC/glib/GSocketMonitor.cpp
         Platform/IPC/unix/AttachmentUnix.cpp
         Platform/IPC/unix/ConnectionUnix.cpp
+        Platform/IPC/unix/SharedMemoryRingBuffer.cpp
 
         Platform/glib/ModuleGlib.cpp
 
@@ -1261,7 +1261,12 @@ static void encodeSharedBuffer(ArgumentEncoder& encoder, SharedBuffer* buffer)
     encoder << (buffer ? static_cast<uint64_t>(buffer->size()): 0);
     if (buffer) {
         RefPtr<SharedMemory> sharedMemoryBuffer = SharedMemory::allocate(buffer->size());
-        memcpy(sharedMemoryBuffer->data(), buffer->data(), buffer->size());
+        char* destination = static_cast<char*>(sharedMemoryBuffer->data());
+        buffer->forEachSegment([&destination](const char* segment, unsigned length) {
+            memcpy(destination, segment, length);
+            destination += length;
+            return true;
+        });
         sharedMemoryBuffer->createHandle(handle, SharedMemory::Protection::ReadOnly);
         encoder << handle;
     }
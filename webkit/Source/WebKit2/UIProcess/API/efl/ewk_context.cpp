@@ -80,6 +80,11 @@ EwkContext::EwkContext(WKContextRef context, const String& extensionsPath)
     // EwkContext make the context with the legacy options, it set the maximum process count to 1.
     // m_processCount also set to 1 to align with the ProcessPoolConfiguration.
     m_processCountLimit = 1;
+
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+    // The legacy options leave speculative revalidation off, turn it on like WebKitGTK+ does.
+    toImpl(context)->configuration().setDiskCacheSpeculativeValidationEnabled(true);
+#endif
     
     ContextMap::AddResult result = contextMap().add(context, this);
     ASSERT_UNUSED(result, result.isNewEntry);
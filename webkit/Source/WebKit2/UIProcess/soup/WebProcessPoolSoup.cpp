@@ -30,6 +30,7 @@
 #include "WebCookieManagerProxy.h"
 #include "WebSoupCustomProtocolRequestManager.h"
 #include <WebCore/Language.h>
+#include <glib.h>
 
 namespace WebKit {
 
@@ -42,6 +43,7 @@ void WebProcessPool::platformInitializeNetworkProcess(NetworkProcessCreationPara
     parameters.urlSchemesRegisteredForCustomProtocols = supplement<WebSoupCustomProtocolRequestManager>()->registeredSchemesForCustomProtocols();
 #if ENABLE(NETWORK_CACHE)
     parameters.shouldEnableNetworkCacheEfficacyLogging = false;
+    parameters.shouldEnableNetworkCacheSegmentedStorage = !!g_getenv("WEBKIT_NETWORK_CACHE_SEGMENTED_STORAGE");
 #endif
 }
 
@@ -270,6 +270,16 @@ void WebLoaderStrategy::setDefersLoading(ResourceLoader* resourceLoader, bool de
     WebProcess::singleton().networkConnection().connection().send(Messages::NetworkConnectionToWebProcess::SetDefersLoading(identifier, defers), 0);
 }
 
+void WebLoaderStrategy::setResourceLoadPriority(ResourceLoader* resourceLoader, ResourceLoadPriority priority)
+{
+    ResourceLoadIdentifier identifier = resourceLoader->identifier();
+    if (!identifier)
+        return;
+
+    // The network process does the scheduling, pass the change on so that it reaches the network layer.
+    WebProcess::singleton().networkConnection().connection().send(Messages::NetworkConnectionToWebProcess::SetResourceLoadPriority(identifier, static_cast<uint8_t>(priority)), 0);
+}
+
 void WebLoaderStrategy::crossOriginRedirectReceived(ResourceLoader*, const URL&)
 {
     // We handle cross origin redirects entirely within the NetworkProcess.
@@ -352,5 +362,19 @@ void WebLoaderStrategy::createPingHandle(NetworkingContext* networkingContext, R
     WebProcess::singleton().networkConnection().connection().send(Messages::NetworkConnectionToWebProcess::LoadPing(loadParameters), 0);
 }
 
+ResourceLoadPhaseTimes WebLoaderStrategy::loadPhaseTimes(ResourceLoadPriority priority)
+{
+    // The loads happen in the network process, which keeps the totals for this web process.
+    ResourceLoadPhaseTimes times;
+    if (!WebProcess::singleton().networkConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::GetLoadPhaseTimes(static_cast<uint8_t>(priority)), Messages::NetworkConnectionToWebProcess::GetLoadPhaseTimes::Reply(times), 0))
+        return { };
+    return times;
+}
+
+void WebLoaderStrategy::resetLoadPhaseTimes()
+{
+    WebProcess::singleton().networkConnection().connection().send(Messages::NetworkConnectionToWebProcess::ResetLoadPhaseTimes(), 0);
+}
+
 
 } // namespace WebKit
@@ -48,6 +48,7 @@ public:
 
     void remove(WebCore::ResourceLoader*) override;
     void setDefersLoading(WebCore::ResourceLoader*, bool) override;
+    void setResourceLoadPriority(WebCore::ResourceLoader*, WebCore::ResourceLoadPriority) override;
     void crossOriginRedirectReceived(WebCore::ResourceLoader*, const WebCore::URL& redirectURL) override;
     
     void servePendingRequests(WebCore::ResourceLoadPriority minimumPriority) override;
@@ -57,6 +58,9 @@ public:
 
     void createPingHandle(WebCore::NetworkingContext*, WebCore::ResourceRequest&, bool shouldUseCredentialStorage) override;
 
+    WebCore::ResourceLoadPhaseTimes loadPhaseTimes(WebCore::ResourceLoadPriority) override;
+    void resetLoadPhaseTimes() override;
+
     WebResourceLoader* webResourceLoaderForIdentifier(ResourceLoadIdentifier identifier) const { return m_webResourceLoaders.get(identifier); }
     RefPtr<WebCore::NetscapePlugInStreamLoader> schedulePluginStreamLoad(WebCore::Frame&, WebCore::NetscapePlugInStreamLoaderClient&, const WebCore::ResourceRequest&);
 
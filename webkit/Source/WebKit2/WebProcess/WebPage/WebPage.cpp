@@ -2737,10 +2737,12 @@ void WebPage::getContentsAsMHTMLData(uint64_t callbackID)
 {
     RefPtr<SharedBuffer> buffer = MHTMLArchive::generateMHTMLData(m_page.get());
 
-    // FIXME: Use SharedBufferDataReference.
-    IPC::DataReference dataReference;
-    if (buffer)
-        dataReference = IPC::DataReference(reinterpret_cast<const uint8_t*>(buffer->data()), buffer->size());
+    if (!buffer) {
+        send(Messages::WebPageProxy::DataCallback(IPC::DataReference(), callbackID));
+        return;
+    }
+    // Encodes the buffer segment by segment without flattening it first.
+    IPC::SharedBufferDataReference dataReference(buffer.get());
     send(Messages::WebPageProxy::DataCallback(dataReference, callbackID));
 }
 #endif
@@ -2806,10 +2808,12 @@ void WebPage::getMainResourceDataOfFrame(uint64_t frameID, uint64_t callbackID)
         }
     }
 
-    // FIXME: Use SharedBufferDataReference.
-    IPC::DataReference dataReference;
-    if (buffer)
-        dataReference = IPC::DataReference(reinterpret_cast<const uint8_t*>(buffer->data()), buffer->size());
+    if (!buffer) {
+        send(Messages::WebPageProxy::DataCallback(IPC::DataReference(), callbackID));
+        return;
+    }
+    // Encodes the buffer segment by segment without flattening it first.
+    IPC::SharedBufferDataReference dataReference(buffer.get());
     send(Messages::WebPageProxy::DataCallback(dataReference, callbackID));
 }
 
@@ -2838,10 +2842,12 @@ void WebPage::getResourceDataFromFrame(uint64_t frameID, const String& resourceU
         }
     }
 
-    // FIXME: Use SharedBufferDataReference.
-    IPC::DataReference dataReference;
-    if (buffer)
-        dataReference = IPC::DataReference(reinterpret_cast<const uint8_t*>(buffer->data()), buffer->size());
+    if (!buffer) {
+        send(Messages::WebPageProxy::DataCallback(IPC::DataReference(), callbackID));
+        return;
+    }
+    // Encodes the buffer segment by segment without flattening it first.
+    IPC::SharedBufferDataReference dataReference(buffer.get());
     send(Messages::WebPageProxy::DataCallback(dataReference, callbackID));
 }
 
@@ -530,6 +530,10 @@ void WebProcess::setCacheModel(uint32_t cm)
         m_hasSetCacheModel = true;
         m_cacheModel = cacheModel;
         platformSetCacheModel(cacheModel);
+
+        // Images make up most of what pages load only once, so they don't get all of the room for dead resources.
+        auto& memoryCache = MemoryCache::singleton();
+        memoryCache.setCapacityForType(CachedResource::ImageResource, memoryCache.maxDeadCapacity() / 2);
     }
 }
 
@@ -886,7 +890,7 @@ static void fromCountedSetToHashMap(TypeCountSet* countedSet, HashMap<String, ui
         map.set(it->key, it->value);
 }
 
-static void getWebCoreMemoryCacheStatistics(Vector<HashMap<String, uint64_t>>& result)
+static void getWebCoreMemoryCacheStatistics(Vector<HashMap<String, uint64_t>>& result, HashMap<String, uint64_t>& statisticsNumbers)
 {
     String imagesString(ASCIILiteral("Images"));
     String cssString(ASCIILiteral("CSS"));
@@ -922,6 +926,10 @@ static void getWebCoreMemoryCacheStatistics(Vector<HashMap<String, uint64_t>>& r
     decodedSizes.set(xslString, memoryCacheStatistics.xslStyleSheets.decodedSize);
     decodedSizes.set(javaScriptString, memoryCacheStatistics.scripts.decodedSize);
     result.append(decodedSizes);
+
+    statisticsNumbers.set(ASCIILiteral("MemoryCacheHitCount"), memoryCacheStatistics.hitCount);
+    statisticsNumbers.set(ASCIILiteral("MemoryCacheMissCount"), memoryCacheStatistics.missCount);
+    statisticsNumbers.set(ASCIILiteral("MemoryCacheEvictionCount"), memoryCacheStatistics.evictionCount);
 }
 
 void WebProcess::getWebCoreStatistics(uint64_t callbackID)
@@ -967,7 +975,7 @@ void WebProcess::getWebCoreStatistics(uint64_t callbackID)
     data.statisticsNumbers.set(ASCIILiteral("GlyphPageCount"), GlyphPage::count());
     
     // Get WebCore memory cache statistics
-    getWebCoreMemoryCacheStatistics(data.webCoreCacheStatistics);
+    getWebCoreMemoryCacheStatistics(data.webCoreCacheStatistics, data.statisticsNumbers);
     
     parentProcessConnection()->send(Messages::WebProcessPool::DidGetStatistics(data, callbackID), 0);
 }
@@ -0,0 +1,319 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Compares the two ways IPC::Connection on Unix can move message bodies between processes, for bodies
+// of 256 bytes to 64 KB. The socket transport sends bodies up to 4 KB inline and gives every larger one
+// a fresh shared memory region whose file descriptor travels with the message. The ring buffer transport
+// copies bodies into SharedMemoryRingBuffer and only writes to the socket to wake up a waiting receiver.
+// It reports the throughput of a stream of messages and the round trip latency of small messages, with
+// a thread on each side of a socket pair standing in for the two processes.
+//
+// On Linux, you can build this against a WebKitGTK+ build tree like so:
+// clang++ -o IPCTransportBenchmark Source/WebKit2/benchmarks/IPCTransportBenchmark.cpp
+//     Source/WebKit2/Platform/IPC/unix/{SharedMemoryRingBuffer,AttachmentUnix}.cpp Source/WebKit2/Platform/unix/SharedMemoryUnix.cpp
+//     Source/WebKit2/Platform/IPC/{Attachment,ArgumentDecoder,ArgumentEncoder,DataReference}.cpp
+//     -O3 -std=c++14 -DBUILDING_GTK__ -ISource/WTF -ISource/WebKit2 -ISource/WebKit2/Platform -ISource/WebKit2/Platform/IPC
+//     -ISource/WebKit2/Platform/IPC/unix -ISource/WebKit2/Shared -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/ForwardingHeaders
+//     -LWebKitBuild/Release/lib -lWebCore -lWTF -licuuc -lpthread
+
+#include "config.h"
+
+#include "Attachment.h"
+#include "SharedMemory.h"
+#include "SharedMemoryRingBuffer.h"
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+
+using namespace IPC;
+using namespace WebKit;
+
+namespace {
+
+static const size_t messageMaxSize = 4096;
+
+struct MessageHeader {
+    uint32_t bodySize;
+    uint32_t isBodyOutOfLine;
+};
+
+class SocketTransport {
+public:
+    explicit SocketTransport(int socket)
+        : m_socket(socket)
+    {
+        m_readBuffer.resize(messageMaxSize);
+    }
+
+    void send(const uint8_t* body, size_t bodySize)
+    {
+        MessageHeader header { static_cast<uint32_t>(bodySize), sizeof(header) + bodySize > messageMaxSize };
+
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        struct iovec iov[2];
+        iov[0].iov_base = &header;
+        iov[0].iov_len = sizeof(header);
+        message.msg_iov = iov;
+        message.msg_iovlen = 1;
+
+        Attachment attachment;
+        char control[CMSG_SPACE(sizeof(int))];
+        if (header.isBodyOutOfLine) {
+            // What ConnectionUnix does for every message body that doesn't fit in a socket packet.
+            auto oolBody = SharedMemory::allocate(bodySize);
+            RELEASE_ASSERT(oolBody);
+            memcpy(oolBody->data(), body, bodySize);
+            SharedMemory::Handle handle;
+            RELEASE_ASSERT(oolBody->createHandle(handle, SharedMemory::Protection::ReadOnly));
+            attachment = handle.releaseAttachment();
+
+            memset(control, 0, sizeof(control));
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            int fileDescriptor = attachment.fileDescriptor();
+            memcpy(CMSG_DATA(cmsg), &fileDescriptor, sizeof(int));
+        } else {
+            iov[1].iov_base = const_cast<uint8_t*>(body);
+            iov[1].iov_len = bodySize;
+            message.msg_iovlen = 2;
+        }
+
+        RELEASE_ASSERT(sendmsg(m_socket, &message, 0) != -1);
+    }
+
+    void receive(Vector<uint8_t>& body)
+    {
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        struct iovec iov[1];
+        iov[0].iov_base = m_readBuffer.data();
+        iov[0].iov_len = m_readBuffer.size();
+        message.msg_iov = iov;
+        message.msg_iovlen = 1;
+        char control[CMSG_SPACE(sizeof(int))];
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t bytesRead = recvmsg(m_socket, &message, 0);
+        RELEASE_ASSERT(bytesRead >= static_cast<ssize_t>(sizeof(MessageHeader)));
+
+        MessageHeader header;
+        memcpy(&header, m_readBuffer.data(), sizeof(header));
+        if (!header.isBodyOutOfLine) {
+            body.resize(header.bodySize);
+            memcpy(body.data(), m_readBuffer.data() + sizeof(header), header.bodySize);
+            return;
+        }
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        RELEASE_ASSERT(cmsg && cmsg->cmsg_type == SCM_RIGHTS);
+        int fileDescriptor;
+        memcpy(&fileDescriptor, CMSG_DATA(cmsg), sizeof(int));
+
+        SharedMemory::Handle handle;
+        handle.adoptAttachment(Attachment(fileDescriptor, header.bodySize));
+        auto oolBody = SharedMemory::map(handle, SharedMemory::Protection::ReadOnly);
+        RELEASE_ASSERT(oolBody);
+        body.resize(header.bodySize);
+        memcpy(body.data(), oolBody->data(), header.bodySize);
+    }
+
+private:
+    int m_socket;
+    Vector<uint8_t> m_readBuffer;
+};
+
+class RingBufferTransport {
+public:
+    RingBufferTransport(int socket, std::unique_ptr<SharedMemoryRingBuffer> ringBuffer)
+        : m_socket(socket)
+        , m_ringBuffer(WTFMove(ringBuffer))
+    {
+    }
+
+    void send(const uint8_t* body, size_t bodySize)
+    {
+        RELEASE_ASSERT(bodySize <= m_ringBuffer->maximumBodySize());
+        for (unsigned attempt = 0; ; ++attempt) {
+            auto result = m_ringBuffer->tryWrite(body, bodySize, 0);
+            RELEASE_ASSERT(result != SharedMemoryRingBuffer::WriteResult::Invalid);
+            if (result == SharedMemoryRingBuffer::WriteResult::Written)
+                break;
+            // Same back off as ConnectionUnix when the receiver is behind.
+            wakeUpReceiverIfNeeded();
+            if (attempt < 1000) {
+                sched_yield();
+                continue;
+            }
+            struct pollfd pollfd = { m_socket, 0, 0 };
+            poll(&pollfd, 1, 1);
+        }
+        wakeUpReceiverIfNeeded();
+    }
+
+    void receive(Vector<uint8_t>& body)
+    {
+        while (true) {
+            SharedMemoryRingBuffer::Record record;
+            auto result = m_ringBuffer->peek(record);
+            RELEASE_ASSERT(result != SharedMemoryRingBuffer::ReadResult::Invalid);
+            if (result == SharedMemoryRingBuffer::ReadResult::Record) {
+                body.resize(record.bodySize);
+                memcpy(body.data(), record.body, record.bodySize);
+                m_ringBuffer->consume();
+                return;
+            }
+            if (m_ringBuffer->prepareToWait()) {
+                uint8_t wakeUp;
+                RELEASE_ASSERT(recv(m_socket, &wakeUp, sizeof(wakeUp), 0) == sizeof(wakeUp));
+            }
+        }
+    }
+
+private:
+    void wakeUpReceiverIfNeeded()
+    {
+        if (!m_ringBuffer->takeConsumerIsWaiting())
+            return;
+        uint8_t wakeUp = 0;
+        RELEASE_ASSERT(::send(m_socket, &wakeUp, sizeof(wakeUp), 0) == sizeof(wakeUp));
+    }
+
+    int m_socket;
+    std::unique_ptr<SharedMemoryRingBuffer> m_ringBuffer;
+};
+
+// One direction of a connection.
+template<typename Transport> struct Channel;
+
+template<> struct Channel<SocketTransport> {
+    Channel()
+    {
+        int sockets[2];
+        RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != -1);
+        sender = std::make_unique<SocketTransport>(sockets[0]);
+        receiver = std::make_unique<SocketTransport>(sockets[1]);
+    }
+
+    std::unique_ptr<SocketTransport> sender;
+    std::unique_ptr<SocketTransport> receiver;
+};
+
+template<> struct Channel<RingBufferTransport> {
+    Channel()
+    {
+        int sockets[2];
+        RELEASE_ASSERT(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != -1);
+        auto ringBuffer = SharedMemoryRingBuffer::create();
+        RELEASE_ASSERT(ringBuffer);
+        SharedMemory::Handle handle;
+        RELEASE_ASSERT(ringBuffer->createHandle(handle));
+        auto mappedRingBuffer = SharedMemoryRingBuffer::map(handle);
+        RELEASE_ASSERT(mappedRingBuffer);
+        sender = std::make_unique<RingBufferTransport>(sockets[0], WTFMove(ringBuffer));
+        receiver = std::make_unique<RingBufferTransport>(sockets[1], WTFMove(mappedRingBuffer));
+    }
+
+    std::unique_ptr<RingBufferTransport> sender;
+    std::unique_ptr<RingBufferTransport> receiver;
+};
+
+template<typename Transport>
+double measureThroughput(size_t messageSize, unsigned messageCount)
+{
+    Channel<Transport> channel;
+    Vector<uint8_t> message(messageSize);
+    for (size_t i = 0; i < messageSize; ++i)
+        message[i] = i;
+
+    double start = monotonicallyIncreasingTimeMS();
+    std::thread receiver([&] {
+        Vector<uint8_t> body;
+        for (unsigned i = 0; i < messageCount; ++i) {
+            channel.receiver->receive(body);
+            RELEASE_ASSERT(body.size() == messageSize && body.last() == message.last());
+        }
+    });
+    for (unsigned i = 0; i < messageCount; ++i)
+        channel.sender->send(message.data(), message.size());
+    receiver.join();
+    return messageCount / (monotonicallyIncreasingTimeMS() - start) * 1000;
+}
+
+template<typename Transport>
+double measureRoundTripMicroseconds(size_t messageSize, unsigned roundTripCount)
+{
+    Channel<Transport> request;
+    Channel<Transport> reply;
+    Vector<uint8_t> message(messageSize);
+
+    std::thread responder([&] {
+        Vector<uint8_t> body;
+        for (unsigned i = 0; i < roundTripCount; ++i) {
+            request.receiver->receive(body);
+            reply.sender->send(body.data(), body.size());
+        }
+    });
+
+    double start = monotonicallyIncreasingTimeMS();
+    Vector<uint8_t> body;
+    for (unsigned i = 0; i < roundTripCount; ++i) {
+        request.sender->send(message.data(), message.size());
+        reply.receiver->receive(body);
+    }
+    double time = monotonicallyIncreasingTimeMS() - start;
+    responder.join();
+    return time / roundTripCount * 1000;
+}
+
+} // anonymous namespace
+
+int main(int, char**)
+{
+    WTF::initializeThreading();
+
+    const size_t messageSizes[] = { 256, 4 * 1024, 16 * 1024, 64 * 1024 };
+    for (size_t messageSize : messageSizes) {
+        unsigned messageCount = 64 * 1024 * 1024 / messageSize;
+        dataLogF("%6zu bytes: socket %9.0f messages/s, ring buffer %9.0f messages/s\n", messageSize,
+            measureThroughput<SocketTransport>(messageSize, messageCount), measureThroughput<RingBufferTransport>(messageSize, messageCount));
+    }
+
+    const unsigned roundTripCount = 20000;
+    dataLogF("   256 bytes round trip: socket %6.1f us, ring buffer %6.1f us\n",
+        measureRoundTripMicroseconds<SocketTransport>(256, roundTripCount), measureRoundTripMicroseconds<RingBufferTransport>(256, roundTripCount));
+    return 0;
+}
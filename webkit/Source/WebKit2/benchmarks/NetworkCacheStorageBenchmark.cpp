@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Compares the two disk cache layouts for 5,000 to 50,000 records of 1 to 16 KB: one file per record
+// under Records/<partition>/<type>/, as NetworkCache::Storage writes them by default, and the append-only
+// segment files of SegmentStorage. It times storing every record, reading them all back in random order,
+// and the startup synchronization that rebuilds the record filter: a walk of the whole record tree that
+// stats every file, against reading the segment index. Reads are served from the page cache, so cold
+// startup on slow flash is worse than what this reports for the record files.
+//
+// On Linux, you can build this against a WebKitGTK+ build tree like so:
+// clang++ -o NetworkCacheStorageBenchmark Source/WebKit2/benchmarks/NetworkCacheStorageBenchmark.cpp
+//     Source/WebKit2/NetworkProcess/cache/NetworkCache{SegmentStorage,Coders,Data,DataSoup,Decoder,Encoder,FileSystem,Key}.cpp
+//     -O3 -std=c++14 -DBUILDING_GTK__ -ISource/WTF -ISource/WebKit2 -ISource/WebKit2/NetworkProcess/cache -ISource/WebKit2/Platform
+//     -ISource/WebKit2/Shared -IWebKitBuild/Release -IWebKitBuild/Release/DerivedSources/ForwardingHeaders
+//     -LWebKitBuild/Release/lib -lWebCore -lWTF -licuuc `pkg-config --cflags --libs libsoup-2.4`
+
+#include "config.h"
+
+#include "NetworkCacheData.h"
+#include "NetworkCacheFileSystem.h"
+#include "NetworkCacheKey.h"
+#include "NetworkCacheSegmentStorage.h"
+#include <WebCore/FileSystem.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <wtf/BloomFilter.h>
+#include <wtf/CurrentTime.h>
+#include <wtf/DataLog.h>
+#include <wtf/RandomNumber.h>
+#include <wtf/Threading.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+using namespace WebKit::NetworkCache;
+
+namespace {
+
+using ContentsFilter = BloomFilter<18>;
+
+struct TestRecord {
+    Key key;
+    Data data;
+};
+
+Vector<TestRecord> makeRecords(unsigned recordCount)
+{
+    static const char* partitions[] = { "news.example.com", "mail.example.com", "shop.example.com", "maps.example.com" };
+    Vector<TestRecord> records;
+    Vector<uint8_t> bytes;
+    for (unsigned i = 0; i < recordCount; ++i) {
+        bytes.resize(1024 + randomNumber() * 15 * 1024);
+        for (auto& byte : bytes)
+            byte = randomNumber() * 256;
+        Key key(partitions[i % WTF_ARRAY_LENGTH(partitions)], "Resource", { }, "https://cdn.example.com/assets/" + String::number(i));
+        records.append({ key, Data(bytes.data(), bytes.size()) });
+    }
+    return records;
+}
+
+String recordPath(const String& recordsPath, const Key& key)
+{
+    auto recordDirectoryPath = WebCore::pathByAppendingComponent(WebCore::pathByAppendingComponent(recordsPath, key.partition()), key.type());
+    return WebCore::pathByAppendingComponent(recordDirectoryPath, key.hashAsString());
+}
+
+void storeRecordFile(const String& recordsPath, const TestRecord& record)
+{
+    WebCore::makeAllDirectories(WebCore::directoryName(recordPath(recordsPath, record.key)));
+    auto path = WebCore::fileSystemRepresentation(recordPath(recordsPath, record.key));
+    int fd = open(path.data(), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+    RELEASE_ASSERT(fd >= 0);
+    RELEASE_ASSERT(write(fd, record.data.data(), record.data.size()) == static_cast<ssize_t>(record.data.size()));
+    close(fd);
+}
+
+// Mirrors the walk Storage::synchronize() does over the record files.
+unsigned synchronizeRecordFiles(const String& recordsPath, ContentsFilter& filter)
+{
+    unsigned count = 0;
+    traverseDirectory(recordsPath, [&](const String& partitionName, DirectoryEntryType) {
+        auto partitionPath = WebCore::pathByAppendingComponent(recordsPath, partitionName);
+        traverseDirectory(partitionPath, [&](const String& type, DirectoryEntryType) {
+            auto recordDirectoryPath = WebCore::pathByAppendingComponent(partitionPath, type);
+            traverseDirectory(recordDirectoryPath, [&](const String& fileName, DirectoryEntryType) {
+                Key::HashType hash;
+                if (!Key::stringToHash(fileName, hash))
+                    return;
+                long long fileSize = 0;
+                WebCore::getFileSize(WebCore::pathByAppendingComponent(recordDirectoryPath, fileName), fileSize);
+                if (!fileSize)
+                    return;
+                filter.add(hash);
+                ++count;
+            });
+        });
+    });
+    return count;
+}
+
+void runBenchmark(const String& basePath, unsigned recordCount)
+{
+    auto records = makeRecords(recordCount);
+    Vector<unsigned> readOrder;
+    for (unsigned i = 0; i < recordCount; ++i)
+        readOrder.append(i);
+    for (unsigned i = recordCount - 1; i > 0; --i)
+        std::swap(readOrder[i], readOrder[randomNumber() * (i + 1)]);
+
+    auto recordsPath = WebCore::pathByAppendingComponent(basePath, "Records-" + String::number(recordCount));
+    auto segmentsPath = WebCore::pathByAppendingComponent(basePath, "Segments-" + String::number(recordCount));
+
+    double start = monotonicallyIncreasingTimeMS();
+    for (auto& record : records)
+        storeRecordFile(recordsPath, record);
+    double filesStoreTime = monotonicallyIncreasingTimeMS() - start;
+
+    // Storage writes the segment index after each batch of writes, batches are usually much longer than this.
+    const unsigned writeBatchSize = 16;
+    start = monotonicallyIncreasingTimeMS();
+    {
+        SegmentStorage segments(segmentsPath);
+        segments.synchronize();
+        for (unsigned i = 0; i < recordCount; ++i) {
+            RELEASE_ASSERT(segments.add(records[i].key.hash(), records[i].data));
+            if (!((i + 1) % writeBatchSize))
+                segments.flushIndex();
+        }
+        segments.flushIndex();
+    }
+    double segmentsStoreTime = monotonicallyIncreasingTimeMS() - start;
+
+    ContentsFilter filesFilter;
+    start = monotonicallyIncreasingTimeMS();
+    unsigned filesCount = synchronizeRecordFiles(recordsPath, filesFilter);
+    double filesStartupTime = monotonicallyIncreasingTimeMS() - start;
+    RELEASE_ASSERT(filesCount == recordCount);
+
+    ContentsFilter segmentsFilter;
+    SegmentStorage segments(segmentsPath);
+    start = monotonicallyIncreasingTimeMS();
+    segments.synchronize();
+    auto entries = segments.entries();
+    for (auto& entry : entries)
+        segmentsFilter.add(entry.hash);
+    double segmentsStartupTime = monotonicallyIncreasingTimeMS() - start;
+    RELEASE_ASSERT(entries.size() == recordCount);
+
+    start = monotonicallyIncreasingTimeMS();
+    for (auto i : readOrder) {
+        RELEASE_ASSERT(filesFilter.mayContain(records[i].key.hash()));
+        auto data = mapFile(WebCore::fileSystemRepresentation(recordPath(recordsPath, records[i].key)).data());
+        RELEASE_ASSERT(bytesEqual(data, records[i].data));
+    }
+    double filesRetrieveTime = monotonicallyIncreasingTimeMS() - start;
+
+    start = monotonicallyIncreasingTimeMS();
+    for (auto i : readOrder) {
+        RELEASE_ASSERT(segmentsFilter.mayContain(records[i].key.hash()));
+        auto data = segments.get(records[i].key.hash());
+        RELEASE_ASSERT(bytesEqual(data, records[i].data));
+    }
+    double segmentsRetrieveTime = monotonicallyIncreasingTimeMS() - start;
+
+    dataLogF("%6u records: store  files %9.0f records/s, segments %9.0f records/s\n", recordCount, recordCount / filesStoreTime * 1000, recordCount / segmentsStoreTime * 1000);
+    dataLogF("%6u records: read   files %9.0f records/s, segments %9.0f records/s\n", recordCount, recordCount / filesRetrieveTime * 1000, recordCount / segmentsRetrieveTime * 1000);
+    dataLogF("%6u records: startup files %8.1f ms,        segments %8.1f ms\n", recordCount, filesStartupTime, segmentsStartupTime);
+
+    segments.clear();
+    deleteDirectoryRecursively(recordsPath);
+    deleteDirectoryRecursively(segmentsPath);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    WTF::initializeThreading();
+
+    char directoryTemplate[] = "/tmp/NetworkCacheStorageBenchmark-XXXXXX";
+    const char* basePath = argc > 1 ? argv[1] : mkdtemp(directoryTemplate);
+    RELEASE_ASSERT(basePath);
+
+    const unsigned recordCounts[] = { 5000, 20000, 50000 };
+    for (unsigned recordCount : recordCounts)
+        runBenchmark(basePath, recordCount);
+
+    if (argc <= 1)
+        WebCore::deleteEmptyDirectory(basePath);
+    return 0;
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures what speculative revalidation in the network cache does to navigation time, against a local
+// HTTP server that adds a fixed latency to every response. The test page has a number of images the
+// preload scanner can see and a chain of scripts that each insert the next one, so that without
+// speculation every link of the chain costs a round trip to revalidate. Every subresource is served with
+// Cache-Control: no-cache and an ETag, and answered with a 304 when revalidated.
+//
+// Each visit uses a new WebKitWebContext sharing one disk cache directory, so that the memory cache of
+// the web process is empty like after a browser restart and every subresource goes through the network
+// cache. Visits alternate between the same page URL, for which the network cache learns the list of
+// subresources, and a page with the same subresources at a new URL every time, for which it never can.
+// The first visits of each series only fill the cache and are left out of the medians.
+//
+// On Linux, you can build this against a WebKitGTK+ build tree like so:
+// clang++ -o SpeculativeLoadBenchmark Source/WebKit2/benchmarks/SpeculativeLoadBenchmark.cpp
+//     -O2 -std=c++14 -IWebKitBuild/Release/DerivedSources/webkit2gtk/include -ISource/WebKit2/UIProcess/API/gtk
+//     -LWebKitBuild/Release/lib -lwebkit2gtk-4.0 `pkg-config --cflags --libs gtk+-3.0 libsoup-2.4`
+// and run it under a display server, Xvfb will do:
+// xvfb-run ./SpeculativeLoadBenchmark [visits] [images] [script chain length] [latency in ms]
+
+#include <algorithm>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include <libsoup/soup.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <webkit2/webkit2.h>
+
+namespace {
+
+struct Parameters {
+    unsigned visitCount { 10 };
+    unsigned imageCount { 20 };
+    unsigned scriptChainLength { 8 };
+    unsigned latencyMS { 40 };
+};
+
+struct ServerStatistics {
+    unsigned requestCount { 0 };
+    unsigned notModifiedCount { 0 };
+};
+
+static Parameters parameters;
+static ServerStatistics serverStatistics;
+
+static const char resourceETag[] = "\"speculative-load-benchmark\"";
+
+struct DelayedMessage {
+    SoupServer* server;
+    SoupMessage* message;
+};
+
+static std::string pageContents()
+{
+    std::string contents = "<!DOCTYPE html><html><head><title>loading</title><script src='/script/0.js'></script></head><body>";
+    for (unsigned i = 0; i < parameters.imageCount; ++i)
+        contents += "<img src='/image/" + std::to_string(i) + ".gif'>";
+    contents += "</body></html>";
+    return contents;
+}
+
+static std::string scriptContents(unsigned index)
+{
+    if (index + 1 >= parameters.scriptChainLength)
+        return "window.addEventListener('load', function() { document.title = 'done'; });";
+
+    return "var script = document.createElement('script'); script.src = '/script/" + std::to_string(index + 1) + ".js'; document.head.appendChild(script);";
+}
+
+static void setResponse(SoupMessage* message, const char* contentType, const void* data, size_t size)
+{
+    soup_message_set_status(message, SOUP_STATUS_OK);
+    soup_message_body_append(message->response_body, SOUP_MEMORY_COPY, data, size);
+    soup_message_headers_set_content_type(message->response_headers, contentType, nullptr);
+}
+
+static void serverCallback(SoupServer* server, SoupMessage* message, const char* path, GHashTable*, SoupClientContext*, gpointer)
+{
+    if (message->method != SOUP_METHOD_GET) {
+        soup_message_set_status(message, SOUP_STATUS_NOT_IMPLEMENTED);
+        return;
+    }
+
+    ++serverStatistics.requestCount;
+
+    if (!strcmp(path, "/page")) {
+        std::string contents = pageContents();
+        setResponse(message, "text/html", contents.data(), contents.size());
+        soup_message_headers_append(message->response_headers, "Cache-Control", "no-store");
+    } else if (!strcmp(path, "/blank")) {
+        setResponse(message, "text/html", "", 0);
+        soup_message_headers_append(message->response_headers, "Cache-Control", "no-store");
+        return;
+    } else {
+        const char* ifNoneMatch = soup_message_headers_get_one(message->request_headers, "If-None-Match");
+        if (ifNoneMatch && !strcmp(ifNoneMatch, resourceETag)) {
+            ++serverStatistics.notModifiedCount;
+            soup_message_set_status(message, SOUP_STATUS_NOT_MODIFIED);
+        } else if (g_str_has_prefix(path, "/script/")) {
+            std::string contents = scriptContents(atoi(path + strlen("/script/")));
+            setResponse(message, "text/javascript", contents.data(), contents.size());
+        } else if (g_str_has_prefix(path, "/image/")) {
+            static const unsigned char gif[] = {
+                0x47, 0x49, 0x46, 0x38, 0x39, 0x61, 0x01, 0x00, 0x01, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+                0xff, 0xff, 0xff, 0x21, 0xf9, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x00,
+                0x01, 0x00, 0x01, 0x00, 0x00, 0x02, 0x02, 0x44, 0x01, 0x00, 0x3b
+            };
+            setResponse(message, "image/gif", gif, sizeof(gif));
+        } else {
+            soup_message_set_status(message, SOUP_STATUS_NOT_FOUND);
+            return;
+        }
+        soup_message_headers_append(message->response_headers, "Cache-Control", "no-cache");
+        soup_message_headers_append(message->response_headers, "ETag", resourceETag);
+    }
+
+    soup_server_pause_message(server, message);
+    auto* delayedMessage = new DelayedMessage { server, message };
+    g_timeout_add(parameters.latencyMS, [](gpointer userData) -> gboolean {
+        auto* delayedMessage = static_cast<DelayedMessage*>(userData);
+        soup_server_unpause_message(delayedMessage->server, delayedMessage->message);
+        delete delayedMessage;
+        return G_SOURCE_REMOVE;
+    }, delayedMessage);
+}
+
+static void loadAndWait(WebKitWebView* webView, const char* uri)
+{
+    GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+    gulong handler = g_signal_connect(webView, "load-changed", G_CALLBACK(+[](WebKitWebView*, WebKitLoadEvent loadEvent, GMainLoop* loop) {
+        if (loadEvent == WEBKIT_LOAD_FINISHED)
+            g_main_loop_quit(loop);
+    }), loop);
+    webkit_web_view_load_uri(webView, uri);
+    g_main_loop_run(loop);
+    g_signal_handler_disconnect(webView, handler);
+    g_main_loop_unref(loop);
+}
+
+static void wait(unsigned milliseconds)
+{
+    GMainLoop* loop = g_main_loop_new(nullptr, FALSE);
+    g_timeout_add(milliseconds, [](gpointer loop) -> gboolean {
+        g_main_loop_quit(static_cast<GMainLoop*>(loop));
+        return G_SOURCE_REMOVE;
+    }, loop);
+    g_main_loop_run(loop);
+    g_main_loop_unref(loop);
+}
+
+struct VisitResult {
+    double navigationTimeMS;
+    ServerStatistics statistics;
+};
+
+static VisitResult visit(const std::string& baseURI, const char* cacheDirectory, const std::string& path)
+{
+    WebKitWebsiteDataManager* manager = webkit_website_data_manager_new("disk-cache-directory", cacheDirectory, nullptr);
+    WebKitWebContext* context = webkit_web_context_new_with_website_data_manager(manager);
+    g_object_unref(manager);
+    webkit_web_context_set_cache_model(context, WEBKIT_CACHE_MODEL_WEB_BROWSER);
+
+    GtkWidget* window = gtk_offscreen_window_new();
+    WebKitWebView* webView = WEBKIT_WEB_VIEW(webkit_web_view_new_with_context(context));
+    gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(webView));
+    gtk_widget_show_all(window);
+
+    // Launch the web and network processes before timing the navigation.
+    std::string blankURI = baseURI + "blank";
+    loadAndWait(webView, blankURI.c_str());
+
+    serverStatistics = ServerStatistics();
+    std::string pageURI = baseURI + path;
+    gint64 startTime = g_get_monotonic_time();
+    loadAndWait(webView, pageURI.c_str());
+    VisitResult result { (g_get_monotonic_time() - startTime) / 1000.0, serverStatistics };
+
+    if (g_strcmp0(webkit_web_view_get_title(webView), "done"))
+        g_printerr("Warning: %s finished loading before the end of the script chain\n", pageURI.c_str());
+
+    // Loading another page lets the network cache save the list of subresources of this one right away,
+    // then give its storage some time to write it before the network process goes away.
+    loadAndWait(webView, blankURI.c_str());
+    wait(1000);
+
+    gtk_widget_destroy(window);
+    g_object_unref(context);
+    return result;
+}
+
+static void removeDirectory(const char* path)
+{
+    if (GDir* directory = g_dir_open(path, 0, nullptr)) {
+        while (const char* name = g_dir_read_name(directory)) {
+            char* childPath = g_build_filename(path, name, nullptr);
+            if (g_file_test(childPath, G_FILE_TEST_IS_DIR))
+                removeDirectory(childPath);
+            else
+                g_unlink(childPath);
+            g_free(childPath);
+        }
+        g_dir_close(directory);
+    }
+    g_rmdir(path);
+}
+
+static double median(std::vector<double> values)
+{
+    if (values.empty())
+        return 0;
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    gtk_init(&argc, &argv);
+
+    if (argc > 1)
+        parameters.visitCount = std::max(3, atoi(argv[1]));
+    if (argc > 2)
+        parameters.imageCount = atoi(argv[2]);
+    if (argc > 3)
+        parameters.scriptChainLength = std::max(1, atoi(argv[3]));
+    if (argc > 4)
+        parameters.latencyMS = atoi(argv[4]);
+
+    GError* error = nullptr;
+    SoupServer* server = soup_server_new(SOUP_SERVER_SERVER_HEADER, "SpeculativeLoadBenchmark", nullptr);
+    soup_server_add_handler(server, nullptr, serverCallback, nullptr, nullptr);
+    if (!soup_server_listen_local(server, 0, static_cast<SoupServerListenOptions>(0), &error)) {
+        g_printerr("Could not start the HTTP server: %s\n", error->message);
+        return 1;
+    }
+    GSList* uris = soup_server_get_uris(server);
+    char* baseURIString = soup_uri_to_string(static_cast<SoupURI*>(uris->data), FALSE);
+    std::string baseURI = baseURIString;
+    g_free(baseURIString);
+    g_slist_free_full(uris, reinterpret_cast<GDestroyNotify>(soup_uri_free));
+
+    char* cacheDirectory = g_dir_make_tmp("SpeculativeLoadBenchmark-XXXXXX", &error);
+    if (!cacheDirectory) {
+        g_printerr("Could not create the cache directory: %s\n", error->message);
+        return 1;
+    }
+
+    g_print("%u images, chain of %u scripts, %u ms of latency per response\n", parameters.imageCount, parameters.scriptChainLength, parameters.latencyMS);
+    g_print("visit  same URL                     new URL\n");
+
+    std::vector<double> sameURLTimes;
+    std::vector<double> newURLTimes;
+    for (unsigned i = 0; i < parameters.visitCount; ++i) {
+        auto sameURL = visit(baseURI, cacheDirectory, "page");
+        auto newURL = visit(baseURI, cacheDirectory, "page?visit=" + std::to_string(i));
+        g_print("%5u  %7.1f ms (%3u req, %3u 304)  %7.1f ms (%3u req, %3u 304)\n", i + 1,
+            sameURL.navigationTimeMS, sameURL.statistics.requestCount, sameURL.statistics.notModifiedCount,
+            newURL.navigationTimeMS, newURL.statistics.requestCount, newURL.statistics.notModifiedCount);
+
+        // The subresources of the page are only preloaded once they were seen in two loads in a row.
+        if (i >= 2)
+            sameURLTimes.push_back(sameURL.navigationTimeMS);
+        if (i >= 1)
+            newURLTimes.push_back(newURL.navigationTimeMS);
+    }
+
+    double sameURLMedian = median(sameURLTimes);
+    double newURLMedian = median(newURLTimes);
+    g_print("median navigation time: %.1f ms with speculative revalidation, %.1f ms without (%.1f%% faster)\n",
+        sameURLMedian, newURLMedian, newURLMedian ? 100 * (newURLMedian - sameURLMedian) / newURLMedian : 0);
+
+    removeDirectory(cacheDirectory);
+    g_free(cacheDirectory);
+    g_object_unref(server);
+    return 0;
+}
@@ -99,7 +99,7 @@
 #endif
 
 #ifndef ENABLE_NETWORK_CACHE
-#if PLATFORM(COCOA) || PLATFORM(GTK)
+#if PLATFORM(COCOA) || PLATFORM(GTK) || PLATFORM(EFL)
 #define ENABLE_NETWORK_CACHE 1
 #else
 #define ENABLE_NETWORK_CACHE 0
@@ -107,13 +107,21 @@
 #endif
 
 #ifndef ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION
-#if ENABLE(NETWORK_CACHE) && (PLATFORM(COCOA) || PLATFORM(GTK))
+#if ENABLE(NETWORK_CACHE) && (PLATFORM(COCOA) || PLATFORM(GTK) || PLATFORM(EFL))
 #define ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION 1
 #else
 #define ENABLE_NETWORK_CACHE_SPECULATIVE_REVALIDATION 0
 #endif
 #endif
 
+#ifndef ENABLE_NETWORK_CACHE_BODY_COMPRESSION
+#if ENABLE(NETWORK_CACHE) && USE(ZLIB) && PLATFORM(GTK)
+#define ENABLE_NETWORK_CACHE_BODY_COMPRESSION 1
+#else
+#define ENABLE_NETWORK_CACHE_BODY_COMPRESSION 0
+#endif
+#endif
+
 #ifndef HAVE_SAFARI_SERVICES_FRAMEWORK
 #if PLATFORM(IOS) && (!defined TARGET_OS_IOS || TARGET_OS_IOS)
 #define HAVE_SAFARI_SERVICES_FRAMEWORK 1
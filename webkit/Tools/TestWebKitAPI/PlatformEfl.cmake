@@ -60,6 +60,7 @@ set(test_webcore_BINARIES
     CSSParser
     HTMLParserIdioms
     LayoutUnit
+    TextCodecUTF8
     URL
 )
 
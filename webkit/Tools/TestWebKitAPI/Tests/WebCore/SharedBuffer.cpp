@@ -191,4 +191,110 @@ TEST_F(SharedBufferTest, copy)
     ASSERT_EQ(length * 5, clone->size());
 }
 
+static Vector<char> contentsOf(const SharedBuffer& buffer)
+{
+    Vector<char> contents;
+    buffer.forEachSegment([&contents](const char* segment, unsigned length) {
+        contents.append(segment, length);
+        return true;
+    });
+    return contents;
+}
+
+static Vector<char> concatenate(std::initializer_list<Vector<char>> vectors)
+{
+    Vector<char> result;
+    for (auto& vector : vectors)
+        result.appendVector(vector);
+    return result;
+}
+
+TEST_F(SharedBufferTest, copySharesSegments)
+{
+    Vector<char> vector0(0x1000, 'a');
+    Vector<char> vector1(0x1000, 'b');
+    Vector<char> vector2(0x1000, 'c');
+    RefPtr<SharedBuffer> sharedBuffer = SharedBuffer::create();
+    sharedBuffer->append(vector0);
+    sharedBuffer->append(vector1);
+    sharedBuffer->append(vector2);
+
+    RefPtr<SharedBuffer> clone = sharedBuffer->copy();
+    ASSERT_EQ(sharedBuffer->size(), clone->size());
+
+    // The copy hands out the very same bytes for every run.
+    const char* original;
+    const char* copied;
+    unsigned position = 0;
+    while (unsigned length = sharedBuffer->getSomeData(original, position)) {
+        ASSERT_EQ(length, clone->getSomeData(copied, position));
+        EXPECT_EQ(original, copied);
+        position += length;
+    }
+    EXPECT_EQ(sharedBuffer->size(), position);
+    EXPECT_TRUE(contentsOf(*clone) == concatenate({ vector0, vector1, vector2 }));
+}
+
+TEST_F(SharedBufferTest, sliceAcrossSegmentBoundaries)
+{
+    Vector<char> vector0(0x1000, 'a');
+    Vector<char> vector1(0x1000, 'b');
+    Vector<char> vector2(0x1000, 'c');
+    RefPtr<SharedBuffer> sharedBuffer = SharedBuffer::create();
+    sharedBuffer->append(vector0);
+    sharedBuffer->append(vector1);
+    sharedBuffer->append(vector2);
+
+    RefPtr<SharedBuffer> slice = sharedBuffer->slice(0x1000 - 10, 0x1000 + 20);
+    ASSERT_EQ(0x1000U + 20U, slice->size());
+
+    const char* original;
+    const char* sliced;
+    unsigned sliceLength = slice->getSomeData(sliced, 0);
+    sharedBuffer->getSomeData(original, 0x1000 - 10);
+    EXPECT_EQ(10U, sliceLength);
+    EXPECT_EQ(original, sliced);
+
+    sliceLength = slice->getSomeData(sliced, 10);
+    sharedBuffer->getSomeData(original, 0x1000);
+    EXPECT_EQ(0x1000U, sliceLength);
+    EXPECT_EQ(original, sliced);
+
+    sliceLength = slice->getSomeData(sliced, 0x1000 + 10);
+    sharedBuffer->getSomeData(original, 0x2000);
+    EXPECT_EQ(10U, sliceLength);
+    EXPECT_EQ(original, sliced);
+
+    EXPECT_TRUE(contentsOf(*slice) == concatenate({ Vector<char>(10, 'a'), vector1, Vector<char>(10, 'c') }));
+    EXPECT_EQ(0, memcmp(slice->flattenedData(), sharedBuffer->flattenedData() + 0x1000 - 10, slice->size()));
+
+    RefPtr<SharedBuffer> innerSlice = sharedBuffer->slice(0x1800, 0x100);
+    ASSERT_EQ(0x100U, innerSlice->size());
+    EXPECT_TRUE(contentsOf(*innerSlice) == Vector<char>(0x100, 'b'));
+}
+
+TEST_F(SharedBufferTest, copyOnWriteAfterAppend)
+{
+    Vector<char> vector0(0x1000, 'a');
+    Vector<char> vector1(0x800, 'b');
+    RefPtr<SharedBuffer> sharedBuffer = SharedBuffer::create();
+    sharedBuffer->append(vector0);
+    sharedBuffer->append(vector1);
+    RefPtr<SharedBuffer> clone = sharedBuffer->copy();
+
+    // Both buffers still refer to the half full last segment, so neither may grow it in place.
+    Vector<char> vector2(0x10, 'c');
+    Vector<char> vector3(0x10, 'd');
+    clone->append(vector2);
+    sharedBuffer->append(vector3);
+    EXPECT_TRUE(contentsOf(*sharedBuffer) == concatenate({ vector0, vector1, vector3 }));
+    EXPECT_TRUE(contentsOf(*clone) == concatenate({ vector0, vector1, vector2 }));
+
+    // Flattening one of them leaves the other alone.
+    sharedBuffer->flattenedData();
+    sharedBuffer->append(vector3);
+    EXPECT_TRUE(contentsOf(*sharedBuffer) == concatenate({ vector0, vector1, vector3, vector3 }));
+    EXPECT_TRUE(contentsOf(*clone) == concatenate({ vector0, vector1, vector2 }));
+}
+
 }
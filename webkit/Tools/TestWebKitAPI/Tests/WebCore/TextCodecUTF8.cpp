@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2016 NAVER Corp. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+
+#include "Test.h"
+#include <WebCore/TextCodecUTF8.h>
+#include <wtf/Vector.h>
+#include <wtf/text/StringBuilder.h>
+#include <wtf/text/WTFString.h>
+
+using namespace WebCore;
+
+namespace TestWebKitAPI {
+
+// Some of every sequence length, with ASCII runs long enough for the vector decoders to skip ahead.
+static const char* utf8Text = "Hello, world! 안녕하세요, 세계! Привет, мир! こんにちは世界 Γειά σου κόσμε 😀👍🏽 नमस्ते दुनिया, "
+    "all human beings are born free and equal in dignity and rights. 모든 인간은 태어날 때부터 자유로우며 ❤️";
+
+static Vector<uint8_t> makeInput(unsigned asciiPrefixLength, unsigned repeatCount)
+{
+    Vector<uint8_t> input;
+    for (unsigned i = 0; i < asciiPrefixLength; ++i)
+        input.append('a');
+    for (unsigned i = 0; i < repeatCount; ++i)
+        input.append(reinterpret_cast<const uint8_t*>(utf8Text), strlen(utf8Text));
+    return input;
+}
+
+static String decodeInChunks(const Vector<uint8_t>& input, size_t chunkSize)
+{
+    std::unique_ptr<TextCodec> codec = std::make_unique<TextCodecUTF8>();
+    StringBuilder result;
+    bool sawError = false;
+    for (size_t offset = 0; offset < input.size(); offset += chunkSize) {
+        size_t length = std::min(chunkSize, input.size() - offset);
+        result.append(codec->decode(reinterpret_cast<const char*>(input.data() + offset), length, false, false, sawError));
+    }
+    result.append(codec->decode(nullptr, 0, true, false, sawError));
+    return result.toString();
+}
+
+// The vector decoders only look at blocks of 18 bytes or more, so decoding a byte at a time runs the scalar
+// loop alone. Every other chunk size must give the same result, including where chunks split sequences and
+// where sequences straddle the vector blocks.
+static void expectSameAsScalar(const Vector<uint8_t>& input)
+{
+    String scalarResult = decodeInChunks(input, 1);
+    const size_t chunkSizes[] = { 18, 19, 33, 34, 35, 64, 100, 4096, input.size() + 1 };
+    for (size_t chunkSize : chunkSizes)
+        EXPECT_TRUE(scalarResult == decodeInChunks(input, chunkSize)) << "input length " << input.size() << ", chunk size " << chunkSize;
+}
+
+TEST(TextCodecUTF8, ScalarReferenceMatchesStrictDecoding)
+{
+    Vector<uint8_t> input = makeInput(0, 4);
+    String expected = String::fromUTF8(input.data(), input.size());
+    ASSERT_FALSE(expected.isNull());
+    EXPECT_TRUE(expected == decodeInChunks(input, 1));
+}
+
+TEST(TextCodecUTF8, VectorDecodingValidInput)
+{
+    // Shift the text so that every sequence starts at every offset of a vector block.
+    for (unsigned asciiPrefixLength = 0; asciiPrefixLength < 32; ++asciiPrefixLength)
+        expectSameAsScalar(makeInput(asciiPrefixLength, 8));
+}
+
+TEST(TextCodecUTF8, VectorDecodingTruncatedInput)
+{
+    Vector<uint8_t> input = makeInput(0, 2);
+    for (size_t length = 0; length <= input.size(); ++length) {
+        Vector<uint8_t> truncatedInput;
+        truncatedInput.append(input.data(), length);
+        expectSameAsScalar(truncatedInput);
+    }
+}
+
+TEST(TextCodecUTF8, VectorDecodingCorruptedInput)
+{
+    // Stray continuations, overlong and surrogate leads, and bytes that can never appear in UTF-8.
+    const uint8_t invalidBytes[] = { 0x80, 0x9F, 0xA0, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xFF };
+    Vector<uint8_t> input = makeInput(0, 2);
+    for (size_t position = 0; position < 96; ++position) {
+        for (uint8_t invalidByte : invalidBytes) {
+            Vector<uint8_t> corruptedInput = input;
+            corruptedInput[position] = invalidByte;
+            expectSameAsScalar(corruptedInput);
+        }
+    }
+
+    // Sequences whose lead byte is fine, but whose second byte makes them overlong or a surrogate.
+    const char* invalidSequences[] = { "\xE0\x80\x80", "\xE0\x9F\xBF", "\xED\xA0\x80", "\xED\xBF\xBF", "\xF0\x8F\xBF\xBF", "\xF4\x90\x80\x80", "\xC0\xAF" };
+    for (const char* invalidSequence : invalidSequences) {
+        for (size_t position = 0; position < 40; ++position) {
+            Vector<uint8_t> corruptedInput = input;
+            corruptedInput.insert(position, reinterpret_cast<const uint8_t*>(invalidSequence), strlen(invalidSequence));
+            expectSameAsScalar(corruptedInput);
+        }
+    }
+}
+
+} // namespace TestWebKitAPI